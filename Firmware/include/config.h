@@ -28,6 +28,7 @@
 //=============================================================================
 #define DEVICE_TYPE         "TUOICAY_V1"
 #define DEVICE_PREFIX       "TC"        // Prefix for device ID
+#define DEVICE_GROUP_MAX_LEN 16        // Max fleet group name length
 
 //=============================================================================
 // TIMING CONSTANTS (milliseconds)
@@ -35,6 +36,10 @@
 // Watchdog
 #define WDT_TIMEOUT_SEC         30      // Watchdog timeout in seconds
 
+// Loop latency
+#define LOOP_STALL_WARN_MS      50      // Log loop() iterations slower than this
+#define LOOP_STATS_INTERVAL_MS  60000   // Log loop timing summary every 60s
+
 // WiFi
 #define WIFI_CONNECT_TIMEOUT_MS 30000   // 30s WiFi connection timeout
 #define WIFI_RECONNECT_MIN_MS   2000    // Min reconnect delay
@@ -46,19 +51,72 @@
 #define MQTT_RECONNECT_MAX_MS   30000   // Max reconnect delay
 #define MQTT_KEEPALIVE_SEC      60      // MQTT keepalive interval
 #define MQTT_OFFLINE_QUEUE_SIZE 10      // Max messages in offline queue
+#define MQTT_TLS_PORT           8883    // Port that selects TLS transport
+#define MQTT_TLS_TIMEOUT_MS     5000    // Max time for TCP + TLS handshake
+#define MQTT_TLS_BUFFER_SIZE    1024    // RX/TX buffer when broker supports MFLN
+#define MQTT_TLS_RX_FULL        16384   // RX buffer when broker ignores MFLN
+#define MQTT_TLS_TX_FULL        512     // TX buffer when broker ignores MFLN
+#define MQTT_TLS_CA_MAX_LEN     4096    // Max CA file size
+#define MQTT_TLS_MIN_EPOCH      1704067200UL // 2024-01-01, clock sanity for CA check
+#define CMD_ID_MAX_LEN          24      // Max command correlation ID length
+#define CMD_CACHE_SIZE          8       // Remembered command IDs (retry dedupe)
+#define CONFIG_BATCH_MAX_OPS    12      // Operations per /api/batch or config/batch
+
+// Web
+#define WEB_EVENTS_MAX_CLIENTS  3       // Concurrent /api/events (SSE) streams
+#define WEB_EVENTS_CHECK_MS     250     // Compare live state for changes every 250ms
+#define WEB_EVENTS_PING_MS      15000   // Comment line keeps idle streams open
+#define WEB_EVENTS_RETRY_MS     3000    // Browser reconnect delay after a drop
+#define WEB_ASYNC_QUEUE_SIZE    8       // Parsed requests waiting for loop() (async backend)
+#define WEB_MAX_BODY_SIZE       1024    // Larger request bodies get 413
+#define WEB_MAX_RESPONSE_HEADERS 4      // Extra headers per response
+#define WEB_MAX_CONNECTIONS     4       // Web sockets incl. event streams (sync backend)
+#define WEB_KEEPALIVE_TIMEOUT_MS 5000   // Close a persistent connection idle this long
+#define WEB_KEEPALIVE_MAX_REQUESTS 100  // Then close (spreads sockets across clients)
+#define WEB_REQUEST_TIMEOUT_MS  2000    // Headers + body must arrive within this (408)
+#define WEB_READ_BUDGET         512     // Bytes read per connection per loop()
+#define WEB_HEAP_SAMPLE_MS      1000    // Heap low-water sampling between requests
+#define WEB_FS_ROOT             "/www"  // Dashboard assets on LittleFS (tools/build_dashboard.py)
+#define WEB_ASSET_PREFIX        "/assets/"  // URL prefix of hashed, immutable assets
+#define WEB_ASSET_PATH_MAX      48      // Longest asset URL served
+#define WEB_FILE_CHUNK_SIZE     512     // Flash read per socket write when streaming a file
+#define WEB_ROUTE_SLOT_BITS     6       // Route hash table: 64 slots
+#define WEB_ROUTE_HASH_SEED     2166136263UL    // Change if routes collide (build fails)
 
 // Sensors
 #define SENSOR_READ_INTERVAL_MS 2000    // Read sensors every 2s (OTA TEST!)
 #define SENSOR_FILTER_SAMPLES   3       // Moving average samples (faster)
+#define SENSOR_COUNT            2       // Soil sensors (per-sensor calibration)
 #define MQTT_PUBLISH_INTERVAL_MS 5000   // Publish MQTT every 5s (reduce traffic)
 
 // Pump
 #define PUMP_MAX_RUNTIME_SEC    3600    // Auto-off after 1 hour (for testing)
 #define PUMP_MIN_OFF_TIME_MS    0       // No cooldown (for testing)
 
+// Irrigation jobs (one pump: runs are serialized)
+#define IRRIGATION_QUEUE_MAX    8       // Jobs waiting behind the active one
+#define IRRIGATION_WAIT_MAX_SEC 1800    // Waited longer: dropped instead of started
+
 // NTP
-#define NTP_SYNC_INTERVAL_MS    21600000 // 6 hours
-#define NTP_TIMEZONE_OFFSET     7       // UTC+7 Vietnam
+#define NTP_POLL_MIN_SEC        900     // Sync interval while drift is unknown / unstable
+#define NTP_POLL_MAX_SEC        86400   // Longest interval once drift is compensated
+#define NTP_RETRY_SEC           60      // No server answered
+#define DEFAULT_TIMEZONE        "ICT-7" // POSIX TZ: UTC+7 Vietnam, no DST
+#define TIMEZONE_MAX_LEN        47      // Longest TZ string (DeviceConfig, API)
+#define TIME_HOST_MAX_LEN       47      // Local HTTP time host, "name[:port]"
+#define LOCATION_UNSET          INT32_MIN   // Latitude / longitude not configured
+
+// Water budget (weather forecast / ET0)
+#define BUDGET_ET0_REF_MM10     50      // ET0 5.0 mm/day = 100% (durations as configured)
+#define BUDGET_TEMP_REF_C10     300     // Max temp that matches the reference ET0 (30.0 C)
+#define BUDGET_ET0_PER_C_MM100  15      // ET0 estimate per C when no et0 is sent (0.15 mm)
+#define BUDGET_RAIN_SKIP_MM10   50      // Expected rain >= 5.0 mm: skip runs
+#define BUDGET_MIN_PERCENT      25      // Scale limits when not skipping
+#define BUDGET_MAX_PERCENT      200
+#define BUDGET_DRY_SHIFT_MAX    10      // Auto threshold shift limit (% moisture)
+#define BUDGET_TTL_DEFAULT_H    24      // Forecast validity when "ttl" is not sent
+#define BUDGET_TTL_MAX_H        72
+#define PUMP_LEDGER_SIZE        16      // Remembered runs/skips with their budget
 
 //=============================================================================
 // DEFAULT THRESHOLDS
@@ -73,6 +131,7 @@
 //=============================================================================
 #define ADC_DRY_VALUE           1023    // ADC value when sensor is dry
 #define ADC_WET_VALUE           300     // ADC value when sensor is wet
+#define ADC_MAX_VALUE           1023    // Full scale (calibration upper bound)
 
 //=============================================================================
 // SERIAL CONFIGURATION
@@ -85,5 +144,7 @@
 #define JSON_BUFFER_SIZE        256     // JSON document buffer
 #define TOPIC_BUFFER_SIZE       64      // MQTT topic buffer
 #define LOG_BUFFER_SIZE         128     // Log message buffer
+#define WEB_RESPONSE_BUFFER_SIZE 256    // HTTP body buffer; larger bodies go chunked
+#define WEB_JSON_ARENA_SIZE     2048    // Parsed request body (JsonDocument memory)
 
 #endif // CONFIG_H
@@ -36,6 +36,7 @@
 #define TC_ERR_MQTT_SUBSCRIBE_FAIL 2003    // Failed to subscribe to topic
 #define TC_ERR_MQTT_TIMEOUT        2004    // Operation timeout
 #define TC_ERR_MQTT_DISCONNECTED   2005    // Unexpectedly disconnected
+#define TC_ERR_MQTT_TLS_FAIL       2006    // TLS handshake or certificate check failed
 
 //=============================================================================
 // SENSOR ERRORS (3xxx)
@@ -69,6 +70,15 @@
 #define TC_ERR_PUMP_OVERCURRENT    6002    // Overcurrent detected (future)
 #define TC_ERR_PUMP_SAFETY_TRIP    6003    // Safety mechanism triggered
 
+//=============================================================================
+// COMMAND / LOGIC ERRORS (8xxx)
+//=============================================================================
+#define TC_ERR_CMD_INVALID         8001    // Unknown action or bad parameter
+#define TC_ERR_CMD_DENIED          8002    // Not allowed from this source
+#define TC_ERR_CMD_RATE_LIMITED    8003    // Too many commands
+#define TC_ERR_CMD_INVALID_STATE   8004    // Not possible in current state (e.g. queue full)
+#define TC_ERR_CMD_STALE           8005    // Replayed seq too old to know its result
+
 //=============================================================================
 // SYSTEM ERRORS (9xxx)
 //=============================================================================
@@ -87,12 +97,20 @@ inline const char* error_to_string(int err) {
         case TC_ERR_WIFI_TIMEOUT:          return "WIFI_TIMEOUT";
         case TC_ERR_MQTT_CONNECT_FAIL:     return "MQTT_CONNECT_FAIL";
         case TC_ERR_MQTT_PUBLISH_FAIL:     return "MQTT_PUBLISH_FAIL";
+        case TC_ERR_MQTT_TLS_FAIL:         return "MQTT_TLS_FAIL";
         case TC_ERR_SENSOR_NOT_FOUND:      return "SENSOR_NOT_FOUND";
         case TC_ERR_SENSOR_READ_FAIL:      return "SENSOR_READ_FAIL";
         case TC_ERR_STORAGE_INIT_FAIL:     return "STORAGE_INIT_FAIL";
+        case TC_ERR_STORAGE_WRITE_FAIL:    return "STORAGE_WRITE_FAIL";
         case TC_ERR_STORAGE_CRC_FAIL:      return "STORAGE_CRC_FAIL";
         case TC_ERR_PUMP_TIMEOUT:          return "PUMP_TIMEOUT";
         case TC_ERR_PUMP_SAFETY_TRIP:      return "PUMP_SAFETY_TRIP";
+        case TC_ERR_CMD_INVALID:           return "CMD_INVALID";
+        case TC_ERR_CMD_DENIED:            return "CMD_DENIED";
+        case TC_ERR_CMD_RATE_LIMITED:      return "CMD_RATE_LIMITED";
+        case TC_ERR_CMD_INVALID_STATE:     return "CMD_INVALID_STATE";
+        case TC_ERR_CMD_STALE:             return "CMD_STALE";
+        case TC_ERR_SYSTEM_INVALID_ARG:    return "INVALID_ARG";
         default:                           return "UNKNOWN_ERROR";
     }
 }
@@ -30,7 +30,11 @@ PumpController::PumpController(uint8_t pin)
     , _minOffTimeMs(PUMP_MIN_OFF_TIME_MS)
     , _speedPercent(PUMP_SPEED_DEFAULT)
     , _initialized(false)
+    , _onMsTotal(0)
 {
+    for (uint8_t i = 0; i < PUMP_REASON_COUNT; i++) {
+        _starts[i] = 0;
+    }
 }
 
 bool PumpController::begin() {
@@ -94,6 +98,7 @@ bool PumpController::turnOn(PumpReason reason, uint16_t duration) {
     _state = PumpState::ON;
     _reason = reason;
     _onTime = millis();
+    _starts[(uint8_t)reason]++;
     
     LOG_INF(MOD_PUMP, "on", "Started (reason=%s, duration=%ds)",
             getReasonString(), _requestedDuration);
@@ -109,6 +114,7 @@ void PumpController::turnOff(bool startCooldown) {
     
     // Turn off
     _setPin(false);
+    _endRun();
     _offTime = millis();
     
     if (startCooldown && _minOffTimeMs > 0) {
@@ -204,6 +210,13 @@ uint16_t PumpController::getCooldownRemaining() const {
     return (uint16_t)((_minOffTimeMs - elapsed) / 1000);
 }
 
+uint64_t PumpController::getTotalOnMs() const {
+    if (_state != PumpState::ON) {
+        return _onMsTotal;
+    }
+    return _onMsTotal + (millis() - _onTime);
+}
+
 void PumpController::setMaxRuntime(uint16_t seconds) {
     _maxRuntimeSec = seconds;
     LOG_INF(MOD_PUMP, "config", "Max runtime set to %ds", seconds);
@@ -231,12 +244,19 @@ void PumpController::setSpeed(uint8_t percent) {
 void PumpController::emergencyStop() {
     LOG_ERR(MOD_PUMP, "ESTOP", "EMERGENCY STOP!");
     _setPin(false);
+    _endRun();
     _state = PumpState::OFF;
     _reason = PumpReason::NONE;
     _offTime = millis();
     // No cooldown on emergency stop - allow immediate restart if needed
 }
 
+void PumpController::_endRun() {
+    if (_state == PumpState::ON) {
+        _onMsTotal += millis() - _onTime;
+    }
+}
+
 void PumpController::_setPin(bool on) {
     if (on) {
         _applyPWM();
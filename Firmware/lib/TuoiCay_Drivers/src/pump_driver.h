@@ -7,6 +7,7 @@
  * - Safety: auto-off after configurable max runtime
  * - Safety: minimum off time to prevent rapid cycling
  * - Track runtime and state
+ * - Lifetime counters since boot: total on-time, starts per reason
  * 
  * HARDWARE:
  * - D6 (GPIO12) → MOSFET Gate (PWM capable)
@@ -49,6 +50,8 @@ enum class PumpReason : uint8_t {
     SCHEDULE = 3    // Scheduled watering
 };
 
+#define PUMP_REASON_COUNT   4       // Entries in PumpReason
+
 //=============================================================================
 // PUMP CONTROLLER CLASS
 //=============================================================================
@@ -185,6 +188,19 @@ public:
      * @brief Get last turn-off timestamp
      */
     unsigned long getLastOffTime() const { return _offTime; }
+    
+    /**
+     * @brief Total time the pump ran since boot, current run included
+     * @return Milliseconds
+     */
+    uint64_t getTotalOnMs() const;
+    
+    /**
+     * @brief Number of times the pump was started for a reason since boot
+     */
+    uint32_t getStartCount(PumpReason reason) const {
+        return _starts[(uint8_t)reason];
+    }
 
 private:
     uint8_t _pin;                           // GPIO pin
@@ -201,6 +217,14 @@ private:
     
     bool _initialized;
     
+    uint64_t _onMsTotal;                    // Completed runs since boot
+    uint32_t _starts[PUMP_REASON_COUNT];    // Starts per PumpReason
+    
+    /**
+     * @brief Account a run that is ending (pump was ON)
+     */
+    void _endRun();
+    
     /**
      * @brief Set physical pin state with PWM
      * @param on true = pump on at current speed
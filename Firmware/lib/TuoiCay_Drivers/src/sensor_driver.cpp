@@ -25,6 +25,7 @@ SoilSensor::SoilSensor(int8_t digitalPin, int8_t analogPin, uint8_t id)
     , _id(id)
     , _digitalValue(true)       // Default: dry (safe assumption)
     , _analogValue(ADC_DRY_VALUE)
+    , _rawValue(0)
     , _moisturePercent(0)
     , _filterIndex(0)
     , _filterFilled(false)
@@ -111,8 +112,8 @@ void SoilSensor::update() {
     
     // Read and filter analog value if available
     if (_analogPin >= 0) {
-        uint16_t rawValue = readAnalogRaw();
-        _analogValue = _addToFilter(rawValue);
+        _rawValue = readAnalogRaw();
+        _analogValue = _addToFilter(_rawValue);
         _moisturePercent = _adcToPercent(_analogValue);
     }
     
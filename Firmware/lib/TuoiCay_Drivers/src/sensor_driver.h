@@ -70,6 +70,12 @@ public:
      */
     uint16_t readAnalogFiltered();
     
+    /**
+     * @brief Last unfiltered ADC sample taken by update()
+     * @return Raw ADC value, or 0 if no analog pin configured
+     */
+    uint16_t getLastRaw() const { return _rawValue; }
+    
     /**
      * @brief Get moisture percentage (0-100%)
      * @return Moisture %, or SENSOR_INVALID_VALUE if no analog available
@@ -125,6 +131,7 @@ private:
     
     bool _digitalValue;                     // Current digital reading
     uint16_t _analogValue;                  // Current filtered analog reading
+    uint16_t _rawValue;                     // Last unfiltered analog sample
     uint8_t _moisturePercent;               // Current moisture %
     
     uint16_t _filterBuffer[SENSOR_FILTER_SIZE]; // Moving average buffer
@@ -6,10 +6,49 @@
 
 #include "captive_portal.h"
 #include <logger.h>
+#include <buffered_response.h>
+#include <json_writer.h>
 
 // Logger module name
 #define MOD_PORTAL  "PORTAL"
 
+//=============================================================================
+// RESPONSE WRITER
+//=============================================================================
+
+/**
+ * @brief Streams a page/JSON body through ESP8266WebServer from a fixed
+ *        stack buffer (Content-Length if it fits, chunked otherwise)
+ */
+class PortalResponse : public BufferedResponse {
+public:
+    PortalResponse(ESP8266WebServer& server, int code, const char* contentType)
+        : _server(server), _code(code), _contentType(contentType) {}
+
+protected:
+    void _sendWhole(const char* data, size_t len) override {
+        _server.send(_code, _contentType, data, len);
+    }
+    
+    void _beginStream() override {
+        _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        _server.send(_code, _contentType, String());
+    }
+    
+    void _sendChunk(const char* data, size_t len) override {
+        _server.sendContent(data, len);
+    }
+    
+    void _endStream() override {
+        _server.chunkedResponseFinalize();
+    }
+
+private:
+    ESP8266WebServer& _server;
+    int _code;
+    const char* _contentType;
+};
+
 //=============================================================================
 // CONSTRUCTOR
 //=============================================================================
@@ -158,7 +197,9 @@ void CaptivePortal::update() {
 
 void CaptivePortal::_handleRoot() {
     LOG_DBG(MOD_PORTAL, "http", "Serving config page");
-    _server->send(200, "text/html", _generateConfigPage());
+    PortalResponse out(*_server, 200, "text/html");
+    _generateConfigPage(out);
+    out.end();
 }
 
 void CaptivePortal::_handleScan() {
@@ -169,7 +210,9 @@ void CaptivePortal::_handleScan() {
         WiFi.scanNetworks(true);
     }
     
-    _server->send(200, "application/json", _generateScanResultsJSON());
+    PortalResponse out(*_server, 200, "application/json");
+    _generateScanResultsJSON(out);
+    out.end();
 }
 
 void CaptivePortal::_handleSave() {
@@ -212,18 +255,21 @@ void CaptivePortal::_handleSave() {
     }
     
     // Send success page
-    _server->send(200, "text/html", _generateSuccessPage());
+    PortalResponse out(*_server, 200, "text/html");
+    _generateSuccessPage(out);
+    out.end();
 }
 
 void CaptivePortal::_handleStatus() {
-    String json = "{";
-    json += "\"active\":" + String(_isActive ? "true" : "false") + ",";
-    json += "\"hasConfig\":" + String(_hasConfig ? "true" : "false") + ",";
-    json += "\"uptime\":" + String((millis() - _startTime) / 1000) + ",";
-    json += "\"stations\":" + String(getStationCount());
-    json += "}";
-    
-    _server->send(200, "application/json", json);
+    PortalResponse out(*_server, 200, "application/json");
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("active", _isActive);
+    json.add("hasConfig", _hasConfig);
+    json.add("uptime", (millis() - _startTime) / 1000);
+    json.add("stations", getStationCount());
+    json.endObject();
+    out.end();
 }
 
 void CaptivePortal::_handleNotFound() {
@@ -236,8 +282,8 @@ void CaptivePortal::_handleNotFound() {
 // HTML GENERATION
 //=============================================================================
 
-String CaptivePortal::_getCSS() {
-    return R"rawliteral(
+// Pages live in flash and are copied into the response buffer piecewise
+static const char PORTAL_CSS[] PROGMEM = R"rawliteral(
 <style>
 *{box-sizing:border-box;margin:0;padding:0}
 body{font-family:-apple-system,BlinkMacSystemFont,'Segoe UI',Roboto,Oxygen,Ubuntu,sans-serif;
@@ -266,10 +312,8 @@ cursor:pointer;transition:transform 0.2s,box-shadow 0.2s}
 .loading{text-align:center;padding:20px;color:#666}
 </style>
 )rawliteral";
-}
 
-String CaptivePortal::_generateConfigPage() {
-    String html = R"rawliteral(
+static const char CONFIG_PAGE_HEAD[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html lang="vi">
 <head>
@@ -277,10 +321,8 @@ String CaptivePortal::_generateConfigPage() {
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <title>Cấu hình TuoiCay</title>
 )rawliteral";
-    
-    html += _getCSS();
-    
-    html += R"rawliteral(
+
+static const char CONFIG_PAGE_BODY[] PROGMEM = R"rawliteral(
 </head>
 <body>
 <div class="container">
@@ -368,12 +410,8 @@ setTimeout(scanNetworks, 500);
 </body>
 </html>
 )rawliteral";
-    
-    return html;
-}
 
-String CaptivePortal::_generateSuccessPage() {
-    String html = R"rawliteral(
+static const char SUCCESS_PAGE_HEAD[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html lang="vi">
 <head>
@@ -381,10 +419,8 @@ String CaptivePortal::_generateSuccessPage() {
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <title>Cấu hình thành công</title>
 )rawliteral";
-    
-    html += _getCSS();
-    
-    html += R"rawliteral(
+
+static const char SUCCESS_PAGE_MID[] PROGMEM = R"rawliteral(
 <style>
 .success{color:#27ae60}
 .info{background:#e8f5e9;border-radius:10px;padding:15px;margin:20px 0;font-size:14px}
@@ -398,10 +434,8 @@ String CaptivePortal::_generateSuccessPage() {
 
 <div class="info">
 <strong>Mạng WiFi:</strong> )rawliteral";
-    
-    html += _escapeHTML(_configuredSSID);
-    
-    html += R"rawliteral(<br>
+
+static const char SUCCESS_PAGE_TAIL[] PROGMEM = R"rawliteral(<br>
 <strong>Trạng thái:</strong> Đang kết nối...
 </div>
 
@@ -419,27 +453,42 @@ setTimeout(function(){
 </body>
 </html>
 )rawliteral";
+
+void CaptivePortal::_generateConfigPage(Print& out) {
+    out.print(FPSTR(CONFIG_PAGE_HEAD));
+    out.print(FPSTR(PORTAL_CSS));
+    out.print(FPSTR(CONFIG_PAGE_BODY));
+}
+
+void CaptivePortal::_generateSuccessPage(Print& out) {
+    char ssid[CAPTIVE_PORTAL_ESCAPED_SSID_LEN];
+    _escapeHTML(_configuredSSID.c_str(), ssid, sizeof(ssid));
     
-    return html;
+    out.print(FPSTR(SUCCESS_PAGE_HEAD));
+    out.print(FPSTR(PORTAL_CSS));
+    out.print(FPSTR(SUCCESS_PAGE_MID));
+    out.print(ssid);
+    out.print(FPSTR(SUCCESS_PAGE_TAIL));
 }
 
-String CaptivePortal::_generateScanResultsJSON() {
-    String json = "[";
+void CaptivePortal::_generateScanResultsJSON(Print& out) {
+    JsonWriter json(out);
+    json.beginArray();
     
     int n = WiFi.scanComplete();
-    if (n > 0) {
-        for (int i = 0; i < n; i++) {
-            if (i > 0) json += ",";
-            json += "{";
-            json += "\"ssid\":\"" + _escapeHTML(WiFi.SSID(i)) + "\",";
-            json += "\"rssi\":" + String(WiFi.RSSI(i)) + ",";
-            json += "\"secure\":" + String(WiFi.encryptionType(i) != ENC_TYPE_NONE ? "true" : "false");
-            json += "}";
-        }
+    for (int i = 0; i < n; i++) {
+        // Page inserts SSIDs with innerHTML: HTML-escape, JsonWriter adds JSON escaping
+        char ssid[CAPTIVE_PORTAL_ESCAPED_SSID_LEN];
+        _escapeHTML(WiFi.SSID(i).c_str(), ssid, sizeof(ssid));
+        
+        json.beginObject();
+        json.add("ssid", ssid);
+        json.add("rssi", (long)WiFi.RSSI(i));
+        json.add("secure", WiFi.encryptionType(i) != ENC_TYPE_NONE);
+        json.endObject();
     }
     
-    json += "]";
-    return json;
+    json.endArray();
 }
 
 //=============================================================================
@@ -456,12 +505,28 @@ uint8_t CaptivePortal::getStationCount() const {
     return WiFi.softAPgetStationNum();
 }
 
-String CaptivePortal::_escapeHTML(const String& str) {
-    String escaped = str;
-    escaped.replace("&", "&amp;");
-    escaped.replace("<", "&lt;");
-    escaped.replace(">", "&gt;");
-    escaped.replace("\"", "&quot;");
-    escaped.replace("'", "&#39;");
-    return escaped;
+void CaptivePortal::_escapeHTML(const char* str, char* out, size_t size) {
+    size_t len = 0;
+    for (; *str; str++) {
+        const char* entity = nullptr;
+        switch (*str) {
+            case '&':  entity = "&amp;"; break;
+            case '<':  entity = "&lt;"; break;
+            case '>':  entity = "&gt;"; break;
+            case '"':  entity = "&quot;"; break;
+            case '\'': entity = "&#39;"; break;
+        }
+        
+        size_t n = entity ? strlen(entity) : 1;
+        if (len + n >= size) {
+            break;
+        }
+        if (entity) {
+            memcpy(out + len, entity, n);
+        } else {
+            out[len] = *str;
+        }
+        len += n;
+    }
+    out[len] = '\0';
 }
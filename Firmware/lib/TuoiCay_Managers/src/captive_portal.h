@@ -33,6 +33,9 @@
 #define CAPTIVE_PORTAL_TIMEOUT      300000      // 5 minutes timeout
 #endif
 
+// SSID (max 32 chars) after HTML escaping, worst case 6 bytes per char
+#define CAPTIVE_PORTAL_ESCAPED_SSID_LEN (32 * 6 + 1)
+
 #ifndef DNS_PORT
 #define DNS_PORT                    53
 #endif
@@ -167,14 +170,15 @@ private:
     void _handleNotFound();
     void _handleStatus();
     
-    // Generate HTML pages
-    String _generateConfigPage();
-    String _generateSuccessPage();
-    String _generateScanResultsJSON();
+    // Write pages straight into the response (no String building)
+    void _generateConfigPage(Print& out);
+    void _generateSuccessPage(Print& out);
+    void _generateScanResultsJSON(Print& out);
     
-    // HTML/CSS helpers
-    String _getCSS();
-    String _escapeHTML(const String& str);
+    /**
+     * @brief HTML-escape into a caller buffer (truncates to fit)
+     */
+    static void _escapeHTML(const char* str, char* out, size_t size);
     
     // State
     ESP8266WebServer* _server;
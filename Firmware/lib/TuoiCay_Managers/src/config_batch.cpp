@@ -0,0 +1,174 @@
+/**
+ * @file config_batch.cpp
+ * @brief Config batch validation implementation
+ *
+ * RULES: #JSON(23) #NVS(18)
+ */
+
+#include "config_batch.h"
+#include <logger.h>
+#include <posix_tz.h>
+#include <http_date.h>
+#include <sun_calc.h>
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+
+/**
+ * @brief Read an integer member; missing uses fallback, wrong type fails
+ */
+static bool readInt(JsonVariantConst obj, const char* key, long min, long max,
+                    long fallback, long& value) {
+    JsonVariantConst field = obj[key];
+    if (field.isNull()) {
+        value = fallback;
+    } else if (field.is<long>()) {
+        value = field.as<long>();
+    } else {
+        return false;
+    }
+    return value >= min && value <= max;
+}
+
+static const long REQUIRED = -1;    // Fallback outside every valid range
+
+//=============================================================================
+// PARSING
+//=============================================================================
+
+bool ConfigBatch::parse(JsonVariantConst ops) {
+    clear();
+
+    JsonArrayConst list = ops.as<JsonArrayConst>();
+    if (list.isNull() || list.size() == 0) {
+        return _fail(-1, "ops must be a non-empty array");
+    }
+    if (list.size() > CONFIG_BATCH_MAX_OPS) {
+        return _fail(-1, "too many ops");
+    }
+
+    for (JsonVariantConst item : list) {
+        BatchOp& op = _ops[_count];
+        const char* error = _parseOp(item, op);
+        if (error) {
+            return _fail(_count, error);
+        }
+        _mask |= BATCH_OP_MASK(op.type);
+        _count++;
+    }
+    return true;
+}
+
+const char* ConfigBatch::_parseOp(JsonVariantConst item, BatchOp& op) {
+    const char* name = item["op"] | "";
+    long a, b, c;
+
+    if (strcmp(name, "thresholds") == 0) {
+        if (!readInt(item, "dry", 0, 100, REQUIRED, a) ||
+            !readInt(item, "wet", 0, 100, REQUIRED, b) || a >= b) {
+            return "thresholds: need 0 <= dry < wet <= 100";
+        }
+        op.type = BatchOpType::THRESHOLDS;
+        op.thresholds.dry = (uint8_t)a;
+        op.thresholds.wet = (uint8_t)b;
+        return nullptr;
+    }
+
+    if (strcmp(name, "mode") == 0) {
+        const char* mode = item["mode"] | "";
+        op.type = BatchOpType::MODE;
+        if (strcmp(mode, "auto") == 0) {
+            op.mode.autoMode = true;
+        } else if (strcmp(mode, "manual") == 0) {
+            op.mode.autoMode = false;
+        } else {
+            return "mode: must be auto or manual";
+        }
+        return nullptr;
+    }
+
+    if (strcmp(name, "speed") == 0) {
+        if (!readInt(item, "speed", 30, 100, REQUIRED, a)) {
+            return "speed: must be 30-100";
+        }
+        op.type = BatchOpType::SPEED;
+        op.speed.percent = (uint8_t)a;
+        return nullptr;
+    }
+
+    if (strcmp(name, "schedule") == 0) {
+        if (!readInt(item, "index", 0, MAX_SCHEDULE_ENTRIES - 1, REQUIRED, a)) {
+            return "schedule: index must be 0-15";
+        }
+        op.type = BatchOpType::SCHEDULE;
+        op.schedule.index = (uint8_t)a;
+        op.schedule.entry.setDefaults();
+        return scheduleEntryFromJson(item, op.schedule.entry);   // nullptr or reason
+    }
+
+    if (strcmp(name, "calibration") == 0) {
+        if (!readInt(item, "sensor", 0, SENSOR_COUNT - 1, REQUIRED, a) ||
+            !readInt(item, "dry", 1, ADC_MAX_VALUE, REQUIRED, b) ||
+            !readInt(item, "wet", 0, ADC_MAX_VALUE, REQUIRED, c) || c >= b) {
+            return "calibration: need sensor 0-1 and 0 <= wet < dry <= 1023";
+        }
+        op.type = BatchOpType::CALIBRATION;
+        op.calibration.sensor = (uint8_t)a;
+        op.calibration.dry = (uint16_t)b;
+        op.calibration.wet = (uint16_t)c;
+        return nullptr;
+    }
+
+    if (strcmp(name, "timezone") == 0) {
+        const char* tz = item["tz"] | "";
+        if (!posixTzValid(tz, TIMEZONE_MAX_LEN)) {
+            return "timezone: tz must be a POSIX TZ string, e.g. ICT-7";
+        }
+        op.type = BatchOpType::TIMEZONE;
+        memset(op.timezone.tz, 0, sizeof(op.timezone.tz));
+        strncpy(op.timezone.tz, tz, sizeof(op.timezone.tz) - 1);
+        return nullptr;
+    }
+
+    if (strcmp(name, "time_host") == 0) {
+        const char* host = item["host"];
+        uint16_t port;
+        size_t nameLen;
+        if (!host || !httpHostValid(host, TIME_HOST_MAX_LEN, port, nameLen)) {
+            return "time_host: host must be name[:port], up to 47 chars";
+        }
+        op.type = BatchOpType::TIME_HOST;
+        memset(op.timeHost.host, 0, sizeof(op.timeHost.host));
+        strncpy(op.timeHost.host, host, sizeof(op.timeHost.host) - 1);
+        return nullptr;
+    }
+
+    if (strcmp(name, "location") == 0) {
+        JsonVariantConst lat = item["lat"];
+        JsonVariantConst lon = item["lon"];
+        op.type = BatchOpType::LOCATION;
+        if (lat.isNull() && lon.isNull()) {
+            op.location.latE4 = LOCATION_UNSET;
+            op.location.lonE4 = LOCATION_UNSET;
+            return nullptr;
+        }
+        if (!lat.is<double>() || !lon.is<double>() ||
+            !sunLocationFromDegrees(lat.as<double>(), lon.as<double>(),
+                                    op.location.latE4, op.location.lonE4)) {
+            return "location: need lat -90..90 and lon -180..180 (or neither)";
+        }
+        return nullptr;
+    }
+
+    return "unknown op";
+}
+
+bool ConfigBatch::_fail(int8_t index, const char* error) {
+    _count = 0;
+    _mask = 0;
+    _errorIndex = index;
+    _error = error;
+    LOG_WRN(MOD_SYSTEM, "batch", "Rejected (op %d): %s", index, error);
+    return false;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file config_batch.h
+ * @brief Validated list of configuration operations applied as one unit
+ *
+ * LOGIC:
+ * - Same payload from POST /api/batch and MQTT config/batch:
+ *   {"ops":[{"op":"thresholds","dry":30,"wet":60}, {"op":"mode","mode":"auto"}, ...]}
+ * - parse() checks every operation before anything is applied; the first
+ *   bad one rejects the whole batch (index + reason kept for the reply)
+ * - Accepted operations are copied into fixed BatchOp slots, so the JSON
+ *   document can be released before the batch is applied
+ * - Applying (runtime state + storage) is done by the owner of that state,
+ *   see applyConfigBatch() in main.cpp
+ *
+ * Operations:
+ * - thresholds:  dry, wet (0-100, dry < wet)
+ * - mode:        mode ("auto" | "manual")
+ * - speed:       speed (30-100 %)
+ * - schedule:    index (0-MAX_SCHEDULE_ENTRIES-1) plus the entry fields of
+ *                /api/schedule (type, hour, minute, days, every, offset,
+ *                from, to, duration, enabled); an index past the end
+ *                appends, gaps become disabled default entries
+ * - calibration: sensor (0-1), dry, wet (raw ADC, wet < dry <= 1023)
+ * - timezone:    tz (POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3")
+ * - time_host:   host ("name[:port]" read for time while NTP is out, "" = none)
+ * - location:    lat (-90..90), lon (-180..180) in degrees for sunrise /
+ *                sunset entries; both left out = no location
+ *
+ * RULES: #JSON(23) #NVS(18)
+ */
+
+#ifndef CONFIG_BATCH_H
+#define CONFIG_BATCH_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <config.h>
+#include "storage_manager.h"    // ScheduleEntry, MAX_SCHEDULE_ENTRIES
+
+//=============================================================================
+// OPERATIONS
+//=============================================================================
+
+enum class BatchOpType : uint8_t {
+    THRESHOLDS = 0,
+    MODE,
+    SPEED,
+    SCHEDULE,
+    CALIBRATION,
+    TIMEZONE,
+    TIME_HOST,
+    LOCATION
+};
+
+#define BATCH_OP_MASK(type)     (1u << (uint8_t)(type))
+
+/**
+ * @brief One validated operation (payload depends on type)
+ */
+struct BatchOp {
+    BatchOpType type;
+
+    struct Thresholds { uint8_t dry; uint8_t wet; };
+    struct Mode { bool autoMode; };
+    struct Speed { uint8_t percent; };
+    struct Schedule { uint8_t index; ScheduleEntry entry; };
+    struct Calibration { uint8_t sensor; uint16_t dry; uint16_t wet; };
+    struct Timezone { char tz[TIMEZONE_MAX_LEN + 1]; };
+    struct TimeHost { char host[TIME_HOST_MAX_LEN + 1]; };
+    struct Location { int32_t latE4; int32_t lonE4; };     // LOCATION_UNSET = none
+
+    union {
+        Thresholds thresholds;
+        Mode mode;
+        Speed speed;
+        Schedule schedule;
+        Calibration calibration;
+        Timezone timezone;
+        TimeHost timeHost;
+        Location location;
+    };
+};
+
+//=============================================================================
+// CONFIG BATCH CLASS
+//=============================================================================
+
+/**
+ * @class ConfigBatch
+ * @brief Up to CONFIG_BATCH_MAX_OPS operations, all valid or none kept
+ */
+class ConfigBatch {
+public:
+    ConfigBatch() { clear(); }
+
+    /**
+     * @brief Validate and store the "ops" array
+     * @param ops Array of operation objects
+     * @return false if any operation is invalid (batch left empty)
+     */
+    bool parse(JsonVariantConst ops);
+
+    void clear() {
+        _count = 0;
+        _mask = 0;
+        _errorIndex = -1;
+        _error = nullptr;
+    }
+
+    uint8_t count() const { return _count; }
+    const BatchOp& op(uint8_t i) const { return _ops[i]; }
+
+    /**
+     * @brief Bit set of BATCH_OP_MASK(type) for every type present
+     */
+    uint8_t mask() const { return _mask; }
+    bool has(BatchOpType type) const { return _mask & BATCH_OP_MASK(type); }
+
+    /**
+     * @brief Failing operation (-1 = the array itself) and reason
+     */
+    int8_t errorIndex() const { return _errorIndex; }
+    const char* error() const { return _error; }
+
+private:
+    BatchOp _ops[CONFIG_BATCH_MAX_OPS];
+    uint8_t _count;
+    uint8_t _mask;
+    int8_t _errorIndex;
+    const char* _error;
+
+    const char* _parseOp(JsonVariantConst item, BatchOp& op);
+    bool _fail(int8_t index, const char* error);
+};
+
+#endif // CONFIG_BATCH_H
@@ -0,0 +1,296 @@
+/**
+ * @file dashboard_html.h
+ * @brief Gzip-compressed dashboard (GENERATED - do not edit)
+ *
+ * LOGIC:
+ * - Generated by tools/build_dashboard.py from web/index.html
+ * - Source 23643 bytes, minified 15180 bytes, gzip 4347 bytes
+ * - DASHBOARD_ETAG changes whenever the compressed content changes
+ *
+ * RULES: #HTTP(24)
+ */
+
+#ifndef DASHBOARD_HTML_H
+#define DASHBOARD_HTML_H
+
+#include <Arduino.h>
+
+#define DASHBOARD_ETAG      "\"fd25a805c8a1c886\""
+#define DASHBOARD_HTML_GZ_LEN   4347
+
+static const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xcd, 0x3b, 0x5b, 0x8f, 0x1b, 0xd7,
+    0x79, 0xef, 0xfc, 0x15, 0x47, 0x74, 0x0d, 0x92, 0xdd, 0x25, 0x77, 0x48, 0x4a, 0xdb, 0xf5, 0x70,
+    0x77, 0x03, 0x69, 0xad, 0x45, 0x54, 0x4b, 0x5a, 0x25, 0x4b, 0x35, 0x2d, 0x04, 0x43, 0x19, 0xce,
+    0x1c, 0x92, 0xc7, 0x9a, 0x9b, 0x67, 0xce, 0x68, 0xc5, 0xd2, 0x7c, 0xe8, 0x53, 0x1f, 0xd2, 0xd6,
+    0x71, 0x7a, 0x4d, 0x83, 0xc2, 0x51, 0x8d, 0xa0, 0x28, 0x90, 0x34, 0x0e, 0x1a, 0x20, 0xc5, 0x2e,
+    0x90, 0x3e, 0xac, 0xa1, 0xff, 0xc1, 0xfe, 0x81, 0xfa, 0x27, 0xf4, 0xfb, 0xce, 0x65, 0x6e, 0xe4,
+    0x92, 0x94, 0xe4, 0x2d, 0xec, 0x07, 0x2f, 0xe7, 0xcc, 0x77, 0xbe, 0xf3, 0xdd, 0x6f, 0x67, 0xb4,
+    0x7f, 0xe3, 0xfd, 0x93, 0xa3, 0xfe, 0x9f, 0x3d, 0xba, 0x4b, 0xc6, 0xdc, 0x73, 0x0f, 0x2b, 0xfb,
+    0xfa, 0x0f, 0xb5, 0x1c, 0xf8, 0xe3, 0x51, 0x6e, 0x11, 0x7b, 0x6c, 0x45, 0x31, 0xe5, 0x07, 0xd5,
+    0xc7, 0xfd, 0xe3, 0xe6, 0x5e, 0x55, 0x2f, 0xfb, 0x96, 0x47, 0x0f, 0xaa, 0xcf, 0x19, 0x3d, 0x0b,
+    0x83, 0x88, 0x57, 0x89, 0x1d, 0xf8, 0x9c, 0xfa, 0x00, 0x76, 0xc6, 0x1c, 0x3e, 0x3e, 0x70, 0xe8,
+    0x73, 0x66, 0xd3, 0xa6, 0x78, 0xd8, 0x26, 0xcc, 0x67, 0x9c, 0x59, 0x6e, 0x33, 0xb6, 0x2d, 0x97,
+    0x1e, 0xb4, 0x5b, 0x06, 0xa2, 0xe1, 0x8c, 0xbb, 0xf4, 0xb0, 0x9f, 0x04, 0xec, 0xc8, 0x9a, 0x90,
+    0xe7, 0xb0, 0xba, 0xbf, 0x23, 0xd7, 0x2a, 0xfb, 0x31, 0x9f, 0xc0, 0xdf, 0x3f, 0x9c, 0x0e, 0x82,
+    0x17, 0xcd, 0x98, 0xfd, 0x39, 0xf3, 0x47, 0xe6, 0x20, 0x88, 0x1c, 0x1a, 0x35, 0x61, 0xa5, 0xe7,
+    0x59, 0xd1, 0x88, 0xf9, 0xa6, 0xd1, 0x0b, 0x2d, 0xc7, 0xc1, 0x77, 0xc6, 0x6c, 0x10, 0x38, 0x93,
+    0xe9, 0x10, 0x68, 0x68, 0x0e, 0x2d, 0x8f, 0xb9, 0x13, 0xf3, 0x76, 0x04, 0x07, 0x6e, 0xc7, 0x96,
+    0x1f, 0x37, 0x63, 0x1a, 0xb1, 0x61, 0x6f, 0x60, 0xd9, 0xcf, 0x46, 0x51, 0x90, 0xf8, 0x8e, 0xf9,
+    0x4e, 0xdb, 0x6a, 0x5b, 0x1d, 0xda, 0xb3, 0x03, 0x37, 0x88, 0xcc, 0x77, 0x28, 0xa5, 0x29, 0xa6,
+    0x8e, 0x11, 0xbe, 0x98, 0xb5, 0x90, 0x19, 0x8b, 0xf9, 0x34, 0x9a, 0x7a, 0xd6, 0x0b, 0xc9, 0x84,
+    0x79, 0xcb, 0x80, 0x57, 0xe9, 0xd1, 0xc4, 0x4a, 0x78, 0x30, 0x1b, 0xb7, 0xa7, 0x0a, 0x87, 0x61,
+    0x38, 0xef, 0x0d, 0x87, 0x3d, 0x4e, 0x5f, 0xf0, 0xa6, 0xe5, 0xb2, 0x91, 0x6f, 0xda, 0x20, 0x0d,
+    0x1a, 0xa9, 0x0d, 0x40, 0x36, 0xe7, 0x81, 0xa7, 0xd1, 0x5b, 0x91, 0x33, 0x2d, 0xd0, 0xb3, 0xdb,
+    0x69, 0x77, 0x69, 0x4f, 0xb1, 0x18, 0x59, 0x0e, 0x4b, 0x62, 0xb3, 0x8d, 0xe7, 0xe5, 0xe9, 0x2a,
+    0xe1, 0x6a, 0xdf, 0xd2, 0xb8, 0xc8, 0xb8, 0x53, 0xa2, 0x43, 0x48, 0x02, 0x04, 0x47, 0xcd, 0xf6,
+    0xcd, 0xc5, 0x8d, 0x88, 0x4b, 0x50, 0xca, 0x23, 0x90, 0xcf, 0x30, 0x88, 0x3c, 0x33, 0x09, 0x43,
+    0x1a, 0xd9, 0x56, 0x4c, 0x67, 0xad, 0xe7, 0x96, 0x9b, 0xd0, 0x69, 0x86, 0xa1, 0xbb, 0x0b, 0xe0,
+    0xe2, 0xf1, 0x8c, 0xb2, 0xd1, 0x98, 0x83, 0x26, 0x5c, 0x47, 0xcb, 0x6e, 0x38, 0x1c, 0xce, 0x5a,
+    0x09, 0xa8, 0x37, 0xb7, 0xa1, 0xbd, 0x07, 0x1b, 0xd4, 0xfb, 0xbd, 0xbd, 0xbd, 0x59, 0x2b, 0xe6,
+    0x16, 0x4f, 0xe2, 0xa9, 0xc3, 0xe2, 0xd0, 0xb5, 0x26, 0x26, 0xf3, 0x5d, 0x90, 0x6d, 0x73, 0xe0,
+    0x06, 0xf6, 0xb3, 0x94, 0x41, 0x60, 0x86, 0x20, 0x47, 0x25, 0x21, 0x08, 0xbe, 0xcb, 0x87, 0x6b,
+    0x8c, 0xad, 0xc0, 0x2f, 0x88, 0xd1, 0x30, 0xec, 0xbd, 0x5b, 0xdd, 0x02, 0x69, 0x1a, 0x70, 0x38,
+    0x2c, 0x40, 0x0e, 0x87, 0xb7, 0x3a, 0xb7, 0x3a, 0xcb, 0x20, 0x51, 0xaf, 0x05, 0xd0, 0x4e, 0xfb,
+    0xbd, 0xdd, 0xe1, 0x52, 0xa4, 0x9e, 0xe5, 0x27, 0x96, 0x5b, 0xc2, 0xfb, 0xde, 0x9e, 0x61, 0x14,
+    0x80, 0x07, 0xdc, 0x4f, 0x39, 0x97, 0x2c, 0x4b, 0x7b, 0x6a, 0x1b, 0xc6, 0xbb, 0x29, 0xf7, 0x39,
+    0xce, 0x4d, 0x3f, 0xf0, 0xcb, 0xa6, 0xb0, 0xa7, 0x85, 0x20, 0xe5, 0xbb, 0x5c, 0x21, 0x49, 0x14,
+    0xc3, 0xa1, 0x61, 0xc0, 0xf2, 0x76, 0xc7, 0x83, 0x50, 0xe8, 0x5b, 0xd0, 0xd1, 0x0c, 0x13, 0x2f,
+    0x2c, 0x49, 0x4c, 0x98, 0x8b, 0xa2, 0x57, 0xba, 0x85, 0x04, 0xf5, 0x02, 0x87, 0x16, 0x40, 0xff,
+    0xc8, 0xbe, 0xe9, 0x64, 0xa0, 0x9a, 0x35, 0xd3, 0xb2, 0x39, 0x7b, 0x4e, 0xa7, 0x99, 0x25, 0x09,
+    0x1f, 0xaf, 0x1b, 0xad, 0xf7, 0xf6, 0x1a, 0xb3, 0x56, 0x14, 0x9c, 0xa5, 0xcc, 0x0f, 0x5d, 0xfa,
+    0xa2, 0x37, 0xb2, 0x42, 0x65, 0xb8, 0xf0, 0x8a, 0x48, 0x4f, 0xc0, 0x17, 0x66, 0x5b, 0x78, 0xdd,
+    0x90, 0x8d, 0x8a, 0xf0, 0xc2, 0x97, 0x9a, 0x8c, 0x53, 0x2f, 0xd6, 0x1e, 0x25, 0x50, 0xe4, 0xdc,
+    0x21, 0x63, 0x51, 0x22, 0x80, 0x68, 0x13, 0x26, 0x5c, 0x61, 0xcd, 0x24, 0x6c, 0x64, 0x12, 0x6e,
+    0x83, 0xad, 0xc5, 0x81, 0xcb, 0x1c, 0xf2, 0x4e, 0xb7, 0xdb, 0x2d, 0xc9, 0x5a, 0x68, 0x22, 0x2f,
+    0xa2, 0xa1, 0x31, 0xec, 0x14, 0xf5, 0xcf, 0xfc, 0x61, 0x90, 0xb7, 0xf7, 0x4e, 0x66, 0xef, 0xbb,
+    0xbb, 0xbb, 0x57, 0x07, 0x01, 0xa4, 0x54, 0x46, 0x80, 0xd8, 0x1e, 0x53, 0x27, 0x71, 0xa9, 0xe0,
+    0x6c, 0x23, 0x8e, 0xf7, 0xb2, 0xe0, 0x03, 0x3f, 0x89, 0x51, 0x62, 0x6c, 0x91, 0xe0, 0x05, 0x0b,
+    0x2a, 0x9d, 0x2a, 0xc5, 0xf4, 0x84, 0x4f, 0x42, 0x88, 0xe3, 0x9c, 0x79, 0xb4, 0xfa, 0xe1, 0x54,
+    0xe3, 0xdc, 0x7b, 0x43, 0x59, 0x15, 0xe3, 0xaa, 0xf4, 0x95, 0x2b, 0xcf, 0xf4, 0x13, 0x6f, 0x40,
+    0x23, 0x38, 0x55, 0xfa, 0xc3, 0x6e, 0x3e, 0xdc, 0x5d, 0x1b, 0x01, 0xae, 0x35, 0xa0, 0xee, 0x15,
+    0xba, 0x93, 0xb1, 0xea, 0x8c, 0x71, 0x7b, 0x3c, 0x0d, 0x83, 0x18, 0x52, 0x56, 0xe0, 0x9b, 0x11,
+    0x75, 0x2d, 0xb4, 0xf0, 0x9e, 0xce, 0x02, 0x00, 0x3f, 0x96, 0x6e, 0xd7, 0xd9, 0x15, 0x42, 0x15,
+    0x1b, 0x94, 0xd1, 0x05, 0xa1, 0x65, 0x33, 0x3e, 0x81, 0xd4, 0x24, 0xc1, 0x0d, 0x0d, 0x6b, 0x00,
+    0x20, 0xf0, 0x00, 0x19, 0x25, 0xc5, 0x6c, 0x0d, 0x80, 0xad, 0x84, 0xd3, 0xb2, 0xe7, 0xa2, 0x95,
+    0x18, 0x3d, 0x97, 0x0e, 0x61, 0x57, 0x2f, 0x92, 0xbb, 0x7b, 0x2a, 0x74, 0x1b, 0x05, 0x6e, 0x17,
+    0xe5, 0x81, 0x24, 0xf5, 0x84, 0x2f, 0xca, 0x33, 0x8c, 0x56, 0x37, 0xd6, 0x27, 0x9b, 0x03, 0x0a,
+    0x0e, 0x4a, 0x97, 0x11, 0x20, 0x73, 0xb7, 0x59, 0xad, 0xa6, 0xac, 0x21, 0x9b, 0x92, 0x05, 0xf1,
+    0x53, 0x50, 0xd3, 0x15, 0x4a, 0x11, 0x74, 0x74, 0x4b, 0x72, 0x07, 0x49, 0x97, 0x35, 0x03, 0xd1,
+    0xad, 0x4c, 0x88, 0x90, 0x91, 0x09, 0xfa, 0xb0, 0x9f, 0x51, 0x67, 0x4b, 0x0b, 0x64, 0x31, 0x82,
+    0x2f, 0x07, 0xd4, 0xf4, 0x67, 0xa1, 0x46, 0xfc, 0x02, 0xf5, 0xd0, 0x3f, 0xad, 0x77, 0x20, 0xcd,
+    0x35, 0x64, 0xe4, 0x8a, 0x3d, 0xcb, 0x75, 0xf3, 0xa6, 0x2c, 0xf3, 0x4a, 0x31, 0x25, 0xce, 0xf6,
+    0x77, 0x64, 0x8d, 0x51, 0xd9, 0xdf, 0x51, 0xd5, 0x0e, 0x96, 0x10, 0xf0, 0xc7, 0x61, 0xcf, 0x89,
+    0xed, 0x5a, 0x71, 0x7c, 0x50, 0x4d, 0xcb, 0x00, 0x2c, 0x57, 0xc6, 0xed, 0xc3, 0xaf, 0x3f, 0xff,
+    0xab, 0xdf, 0x90, 0x62, 0xc1, 0x02, 0xab, 0xc5, 0x2d, 0x10, 0xd0, 0x04, 0x74, 0xe7, 0xf0, 0xab,
+    0x1f, 0xcf, 0x2f, 0x7e, 0x4a, 0xe6, 0xe7, 0xff, 0xee, 0x91, 0xaf, 0x3e, 0x9b, 0x9f, 0xff, 0x82,
+    0x03, 0x74, 0x07, 0x6b, 0x9b, 0xd0, 0xf2, 0x35, 0xb8, 0xc8, 0xb5, 0x55, 0xc2, 0x9c, 0x83, 0xaa,
+    0x17, 0xb0, 0x98, 0x27, 0x11, 0xad, 0x1e, 0x36, 0x9b, 0x40, 0x1c, 0x00, 0x1d, 0x16, 0x40, 0x31,
+    0xc9, 0x56, 0x0f, 0xdf, 0x55, 0xaf, 0x80, 0x6c, 0x38, 0xb5, 0x78, 0x36, 0x44, 0xd4, 0xea, 0x95,
+    0xd4, 0x3c, 0xb8, 0x7c, 0x39, 0x21, 0x83, 0x57, 0x2f, 0xbd, 0x25, 0x54, 0xc8, 0x7c, 0x46, 0x20,
+    0x49, 0x4a, 0x52, 0x30, 0x4d, 0x9c, 0x8a, 0xb5, 0xea, 0xe1, 0xc9, 0xf1, 0x71, 0x7a, 0x24, 0x62,
+    0xd6, 0xef, 0xef, 0x41, 0x0c, 0xac, 0x12, 0x21, 0xc3, 0x83, 0x6a, 0xc9, 0x9f, 0x48, 0xe6, 0x50,
+    0x3d, 0x92, 0x8b, 0x7d, 0xa8, 0x86, 0xea, 0xa1, 0xa6, 0x7c, 0x90, 0x80, 0x29, 0xa5, 0x34, 0x80,
+    0xe6, 0x88, 0x4e, 0x51, 0x55, 0x12, 0xf8, 0xb6, 0xcb, 0xec, 0x67, 0x10, 0x98, 0x82, 0xd1, 0xc8,
+    0xa5, 0x8f, 0x60, 0xb1, 0xde, 0xa8, 0x1e, 0xde, 0x99, 0x9f, 0xff, 0xb2, 0xbf, 0xd3, 0x9f, 0x9f,
+    0xff, 0x47, 0x9f, 0xdc, 0x79, 0xf5, 0xf3, 0x07, 0xfb, 0x3b, 0x12, 0xc9, 0x52, 0x71, 0xe4, 0x98,
+    0x3f, 0x1a, 0xcf, 0xcf, 0xff, 0x1b, 0xb5, 0x70, 0xf1, 0xd3, 0xab, 0xd9, 0x97, 0xe9, 0x5c, 0x2b,
+    0xc3, 0xa1, 0x5a, 0x02, 0x0f, 0x6e, 0x3f, 0x7c, 0x7c, 0xfb, 0x7e, 0x2a, 0x84, 0xe5, 0x64, 0xe3,
+    0x86, 0x05, 0xb2, 0x1f, 0xc0, 0x22, 0x92, 0x8d, 0x96, 0xf0, 0x77, 0xf7, 0xc8, 0xd1, 0x77, 0xe7,
+    0xe7, 0xbf, 0x27, 0xf8, 0xf0, 0x4f, 0x8b, 0x84, 0xaf, 0xa4, 0xff, 0xeb, 0xcf, 0xff, 0xe6, 0x9f,
+    0xff, 0xf7, 0xbf, 0x3e, 0x25, 0xfd, 0xf9, 0xc5, 0x67, 0xb6, 0xe4, 0x23, 0xaf, 0x4b, 0xdc, 0xa4,
+    0x34, 0x51, 0x48, 0x25, 0x64, 0x49, 0x2e, 0x21, 0x3a, 0x03, 0x6b, 0xcd, 0x88, 0x04, 0x02, 0xf9,
+    0x04, 0x8f, 0x12, 0x7e, 0x47, 0x64, 0x78, 0x06, 0xdf, 0x1a, 0xd1, 0x9c, 0x3d, 0x84, 0x94, 0x3a,
+    0x55, 0xe2, 0x31, 0xff, 0xa0, 0xda, 0x35, 0xe0, 0x87, 0xf5, 0xe2, 0xa0, 0x0a, 0x35, 0x4c, 0x95,
+    0x08, 0x1b, 0x96, 0xbf, 0x2b, 0xda, 0x1e, 0x64, 0xee, 0x25, 0x2a, 0x9a, 0x60, 0x34, 0x47, 0xe1,
+    0x08, 0xf4, 0x60, 0xc9, 0xa1, 0x03, 0x3e, 0x2b, 0x10, 0xde, 0xc7, 0x70, 0x5c, 0xe7, 0x63, 0x16,
+    0xcb, 0xb2, 0xb3, 0x51, 0xd5, 0xba, 0xc1, 0x73, 0xe3, 0x14, 0x24, 0xb5, 0x34, 0x38, 0xbf, 0x99,
+    0x8b, 0xc4, 0x64, 0xa1, 0x0c, 0xaa, 0x1e, 0x62, 0x61, 0x55, 0xf6, 0x92, 0x8d, 0x94, 0x06, 0x5d,
+    0x8e, 0x20, 0x0a, 0x55, 0xf6, 0xf5, 0xe7, 0x3f, 0xf9, 0x3d, 0xb9, 0xfc, 0x8b, 0x90, 0x38, 0xf3,
+    0x8b, 0x5f, 0xf8, 0x23, 0xc2, 0x33, 0xc9, 0x6f, 0x6c, 0x74, 0x97, 0x3f, 0x67, 0xc2, 0xf3, 0x7f,
+    0xc7, 0x89, 0x3f, 0x7a, 0xf5, 0xe5, 0xfc, 0xe2, 0xa5, 0x3f, 0xca, 0x69, 0x2c, 0x0b, 0x32, 0x50,
+    0xb4, 0xe0, 0x1e, 0x91, 0x9b, 0x0e, 0x3f, 0x18, 0x5f, 0xfe, 0xd6, 0xdc, 0xdf, 0x91, 0x0f, 0x45,
+    0x95, 0xa8, 0x8c, 0x29, 0x64, 0xe3, 0x44, 0x93, 0xfe, 0x38, 0xa2, 0xf1, 0x18, 0x98, 0x56, 0x6a,
+    0x59, 0xa6, 0x95, 0xae, 0x91, 0x61, 0x7e, 0xf5, 0xeb, 0xf9, 0xc5, 0xcf, 0xf8, 0x06, 0xb8, 0xcf,
+    0x28, 0xdf, 0x04, 0xf7, 0x2d, 0x81, 0x7b, 0x41, 0xb4, 0xa9, 0xae, 0xa4, 0x9e, 0xb0, 0xa0, 0xee,
+    0x91, 0x7c, 0xb5, 0x42, 0x44, 0x4a, 0xc9, 0x0b, 0xde, 0x7a, 0x4e, 0x8f, 0x84, 0x18, 0x50, 0xf4,
+    0xf7, 0x5f, 0x7d, 0x99, 0xbc, 0xa6, 0x7f, 0xfc, 0xcf, 0xa7, 0x5f, 0x92, 0xfb, 0xf3, 0x8b, 0x1f,
+    0x41, 0x1e, 0xe6, 0x28, 0xe8, 0x9f, 0x31, 0x54, 0xd8, 0x6f, 0xa4, 0xbe, 0x0a, 0x42, 0xdf, 0xd8,
+    0x4d, 0x3e, 0x4a, 0x62, 0xce, 0x86, 0x93, 0xa6, 0xce, 0x8d, 0x60, 0x4f, 0xd0, 0xcf, 0x0e, 0x28,
+    0x3f, 0xa3, 0xd4, 0x4f, 0xa3, 0x5a, 0xbe, 0xa3, 0xd2, 0xa6, 0x8b, 0x51, 0xea, 0x57, 0x9c, 0xb8,
+    0x05, 0x7a, 0x52, 0x83, 0x14, 0xb2, 0x4f, 0x23, 0x8f, 0xa8, 0x1d, 0xca, 0x9e, 0x27, 0xf2, 0x1e,
+    0xf4, 0xb9, 0x52, 0x19, 0xba, 0x7e, 0xb9, 0xeb, 0x5b, 0x03, 0x17, 0x5d, 0x10, 0xc4, 0x36, 0x46,
+    0xdf, 0xd4, 0x51, 0xe6, 0x54, 0x01, 0xd4, 0x33, 0xe7, 0xd1, 0xe8, 0x45, 0xde, 0xc4, 0x88, 0xab,
+    0xbd, 0x41, 0x6b, 0x3e, 0x27, 0xcd, 0xfc, 0x19, 0xf7, 0x21, 0x05, 0x95, 0x52, 0x48, 0xa1, 0x7c,
+    0xca, 0x6c, 0x49, 0x49, 0xbb, 0x7d, 0x85, 0x35, 0x89, 0x7a, 0x32, 0x43, 0x6d, 0x3c, 0x95, 0x0b,
+    0xca, 0x70, 0x8c, 0x5d, 0xd3, 0x30, 0xaa, 0x2b, 0x0c, 0x50, 0x6d, 0x72, 0x92, 0x48, 0x99, 0x5f,
+    0x5b, 0xdb, 0x5f, 0xb7, 0x68, 0xdb, 0x04, 0xb4, 0x68, 0x53, 0xb4, 0x53, 0x1a, 0x1d, 0x54, 0x47,
+    0xec, 0xf2, 0x5f, 0x27, 0x19, 0x8d, 0xe2, 0x31, 0xa3, 0xef, 0xcd, 0x24, 0x6f, 0x3c, 0xa5, 0xfe,
+    0x1b, 0xc9, 0x75, 0x23, 0xf9, 0x75, 0x36, 0x93, 0x5f, 0xbb, 0x28, 0xbf, 0xf6, 0xde, 0x26, 0xf2,
+    0x6b, 0x7f, 0x2b, 0xe4, 0xd7, 0xbe, 0x56, 0xf9, 0x75, 0x37, 0x93, 0x5f, 0xa7, 0x24, 0xbf, 0xce,
+    0x26, 0xf2, 0xeb, 0x7c, 0x2b, 0xe4, 0xd7, 0xb9, 0x56, 0xf9, 0xdd, 0xdc, 0x4c, 0x7e, 0xdd, 0x92,
+    0xff, 0x1a, 0x9b, 0xc8, 0xaf, 0xfb, 0xad, 0x90, 0x5f, 0xf7, 0x4d, 0xe4, 0xf7, 0x5a, 0x55, 0x03,
+    0x24, 0xaf, 0x7c, 0x08, 0x16, 0x95, 0x03, 0xe6, 0xb0, 0x85, 0x0c, 0x90, 0xa6, 0xb4, 0x72, 0xd8,
+    0x7d, 0x93, 0x5a, 0x5a, 0xa4, 0x1c, 0xb2, 0x38, 0x6a, 0xc8, 0xea, 0xeb, 0x35, 0x15, 0xe5, 0xdf,
+    0xff, 0x44, 0x94, 0xa2, 0x7f, 0x0b, 0xc5, 0xcd, 0x18, 0xfe, 0x64, 0x39, 0xf2, 0x30, 0x2b, 0xc0,
+    0x6c, 0x9c, 0x57, 0xdd, 0x0f, 0x6c, 0x28, 0x8b, 0x73, 0x5d, 0x49, 0x0e, 0xf1, 0x9b, 0xd4, 0xff,
+    0x95, 0x87, 0xa3, 0x04, 0xcf, 0x35, 0x49, 0xe9, 0xa0, 0xd3, 0x20, 0x89, 0xec, 0x7c, 0xff, 0x43,
+    0x3e, 0x21, 0xa7, 0x16, 0x23, 0x31, 0xd4, 0x5e, 0x0b, 0xc0, 0xb7, 0x6d, 0x68, 0x9b, 0x2d, 0x7b,
+    0x92, 0x03, 0xaf, 0xbc, 0x1e, 0x65, 0x50, 0xd9, 0x8b, 0xda, 0x8c, 0x47, 0xf3, 0x8b, 0x7f, 0x61,
+    0x8b, 0xd4, 0x24, 0xfe, 0x12, 0xa6, 0xaf, 0x36, 0x09, 0x92, 0xf6, 0x9e, 0xc5, 0x92, 0xf2, 0x08,
+    0x91, 0x1d, 0x47, 0x81, 0x77, 0x07, 0xfa, 0xb3, 0x98, 0x46, 0xaa, 0x21, 0xc0, 0x93, 0x47, 0x0c,
+    0x4e, 0x26, 0x7c, 0x4c, 0x03, 0x20, 0xe2, 0xf2, 0x97, 0xfe, 0x98, 0x38, 0xc9, 0x64, 0x7e, 0xf1,
+    0x97, 0x7c, 0x65, 0x89, 0x89, 0xd3, 0x27, 0x90, 0xe2, 0xe3, 0x10, 0x7d, 0x32, 0x4f, 0x76, 0x22,
+    0x56, 0x72, 0x44, 0xc7, 0x20, 0xc0, 0x7b, 0x8f, 0xf2, 0x20, 0x2c, 0xcc, 0xf3, 0x34, 0x88, 0x0e,
+    0x2b, 0x3f, 0x60, 0xc7, 0x05, 0xde, 0xcf, 0xd8, 0x90, 0x15, 0x55, 0xf0, 0xe0, 0x7b, 0xfd, 0x7e,
+    0x1e, 0xc2, 0xfb, 0x98, 0xf3, 0x22, 0xc4, 0xd1, 0xfc, 0xfc, 0x0b, 0x8f, 0x0c, 0x18, 0x34, 0x59,
+    0x05, 0xad, 0xc6, 0xd4, 0x8f, 0x83, 0x28, 0x5e, 0xa6, 0x22, 0xf5, 0x27, 0xb6, 0x23, 0x16, 0xf2,
+    0xc3, 0x0a, 0x54, 0x59, 0x31, 0x27, 0xd8, 0x88, 0x51, 0x72, 0x40, 0xa6, 0xb3, 0x5e, 0xc5, 0xa5,
+    0x9c, 0x48, 0x86, 0xee, 0x58, 0x31, 0x2e, 0x1a, 0xdb, 0xea, 0xf9, 0x36, 0xc7, 0x27, 0x09, 0x11,
+    0x06, 0xae, 0xdb, 0x87, 0xb5, 0x08, 0x96, 0xfc, 0xc4, 0x75, 0xe5, 0xaa, 0xc0, 0xf3, 0x27, 0x34,
+    0x8a, 0x19, 0xa8, 0x4a, 0xbd, 0x20, 0xea, 0xbf, 0x9d, 0x1d, 0x72, 0xb7, 0x6f, 0x8d, 0xa0, 0xd9,
+    0x25, 0x20, 0x4e, 0x4e, 0x76, 0xac, 0x90, 0xed, 0x88, 0x0d, 0xdb, 0x04, 0xe8, 0xe5, 0xc4, 0x8a,
+    0xc9, 0xbd, 0x61, 0xf3, 0x61, 0xe0, 0xd3, 0xe6, 0x03, 0x0b, 0x62, 0x8c, 0xc0, 0x88, 0xa0, 0xda,
+    0xc9, 0x15, 0xc6, 0x6d, 0xb9, 0x88, 0x0d, 0x43, 0xf1, 0xf0, 0xb4, 0x5e, 0xe3, 0x11, 0xa3, 0x31,
+    0xbc, 0x7b, 0xf2, 0x61, 0x2f, 0x3b, 0xfc, 0x18, 0x00, 0x89, 0x0b, 0x75, 0x16, 0x19, 0x82, 0x4d,
+    0xe4, 0x8e, 0x27, 0x75, 0xcf, 0x9a, 0x10, 0xfa, 0xc2, 0x46, 0x84, 0x60, 0x13, 0xe4, 0x26, 0x41,
+    0x83, 0x69, 0x54, 0x86, 0x89, 0x6f, 0xe3, 0x0c, 0x85, 0x58, 0x61, 0xe8, 0x4e, 0x64, 0x57, 0x5a,
+    0x77, 0x1a, 0x64, 0x5a, 0x39, 0x19, 0x7c, 0x44, 0x6d, 0xde, 0x02, 0xab, 0x80, 0x00, 0x50, 0x57,
+    0x4c, 0x38, 0x8d, 0x5e, 0xc5, 0x09, 0xec, 0xc4, 0x03, 0x66, 0x5a, 0x23, 0xca, 0xef, 0xba, 0x14,
+    0x7f, 0xde, 0x99, 0xdc, 0x73, 0xea, 0x35, 0x3d, 0x64, 0xa8, 0x35, 0x5a, 0x18, 0x3a, 0x8e, 0x64,
+    0x71, 0x0b, 0x34, 0x8a, 0xcd, 0x2d, 0xfd, 0xba, 0xa7, 0x14, 0x12, 0x22, 0xf9, 0x57, 0x22, 0xcb,
+    0xc6, 0x04, 0x35, 0x38, 0x33, 0x8c, 0x97, 0xa2, 0x44, 0x20, 0xf2, 0x1d, 0x52, 0x3b, 0x79, 0x58,
+    0x23, 0x26, 0xfc, 0x39, 0x3e, 0xae, 0x09, 0x58, 0x61, 0xcc, 0x0f, 0x2d, 0x0f, 0xc5, 0x59, 0x53,
+    0x1d, 0x78, 0x8d, 0x6c, 0x91, 0x7a, 0x71, 0x5b, 0xe0, 0x8b, 0x6d, 0xc1, 0x70, 0x88, 0x67, 0x48,
+    0xaa, 0xd0, 0x01, 0xca, 0xf8, 0x7f, 0xf8, 0x07, 0x53, 0xf9, 0x1c, 0x51, 0x2b, 0x0e, 0xfc, 0x19,
+    0x69, 0x92, 0x74, 0x25, 0xf1, 0xd1, 0x6c, 0x66, 0xf1, 0x0f, 0x11, 0x53, 0x6d, 0x85, 0x74, 0xf4,
+    0x5c, 0x63, 0x41, 0x3a, 0x78, 0xa2, 0x3e, 0xdd, 0x5b, 0x29, 0x93, 0x6c, 0x70, 0x80, 0xf4, 0x7a,
+    0xcb, 0x65, 0x82, 0x2d, 0x11, 0xce, 0x06, 0x90, 0xc1, 0xdb, 0x8f, 0xfb, 0x27, 0x82, 0x45, 0x39,
+    0x66, 0xa8, 0x89, 0x4d, 0x6b, 0x84, 0x93, 0xdf, 0x8f, 0xbf, 0xc5, 0x7e, 0x39, 0xbe, 0xc8, 0xa4,
+    0x04, 0x0d, 0xe2, 0x3d, 0x91, 0x1a, 0x57, 0x50, 0x9b, 0x6f, 0x22, 0xb3, 0x9d, 0xd0, 0xfe, 0xad,
+    0xdd, 0x99, 0x6f, 0x11, 0x71, 0x27, 0x1b, 0x92, 0x7a, 0x0a, 0x2c, 0xef, 0x04, 0x14, 0x3c, 0xb9,
+    0x71, 0x70, 0x90, 0x12, 0x83, 0x56, 0xab, 0x7f, 0xcb, 0x8e, 0x3f, 0x15, 0x0a, 0xd7, 0xe8, 0xde,
+    0x8f, 0x26, 0xbd, 0xca, 0x6c, 0x1d, 0x46, 0x4d, 0x24, 0x62, 0xd4, 0xbf, 0xaf, 0xc2, 0xf8, 0x03,
+    0xca, 0x53, 0x8c, 0x2d, 0x19, 0x44, 0x04, 0x8e, 0xc4, 0x77, 0xe8, 0x90, 0xf9, 0x54, 0x38, 0x53,
+    0x21, 0xd8, 0x68, 0xb0, 0x5e, 0x25, 0x17, 0x73, 0xde, 0x47, 0xa4, 0x7e, 0x70, 0x56, 0x6f, 0x64,
+    0xd8, 0x58, 0xb8, 0x88, 0xe9, 0x4a, 0xa1, 0xb1, 0x70, 0xc1, 0xb2, 0x10, 0x03, 0x62, 0x93, 0x33,
+    0x11, 0x19, 0xd3, 0x25, 0xfe, 0xd4, 0xed, 0x8b, 0xaf, 0x00, 0x3f, 0x9e, 0xac, 0xc9, 0xc2, 0x67,
+    0xa9, 0xb5, 0x24, 0x04, 0x74, 0x39, 0x26, 0xb6, 0x08, 0x84, 0xaf, 0x71, 0x6b, 0xe8, 0x06, 0x41,
+    0x54, 0xaf, 0x67, 0xb4, 0x83, 0x67, 0x64, 0x9b, 0x77, 0x08, 0x34, 0xf4, 0xc6, 0xaa, 0x88, 0x21,
+    0x61, 0x17, 0xe8, 0x4e, 0x04, 0xd5, 0x39, 0x2a, 0x87, 0x14, 0x62, 0x25, 0x5a, 0xbe, 0xa4, 0x51,
+    0xd2, 0x84, 0x93, 0x55, 0x08, 0xc3, 0x5a, 0x23, 0x3a, 0x24, 0x7f, 0x87, 0x4c, 0x6b, 0x85, 0x18,
+    0x5b, 0x33, 0x0b, 0x00, 0x33, 0xb0, 0x67, 0xcc, 0x01, 0x02, 0x67, 0xbd, 0x96, 0xc5, 0xc8, 0xda,
+    0x36, 0x99, 0x2a, 0x9c, 0xa6, 0x46, 0xbe, 0x4d, 0x6c, 0x0b, 0x42, 0x2e, 0x78, 0x80, 0x1f, 0x34,
+    0x63, 0x1e, 0x40, 0x70, 0x9b, 0x35, 0x2a, 0xa0, 0x7c, 0xea, 0xd7, 0x21, 0x2d, 0x1c, 0x2a, 0x81,
+    0x45, 0xea, 0xd6, 0x8e, 0x1c, 0x80, 0xba, 0xba, 0xc6, 0x4d, 0x24, 0x32, 0xa2, 0x10, 0xec, 0x7c,
+    0x15, 0xbb, 0x67, 0x95, 0x52, 0xda, 0x88, 0x5a, 0xea, 0x04, 0x94, 0x49, 0xbd, 0x86, 0x59, 0x03,
+    0x2d, 0x5d, 0x6d, 0x8a, 0x5a, 0x1f, 0x41, 0x9c, 0x11, 0xaa, 0xd2, 0xa7, 0x39, 0xd9, 0x69, 0xc2,
+    0x0e, 0xd2, 0x78, 0x4d, 0xeb, 0x8e, 0x50, 0x29, 0x42, 0xda, 0xc8, 0x6f, 0x9d, 0x4a, 0x50, 0x94,
+    0x52, 0xe0, 0xd2, 0x16, 0x8d, 0x22, 0x50, 0x52, 0x2d, 0x93, 0x21, 0x11, 0x2b, 0x26, 0xf0, 0x4b,
+    0xc5, 0x09, 0x05, 0x83, 0x28, 0xe0, 0xcd, 0x9f, 0x23, 0xf2, 0x42, 0xef, 0x35, 0xed, 0x0f, 0x13,
+    0xbe, 0x30, 0x42, 0x69, 0xd0, 0x62, 0xe6, 0x26, 0x6c, 0x3a, 0x4d, 0x6f, 0x78, 0x46, 0x3e, 0xd7,
+    0x29, 0xa0, 0x35, 0x81, 0x54, 0x40, 0xc3, 0x79, 0xda, 0x27, 0xd7, 0xef, 0xca, 0xc6, 0x7d, 0x4b,
+    0xc8, 0x94, 0x74, 0x6d, 0x91, 0xda, 0xbb, 0x35, 0x14, 0x86, 0xe4, 0x59, 0x97, 0xdd, 0x4e, 0x7a,
+    0xcb, 0xb3, 0x8a, 0x7d, 0xe4, 0xf4, 0x2a, 0x01, 0xc8, 0x14, 0x0c, 0xe8, 0x49, 0x1d, 0x03, 0xad,
+    0x5a, 0x8d, 0x20, 0xb3, 0x8a, 0x45, 0xe7, 0x8e, 0xd7, 0x58, 0x95, 0x39, 0xb0, 0x26, 0x5a, 0x82,
+    0x1a, 0x97, 0x35, 0xea, 0x4a, 0x5d, 0x3d, 0x7f, 0x9c, 0xd0, 0x04, 0x58, 0x81, 0xd8, 0x0d, 0xa6,
+    0x3b, 0xc6, 0x0a, 0x50, 0x9e, 0x98, 0x7f, 0x89, 0x89, 0x6a, 0x15, 0x2b, 0xaa, 0xb2, 0x2a, 0x1f,
+    0x59, 0x01, 0x41, 0xc8, 0x37, 0x2d, 0xcf, 0x0a, 0xeb, 0x31, 0x5a, 0x99, 0x98, 0xac, 0x32, 0x71,
+    0xde, 0xc9, 0x07, 0x22, 0x53, 0x40, 0xef, 0xf7, 0x0f, 0xf7, 0x60, 0xeb, 0x47, 0x01, 0xf3, 0x81,
+    0xdb, 0x1d, 0x52, 0x5b, 0x66, 0x5f, 0x5a, 0xb6, 0xf1, 0xca, 0x90, 0x56, 0x9a, 0x4e, 0x01, 0x56,
+    0x75, 0x6b, 0x83, 0x3e, 0xdf, 0xa2, 0x72, 0xb5, 0xa7, 0xc2, 0xdb, 0x69, 0xae, 0xdf, 0x01, 0xbc,
+    0x3a, 0xdf, 0x3c, 0xa3, 0x13, 0x80, 0xfe, 0xe3, 0xd3, 0x93, 0x87, 0x20, 0xab, 0x88, 0xf9, 0x23,
+    0x36, 0x9c, 0xd4, 0x71, 0xb3, 0x28, 0xa0, 0x54, 0x72, 0xb9, 0x91, 0x2e, 0x90, 0x4f, 0x3e, 0x91,
+    0x5b, 0xb4, 0x8d, 0x6a, 0xd5, 0xa7, 0x1e, 0x8d, 0xdc, 0x94, 0x2a, 0x36, 0xd8, 0xd0, 0xab, 0x2c,
+    0x96, 0x66, 0x29, 0x52, 0x08, 0x36, 0x41, 0x44, 0xea, 0x58, 0xc0, 0x31, 0x51, 0x5e, 0xc2, 0x9f,
+    0x7d, 0x72, 0x13, 0xfe, 0x6c, 0x6d, 0x65, 0xf1, 0x8c, 0xe6, 0xb7, 0x3c, 0x61, 0x1f, 0x22, 0x29,
+    0xd3, 0x31, 0xb4, 0x2d, 0x26, 0x96, 0xa7, 0xd0, 0xe9, 0x26, 0x9c, 0x8a, 0x9f, 0xd0, 0xf9, 0x5a,
+    0xe2, 0xde, 0x0b, 0x42, 0x0d, 0xf8, 0xb0, 0x14, 0x83, 0x49, 0x86, 0x96, 0x1b, 0xd3, 0x99, 0xe6,
+    0x7b, 0x0c, 0xd8, 0x4e, 0x05, 0xc3, 0x75, 0xda, 0x42, 0x2c, 0x8d, 0x56, 0x68, 0x39, 0xe0, 0xc8,
+    0x11, 0xaf, 0x77, 0xb6, 0x6b, 0x46, 0x96, 0x91, 0xbd, 0x3c, 0xa4, 0x3c, 0x66, 0x09, 0xec, 0x6a,
+    0x25, 0xd5, 0xb6, 0xd8, 0x56, 0xed, 0xa9, 0x0a, 0xe6, 0xda, 0x29, 0xc7, 0x5b, 0x35, 0xb3, 0xb6,
+    0xe5, 0x6d, 0xb6, 0x17, 0x98, 0xca, 0x6d, 0xa5, 0x2d, 0xcd, 0xe4, 0x66, 0xbb, 0xa9, 0x5f, 0x30,
+    0x0e, 0x9a, 0x19, 0x47, 0x21, 0x8f, 0xc4, 0xc8, 0xd2, 0x23, 0x28, 0xeb, 0x91, 0x59, 0x9d, 0xed,
+    0x6e, 0xa4, 0x75, 0x3e, 0xae, 0xe4, 0x53, 0x0d, 0xd4, 0x92, 0xb9, 0x16, 0x20, 0xc6, 0x42, 0x00,
+    0xba, 0x60, 0xa0, 0xb1, 0x9e, 0x41, 0x6d, 0xeb, 0x24, 0x57, 0x3a, 0x28, 0x08, 0xcb, 0xe7, 0x14,
+    0x8e, 0xb1, 0x5d, 0x6a, 0x45, 0x29, 0xba, 0xec, 0x55, 0xf1, 0x48, 0x9d, 0x3c, 0xca, 0x2c, 0xdc,
+    0x7d, 0x0e, 0x42, 0x88, 0x33, 0x0e, 0xce, 0x98, 0xef, 0x04, 0x67, 0x2d, 0xb1, 0x2c, 0x1b, 0x5d,
+    0x7c, 0x55, 0xe4, 0xb6, 0x97, 0xb3, 0x5f, 0x65, 0x70, 0x68, 0xa4, 0x3e, 0x3d, 0x23, 0xb9, 0x7d,
+    0x2a, 0x21, 0x52, 0x71, 0x00, 0xea, 0x9d, 0xe2, 0x87, 0x30, 0x41, 0x48, 0x31, 0x69, 0xc1, 0x81,
+    0x22, 0xb3, 0x14, 0xb8, 0x03, 0x7c, 0x0a, 0xca, 0xa3, 0x71, 0x6c, 0x8d, 0x84, 0xfa, 0x10, 0x2e,
+    0x9f, 0x39, 0x84, 0xff, 0x85, 0xf8, 0xad, 0x17, 0xd8, 0x18, 0x78, 0xab, 0xd5, 0xd0, 0xa8, 0x45,
+    0x2e, 0x2a, 0xe0, 0x2e, 0x12, 0x3d, 0x2b, 0x44, 0x8f, 0xfc, 0x8d, 0x9d, 0x56, 0x96, 0x22, 0x19,
+    0xd3, 0x02, 0xa6, 0xf0, 0x8a, 0x47, 0xf9, 0x38, 0x00, 0x7f, 0xa8, 0x3d, 0x3a, 0x39, 0xed, 0xd7,
+    0xb6, 0x2b, 0x69, 0x4e, 0x9f, 0xd6, 0x54, 0x2c, 0x6b, 0xf6, 0x27, 0x21, 0x85, 0xb2, 0xa0, 0x86,
+    0x24, 0x32, 0x5b, 0xd8, 0xd9, 0x0e, 0x66, 0xdc, 0xda, 0x6c, 0xbb, 0x82, 0x37, 0xb5, 0x66, 0x39,
+    0x60, 0x4c, 0x2d, 0x5b, 0x7a, 0x5c, 0x4d, 0x52, 0x80, 0x55, 0x40, 0xb9, 0x10, 0xd8, 0x2c, 0x77,
+    0xb7, 0x82, 0x67, 0x99, 0xcb, 0xbf, 0x55, 0x0b, 0xe4, 0xbc, 0x7e, 0xfb, 0xe3, 0x5c, 0xd1, 0xfa,
+    0xcc, 0x08, 0x85, 0xd8, 0x41, 0x24, 0x81, 0x42, 0x23, 0x22, 0xf5, 0xbb, 0x14, 0x02, 0x80, 0x5e,
+    0x10, 0x45, 0x0c, 0x14, 0xe6, 0x60, 0x9a, 0x41, 0xc2, 0x0b, 0x1e, 0x70, 0x4b, 0x3a, 0xc0, 0x9a,
+    0x02, 0x24, 0xd3, 0x5d, 0xb1, 0x00, 0x91, 0xc7, 0x60, 0xe2, 0xf8, 0x47, 0x66, 0x0a, 0x3a, 0x21,
+    0x0c, 0x49, 0x53, 0x5a, 0x2c, 0x4f, 0xf2, 0x77, 0x9f, 0x25, 0x03, 0xc0, 0xee, 0xe8, 0xfa, 0x0c,
+    0x40, 0x1e, 0x6c, 0x12, 0x1e, 0x25, 0xf4, 0x9b, 0x51, 0xfe, 0x5b, 0xf5, 0x7a, 0xce, 0x5b, 0xf4,
+    0x79, 0xce, 0xba, 0x1e, 0xef, 0x1b, 0x51, 0xb4, 0xc0, 0xff, 0xe6, 0x8a, 0xce, 0x5f, 0xdb, 0xa5,
+    0x22, 0x83, 0xee, 0x0e, 0x98, 0x11, 0x71, 0x04, 0x62, 0x67, 0x7d, 0xc3, 0xd6, 0x53, 0xdd, 0xfe,
+    0xe6, 0x3a, 0xd0, 0x8d, 0x90, 0x14, 0xbb, 0xd0, 0x14, 0x89, 0x50, 0x24, 0xd0, 0x71, 0x28, 0xda,
+    0xc4, 0xcc, 0x4f, 0x34, 0x5f, 0x0f, 0xf5, 0x6d, 0x2c, 0x79, 0x36, 0xbe, 0xfc, 0x2d, 0x09, 0xc7,
+    0xf3, 0xf3, 0x2f, 0x18, 0xf1, 0xa1, 0x16, 0xfb, 0x94, 0x8c, 0x5f, 0xbd, 0xf4, 0xb3, 0xeb, 0x5a,
+    0x22, 0x66, 0xb7, 0xfc, 0x46, 0xad, 0x10, 0x9b, 0xf3, 0x26, 0x2d, 0xaf, 0x6f, 0xaf, 0xd1, 0xa8,
+    0x35, 0x7f, 0x4f, 0x81, 0x23, 0x13, 0xc5, 0xbb, 0x4d, 0xb2, 0x35, 0x60, 0xcf, 0x44, 0x1e, 0xdf,
+    0xd6, 0xdc, 0x95, 0x7c, 0xbe, 0xfa, 0xf1, 0xe5, 0x17, 0xc4, 0xc5, 0xd9, 0x75, 0x2a, 0x01, 0x93,
+    0xe0, 0x85, 0xf4, 0x81, 0x28, 0x51, 0x41, 0xa4, 0x58, 0x80, 0x6f, 0x13, 0x79, 0x93, 0x2c, 0x16,
+    0x51, 0x55, 0xa2, 0x2a, 0x6f, 0xf4, 0x4a, 0x89, 0x79, 0x55, 0xc4, 0xca, 0x5b, 0x58, 0x3e, 0x7a,
+    0xad, 0xb3, 0xdb, 0xcc, 0xe4, 0xae, 0xb6, 0x5b, 0x50, 0x2a, 0x13, 0x4c, 0xac, 0x35, 0xe0, 0x85,
+    0x0f, 0x11, 0xc0, 0x80, 0x56, 0x57, 0xbb, 0x57, 0x77, 0x28, 0xb0, 0x35, 0xeb, 0x4e, 0x32, 0x17,
+    0x49, 0x3f, 0x29, 0x48, 0x1d, 0x24, 0x56, 0x5d, 0xd4, 0x7a, 0xeb, 0x5e, 0xe8, 0xa2, 0x1a, 0xa5,
+    0x96, 0x58, 0xbc, 0xbb, 0x36, 0xcb, 0x13, 0xe8, 0x4d, 0x49, 0xef, 0x37, 0x69, 0x5f, 0x97, 0x2f,
+    0x97, 0x7d, 0x55, 0xa1, 0x4c, 0x21, 0xd7, 0xe6, 0x5d, 0x97, 0x09, 0x29, 0x95, 0xbc, 0x7e, 0xe0,
+    0x93, 0xfa, 0x3b, 0xba, 0x7f, 0x72, 0xf4, 0xc1, 0xd3, 0xd3, 0x93, 0xc7, 0xdf, 0x3f, 0xba, 0x7b,
+    0x8a, 0xc3, 0x6a, 0xfc, 0x5e, 0x17, 0xb6, 0xd8, 0xe3, 0x57, 0x5f, 0x5a, 0xc4, 0xbe, 0xfc, 0x4f,
+    0xc0, 0x18, 0x71, 0x1b, 0x56, 0x70, 0xbc, 0xff, 0x6b, 0xf2, 0x71, 0x62, 0x81, 0x45, 0xce, 0x2f,
+    0x3e, 0x67, 0xfa, 0x73, 0x04, 0xe2, 0xce, 0xcf, 0x5f, 0x32, 0x00, 0xf3, 0x79, 0x08, 0x60, 0x0f,
+    0xfb, 0x8f, 0x50, 0x65, 0x5c, 0x3c, 0x7c, 0xb7, 0xdf, 0x7f, 0x44, 0xea, 0x1e, 0x7e, 0xac, 0x85,
+    0xbd, 0xe1, 0xbf, 0x11, 0x1f, 0xb6, 0x30, 0x32, 0x80, 0xff, 0x37, 0x60, 0x07, 0xf6, 0x88, 0x98,
+    0x43, 0xbe, 0xd7, 0xef, 0xe3, 0x93, 0x48, 0x07, 0xf0, 0xac, 0xbe, 0x32, 0xe1, 0xd6, 0xa4, 0x86,
+    0x63, 0x93, 0x42, 0x23, 0x27, 0xee, 0x1f, 0xea, 0x7c, 0xa5, 0x5d, 0x67, 0xf7, 0x3c, 0x0b, 0x76,
+    0x0d, 0xfd, 0xeb, 0xc4, 0xb7, 0x45, 0xbf, 0xca, 0x5b, 0x2e, 0x82, 0x60, 0x22, 0x3a, 0xd2, 0xcc,
+    0xca, 0x3b, 0x8c, 0x55, 0xad, 0x71, 0xee, 0x6a, 0x67, 0x01, 0x79, 0x41, 0x96, 0x4f, 0xe0, 0x28,
+    0x01, 0x26, 0xda, 0x2a, 0xfd, 0xb0, 0x0e, 0xb3, 0xbe, 0x07, 0x5a, 0x68, 0x85, 0x71, 0x68, 0x28,
+    0x5f, 0x3d, 0x88, 0x31, 0x13, 0x60, 0x0f, 0x00, 0x4c, 0xd4, 0x0b, 0xeb, 0x6a, 0xfe, 0xd5, 0xe2,
+    0xc1, 0x31, 0x7b, 0x01, 0x6e, 0xda, 0x6e, 0x88, 0x76, 0x3f, 0xc6, 0x6c, 0x5b, 0x00, 0xc4, 0x55,
+    0x2f, 0x5e, 0xcf, 0x67, 0xe2, 0x2f, 0x21, 0x24, 0x4e, 0xfc, 0x88, 0xc5, 0x22, 0x95, 0x7b, 0xf3,
+    0x8b, 0xbf, 0xb6, 0x85, 0x7d, 0x65, 0xcb, 0x5b, 0x38, 0x09, 0x00, 0x9b, 0xf8, 0x9d, 0x9f, 0xbd,
+    0x00, 0x2b, 0x25, 0x26, 0x6c, 0x75, 0x2d, 0x5e, 0x1c, 0x30, 0x22, 0x12, 0xcc, 0x5a, 0x60, 0x46,
+    0x12, 0xd7, 0x8e, 0xda, 0x0a, 0x6b, 0x1e, 0xf1, 0xc1, 0x02, 0x48, 0x6a, 0x8c, 0xca, 0x2c, 0x9e,
+    0xcf, 0x2f, 0x7e, 0x84, 0x17, 0x4c, 0xbf, 0x2a, 0xc6, 0x26, 0x11, 0x4a, 0xa4, 0x75, 0x94, 0xeb,
+    0x34, 0x59, 0x8a, 0x60, 0x68, 0x59, 0x33, 0x5b, 0xd3, 0xde, 0xbf, 0xd4, 0xf5, 0xb1, 0xd7, 0x6c,
+    0xe4, 0x8d, 0x50, 0x2d, 0x2d, 0x94, 0x27, 0xcb, 0xc6, 0x60, 0x62, 0x47, 0xde, 0x47, 0x1b, 0xe5,
+    0xc0, 0xba, 0x78, 0xb1, 0x96, 0xc6, 0x58, 0x3f, 0x38, 0x2b, 0xcd, 0x6b, 0xf3, 0xdc, 0x89, 0x1e,
+    0xf8, 0xda, 0xc2, 0x26, 0x0d, 0x03, 0x7b, 0x6c, 0xe6, 0x87, 0xaf, 0x48, 0x8d, 0x32, 0x34, 0xf0,
+    0x59, 0x40, 0x8f, 0x0b, 0xef, 0x8a, 0x85, 0x85, 0xb8, 0xba, 0x52, 0xa0, 0x8b, 0xb1, 0x54, 0x69,
+    0x58, 0x38, 0xa1, 0x0e, 0x85, 0xc2, 0x49, 0x35, 0xcb, 0x4a, 0xbf, 0xdf, 0x48, 0x28, 0x5d, 0x0c,
+    0xa4, 0x6b, 0x94, 0xb4, 0x64, 0xea, 0xe3, 0x64, 0x4a, 0x52, 0xd7, 0x38, 0x6b, 0x47, 0x4b, 0xf2,
+    0x46, 0x46, 0xcf, 0x27, 0x7d, 0xf0, 0xad, 0xef, 0x27, 0xbe, 0xe8, 0xab, 0xe1, 0x45, 0x29, 0xa0,
+    0xd4, 0xf4, 0x57, 0x60, 0x78, 0x17, 0x19, 0x8a, 0xab, 0x55, 0xcd, 0x96, 0xda, 0x58, 0x90, 0xc4,
+    0x0d, 0x47, 0x4f, 0x21, 0xd6, 0xe1, 0x53, 0x5f, 0x95, 0x7d, 0xf5, 0x99, 0x05, 0x8e, 0x27, 0x3e,
+    0x40, 0xad, 0xa5, 0x98, 0x96, 0xef, 0xac, 0x95, 0xa6, 0x02, 0xe5, 0x8f, 0xb5, 0xb2, 0xa1, 0x92,
+    0xa4, 0x60, 0x13, 0x51, 0x2c, 0x4c, 0xd9, 0x4a, 0x05, 0x81, 0x02, 0xbb, 0x46, 0xe3, 0xd6, 0x93,
+    0x2c, 0xf5, 0x63, 0x9b, 0xac, 0x6c, 0xba, 0x36, 0xb0, 0xe6, 0x37, 0x9a, 0x2c, 0x3a, 0x2b, 0x27,
+    0x8b, 0xce, 0x06, 0xc6, 0xdb, 0x17, 0x64, 0xa7, 0x97, 0xb5, 0x2b, 0x02, 0x4d, 0xe1, 0xf3, 0x8e,
+    0xac, 0x8a, 0x53, 0x4b, 0x62, 0x88, 0x58, 0x1c, 0x2b, 0x8a, 0xd1, 0xab, 0x38, 0xb3, 0x78, 0x3f,
+    0x3b, 0x9d, 0x29, 0xec, 0x9b, 0x4c, 0x1a, 0xc5, 0x1d, 0xd5, 0x3a, 0x8b, 0x58, 0x1c, 0xe9, 0x41,
+    0xfd, 0xe4, 0x32, 0x70, 0x68, 0x13, 0x1d, 0x26, 0xa5, 0x11, 0x27, 0x95, 0x07, 0x25, 0x6a, 0x0a,
+    0x2f, 0x71, 0x8c, 0x89, 0x5f, 0xd0, 0x80, 0x2d, 0x38, 0x16, 0x73, 0xa1, 0x8a, 0x40, 0x0b, 0x92,
+    0x83, 0xcd, 0xb4, 0x4e, 0xc5, 0x73, 0x9e, 0x18, 0x1f, 0x36, 0xb6, 0x2b, 0x7a, 0xd0, 0x59, 0x7c,
+    0xd5, 0xc6, 0x57, 0xd9, 0xe0, 0x73, 0x7d, 0x7d, 0xbb, 0x7c, 0xb4, 0x08, 0x48, 0x52, 0x2b, 0x7b,
+    0xdd, 0xb9, 0xa2, 0x2e, 0xf0, 0xff, 0x5f, 0x7d, 0x22, 0x95, 0xa4, 0x99, 0x59, 0xc5, 0xdb, 0xc6,
+    0x75, 0x77, 0xf1, 0xfb, 0x21, 0xd1, 0x83, 0x2e, 0xf9, 0x0e, 0xe1, 0x1a, 0xda, 0xae, 0x92, 0xaf,
+    0x9c, 0x82, 0x0b, 0x5c, 0xed, 0x29, 0x1c, 0xba, 0xc2, 0xf2, 0x4c, 0xb6, 0x30, 0x01, 0xed, 0x55,
+    0xf2, 0x63, 0xd9, 0xfc, 0x6d, 0x66, 0x3a, 0x98, 0xbd, 0x6a, 0x6e, 0xdb, 0x35, 0xe4, 0xfb, 0x62,
+    0x2a, 0x5b, 0x80, 0x16, 0x6f, 0xb6, 0xc9, 0xae, 0x82, 0x9e, 0x11, 0xc1, 0x0b, 0xa9, 0xd3, 0xc6,
+    0x62, 0xf9, 0x7f, 0xcf, 0x67, 0x7c, 0x65, 0xef, 0x28, 0x2a, 0x75, 0x0e, 0x15, 0x7a, 0xb0, 0xa4,
+    0x0f, 0xa8, 0xec, 0xef, 0xe8, 0x4f, 0x56, 0xf6, 0x77, 0xd4, 0x3f, 0x18, 0xd9, 0x91, 0xff, 0x68,
+    0xf6, 0xff, 0x00, 0x5b, 0xf9, 0x3f, 0x15, 0x4c, 0x3b, 0x00, 0x00,
+};
+
+#endif // DASHBOARD_HTML_H
@@ -0,0 +1,169 @@
+/**
+ * @file http_date_client.cpp
+ * @brief Implementation of the HTTP Date probe
+ *
+ * LOGIC:
+ * - HTTP/1.1 HEAD with "Connection: close": no body to skip, the server
+ *   closes after the headers
+ * - A Date line already waiting in the socket buffer is read late: that
+ *   moves T4 and the midpoint, but grows the error bound by as much, so
+ *   the bound still holds
+ * - End of headers (empty line) or a closed socket without Date = failed
+ *
+ * RULES: #TIME(12)
+ */
+
+#include "http_date_client.h"
+#include <sys/time.h>
+#include <http_date.h>
+#include <logger.h>
+
+//=============================================================================
+// HTTP DATE CLIENT IMPLEMENTATION
+//=============================================================================
+
+HttpDateClient::HttpDateClient()
+    : _port(80)
+    , _stage(Stage::IDLE)
+    , _startMs(0)
+    , _t1Us(0)
+    , _lineLen(0)
+    , _lastError(nullptr)
+    , _answered(0)
+    , _failed(0) {
+    memset(_host, 0, sizeof(_host));
+    memset(_name, 0, sizeof(_name));
+    _sample.offsetUs = 0;
+    _sample.accuracyMs = 0;
+}
+
+bool HttpDateClient::setHost(const char* host) {
+    uint16_t port;
+    size_t nameLen;
+    if (!host) host = "";
+    if (!httpHostValid(host, TIME_HOST_MAX_LEN, port, nameLen)) return false;
+    
+    if (busy()) {
+        _finish("host changed");
+    }
+    memset(_host, 0, sizeof(_host));
+    strncpy(_host, host, sizeof(_host) - 1);
+    memset(_name, 0, sizeof(_name));
+    strncpy(_name, host, nameLen);
+    _port = port;
+    _connector.clearCache();
+    return true;
+}
+
+bool HttpDateClient::start() {
+    if (busy() || !enabled() || WiFi.status() != WL_CONNECTED) return false;
+    
+    _startMs = millis();
+    _lineLen = 0;
+    if (!_connector.begin(_name, _port)) {
+        _finish("connect failed");
+        return false;
+    }
+    _stage = Stage::CONNECTING;
+    return true;
+}
+
+bool HttpDateClient::update() {
+    if (!busy()) return false;
+    
+    if (millis() - _startMs >= HTTP_DATE_TIMEOUT_MS) {
+        return _finish("timeout");
+    }
+    
+    if (_stage == Stage::CONNECTING) {
+        TcpConnectState tcp = _connector.poll();
+        if (tcp == TcpConnectState::FAILED) {
+            return _finish("connect failed");
+        }
+        if (tcp == TcpConnectState::CONNECTED) {
+            return _sendRequest();
+        }
+        return false;
+    }
+    
+    while (_client.available() > 0) {
+        int c = _client.read();
+        if (c < 0) break;
+        if (c == '\n') {
+            if (_onLine()) return true;
+            _lineLen = 0;
+        } else if (c != '\r' && _lineLen < sizeof(_line) - 1) {
+            _line[_lineLen++] = (char)c;
+        }
+    }
+    
+    if (!_client.connected()) {
+        return _finish("no Date header");
+    }
+    return false;
+}
+
+bool HttpDateClient::_sendRequest() {
+    if (!_connector.claim(_client)) {
+        return _finish("connect failed");
+    }
+    
+    char request[40 + TIME_HOST_MAX_LEN];
+    int len = snprintf(request, sizeof(request),
+                       "HEAD / HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", _host);
+    
+    _t1Us = _nowUs();
+    if (_client.write((const uint8_t*)request, len) != (size_t)len) {
+        return _finish("send failed");
+    }
+    _stage = Stage::READING;
+    return false;
+}
+
+bool HttpDateClient::_onLine() {
+    _line[_lineLen] = '\0';
+    
+    // Empty line: end of headers
+    if (_lineLen == 0) {
+        return _finish("no Date header");
+    }
+    if (strncasecmp(_line, "Date:", 5) != 0) {
+        return false;
+    }
+    
+    int64_t t4 = _nowUs();
+    int64_t epoch;
+    if (!httpDateParse(_line + 5, epoch)) {
+        return _finish("bad Date header");
+    }
+    
+    // Date is truncated to the second: its middle, against our midpoint
+    _sample.offsetUs = epoch * 1000000 + 500000 - (_t1Us + t4) / 2;
+    _sample.accuracyMs = 500 + (uint32_t)((t4 - _t1Us) / 2000) + 1;
+    return _finish(nullptr);
+}
+
+bool HttpDateClient::_finish(const char* error) {
+    if (_stage == Stage::CONNECTING) {
+        _connector.abort();
+    }
+    _client.stop();
+    _stage = Stage::IDLE;
+    _lastError = error;
+    
+    if (error) {
+        _failed++;
+        LOG_DBG(MOD_TIME, "http", "%s: %s", _host, error);
+    } else {
+        _answered++;
+        LOG_DBG(MOD_TIME, "http", "%s: offset %ld ms, +-%lu ms", _host,
+                (long)(_sample.offsetUs / 1000), (unsigned long)_sample.accuracyMs);
+    }
+    return true;
+}
+
+int64_t HttpDateClient::_nowUs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
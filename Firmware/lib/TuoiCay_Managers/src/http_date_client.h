@@ -0,0 +1,136 @@
+/**
+ * @file http_date_client.h
+ * @brief Non-blocking HTTP Date probe of a local host (fallback clock)
+ *
+ * LOGIC:
+ * - Sites that block UDP 123 still have a router, NAS or gateway that
+ *   answers HTTP: the Date header of its reply gives the time
+ * - HEAD / over TcpConnector (no blocking connect); update() reads the
+ *   reply line by line, the first "Date:" line ends the probe
+ * - T1 = request written, T4 = Date line read; the server stamped the
+ *   reply in between, truncated to the second, so
+ *     time at (T1 + T4) / 2 = Date + 0.5 s, error <= 0.5 s + (T4 - T1) / 2
+ * - Host is "name-or-ip" or "name-or-ip:port" (port 80 by default)
+ * - The client only measures: TimeManager decides whether to use it
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef HTTP_DATE_CLIENT_H
+#define HTTP_DATE_CLIENT_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <config.h>
+#include "tcp_connector.h"
+
+#define HTTP_DATE_TIMEOUT_MS    3000    // Connect + reply
+#define HTTP_DATE_LINE_MAX      64      // Longer header lines are cut (not Date)
+
+/**
+ * @brief One usable answer
+ */
+struct HttpDateSample {
+    int64_t offsetUs;           // Server clock - our clock
+    uint32_t accuracyMs;
+};
+
+//=============================================================================
+// HTTP DATE CLIENT CLASS
+//=============================================================================
+
+/**
+ * @class HttpDateClient
+ * @brief Reads the time from the Date header of a local HTTP server
+ */
+class HttpDateClient {
+public:
+    HttpDateClient();
+    
+    /**
+     * @brief Host to ask ("" = none); a probe in flight is aborted
+     * @return false if too long or the port is not a number
+     */
+    bool setHost(const char* host);
+    
+    const char* getHost() const { return _host; }
+    
+    bool enabled() const { return _host[0] != '\0'; }
+    
+    /**
+     * @brief Start a probe (needs WiFi and a host)
+     * @return false if one is running or it could not start
+     */
+    bool start();
+    
+    bool busy() const { return _stage != Stage::IDLE; }
+    
+    /**
+     * @brief Poll connect / reply / timeout (call in loop)
+     * @return true once when a probe has finished (see ok())
+     */
+    bool update();
+    
+    /**
+     * @brief Last probe gave a sample
+     */
+    bool ok() const { return _lastError == nullptr && _answered > 0; }
+    
+    const HttpDateSample& sample() const { return _sample; }
+    
+    /**
+     * @brief Why the last probe failed (nullptr = it answered)
+     */
+    const char* lastError() const { return _lastError; }
+    
+    uint16_t getAnswered() const { return _answered; }
+    uint16_t getFailed() const { return _failed; }
+
+private:
+    enum class Stage : uint8_t {
+        IDLE = 0,
+        CONNECTING = 1,         // TcpConnector working
+        READING = 2             // Request sent, reading header lines
+    };
+    
+    char _host[TIME_HOST_MAX_LEN + 1];  // As configured
+    char _name[TIME_HOST_MAX_LEN + 1];  // Without ":port"
+    uint16_t _port;
+    
+    TcpConnector _connector;
+    WiFiClient _client;
+    Stage _stage;
+    unsigned long _startMs;
+    int64_t _t1Us;
+    char _line[HTTP_DATE_LINE_MAX];
+    uint8_t _lineLen;
+    
+    HttpDateSample _sample;
+    const char* _lastError;
+    uint16_t _answered;
+    uint16_t _failed;
+    
+    /**
+     * @brief Request written: send HEAD, start reading
+     */
+    bool _sendRequest();
+    
+    /**
+     * @brief One complete header line in _line
+     * @return true if the probe is over
+     */
+    bool _onLine();
+    
+    /**
+     * @brief End the probe (error = nullptr: _sample is new)
+     * @return true (update() result)
+     */
+    bool _finish(const char* error);
+    
+    /**
+     * @brief Our clock, us since 1970
+     */
+    static int64_t _nowUs();
+};
+
+#endif // HTTP_DATE_CLIENT_H
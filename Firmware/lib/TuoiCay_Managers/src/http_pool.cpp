@@ -0,0 +1,475 @@
+/**
+ * @file http_pool.cpp
+ * @brief Persistent HTTP connection pool implementation
+ *
+ * RULES: #HTTP(24) #PERF(15)
+ */
+
+#include "http_pool.h"
+#include <logger.h>
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+
+/**
+ * @brief Case-insensitive search for a token in a header value
+ */
+static bool containsToken(const char* value, const char* token) {
+    size_t len = strlen(token);
+    for (; *value; value++) {
+        if (strncasecmp(value, token, len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Complete JSON error response that closes the connection
+ */
+static void writeError(WiFiClient& client, int code, const char* message) {
+    char body[64];
+    int bodyLen = snprintf(body, sizeof(body), "{\"ok\":false,\"error\":\"%s\"}", message);
+
+    char head[160];
+    int headLen = snprintf(head, sizeof(head),
+        "HTTP/1.1 %d %s\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: %d\r\n"
+        "%s"
+        "Connection: close\r\n"
+        "\r\n",
+        code, HttpConnectionPool::statusText(code), bodyLen,
+        code == 503 ? "Retry-After: 1\r\n" : "");
+
+    client.write((const uint8_t*)head, headLen);
+    client.write((const uint8_t*)body, bodyLen);
+}
+
+//=============================================================================
+// CONSTRUCTOR / LIFECYCLE
+//=============================================================================
+
+HttpConnectionPool::HttpConnectionPool(uint16_t port)
+    : _server(port)
+    , _bodyOwner(nullptr)
+    , _next(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    for (uint8_t i = 0; i < WEB_MAX_CONNECTIONS; i++) {
+        _conns[i].state = HttpConnState::FREE;
+    }
+}
+
+void HttpConnectionPool::begin() {
+    _server.begin();
+}
+
+void HttpConnectionPool::stop() {
+    for (uint8_t i = 0; i < WEB_MAX_CONNECTIONS; i++) {
+        if (_conns[i].state != HttpConnState::FREE) {
+            _close(_conns[i]);
+        }
+    }
+    _server.stop();
+}
+
+uint8_t HttpConnectionPool::openCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < WEB_MAX_CONNECTIONS; i++) {
+        if (_conns[i].state != HttpConnState::FREE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+//=============================================================================
+// POLLING
+//=============================================================================
+
+HttpConnection* HttpConnectionPool::poll(uint8_t external) {
+    unsigned long now = millis();
+    _accept(external);
+
+    HttpConnection* ready = nullptr;
+    for (uint8_t n = 0; n < WEB_MAX_CONNECTIONS; n++) {
+        uint8_t i = (_next + n) % WEB_MAX_CONNECTIONS;
+        HttpConnection& conn = _conns[i];
+        if (conn.state == HttpConnState::FREE) {
+            continue;
+        }
+
+        // Stays "connected" while unread data remains, so a client that
+        // pipelined requests and half-closed is still served
+        if (!conn.client.connected()) {
+            _close(conn);
+            continue;
+        }
+
+        _read(conn, now);
+
+        switch (conn.state) {
+            case HttpConnState::IDLE:
+                if (now - conn.since >= WEB_KEEPALIVE_TIMEOUT_MS) {
+                    _stats.idleClosed++;
+                    _close(conn);
+                }
+                break;
+
+            case HttpConnState::HEAD:
+            case HttpConnState::BODY:
+                if (now - conn.since >= WEB_REQUEST_TIMEOUT_MS) {
+                    _stats.timeouts++;
+                    _reject(conn, 408, "Request timeout");
+                }
+                break;
+
+            case HttpConnState::READY:
+                // Peer that does not read its responses loses the slot
+                if (now - conn.since >= WEB_REQUEST_TIMEOUT_MS + WEB_KEEPALIVE_TIMEOUT_MS) {
+                    _stats.timeouts++;
+                    _close(conn);
+                } else if (!ready && conn.client.availableForWrite() >= WEB_RESPONSE_BUFFER_SIZE) {
+                    ready = &conn;
+                    _next = (i + 1) % WEB_MAX_CONNECTIONS;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (ready) {
+        if (ready->served > 0) {
+            _stats.reused++;
+        }
+        // Hand the socket back when it served its share or others need one
+        if (ready->served + 1 >= WEB_KEEPALIVE_MAX_REQUESTS ||
+            openCount() + external >= WEB_MAX_CONNECTIONS) {
+            ready->keepAlive = false;
+        }
+    }
+    return ready;
+}
+
+void HttpConnectionPool::finish(HttpConnection* conn) {
+    if (conn->state == HttpConnState::FREE) {
+        return;             // Detached while the request was handled
+    }
+    if (_bodyOwner == conn) {
+        _bodyOwner = nullptr;
+    }
+    conn->served++;
+
+    if (!conn->keepAlive || !conn->client.connected()) {
+        _close(*conn);
+        return;
+    }
+    conn->state = HttpConnState::IDLE;
+    conn->since = millis();
+}
+
+WiFiClient HttpConnectionPool::detach(HttpConnection* conn) {
+    WiFiClient client = conn->client;
+    conn->client = WiFiClient();        // Drop our reference, socket stays open
+    if (_bodyOwner == conn) {
+        _bodyOwner = nullptr;
+    }
+    conn->state = HttpConnState::FREE;
+    return client;
+}
+
+bool HttpConnectionPool::body(const HttpConnection* conn, const char*& data, size_t& len) const {
+    if (conn->contentLength == 0 || _bodyOwner != conn) {
+        return false;
+    }
+    data = _body;
+    len = conn->bodyLen;
+    return true;
+}
+
+//=============================================================================
+// ACCEPT
+//=============================================================================
+
+void HttpConnectionPool::_accept(uint8_t external) {
+    if (!_server.hasClient()) {
+        return;
+    }
+
+    HttpConnection* slot = nullptr;
+    if (openCount() + external < WEB_MAX_CONNECTIONS) {
+        for (uint8_t i = 0; i < WEB_MAX_CONNECTIONS && !slot; i++) {
+            if (_conns[i].state == HttpConnState::FREE) {
+                slot = &_conns[i];
+            }
+        }
+    }
+
+    if (!slot) {
+        // Full: the longest idle persistent connection makes room
+        unsigned long now = millis();
+        for (uint8_t i = 0; i < WEB_MAX_CONNECTIONS; i++) {
+            HttpConnection& conn = _conns[i];
+            if (conn.state == HttpConnState::IDLE &&
+                (!slot || now - conn.since > now - slot->since)) {
+                slot = &conn;
+            }
+        }
+        if (slot) {
+            _stats.evicted++;
+            _close(*slot);
+        }
+    }
+
+    WiFiClient client = _server.accept();
+    if (!slot) {
+        _stats.rejected++;
+        LOG_WRN(MOD_WEB, "conn", "Pool full, client rejected");
+        writeError(client, 503, "Server busy");
+        client.stop();
+        return;
+    }
+
+    client.setNoDelay(true);            // Header and body writes go out at once
+    slot->client = client;
+    slot->state = HttpConnState::IDLE;
+    slot->since = millis();
+    slot->served = 0;
+    _stats.accepted++;
+
+    uint8_t open = openCount() + external;
+    if (open > _stats.peak) {
+        _stats.peak = open;
+    }
+}
+
+//=============================================================================
+// REQUEST PARSING
+//=============================================================================
+
+void HttpConnectionPool::_read(HttpConnection& conn, unsigned long now) {
+    uint16_t budget = WEB_READ_BUDGET;
+
+    while ((conn.state == HttpConnState::IDLE || conn.state == HttpConnState::HEAD) &&
+           budget > 0 && conn.client.available() > 0) {
+        int c = conn.client.read();
+        if (c < 0) {
+            break;
+        }
+        budget--;
+
+        if (conn.state == HttpConnState::IDLE) {
+            _beginRequest(conn, now);
+        }
+
+        if (c == '\n') {
+            if (conn.lineLen > 0 && conn.line[conn.lineLen - 1] == '\r') {
+                conn.lineLen--;
+            }
+            conn.line[conn.lineLen] = '\0';
+            _parseLine(conn, now);
+            conn.lineLen = 0;
+            conn.lineTooLong = false;
+        } else if (conn.lineLen < HTTP_LINE_MAX - 1) {
+            conn.line[conn.lineLen++] = (char)c;
+        } else {
+            conn.lineTooLong = true;
+        }
+    }
+
+    if (conn.state != HttpConnState::BODY) {
+        return;
+    }
+
+    // One body at a time: others keep theirs in the socket until it is free
+    if (_bodyOwner != &conn) {
+        if (_bodyOwner) {
+            return;
+        }
+        _bodyOwner = &conn;
+    }
+
+    int available = conn.client.available();
+    size_t remaining = conn.contentLength - conn.bodyLen;
+    size_t want = (available > 0 && (size_t)available < remaining) ? (size_t)available : remaining;
+    if (available > 0 && want > 0) {
+        int got = conn.client.read((uint8_t*)_body + conn.bodyLen, want);
+        if (got > 0) {
+            conn.bodyLen += got;
+        }
+    }
+
+    if (conn.bodyLen == conn.contentLength) {
+        _body[conn.bodyLen] = '\0';
+        conn.state = HttpConnState::READY;
+    }
+}
+
+void HttpConnectionPool::_beginRequest(HttpConnection& conn, unsigned long now) {
+    conn.state = HttpConnState::HEAD;
+    conn.since = now;
+    conn.method = HttpMethod::OTHER;
+    conn.http11 = false;
+    conn.keepAlive = false;
+    conn.chunked = false;
+    conn.lineTooLong = false;
+    conn.lines = 0;
+    conn.lineLen = 0;
+    conn.contentLength = 0;
+    conn.bodyLen = 0;
+    conn.path[0] = '\0';
+    conn.ifNoneMatch[0] = '\0';
+}
+
+void HttpConnectionPool::_parseLine(HttpConnection& conn, unsigned long now) {
+    bool empty = conn.line[0] == '\0' && !conn.lineTooLong;
+
+    if (conn.lines == 0) {
+        if (empty) {
+            return;         // CRLF between pipelined requests is allowed
+        }
+        conn.lines = 1;
+        if (conn.lineTooLong) {
+            _reject(conn, 414, "URI too long");
+        } else {
+            _parseRequestLine(conn);
+        }
+        return;
+    }
+
+    if (empty) {
+        _headersDone(conn, now);
+        return;
+    }
+
+    if (++conn.lines > HTTP_HEADERS_MAX) {
+        _reject(conn, 431, "Too many headers");
+        return;
+    }
+    if (!conn.lineTooLong) {
+        _parseHeader(conn);
+    }
+}
+
+void HttpConnectionPool::_parseRequestLine(HttpConnection& conn) {
+    // METHOD SP target SP HTTP/1.x
+    char* method = conn.line;
+    char* target = strchr(method, ' ');
+    char* version = target ? strchr(target + 1, ' ') : nullptr;
+    if (!version || strncmp(version + 1, "HTTP/1.", 7) != 0) {
+        _reject(conn, 400, "Bad request line");
+        return;
+    }
+    *target++ = '\0';
+    *version++ = '\0';
+
+    if (strcmp(method, "GET") == 0) {
+        conn.method = HttpMethod::GET;
+    } else if (strcmp(method, "POST") == 0) {
+        conn.method = HttpMethod::POST;
+    }
+
+    // HTTP/1.1 is persistent unless the client says otherwise
+    conn.http11 = strcmp(version, "HTTP/1.0") != 0;
+    conn.keepAlive = conn.http11;
+
+    char* query = strchr(target, '?');
+    if (query) {
+        *query = '\0';
+    }
+    if (strlen(target) > HTTP_PATH_MAX) {
+        _reject(conn, 414, "URI too long");
+        return;
+    }
+    strcpy(conn.path, target);
+}
+
+void HttpConnectionPool::_parseHeader(HttpConnection& conn) {
+    char* colon = strchr(conn.line, ':');
+    if (!colon) {
+        return;
+    }
+    *colon = '\0';
+    const char* name = conn.line;
+    char* value = colon + 1;
+    while (*value == ' ' || *value == '\t') {
+        value++;
+    }
+
+    if (strcasecmp(name, "Content-Length") == 0) {
+        char* end;
+        unsigned long len = strtoul(value, &end, 10);
+        if (end == value || (*end != '\0' && *end != ' ')) {
+            _reject(conn, 400, "Bad Content-Length");
+            return;
+        }
+        conn.contentLength = len;
+    } else if (strcasecmp(name, "Connection") == 0) {
+        if (containsToken(value, "close")) {
+            conn.keepAlive = false;
+        } else if (containsToken(value, "keep-alive")) {
+            conn.keepAlive = true;      // HTTP/1.0 opt-in
+        }
+    } else if (strcasecmp(name, "Transfer-Encoding") == 0) {
+        conn.chunked = true;
+    } else if (strcasecmp(name, "If-None-Match") == 0) {
+        strncpy(conn.ifNoneMatch, value, HTTP_ETAG_MAX);
+        conn.ifNoneMatch[HTTP_ETAG_MAX] = '\0';
+    }
+}
+
+void HttpConnectionPool::_headersDone(HttpConnection& conn, unsigned long now) {
+    if (conn.chunked) {
+        _reject(conn, 411, "Length required");
+    } else if (conn.contentLength > WEB_MAX_BODY_SIZE) {
+        _reject(conn, 413, "Body too large");
+    } else if (conn.contentLength > 0) {
+        conn.state = HttpConnState::BODY;
+        conn.since = now;               // Body gets its own time budget
+    } else {
+        conn.state = HttpConnState::READY;
+    }
+}
+
+//=============================================================================
+// CLOSING
+//=============================================================================
+
+void HttpConnectionPool::_close(HttpConnection& conn) {
+    conn.client.stop();
+    conn.client = WiFiClient();
+    if (_bodyOwner == &conn) {
+        _bodyOwner = nullptr;
+    }
+    conn.state = HttpConnState::FREE;
+}
+
+void HttpConnectionPool::_reject(HttpConnection& conn, int code, const char* message) {
+    LOG_DBG(MOD_WEB, "conn", "Rejected: %d %s", code, message);
+    writeError(conn.client, code, message);
+    _close(conn);
+}
+
+const char* HttpConnectionPool::statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        case 414: return "URI Too Long";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
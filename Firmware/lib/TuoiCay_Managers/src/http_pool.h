@@ -0,0 +1,171 @@
+/**
+ * @file http_pool.h
+ * @brief Persistent HTTP/1.1 connections for the sync web backend
+ *
+ * LOGIC:
+ * - Accepts sockets from a WiFiServer into a fixed pool; a socket stays
+ *   open after its response (keep-alive) so the next poll from the same
+ *   browser skips the TCP handshake and leaves no TIME_WAIT behind
+ * - Incremental reader per connection: request line and headers are
+ *   consumed line by line as bytes arrive, never waiting in loop()
+ * - Pipelining: bytes after a request stay in the socket and are parsed
+ *   once that request was answered, so responses keep request order
+ * - One shared body buffer (WEB_MAX_BODY_SIZE); a second connection with
+ *   a body waits, unread, until the buffer is free
+ * - Budget: pool connections + sockets taken over elsewhere (event
+ *   streams) <= WEB_MAX_CONNECTIONS, since lwIP only has 5 TCP PCBs and
+ *   MQTT needs one. A new client when full evicts the oldest idle
+ *   connection, or gets 503 and is closed
+ * - Timeouts: idle keep-alive connection WEB_KEEPALIVE_TIMEOUT_MS, request
+ *   not complete within WEB_REQUEST_TIMEOUT_MS -> 408 and close
+ * - Backpressure: a ready request is only served when its socket can take
+ *   a response buffer; keep-alive is refused while clients are waiting
+ * - Protocol errors (400, 411, 413, 414, 431) are answered here; header lines
+ *   longer than HTTP_LINE_MAX (User-Agent, Cookie) are skipped
+ *
+ * RULES: #HTTP(24) #PERF(15)
+ */
+
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <config.h>
+
+#define HTTP_LINE_MAX           96      // Request line / header line
+#define HTTP_PATH_MAX           48      // Path without query string
+#define HTTP_ETAG_MAX           24      // If-None-Match value kept
+#define HTTP_HEADERS_MAX        32      // Header lines per request
+
+//=============================================================================
+// CONNECTION
+//=============================================================================
+
+enum class HttpConnState : uint8_t {
+    FREE = 0,       // Slot unused
+    IDLE,           // Open, waiting for the next request
+    HEAD,           // Reading request line + headers
+    BODY,           // Reading body into the shared buffer
+    READY           // Complete request, waiting to be served
+};
+
+enum class HttpMethod : uint8_t {
+    OTHER = 0,
+    GET,
+    POST
+};
+
+/**
+ * @brief One pooled socket and the request being read from it
+ */
+struct HttpConnection {
+    WiFiClient client;
+    HttpConnState state;
+    unsigned long since;        // Start of idle period / request
+    uint16_t served;            // Requests answered on this socket
+
+    // Current request
+    HttpMethod method;
+    bool http11;
+    bool keepAlive;             // Response may leave the socket open
+    bool chunked;               // Transfer-Encoding in request (unsupported)
+    bool lineTooLong;
+    uint8_t lines;              // Lines read so far (0 = request line next)
+    uint8_t lineLen;
+    uint32_t contentLength;
+    uint32_t bodyLen;
+    char line[HTTP_LINE_MAX];
+    char path[HTTP_PATH_MAX + 1];
+    char ifNoneMatch[HTTP_ETAG_MAX + 1];
+};
+
+/**
+ * @brief Connection counters (/api/perf)
+ */
+struct HttpPoolStats {
+    uint32_t accepted;          // Sockets taken into the pool
+    uint32_t reused;            // Requests on an already used socket
+    uint32_t evicted;           // Idle sockets closed for a new client
+    uint32_t rejected;          // New clients answered 503 (pool full)
+    uint32_t timeouts;          // Requests not complete in time (408)
+    uint32_t idleClosed;        // Keep-alive sockets closed after idle timeout
+    uint8_t peak;               // Most sockets open at once (incl. streams)
+};
+
+//=============================================================================
+// CONNECTION POOL CLASS
+//=============================================================================
+
+/**
+ * @class HttpConnectionPool
+ * @brief Fixed set of keep-alive connections behind one listening port
+ */
+class HttpConnectionPool {
+public:
+    explicit HttpConnectionPool(uint16_t port);
+
+    void begin();
+
+    /**
+     * @brief Close every pooled socket and stop listening
+     */
+    void stop();
+
+    /**
+     * @brief Accept, read and expire connections (call from loop)
+     * @param external Sockets held outside the pool (event streams)
+     * @return Connection with a complete request to serve now, or nullptr
+     */
+    HttpConnection* poll(uint8_t external);
+
+    /**
+     * @brief Request answered: keep socket for the next one or close it
+     */
+    void finish(HttpConnection* conn);
+
+    /**
+     * @brief Take the socket out of the pool without closing it
+     *        (event stream takeover); the slot is free afterwards
+     */
+    WiFiClient detach(HttpConnection* conn);
+
+    /**
+     * @brief Body of the request being served (NUL-terminated)
+     * @return false if the request has none
+     */
+    bool body(const HttpConnection* conn, const char*& data, size_t& len) const;
+
+    uint8_t openCount() const;
+    const HttpPoolStats& stats() const { return _stats; }
+    void resetPeak() { _stats.peak = 0; }
+
+    /**
+     * @brief Reason phrase for a status code
+     */
+    static const char* statusText(int code);
+
+private:
+    WiFiServer _server;
+    HttpConnection _conns[WEB_MAX_CONNECTIONS];
+    char _body[WEB_MAX_BODY_SIZE + 1];
+    HttpConnection* _bodyOwner;         // Connection using _body
+    uint8_t _next;                      // Round-robin start for serving
+    HttpPoolStats _stats;
+
+    void _accept(uint8_t external);
+    void _read(HttpConnection& conn, unsigned long now);
+    void _beginRequest(HttpConnection& conn, unsigned long now);
+    void _parseLine(HttpConnection& conn, unsigned long now);
+    void _parseRequestLine(HttpConnection& conn);
+    void _parseHeader(HttpConnection& conn);
+    void _headersDone(HttpConnection& conn, unsigned long now);
+    void _close(HttpConnection& conn);
+
+    /**
+     * @brief Answer a request the server cannot serve, then close
+     */
+    void _reject(HttpConnection& conn, int code, const char* message);
+};
+
+#endif // HTTP_POOL_H
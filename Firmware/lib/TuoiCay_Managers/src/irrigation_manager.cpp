@@ -0,0 +1,145 @@
+/**
+ * @file irrigation_manager.cpp
+ * @brief Implementation of the irrigation arbiter
+ *
+ * LOGIC:
+ * - The pump gets each job's remaining time as its run duration. The
+ *   arbiter also ends runs itself in update(), so the run still ends
+ *   when the pump caps the duration at its max runtime
+ * - A pump that is off while a job is active means the pump ended the
+ *   run (safety auto-off, emergency stop): the job is closed, the next
+ *   one starts
+ * - Every verdict is logged once, at the request
+ *
+ * RULES: #ACTUATOR(15) #SAFETY(2)
+ */
+
+#include "irrigation_manager.h"
+#include <logger.h>
+
+static_assert((uint8_t)IrrigationSource::MANUAL == (uint8_t)PumpReason::MANUAL &&
+              (uint8_t)IrrigationSource::AUTO == (uint8_t)PumpReason::AUTO &&
+              (uint8_t)IrrigationSource::SCHEDULE == (uint8_t)PumpReason::SCHEDULE,
+              "IrrigationSource must mirror PumpReason");
+
+// Global instance
+IrrigationManager irrigation;
+
+//=============================================================================
+// IRRIGATION MANAGER IMPLEMENTATION
+//=============================================================================
+
+IrrigationManager::IrrigationManager() : _pump(nullptr) {}
+
+void IrrigationManager::begin(PumpController* pump) {
+    _pump = pump;
+    LOG_INF(MOD_JOBS, "init", "Ready (queue=%d, max wait=%ds)",
+            IRRIGATION_QUEUE_MAX, IRRIGATION_WAIT_MAX_SEC);
+}
+
+IrrigationVerdict IrrigationManager::request(PumpReason reason, uint16_t durationSec,
+                                             uint8_t entry) {
+    if (!_pump || reason == PumpReason::NONE) return IrrigationVerdict::REFUSED;
+    
+    IrrigationSource source = (IrrigationSource)reason;
+    uint16_t previous = _queue.active().id;
+    IrrigationVerdict verdict = _queue.submit(source, durationSec, entry, millis());
+    
+    if (verdict == IrrigationVerdict::PREEMPTED) {
+        LOG_INF(MOD_JOBS, "preempt", "Job #%u (%s) preempts #%u", _queue.active().id,
+                irrigationSourceName(source), previous);
+        _pump->turnOff(false);      // Handover: no cooldown
+    }
+    if (verdict == IrrigationVerdict::STARTED || verdict == IrrigationVerdict::PREEMPTED) {
+        uint16_t id = _queue.active().id;
+        if (!_startActive() || _queue.active().id != id) {
+            verdict = IrrigationVerdict::REFUSED;
+        }
+    }
+    
+    if (verdict == IrrigationVerdict::QUEUED) {
+        LOG_INF(MOD_JOBS, "queue", "%s job queued behind #%u (%d waiting)",
+                irrigationSourceName(source), _queue.active().id, _queue.waitingCount());
+    } else if (verdict != IrrigationVerdict::STARTED && verdict != IrrigationVerdict::PREEMPTED) {
+        LOG_DBG(MOD_JOBS, "request", "%s job %s", irrigationSourceName(source),
+                irrigationVerdictName(verdict));
+    }
+    return verdict;
+}
+
+bool IrrigationManager::cancel(PumpReason reason) {
+    IrrigationSource source = (IrrigationSource)reason;
+    if (!has(reason)) return false;
+    
+    uint16_t id = _queue.active().id;
+    if (_queue.cancel(source)) {
+        LOG_INF(MOD_JOBS, "cancel", "Job #%u (%s) cancelled", id, irrigationSourceName(source));
+        _pump->turnOff(true);
+        _next();
+    }
+    return true;
+}
+
+void IrrigationManager::stop() {
+    uint8_t waiting = _queue.waitingCount();
+    bool running = _queue.clear();
+    if (running || waiting) {
+        LOG_INF(MOD_JOBS, "stop", "All jobs dropped (%s, %d waiting)",
+                running ? "1 running" : "none running", waiting);
+    }
+    if (_pump && _pump->isRunning()) {
+        _pump->turnOff(true);
+    }
+}
+
+void IrrigationManager::update() {
+    if (!_pump || !_queue.hasActive()) return;
+    
+    const IrrigationJob& job = _queue.active();
+    if (!_pump->isRunning()) {
+        LOG_WRN(MOD_JOBS, "end", "Job #%u (%s) ended by the pump after %lus", job.id,
+                irrigationSourceName(job.source), (unsigned long)_queue.elapsedSec(millis()));
+        _next();
+    } else if (_queue.due(millis())) {
+        LOG_INF(MOD_JOBS, "end", "Job #%u (%s) done", job.id, irrigationSourceName(job.source));
+        _pump->turnOff(true);
+        _next();
+    }
+}
+
+bool IrrigationManager::has(PumpReason reason) const {
+    return _queue.has((IrrigationSource)reason);
+}
+
+bool IrrigationManager::_startActive() {
+    while (_queue.hasActive()) {
+        const IrrigationJob& job = _queue.active();
+        if (_pump->turnOn((PumpReason)job.source, job.runSec())) {
+            LOG_INF(MOD_JOBS, "start", "Job #%u (%s%s) running, %us%s", job.id,
+                    irrigationSourceName(job.source), job.doneSec ? ", resumed" : "",
+                    job.runSec(), job.runSec() ? "" : " max");
+            return true;
+        }
+        
+        LOG_DBG(MOD_JOBS, "start", "Pump refused job #%u (%s)", job.id,
+                irrigationSourceName(job.source));
+        _promote();
+    }
+    return false;
+}
+
+void IrrigationManager::_next() {
+    if (_promote()) {
+        _startActive();
+    }
+}
+
+bool IrrigationManager::_promote() {
+    uint8_t expired;
+    bool promoted = _queue.next(millis(), expired);
+    if (expired) {
+        LOG_WRN(MOD_JOBS, "expire", "%d job(s) waited over %ds, dropped", expired,
+                IRRIGATION_WAIT_MAX_SEC);
+    }
+    return promoted;
+}
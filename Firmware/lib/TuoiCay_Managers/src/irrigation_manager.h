@@ -0,0 +1,109 @@
+/**
+ * @file irrigation_manager.h
+ * @brief Irrigation arbiter: the only code that switches the pump for a run
+ *
+ * LOGIC:
+ * - Manual commands (web / MQTT), auto watering and the scheduler ask
+ *   for water through request(); the job queue (irrigation_queue.h)
+ *   decides whether it runs now, preempts, waits or is refused
+ * - The arbiter owns each run's duration. A run ends when its time is
+ *   up, when its source cancels it, or when the pump stops by itself
+ *   (max runtime safety). In that last case the job is closed too, so the
+ *   queue and PumpController never disagree about what is running
+ * - cancel() only touches the caller's own jobs: an auto stop (soil wet)
+ *   no longer ends a scheduled run
+ * - stop() (pump "off" from the user) drops every job, waiting ones too
+ * - Handover between jobs switches the pump off without cooldown and on
+ *   again under the new reason; a run ending normally starts the cooldown
+ *
+ * RULES: #ACTUATOR(15) #SAFETY(2)
+ */
+
+#ifndef IRRIGATION_MANAGER_H
+#define IRRIGATION_MANAGER_H
+
+#include <Arduino.h>
+#include <pump_driver.h>
+#include <irrigation_queue.h>
+
+//=============================================================================
+// IRRIGATION MANAGER CLASS
+//=============================================================================
+
+/**
+ * @class IrrigationManager
+ * @brief Serializes watering jobs from all sources on one pump
+ */
+class IrrigationManager {
+public:
+    IrrigationManager();
+    
+    /**
+     * @brief Attach the pump (already begun)
+     */
+    void begin(PumpController* pump);
+    
+    /**
+     * @brief Ask for a run
+     * @param reason MANUAL, AUTO or SCHEDULE
+     * @param durationSec 0 = until cancelled (capped by the pump's max runtime)
+     * @param entry Schedule entry index (SCHEDULE only)
+     */
+    IrrigationVerdict request(PumpReason reason, uint16_t durationSec,
+                              uint8_t entry = IRRIGATION_NO_ENTRY);
+    
+    /**
+     * @brief Drop the jobs of one source (stops the pump if one is running)
+     * @return true if the source had a job
+     */
+    bool cancel(PumpReason reason);
+    
+    /**
+     * @brief Drop all jobs and switch the pump off
+     */
+    void stop();
+    
+    /**
+     * @brief End runs whose time is up, start the next (call before pump.update())
+     */
+    void update();
+    
+    /**
+     * @brief Source has a job, running or waiting
+     */
+    bool has(PumpReason reason) const;
+    
+    /**
+     * @brief A job is running or waiting
+     */
+    bool busy() const { return _queue.hasActive() || _queue.waitingCount() > 0; }
+    
+    const IrrigationQueue& getQueue() const { return _queue; }
+
+private:
+    PumpController* _pump;
+    IrrigationQueue _queue;
+    
+    /**
+     * @brief Switch the pump on for the active job; a job the pump refuses
+     *        is dropped and the next one tried
+     * @return false if no job is running afterwards
+     */
+    bool _startActive();
+    
+    /**
+     * @brief Active job is over: promote the next one and start it
+     */
+    void _next();
+    
+    /**
+     * @brief Make the next waiting job active (pump untouched), log expired ones
+     * @return true if one is active now
+     */
+    bool _promote();
+};
+
+// Global instance
+extern IrrigationManager irrigation;
+
+#endif // IRRIGATION_MANAGER_H
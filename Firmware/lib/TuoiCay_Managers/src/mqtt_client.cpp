@@ -0,0 +1,610 @@
+/**
+ * @file mqtt_client.cpp
+ * @brief Implementation of lightweight MQTT 3.1.1 client
+ *
+ * LOGIC:
+ * - Packets are read incrementally into _buffer; loop() never blocks
+ *   waiting for the rest of a packet
+ * - CONNECT/CONNACK: the caller opens the socket, sendConnect() writes
+ *   CONNECT, pollConnAck() is called each loop until the answer arrives
+ * - QoS 1 PUBLISH is copied into an in-flight slot before sending so it
+ *   can be resent with DUP=1 on timeout or after reconnect
+ * - PUBACK frees the slot and reports delivery via ack callback
+ * - Incoming QoS 1 PUBLISH is always acked; a DUP redelivery of an ID
+ *   we already processed is acked but not dispatched again. A packet
+ *   larger than _buffer is acked and dropped (its payload is truncated)
+ * - Topic and payload are NUL-terminated in place in _buffer before the
+ *   message callback, so callers parse them without a stack copy
+ *
+ * RULES: #MQTT(9) #PROTOCOL(14)
+ */
+
+#include "mqtt_client.h"
+#include <logger.h>
+
+//=============================================================================
+// MQTT PACKET TYPES
+//=============================================================================
+#define MQTT_CONNECT        0x10
+#define MQTT_CONNACK        0x20
+#define MQTT_PUBLISH        0x30
+#define MQTT_PUBACK         0x40
+#define MQTT_SUBSCRIBE      0x82    // Includes required reserved bits
+#define MQTT_SUBACK         0x90
+#define MQTT_UNSUBSCRIBE    0xA2    // Includes required reserved bits
+#define MQTT_UNSUBACK       0xB0
+#define MQTT_PINGREQ        0xC0
+#define MQTT_PINGRESP       0xD0
+#define MQTT_DISCONNECT     0xE0
+
+#define MQTT_FLAG_DUP       0x08
+#define MQTT_FLAG_RETAIN    0x01
+
+//=============================================================================
+// MQTT CLIENT IMPLEMENTATION
+//=============================================================================
+
+MqttClient::MqttClient(Client& transport)
+    : _transport(&transport)
+    , _host(nullptr)
+    , _port(1883)
+    , _keepAliveSec(MQTT_KEEPALIVE_SEC)
+    , _msgCallback(nullptr)
+    , _ackCallback(nullptr)
+    , _state(MQTT_CLIENT_DISCONNECTED)
+    , _awaitingConnAck(false)
+    , _pingOutstanding(false)
+    , _lastOutActivity(0)
+    , _lastInActivity(0)
+    , _nextPacketId(0)
+    , _rxStage(RxStage::HEADER)
+    , _rxHeader(0)
+    , _rxLength(0)
+    , _rxMultiplier(1)
+    , _rxPos(0)
+    , _rxRecentHead(0)
+    , _ackedCount(0)
+    , _retransmitCount(0)
+    , _droppedCount(0)
+    , _duplicateCount(0)
+{
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+        _inflight[i].packetId = 0;
+    }
+    for (uint8_t i = 0; i < MQTT_RX_DEDUPE_SIZE; i++) {
+        _rxRecentIds[i] = 0;
+    }
+}
+
+void MqttClient::setServer(const char* host, uint16_t port) {
+    _host = host;
+    _port = port;
+}
+
+bool MqttClient::sendConnect(const char* clientId, const char* username, const char* password,
+                             const char* willTopic, uint8_t willQos, bool willRetain,
+                             const char* willMessage) {
+    if (clientId == nullptr) return false;
+
+    if (!_transport->connected()) {
+        _state = MQTT_CLIENT_CONNECT_FAILED;
+        return false;
+    }
+
+    // Build CONNECT into the (idle) receive buffer, leaving 5 bytes for header
+    const size_t hdrRoom = 5;
+    size_t pos = hdrRoom;
+    static const uint8_t protocol[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04};
+    memcpy(_buffer + pos, protocol, sizeof(protocol));
+    pos += sizeof(protocol);
+
+    uint8_t flags = 0x02;  // Clean session
+    if (willTopic) {
+        flags |= 0x04 | ((willQos & 0x03) << 3) | (willRetain ? 0x20 : 0x00);
+    }
+    bool hasUser = username && username[0] != '\0';
+    bool hasPass = hasUser && password && password[0] != '\0';
+    if (hasUser) flags |= 0x80;
+    if (hasPass) flags |= 0x40;
+
+    _buffer[pos++] = flags;
+    _buffer[pos++] = _keepAliveSec >> 8;
+    _buffer[pos++] = _keepAliveSec & 0xFF;
+
+    pos = _writeString(_buffer, pos, sizeof(_buffer), clientId);
+    if (pos && willTopic) {
+        pos = _writeString(_buffer, pos, sizeof(_buffer), willTopic);
+        if (pos) pos = _writeString(_buffer, pos, sizeof(_buffer), willMessage ? willMessage : "");
+    }
+    if (pos && hasUser) pos = _writeString(_buffer, pos, sizeof(_buffer), username);
+    if (pos && hasPass) pos = _writeString(_buffer, pos, sizeof(_buffer), password);
+
+    if (pos == 0) {
+        LOG_ERR(MOD_MQTT, "conn", "CONNECT packet too large");
+        _drop(MQTT_CLIENT_CONNECT_FAILED);
+        return false;
+    }
+
+    // Fixed header right before the variable header
+    uint8_t lenBuf[4];
+    uint8_t lenBytes = _encodeLength(lenBuf, pos - hdrRoom);
+    size_t start = hdrRoom - 1 - lenBytes;
+    _buffer[start] = MQTT_CONNECT;
+    memcpy(_buffer + start + 1, lenBuf, lenBytes);
+
+    size_t total = pos - start;
+    if (_transport->write(_buffer + start, total) != total) {
+        _drop(MQTT_CLIENT_CONNECT_FAILED);
+        return false;
+    }
+
+    _rxStage = RxStage::HEADER;
+    _awaitingConnAck = true;
+    _lastOutActivity = millis();
+    return true;
+}
+
+MqttConnAck MqttClient::pollConnAck() {
+    if (!_awaitingConnAck) {
+        return _state == MQTT_CLIENT_CONNECTED ? MqttConnAck::ACCEPTED : MqttConnAck::REJECTED;
+    }
+
+    if (!_transport->connected()) {
+        _drop(MQTT_CLIENT_CONNECTION_LOST);
+        return MqttConnAck::REJECTED;
+    }
+
+    if (!_readPacket()) {
+        // _readPacket() may have dropped the socket on a malformed header
+        return _awaitingConnAck ? MqttConnAck::PENDING : MqttConnAck::REJECTED;
+    }
+
+    if ((_rxHeader & 0xF0) != MQTT_CONNACK || _rxLength < 2) {
+        _drop(MQTT_CLIENT_BAD_PROTOCOL);
+        return MqttConnAck::REJECTED;
+    }
+    if (_buffer[1] != 0) {
+        _drop(_buffer[1]);
+        return MqttConnAck::REJECTED;
+    }
+
+    _awaitingConnAck = false;
+    _state = MQTT_CLIENT_CONNECTED;
+    _pingOutstanding = false;
+    _lastInActivity = _lastOutActivity = millis();
+
+    // Clean session: broker forgot our unacked messages, resend them
+    _retransmit(true);
+    return MqttConnAck::ACCEPTED;
+}
+
+void MqttClient::disconnect() {
+    if (_transport->connected()) {
+        _sendSimple(MQTT_DISCONNECT);
+    }
+    _drop(MQTT_CLIENT_DISCONNECTED);
+}
+
+bool MqttClient::connected() {
+    if (_state != MQTT_CLIENT_CONNECTED) return false;
+
+    if (!_transport->connected()) {
+        _drop(MQTT_CLIENT_CONNECTION_LOST);
+        return false;
+    }
+    return true;
+}
+
+bool MqttClient::loop() {
+    if (!connected()) return false;
+
+    unsigned long now = millis();
+    unsigned long keepAliveMs = _keepAliveSec * 1000UL;
+
+    // Keepalive: ping when idle, give up if broker stays silent
+    if (now - _lastInActivity > keepAliveMs || now - _lastOutActivity > keepAliveMs) {
+        if (_pingOutstanding) {
+            LOG_WRN(MOD_MQTT, "ping", "No PINGRESP, dropping connection");
+            _drop(MQTT_CLIENT_CONNECTION_TIMEOUT);
+            return false;
+        }
+        if (_sendSimple(MQTT_PINGREQ)) {
+            _pingOutstanding = true;
+            _lastInActivity = now;
+        }
+    }
+
+    // Incoming packets (bounded per call)
+    for (uint8_t n = 0; n < MQTT_MAX_PACKETS_PER_LOOP && _readPacket(); n++) {
+        _lastInActivity = millis();
+        _handlePacket();
+        if (_state != MQTT_CLIENT_CONNECTED) return false;
+    }
+
+    _retransmit(false);
+
+    return _state == MQTT_CLIENT_CONNECTED;
+}
+
+bool MqttClient::publish(const char* topic, const char* payload, bool retain) {
+    if (!connected()) return false;
+    return _sendPublish(topic, payload, retain, 0, false);
+}
+
+uint16_t MqttClient::publishQos1(const char* topic, const char* payload, bool retain) {
+    if (!connected()) return 0;
+
+    MqttInflight* slot = nullptr;
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+        if (_inflight[i].packetId == 0) {
+            slot = &_inflight[i];
+            break;
+        }
+    }
+    if (slot == nullptr) return 0;  // Window full
+
+    if (strlen(topic) >= MQTT_TOPIC_MAX_LEN || strlen(payload) >= MQTT_PAYLOAD_MAX) {
+        LOG_WRN(MOD_MQTT, "pub", "QoS1 message too large: %s", topic);
+        return 0;
+    }
+
+    uint16_t packetId = _allocPacketId();
+    if (!_sendPublish(topic, payload, retain, packetId, false)) {
+        return 0;
+    }
+
+    strcpy(slot->topic, topic);
+    strcpy(slot->payload, payload);
+    slot->retain = retain;
+    slot->retries = 0;
+    slot->sentAt = millis();
+    slot->packetId = packetId;
+
+    return packetId;
+}
+
+bool MqttClient::subscribe(const char* topic, uint8_t qos) {
+    if (qos > 1) qos = 1;
+    return _sendSubscribe(MQTT_SUBSCRIBE, topic, qos);
+}
+
+bool MqttClient::unsubscribe(const char* topic) {
+    return _sendSubscribe(MQTT_UNSUBSCRIBE, topic, -1);
+}
+
+uint8_t MqttClient::getInflightCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+        if (_inflight[i].packetId != 0) count++;
+    }
+    return count;
+}
+
+//=============================================================================
+// PRIVATE METHODS
+//=============================================================================
+
+bool MqttClient::_sendSubscribe(uint8_t header, const char* topic, int qos) {
+    if (!connected()) return false;
+
+    size_t topicLen = strlen(topic);
+    if (topicLen >= MQTT_TOPIC_MAX_LEN) return false;
+
+    // header(1) + len(<=2) + id(2) + topic(2+n) + qos(1, SUBSCRIBE only)
+    uint8_t packet[8 + MQTT_TOPIC_MAX_LEN];
+    uint16_t packetId = _allocPacketId();
+    uint32_t remaining = 2 + 2 + topicLen + (qos >= 0 ? 1 : 0);
+
+    size_t pos = 0;
+    packet[pos++] = header;
+    pos += _encodeLength(packet + pos, remaining);
+    packet[pos++] = packetId >> 8;
+    packet[pos++] = packetId & 0xFF;
+    pos = _writeString(packet, pos, sizeof(packet), topic);
+    if (qos >= 0) {
+        packet[pos++] = qos;
+    }
+
+    if (_transport->write(packet, pos) != pos) {
+        _drop(MQTT_CLIENT_CONNECTION_LOST);
+        return false;
+    }
+    _lastOutActivity = millis();
+    return true;
+}
+
+bool MqttClient::_readPacket() {
+    while (_transport->available() > 0) {
+        if (_rxStage == RxStage::BODY) {
+            // Bulk read the body; bytes past the buffer end are discarded
+            uint32_t want = _rxLength - _rxPos;
+            if (_rxPos < sizeof(_buffer)) {
+                uint32_t room = sizeof(_buffer) - _rxPos;
+                int got = _transport->read(_buffer + _rxPos, want < room ? want : room);
+                if (got <= 0) return false;
+                _rxPos += got;
+            } else {
+                if (_transport->read() < 0) return false;
+                _rxPos++;
+            }
+            if (_rxPos >= _rxLength) {
+                _rxStage = RxStage::HEADER;
+                return true;
+            }
+            continue;
+        }
+
+        int c = _transport->read();
+        if (c < 0) return false;
+
+        if (_rxStage == RxStage::HEADER) {
+            _rxHeader = (uint8_t)c;
+            _rxLength = 0;
+            _rxMultiplier = 1;
+            _rxPos = 0;
+            _rxStage = RxStage::LENGTH;
+        } else {
+            _rxLength += (c & 0x7F) * _rxMultiplier;
+            _rxMultiplier *= 128;
+            if (c & 0x80) {
+                if (_rxMultiplier > 128UL * 128 * 128) {
+                    _drop(MQTT_CLIENT_BAD_PROTOCOL);
+                    return false;
+                }
+                continue;
+            }
+            if (_rxLength == 0) {
+                _rxStage = RxStage::HEADER;
+                return true;
+            }
+            _rxStage = RxStage::BODY;
+        }
+    }
+    return false;
+}
+
+void MqttClient::_handlePacket() {
+    uint8_t type = _rxHeader & 0xF0;
+
+    switch (type) {
+        case MQTT_PUBLISH:
+            _handlePublish();
+            break;
+
+        case MQTT_PUBACK:
+            if (_rxLength >= 2) {
+                _handlePubAck(((uint16_t)_buffer[0] << 8) | _buffer[1]);
+            }
+            break;
+
+        case MQTT_SUBACK:
+            if (_rxLength >= 3 && _buffer[2] == 0x80) {
+                LOG_WRN(MOD_MQTT, "sub", "Broker rejected subscription (id=%u)",
+                        ((uint16_t)_buffer[0] << 8) | _buffer[1]);
+            }
+            break;
+
+        case MQTT_UNSUBACK:
+            break;
+
+        case MQTT_PINGREQ:
+            _sendSimple(MQTT_PINGRESP);
+            break;
+
+        case MQTT_PINGRESP:
+            _pingOutstanding = false;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MqttClient::_handlePublish() {
+    uint8_t qos = (_rxHeader >> 1) & 0x03;
+    bool dup = _rxHeader & MQTT_FLAG_DUP;
+
+    uint16_t topicLen = ((uint16_t)_buffer[0] << 8) | _buffer[1];
+
+    // Too large for the buffer: the payload is lost, but a QoS 1 message
+    // must still be acked or the broker redelivers it on every reconnect
+    // and it keeps an inflight slot of ours on the broker
+    if (_rxLength > sizeof(_buffer)) {
+        LOG_WRN(MOD_MQTT, "recv", "Packet too large (%lu bytes), dropped",
+                (unsigned long)_rxLength);
+        if (qos == 0) return;
+        if (4 + (size_t)topicLen > sizeof(_buffer)) {
+            // Packet ID lies in the discarded part: cannot ack it
+            LOG_ERR(MOD_MQTT, "recv", "Oversized QoS %d packet without readable id, disconnecting",
+                    qos);
+            _drop(MQTT_CLIENT_BAD_PROTOCOL);
+            return;
+        }
+        uint16_t packetId = ((uint16_t)_buffer[2 + topicLen] << 8) | _buffer[3 + topicLen];
+        _sendSimple(MQTT_PUBACK, packetId, true);
+        _isDuplicate(packetId);
+        return;
+    }
+    size_t payloadStart = 2 + topicLen + (qos > 0 ? 2 : 0);
+    if (payloadStart > _rxLength) return;
+
+    uint16_t packetId = 0;
+    if (qos > 0) {
+        packetId = ((uint16_t)_buffer[2 + topicLen] << 8) | _buffer[3 + topicLen];
+    }
+
+    // Move topic 2 bytes back so it can be NUL-terminated in place; the
+    // payload follows right behind it, which leaves a byte for its NUL
+    size_t payloadLen = _rxLength - payloadStart;
+    memmove(_buffer, _buffer + 2, topicLen);
+    _buffer[topicLen] = '\0';
+    memmove(_buffer + topicLen + 1, _buffer + payloadStart, payloadLen);
+    _buffer[topicLen + 1 + payloadLen] = '\0';
+
+    bool duplicate = false;
+    if (qos > 0) {
+        _sendSimple(MQTT_PUBACK, packetId, true);
+        duplicate = _isDuplicate(packetId) && dup;
+    }
+
+    if (duplicate) {
+        _duplicateCount++;
+        LOG_DBG(MOD_MQTT, "recv", "Duplicate id=%u ignored", packetId);
+        return;
+    }
+
+    if (_msgCallback) {
+        _msgCallback((char*)_buffer, _buffer + topicLen + 1, payloadLen);
+    }
+}
+
+bool MqttClient::isRetained() const {
+    return (_rxHeader & 0xF0) == MQTT_PUBLISH && (_rxHeader & MQTT_FLAG_RETAIN);
+}
+
+void MqttClient::_handlePubAck(uint16_t packetId) {
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+        if (_inflight[i].packetId == packetId) {
+            _inflight[i].packetId = 0;
+            _ackedCount++;
+            LOG_DBG(MOD_MQTT, "ack", "PUBACK id=%u", packetId);
+            if (_ackCallback) _ackCallback(packetId, true);
+            return;
+        }
+    }
+}
+
+bool MqttClient::_sendPublish(const char* topic, const char* payload, bool retain,
+                              uint16_t packetId, bool dup) {
+    size_t topicLen = strlen(topic);
+    size_t payloadLen = strlen(payload);
+    if (topicLen >= MQTT_TOPIC_MAX_LEN) return false;
+
+    uint32_t remaining = 2 + topicLen + (packetId ? 2 : 0) + payloadLen;
+
+    // Header + topic + packet ID in one small write, then the payload
+    uint8_t header[5 + 2 + MQTT_TOPIC_MAX_LEN + 2];
+    size_t pos = 0;
+    header[pos++] = MQTT_PUBLISH | (packetId ? 0x02 : 0x00) |
+                    (dup ? MQTT_FLAG_DUP : 0x00) | (retain ? MQTT_FLAG_RETAIN : 0x00);
+    pos += _encodeLength(header + pos, remaining);
+    pos = _writeString(header, pos, sizeof(header), topic);
+    if (packetId) {
+        header[pos++] = packetId >> 8;
+        header[pos++] = packetId & 0xFF;
+    }
+
+    if (_transport->write(header, pos) != pos ||
+        (payloadLen > 0 && _transport->write((const uint8_t*)payload, payloadLen) != payloadLen)) {
+        _drop(MQTT_CLIENT_CONNECTION_LOST);
+        return false;
+    }
+
+    _lastOutActivity = millis();
+    return true;
+}
+
+bool MqttClient::_sendSimple(uint8_t header, uint16_t packetId, bool hasId) {
+    uint8_t packet[4] = {header, 0, 0, 0};
+    size_t len = 2;
+    if (hasId) {
+        packet[1] = 2;
+        packet[2] = packetId >> 8;
+        packet[3] = packetId & 0xFF;
+        len = 4;
+    }
+
+    if (_transport->write(packet, len) != len) {
+        return false;
+    }
+    _lastOutActivity = millis();
+    return true;
+}
+
+void MqttClient::_retransmit(bool force) {
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+        MqttInflight& msg = _inflight[i];
+        if (msg.packetId == 0) continue;
+        if (!force && now - msg.sentAt < MQTT_RETRY_TIMEOUT_MS) continue;
+
+        if (!force && msg.retries >= MQTT_RETRY_MAX) {
+            LOG_WRN(MOD_MQTT, "retry", "No PUBACK after %d retries, dropped: %s",
+                    msg.retries, msg.topic);
+            uint16_t packetId = msg.packetId;
+            msg.packetId = 0;
+            _droppedCount++;
+            if (_ackCallback) _ackCallback(packetId, false);
+            continue;
+        }
+
+        if (!_sendPublish(msg.topic, msg.payload, msg.retain, msg.packetId, true)) {
+            return;  // Connection dropped, keep remaining for next connect
+        }
+        if (!force) msg.retries++;
+        msg.sentAt = now;
+        _retransmitCount++;
+        LOG_DBG(MOD_MQTT, "retry", "Resent id=%u: %s", msg.packetId, msg.topic);
+    }
+}
+
+uint16_t MqttClient::_allocPacketId() {
+    for (;;) {
+        _nextPacketId++;
+        if (_nextPacketId == 0) continue;
+
+        // Never reuse an ID that is still waiting for PUBACK
+        bool inUse = false;
+        for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+            if (_inflight[i].packetId == _nextPacketId) {
+                inUse = true;
+                break;
+            }
+        }
+        if (!inUse) return _nextPacketId;
+    }
+}
+
+bool MqttClient::_isDuplicate(uint16_t packetId) {
+    for (uint8_t i = 0; i < MQTT_RX_DEDUPE_SIZE; i++) {
+        if (_rxRecentIds[i] == packetId) return true;
+    }
+    _rxRecentIds[_rxRecentHead] = packetId;
+    _rxRecentHead = (_rxRecentHead + 1) % MQTT_RX_DEDUPE_SIZE;
+    return false;
+}
+
+void MqttClient::_drop(int newState) {
+    _transport->stop();
+    _state = newState;
+    _awaitingConnAck = false;
+    _rxStage = RxStage::HEADER;
+    _pingOutstanding = false;
+
+    // Broker-side packet IDs restart with the new session
+    for (uint8_t i = 0; i < MQTT_RX_DEDUPE_SIZE; i++) {
+        _rxRecentIds[i] = 0;
+    }
+}
+
+uint8_t MqttClient::_encodeLength(uint8_t* buf, uint32_t length) {
+    uint8_t count = 0;
+    do {
+        uint8_t digit = length % 128;
+        length /= 128;
+        if (length > 0) digit |= 0x80;
+        buf[count++] = digit;
+    } while (length > 0 && count < 4);
+    return count;
+}
+
+size_t MqttClient::_writeString(uint8_t* buf, size_t pos, size_t bufSize, const char* str) {
+    size_t len = strlen(str);
+    if (pos + 2 + len > bufSize) return 0;
+
+    buf[pos++] = len >> 8;
+    buf[pos++] = len & 0xFF;
+    memcpy(buf + pos, str, len);
+    return pos + len;
+}
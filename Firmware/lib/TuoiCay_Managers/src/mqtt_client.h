@@ -0,0 +1,329 @@
+/**
+ * @file mqtt_client.h
+ * @brief Lightweight MQTT 3.1.1 client with QoS 1 publish support
+ *
+ * LOGIC:
+ * - Speaks MQTT 3.1.1 directly over any Arduino Client (WiFiClient or
+ *   WiFiClientSecure for TLS)
+ * - QoS 0 and QoS 1 publish (QoS 1 uses packet IDs + PUBACK)
+ * - Bounded in-flight window: at most MQTT_INFLIGHT_MAX unacked messages
+ * - Retransmit with DUP flag when PUBACK does not arrive in time
+ * - Unacked messages survive reconnects and are resent after CONNACK
+ * - Incoming QoS 1 messages are acked; DUP redeliveries are deduplicated
+ * - Incremental packet reader (never waits for missing bytes in loop())
+ * - Connect is split in two: sendConnect() on an already open socket,
+ *   then pollConnAck() from loop() until the broker answers
+ *
+ * Replaces PubSubClient, which can only publish QoS 0 and silently
+ * drops PUBACK packets.
+ *
+ * RULES: #MQTT(9) #PROTOCOL(14)
+ */
+
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <config.h>
+
+//=============================================================================
+// LIMITS
+//=============================================================================
+#define MQTT_TOPIC_MAX_LEN      64      // Max topic length
+#define MQTT_PAYLOAD_MAX        256     // Max payload length
+#define MQTT_PACKET_BUFFER_SIZE 512     // Max incoming packet size
+#define MQTT_INFLIGHT_MAX       4       // Max unacked QoS 1 messages
+#define MQTT_RETRY_TIMEOUT_MS   5000    // Resend if no PUBACK within this time
+#define MQTT_RETRY_MAX          3       // Drop message after this many resends
+#define MQTT_RX_DEDUPE_SIZE     8       // Remembered incoming QoS 1 packet IDs
+#define MQTT_MAX_PACKETS_PER_LOOP 4     // Bound work done in one loop() call
+
+//=============================================================================
+// CLIENT STATE CODES (compatible with PubSubClient::state())
+//=============================================================================
+#define MQTT_CLIENT_CONNECTION_TIMEOUT     -4
+#define MQTT_CLIENT_CONNECTION_LOST        -3
+#define MQTT_CLIENT_CONNECT_FAILED         -2
+#define MQTT_CLIENT_DISCONNECTED           -1
+#define MQTT_CLIENT_CONNECTED               0
+#define MQTT_CLIENT_BAD_PROTOCOL            1
+#define MQTT_CLIENT_BAD_CLIENT_ID           2
+#define MQTT_CLIENT_UNAVAILABLE             3
+#define MQTT_CLIENT_BAD_CREDENTIALS         4
+#define MQTT_CLIENT_UNAUTHORIZED            5
+
+//=============================================================================
+// CONNACK POLL RESULT
+//=============================================================================
+enum class MqttConnAck : uint8_t {
+    PENDING = 0,        // No answer yet
+    ACCEPTED = 1,       // Session established
+    REJECTED = 2        // Refused or socket closed (see state())
+};
+
+//=============================================================================
+// CALLBACK TYPES
+//=============================================================================
+// topic and payload are NUL-terminated (payload[length] == '\0')
+typedef void (*MqttClientMessageCallback)(char* topic, uint8_t* payload, unsigned int length);
+typedef void (*MqttClientAckCallback)(uint16_t packetId, bool delivered);
+
+//=============================================================================
+// IN-FLIGHT MESSAGE (waiting for PUBACK)
+//=============================================================================
+struct MqttInflight {
+    uint16_t packetId;          // 0 = slot free
+    char topic[MQTT_TOPIC_MAX_LEN];
+    char payload[MQTT_PAYLOAD_MAX];
+    bool retain;
+    uint8_t retries;            // Number of resends so far
+    unsigned long sentAt;       // millis() of last (re)send
+};
+
+//=============================================================================
+// MQTT CLIENT CLASS
+//=============================================================================
+
+/**
+ * @class MqttClient
+ * @brief Minimal MQTT 3.1.1 client (QoS 0/1 publish, QoS 0/1 subscribe)
+ */
+class MqttClient {
+public:
+    /**
+     * @brief Constructor
+     * @param transport Underlying TCP client
+     */
+    MqttClient(Client& transport);
+
+    /**
+     * @brief Switch underlying client (plain TCP or TLS); only while disconnected
+     */
+    void setTransport(Client& transport) { _transport = &transport; }
+
+    /**
+     * @brief Set broker address
+     */
+    void setServer(const char* host, uint16_t port);
+
+    /**
+     * @brief Set callback for incoming PUBLISH messages
+     */
+    void setCallback(MqttClientMessageCallback callback) { _msgCallback = callback; }
+
+    /**
+     * @brief Set callback for QoS 1 delivery result (PUBACK or dropped)
+     */
+    void setAckCallback(MqttClientAckCallback callback) { _ackCallback = callback; }
+
+    /**
+     * @brief Set keepalive interval in seconds
+     */
+    void setKeepAlive(uint16_t seconds) { _keepAliveSec = seconds; }
+
+    /**
+     * @brief Send CONNECT on an already connected transport (non-blocking)
+     * @param clientId MQTT client ID
+     * @param username Username (nullptr = none)
+     * @param password Password (nullptr = none)
+     * @param willTopic LWT topic (nullptr = no LWT)
+     * @param willQos LWT QoS
+     * @param willRetain LWT retain flag
+     * @param willMessage LWT payload
+     * @return true if CONNECT was written
+     */
+    bool sendConnect(const char* clientId, const char* username, const char* password,
+                     const char* willTopic, uint8_t willQos, bool willRetain,
+                     const char* willMessage);
+
+    /**
+     * @brief Check for CONNACK after sendConnect() (call in loop)
+     * @return PENDING until the broker answers
+     */
+    MqttConnAck pollConnAck();
+
+    /**
+     * @brief Send DISCONNECT and close socket
+     * In-flight messages are kept and resent on next connect.
+     */
+    void disconnect();
+
+    /**
+     * @brief Check if connected (socket open and CONNACK received)
+     */
+    bool connected();
+
+    /**
+     * @brief Process incoming packets, keepalive and retransmits (call in loop)
+     * @return true if still connected
+     */
+    bool loop();
+
+    /**
+     * @brief Publish with QoS 0 (fire-and-forget)
+     */
+    bool publish(const char* topic, const char* payload, bool retain);
+
+    /**
+     * @brief Publish with QoS 1 (tracked until PUBACK)
+     * @return Packet ID (>0) if sent and tracked, 0 if window full or send failed
+     */
+    uint16_t publishQos1(const char* topic, const char* payload, bool retain);
+
+    /**
+     * @brief Subscribe to topic
+     * @param qos Requested QoS (0 or 1; 2 is downgraded to 1)
+     */
+    bool subscribe(const char* topic, uint8_t qos);
+
+    /**
+     * @brief Unsubscribe from topic
+     */
+    bool unsubscribe(const char* topic);
+
+    /**
+     * @brief Check if a QoS 1 message can be accepted right now
+     */
+    bool canPublishQos1() const { return getInflightCount() < MQTT_INFLIGHT_MAX; }
+
+    /**
+     * @brief Get number of unacked QoS 1 messages
+     */
+    uint8_t getInflightCount() const;
+
+    /**
+     * @brief Get client state (MQTT_CLIENT_* codes)
+     */
+    int state() const { return _state; }
+
+    /**
+     * @brief RETAIN flag of the message being delivered (valid inside the
+     *        message callback: set = stored copy sent on subscribe)
+     */
+    bool isRetained() const;
+
+    /**
+     * @brief Delivery statistics
+     */
+    uint32_t getAckedCount() const { return _ackedCount; }
+    uint32_t getRetransmitCount() const { return _retransmitCount; }
+    uint32_t getDroppedCount() const { return _droppedCount; }
+    uint32_t getDuplicateCount() const { return _duplicateCount; }
+
+private:
+    // Incremental reader stages
+    enum class RxStage : uint8_t {
+        HEADER = 0,
+        LENGTH = 1,
+        BODY = 2
+    };
+
+    Client* _transport;
+    const char* _host;
+    uint16_t _port;
+    uint16_t _keepAliveSec;
+
+    MqttClientMessageCallback _msgCallback;
+    MqttClientAckCallback _ackCallback;
+
+    int _state;
+    bool _awaitingConnAck;
+    bool _pingOutstanding;
+    unsigned long _lastOutActivity;
+    unsigned long _lastInActivity;
+    uint16_t _nextPacketId;
+
+    // Receive state
+    uint8_t _buffer[MQTT_PACKET_BUFFER_SIZE];
+    RxStage _rxStage;
+    uint8_t _rxHeader;
+    uint32_t _rxLength;
+    uint32_t _rxMultiplier;
+    uint32_t _rxPos;
+
+    // QoS 1 tracking
+    MqttInflight _inflight[MQTT_INFLIGHT_MAX];
+    uint16_t _rxRecentIds[MQTT_RX_DEDUPE_SIZE];
+    uint8_t _rxRecentHead;
+
+    // Statistics
+    uint32_t _ackedCount;
+    uint32_t _retransmitCount;
+    uint32_t _droppedCount;
+    uint32_t _duplicateCount;
+
+    /**
+     * @brief Read available bytes into the packet buffer
+     * @return true when a complete packet is ready
+     */
+    bool _readPacket();
+
+    /**
+     * @brief Dispatch a complete packet
+     */
+    void _handlePacket();
+
+    /**
+     * @brief Handle incoming PUBLISH
+     */
+    void _handlePublish();
+
+    /**
+     * @brief Handle incoming PUBACK
+     */
+    void _handlePubAck(uint16_t packetId);
+
+    /**
+     * @brief Send PUBLISH packet (QoS 0 or 1)
+     */
+    bool _sendPublish(const char* topic, const char* payload, bool retain,
+                      uint16_t packetId, bool dup);
+
+    /**
+     * @brief Send SUBSCRIBE or UNSUBSCRIBE for one topic
+     * @param qos Requested QoS, or -1 for UNSUBSCRIBE (no QoS byte)
+     */
+    bool _sendSubscribe(uint8_t header, const char* topic, int qos);
+
+    /**
+     * @brief Send a 2-byte packet (PINGREQ, DISCONNECT...) or 4-byte ack
+     */
+    bool _sendSimple(uint8_t header, uint16_t packetId = 0, bool hasId = false);
+
+    /**
+     * @brief Resend all in-flight messages whose PUBACK timed out
+     * @param force Resend all regardless of timeout (after reconnect)
+     */
+    void _retransmit(bool force);
+
+    /**
+     * @brief Allocate next non-zero packet ID
+     */
+    uint16_t _allocPacketId();
+
+    /**
+     * @brief Check/remember incoming QoS 1 packet ID for dedupe
+     * @return true if already seen
+     */
+    bool _isDuplicate(uint16_t packetId);
+
+    /**
+     * @brief Close socket and set state
+     */
+    void _drop(int newState);
+
+    /**
+     * @brief Encode MQTT remaining length
+     * @return Number of bytes written (1-4)
+     */
+    static uint8_t _encodeLength(uint8_t* buf, uint32_t length);
+
+    /**
+     * @brief Append length-prefixed UTF-8 string
+     * @return New position, or 0 if it does not fit
+     */
+    static size_t _writeString(uint8_t* buf, size_t pos, size_t bufSize, const char* str);
+};
+
+#endif // MQTT_CLIENT_H
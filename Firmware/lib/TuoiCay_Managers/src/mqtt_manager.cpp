@@ -4,8 +4,20 @@
  * 
  * LOGIC:
  * - Connect with LWT: devices/{deviceId}/status
+ * - connect() only starts an attempt; update() walks it through
+ *   TCP -> CONNECT -> CONNACK and gives up after MQTT_CONNECT_TIMEOUT_MS
+ * - TLS: BearSSL cannot start its handshake on a socket we opened, so
+ *   TCP + handshake is one blocking step (bounded by MQTT_TLS_TIMEOUT_MS);
+ *   session resumption keeps reconnects short. CONNACK is still polled.
+ *   TLS mode therefore does not meet the 50 ms loop() budget. To keep an
+ *   unreachable broker from blocking, TcpConnector first checks that the
+ *   port answers; that socket is dropped and the blocking part starts
+ * - The MFLN probe (its own TCP + ClientHello, no timeout of ours) runs
+ *   on the first connect to a broker only; begin() forgets the answer
  * - Exponential backoff: 2s -> 4s -> 8s -> 16s -> 30s (max)
  * - Queue messages when offline, flush on reconnect
+ * - QoS 1 messages leave the queue only when the in-flight window has room;
+ *   MqttClient keeps them until PUBACK and resends them after reconnect
  * - Auto-resubscribe to all topics after reconnect
  * 
  * RULES: #MQTT(9) #ERROR(6)
@@ -15,6 +27,7 @@
 #include <logger.h>
 #include <error_codes.h>
 #include <ArduinoJson.h>
+#include "storage_manager.h"
 
 //=============================================================================
 // STATIC INSTANCE POINTER
@@ -27,6 +40,12 @@ MqttManager* MqttManager::_instance = nullptr;
 
 MqttManager::MqttManager()
     : _client(_wifiClient)
+    , _connectPhase(ConnectPhase::NONE)
+    , _useTls(false)
+    , _tlsPin(TlsPin::NONE)
+    , _tlsMfln(TlsMfln::UNKNOWN)
+    , _tlsHandshakeMs(0)
+    , _tlsHeapUsed(0)
     , _port(1883)
     , _state(MqttState::IDLE)
     , _msgCallback(nullptr)
@@ -35,15 +54,13 @@ MqttManager::MqttManager()
     , _lastReconnectTime(0)
     , _reconnectDelay(MQTT_RECONNECT_MIN_MS)
     , _reconnectCount(0)
+    , _reconnectTotal(0)
     , _initialized(false)
     , _hasCredentials(false)
+    , _queueHead(0)
+    , _queueCount(0)
     , _subscriptionCount(0)
 {
-    // Initialize queue
-    for (int i = 0; i < MQTT_QUEUE_SIZE; i++) {
-        _queue[i].used = false;
-    }
-    
     // Set static instance for callback
     _instance = this;
 }
@@ -59,21 +76,25 @@ bool MqttManager::begin(const char* broker, uint16_t port, const char* deviceId)
         return false;
     }
     
+    if (_broker != broker || _port != port) {
+        _tlsMfln = TlsMfln::UNKNOWN;
+    }
     _broker = broker;
     _port = port;
     _deviceId = deviceId;
+    _useTls = (port == MQTT_TLS_PORT);
     
-    // Configure PubSubClient
+    // Configure MQTT client
+    _client.setTransport(_useTls ? static_cast<Client&>(_secureClient) : static_cast<Client&>(_wifiClient));
     _client.setServer(_broker.c_str(), _port);
     _client.setCallback(_staticCallback);
-    _client.setBufferSize(512);  // Larger buffer for JSON
-    _client.setKeepAlive(60);    // 60 second keepalive
+    _client.setKeepAlive(MQTT_KEEPALIVE_SEC);
     
     _initialized = true;
     _state = MqttState::IDLE;
     
-    LOG_INF(MOD_MQTT, "init", "MQTT ready, broker=%s:%d, deviceId=%s", 
-            broker, port, deviceId);
+    LOG_INF(MOD_MQTT, "init", "MQTT ready, broker=%s:%d%s, deviceId=%s", 
+            broker, port, _useTls ? " (TLS)" : "", deviceId);
     
     return true;
 }
@@ -105,70 +126,37 @@ bool MqttManager::connect() {
         return true;
     }
     
-    LOG_INF(MOD_MQTT, "conn", "Connecting to %s:%d...", _broker.c_str(), _port);
+    if (_state == MqttState::CONNECTING) {
+        return true;  // Attempt already in progress
+    }
     
-    // Build LWT topic: devices/{deviceId}/status
-    char lwtTopic[MQTT_TOPIC_MAX_LEN];
-    snprintf(lwtTopic, sizeof(lwtTopic), "devices/%s/status", _deviceId.c_str());
+    LOG_INF(MOD_MQTT, "conn", "Connecting to %s:%d...", _broker.c_str(), _port);
     
-    // LWT payload (offline)
-    const char* lwtPayload = "{\"online\":false}";
+    // Drop any half-open socket from a previous session
+    if (_wifiClient.connected()) {
+        _wifiClient.stop();
+    }
+    if (_secureClient.connected()) {
+        _secureClient.stop();
+    }
     
-    // Client ID = deviceId
-    String clientId = "TC_" + _deviceId;
+    _connectStartTime = millis();
+    _connectPhase = ConnectPhase::TCP;
+    _setState(MqttState::CONNECTING);
     
-    bool connected = false;
-    if (_hasCredentials) {
-        connected = _client.connect(
-            clientId.c_str(),
-            _username.c_str(),
-            _password.c_str(),
-            lwtTopic,           // LWT topic
-            1,                  // LWT QoS
-            true,               // LWT retain
-            lwtPayload          // LWT payload
-        );
-    } else {
-        connected = _client.connect(
-            clientId.c_str(),
-            lwtTopic,           // LWT topic
-            1,                  // LWT QoS
-            true,               // LWT retain
-            lwtPayload          // LWT payload
-        );
-    }
-    
-    if (connected) {
-        _reconnectCount = 0;
-        _reconnectDelay = MQTT_RECONNECT_MIN_MS;
-        _setState(MqttState::CONNECTED);
-        
-        // Publish online status
-        _publishOnlineStatus();
-        
-        // Resubscribe to all topics
-        _resubscribeAll();
-        
-        // Flush queued messages
-        _flushQueue();
-        
-        LOG_INF(MOD_MQTT, "conn", "Connected! Client=%s", clientId.c_str());
-        return true;
-    } else {
-        int state = _client.state();
-        LOG_WRN(MOD_MQTT, "conn", "Connection failed, state=%d", state);
-        
-        _reconnectCount++;
-        _calculateBackoff();
-        _lastReconnectTime = millis();
-        _setState(MqttState::DISCONNECTED);
-        
+    // TLS: reachability check only, handshake in _updateConnecting()
+    if (!_connector.begin(_broker.c_str(), _port)) {
+        _onConnectFailed("TCP start failed");
         return false;
     }
+    
+    return true;
 }
 
 void MqttManager::disconnect() {
     LOG_INF(MOD_MQTT, "disc", "Disconnecting...");
+    _connector.abort();
+    _connectPhase = ConnectPhase::NONE;
     _client.disconnect();
     _setState(MqttState::IDLE);
     _reconnectCount = 0;
@@ -180,6 +168,12 @@ void MqttManager::update() {
     
     unsigned long now = millis();
     
+    // Connection attempt in progress
+    if (_state == MqttState::CONNECTING) {
+        _updateConnecting();
+        return;
+    }
+    
     // Process incoming messages if connected
     if (_client.connected()) {
         _client.loop();
@@ -188,6 +182,11 @@ void MqttManager::update() {
         if (_state != MqttState::CONNECTED) {
             _setState(MqttState::CONNECTED);
         }
+        
+        // Move backlog into the in-flight window as PUBACKs free slots
+        if (_queueCount > 0 && _client.canPublishQos1()) {
+            _flushQueue();
+        }
     } else {
         // Handle disconnection
         if (_state == MqttState::CONNECTED) {
@@ -212,22 +211,29 @@ bool MqttManager::publish(const char* topic, const char* payload, uint8_t qos, b
     
     // Build full topic
     char fullTopic[MQTT_TOPIC_MAX_LEN];
-    if (addPrefix) {
-        snprintf(fullTopic, sizeof(fullTopic), "devices/%s/%s", _deviceId.c_str(), topic);
-    } else {
-        strncpy(fullTopic, topic, sizeof(fullTopic) - 1);
-        fullTopic[sizeof(fullTopic) - 1] = '\0';
-    }
+    _fullTopic(topic, addPrefix, fullTopic, sizeof(fullTopic));
     
     // If connected, publish directly
     if (_client.connected()) {
-        bool result = _client.publish(fullTopic, payload, retain);
-        if (result) {
-            LOG_DBG(MOD_MQTT, "pub", "-> %s", fullTopic);
-        } else {
-            LOG_WRN(MOD_MQTT, "pub", "FAILED: %s", fullTopic);
+        if (qos == 0) {
+            bool result = _client.publish(fullTopic, payload, retain);
+            if (result) {
+                LOG_DBG(MOD_MQTT, "pub", "-> %s", fullTopic);
+            } else {
+                LOG_WRN(MOD_MQTT, "pub", "FAILED: %s", fullTopic);
+            }
+            return result;
         }
-        return result;
+        
+        // QoS 1: keep FIFO order behind any backlog, else send now
+        if (_queueCount == 0) {
+            uint16_t packetId = _client.publishQos1(fullTopic, payload, retain);
+            if (packetId) {
+                LOG_DBG(MOD_MQTT, "pub", "-> %s (QoS=1, id=%u)", fullTopic, packetId);
+                return true;
+            }
+        }
+        return _queueMessage(fullTopic, payload, qos, retain);
     }
     
     // If disconnected, queue message (only QoS > 0 messages)
@@ -245,27 +251,24 @@ bool MqttManager::subscribe(const char* topic, uint8_t qos, bool addPrefix) {
     
     // Build full topic
     char fullTopic[MQTT_TOPIC_MAX_LEN];
-    if (addPrefix) {
-        snprintf(fullTopic, sizeof(fullTopic), "devices/%s/%s", _deviceId.c_str(), topic);
-    } else {
-        strncpy(fullTopic, topic, sizeof(fullTopic) - 1);
-        fullTopic[sizeof(fullTopic) - 1] = '\0';
-    }
+    _fullTopic(topic, addPrefix, fullTopic, sizeof(fullTopic));
     
     // Save subscription for resubscribe
-    if (_subscriptionCount < MAX_SUBSCRIPTIONS) {
-        bool alreadyExists = false;
-        for (uint8_t i = 0; i < _subscriptionCount; i++) {
-            if (_subscriptions[i] == fullTopic) {
-                alreadyExists = true;
-                _subscriptionQos[i] = qos;
-                break;
-            }
+    bool alreadyExists = false;
+    for (uint8_t i = 0; i < _subscriptionCount; i++) {
+        if (strcmp(_subscriptions[i], fullTopic) == 0) {
+            alreadyExists = true;
+            _subscriptionQos[i] = qos;
+            break;
         }
-        if (!alreadyExists) {
-            _subscriptions[_subscriptionCount] = fullTopic;
+    }
+    if (!alreadyExists) {
+        if (_subscriptionCount < MAX_SUBSCRIPTIONS) {
+            memcpy(_subscriptions[_subscriptionCount], fullTopic, MQTT_TOPIC_MAX_LEN);
             _subscriptionQos[_subscriptionCount] = qos;
             _subscriptionCount++;
+        } else {
+            LOG_WRN(MOD_MQTT, "sub", "Subscription table full, %s not kept", fullTopic);
         }
     }
     
@@ -285,6 +288,33 @@ bool MqttManager::subscribe(const char* topic, uint8_t qos, bool addPrefix) {
     return true;
 }
 
+bool MqttManager::unsubscribe(const char* topic, bool addPrefix) {
+    if (!_initialized) return false;
+    
+    char fullTopic[MQTT_TOPIC_MAX_LEN];
+    _fullTopic(topic, addPrefix, fullTopic, sizeof(fullTopic));
+    
+    bool found = false;
+    for (uint8_t i = 0; i < _subscriptionCount; i++) {
+        if (strcmp(_subscriptions[i], fullTopic) == 0) {
+            // Move last entry into the hole
+            _subscriptionCount--;
+            if (i != _subscriptionCount) {
+                memcpy(_subscriptions[i], _subscriptions[_subscriptionCount], MQTT_TOPIC_MAX_LEN);
+                _subscriptionQos[i] = _subscriptionQos[_subscriptionCount];
+            }
+            found = true;
+            break;
+        }
+    }
+    
+    if (_client.connected()) {
+        _client.unsubscribe(fullTopic);
+        LOG_INF(MOD_MQTT, "unsub", "x %s", fullTopic);
+    }
+    return found;
+}
+
 bool MqttManager::isConnected() const {
     return _state == MqttState::CONNECTED;
 }
@@ -299,18 +329,19 @@ const char* MqttManager::getStateString() const {
     }
 }
 
-uint8_t MqttManager::getQueuedCount() const {
-    uint8_t count = 0;
-    for (int i = 0; i < MQTT_QUEUE_SIZE; i++) {
-        if (_queue[i].used) count++;
-    }
-    return count;
-}
-
 void MqttManager::buildTopic(const char* topic, char* buffer, size_t bufSize) {
     snprintf(buffer, bufSize, "devices/%s/%s", _deviceId.c_str(), topic);
 }
 
+void MqttManager::_fullTopic(const char* topic, bool addPrefix, char* buffer, size_t bufSize) {
+    if (addPrefix) {
+        buildTopic(topic, buffer, bufSize);
+    } else {
+        strncpy(buffer, topic, bufSize - 1);
+        buffer[bufSize - 1] = '\0';
+    }
+}
+
 //=============================================================================
 // PRIVATE METHODS
 //=============================================================================
@@ -327,6 +358,206 @@ void MqttManager::_setState(MqttState newState) {
     }
 }
 
+void MqttManager::_updateConnecting() {
+    if (millis() - _connectStartTime >= MQTT_CONNECT_TIMEOUT_MS) {
+        _connector.abort();
+        _client.disconnect();
+        _onConnectFailed(_connectPhase == ConnectPhase::TCP ? "TCP timeout" : "CONNACK timeout");
+        return;
+    }
+    
+    if (WiFi.status() != WL_CONNECTED) {
+        _connector.abort();
+        _client.disconnect();
+        _onConnectFailed("WiFi lost");
+        return;
+    }
+    
+    switch (_connectPhase) {
+        case ConnectPhase::TCP: {
+            TcpConnectState tcp = _connector.poll();
+            if (tcp == TcpConnectState::FAILED) {
+                _connector.abort();
+                _onConnectFailed("TCP connect failed");
+            } else if (tcp == TcpConnectState::CONNECTED && _useTls) {
+                // Broker is up: drop the check socket, then the blocking handshake
+                _connector.abort();
+                if (_connectTls() && _sendConnect()) {
+                    _connectPhase = ConnectPhase::CONNACK;
+                } else {
+                    _client.disconnect();
+                    _onConnectFailed("TLS connect failed");
+                }
+            } else if (tcp == TcpConnectState::CONNECTED) {
+                if (_connector.claim(_wifiClient) && _sendConnect()) {
+                    _connectPhase = ConnectPhase::CONNACK;
+                } else {
+                    _client.disconnect();
+                    _onConnectFailed("CONNECT send failed");
+                }
+            }
+            break;
+        }
+        
+        case ConnectPhase::CONNACK: {
+            MqttConnAck ack = _client.pollConnAck();
+            if (ack == MqttConnAck::ACCEPTED) {
+                _onConnected();
+            } else if (ack == MqttConnAck::REJECTED) {
+                _onConnectFailed("CONNACK rejected");
+            }
+            break;
+        }
+        
+        default:
+            _onConnectFailed("No attempt");
+            break;
+    }
+}
+
+bool MqttManager::_configureTls() {
+    if (_tlsPin != TlsPin::NONE) return true;
+    
+    // Pins: CA preferred (survives broker cert renewal), fingerprint fallback
+    String pin;
+    if (storage.readTextFile(MQTT_CA_FILE, pin, MQTT_TLS_CA_MAX_LEN) &&
+        _tlsTrustAnchors.append(pin.c_str())) {
+        _secureClient.setTrustAnchors(&_tlsTrustAnchors);
+        _tlsPin = TlsPin::CA;
+        LOG_INF(MOD_MQTT, "tls", "Pinned to CA from %s", MQTT_CA_FILE);
+    } else if (storage.readTextFile(MQTT_FP_FILE, pin, 64)) {
+        pin.trim();
+        if (_secureClient.setFingerprint(pin.c_str())) {
+            _tlsPin = TlsPin::FINGERPRINT;
+            LOG_INF(MOD_MQTT, "tls", "Pinned to fingerprint from %s", MQTT_FP_FILE);
+        }
+    }
+    
+    if (_tlsPin == TlsPin::NONE) {
+#ifdef MQTT_TLS_ALLOW_INSECURE
+        _secureClient.setInsecure();
+        _tlsPin = TlsPin::INSECURE;
+        LOG_WRN(MOD_MQTT, "tls", "No pin found, certificate NOT verified!");
+#else
+        LOG_ERR(MOD_MQTT, "tls", "No %s or %s on LittleFS, refusing TLS", MQTT_CA_FILE, MQTT_FP_FILE);
+        return false;
+#endif
+    }
+    
+    _secureClient.setSession(&_tlsSession);
+    _secureClient.setTimeout(MQTT_TLS_TIMEOUT_MS);
+    return true;
+}
+
+void MqttManager::_probeMfln() {
+    if (_tlsMfln != TlsMfln::UNKNOWN) return;
+    
+    // Small record size keeps both TLS buffers within the ESP8266 heap;
+    // without MFLN the broker may send full 16KB records. The broker just
+    // answered on TCP, so a failed probe means no MFLN, not "unreachable"
+    unsigned long start = millis();
+    if (BearSSL::WiFiClientSecure::probeMaxFragmentLength(_broker.c_str(), _port, MQTT_TLS_BUFFER_SIZE)) {
+        _tlsMfln = TlsMfln::ACCEPTED;
+        _secureClient.setBufferSizes(MQTT_TLS_BUFFER_SIZE, MQTT_TLS_BUFFER_SIZE);
+        LOG_INF(MOD_MQTT, "tls", "MFLN %d accepted (probe %lums)", MQTT_TLS_BUFFER_SIZE,
+                millis() - start);
+    } else {
+        _tlsMfln = TlsMfln::REFUSED;
+        _secureClient.setBufferSizes(MQTT_TLS_RX_FULL, MQTT_TLS_TX_FULL);
+        LOG_WRN(MOD_MQTT, "tls", "Broker has no MFLN, using %d byte RX buffer (probe %lums)",
+                MQTT_TLS_RX_FULL, millis() - start);
+    }
+}
+
+bool MqttManager::_connectTls() {
+    if (!_configureTls()) return false;
+    
+    // CA validation checks certificate dates, so it needs NTP time
+    if (_tlsPin == TlsPin::CA) {
+        time_t now = time(nullptr);
+        if (now < (time_t)MQTT_TLS_MIN_EPOCH) {
+            LOG_WRN(MOD_MQTT, "tls", "Clock not set yet, postponing TLS");
+            return false;
+        }
+        _secureClient.setX509Time(now);
+    }
+    
+    _probeMfln();
+    
+    uint32_t heapBefore = ESP.getFreeHeap();
+    unsigned long start = millis();
+    
+    bool ok = _secureClient.connect(_broker.c_str(), _port);
+    
+    _tlsHandshakeMs = millis() - start;
+    uint32_t heapAfter = ESP.getFreeHeap();
+    _tlsHeapUsed = heapBefore > heapAfter ? heapBefore - heapAfter : 0;
+    
+    if (!ok) {
+        char sslErr[64] = "";
+        int code = _secureClient.getLastSSLError(sslErr, sizeof(sslErr));
+        LOG_ERR(MOD_MQTT, "tls", "%s: ssl=%d %s (%lums)", error_to_string(TC_ERR_MQTT_TLS_FAIL),
+                code, sslErr, (unsigned long)_tlsHandshakeMs);
+        return false;
+    }
+    
+    _secureClient.setNoDelay(true);
+    LOG_INF(MOD_MQTT, "tls", "Handshake %lums, heap used=%lu, free=%lu",
+            (unsigned long)_tlsHandshakeMs, (unsigned long)_tlsHeapUsed, (unsigned long)heapAfter);
+    return true;
+}
+
+bool MqttManager::_sendConnect() {
+    // Build LWT topic: devices/{deviceId}/status
+    char lwtTopic[MQTT_TOPIC_MAX_LEN];
+    snprintf(lwtTopic, sizeof(lwtTopic), "devices/%s/status", _deviceId.c_str());
+    
+    // LWT payload (offline)
+    const char* lwtPayload = "{\"online\":false}";
+    
+    // Client ID = deviceId
+    String clientId = "TC_" + _deviceId;
+    
+    return _client.sendConnect(
+        clientId.c_str(),
+        _hasCredentials ? _username.c_str() : nullptr,
+        _hasCredentials ? _password.c_str() : nullptr,
+        lwtTopic,           // LWT topic
+        1,                  // LWT QoS
+        true,               // LWT retain
+        lwtPayload          // LWT payload
+    );
+}
+
+void MqttManager::_onConnected() {
+    _connectPhase = ConnectPhase::NONE;
+    _reconnectCount = 0;
+    _reconnectDelay = MQTT_RECONNECT_MIN_MS;
+    _setState(MqttState::CONNECTED);
+    
+    // Publish online status
+    _publishOnlineStatus();
+    
+    // Resubscribe to all topics
+    _resubscribeAll();
+    
+    // Flush queued messages
+    _flushQueue();
+    
+    LOG_INF(MOD_MQTT, "conn", "Connected in %lums", millis() - _connectStartTime);
+}
+
+void MqttManager::_onConnectFailed(const char* reason) {
+    LOG_WRN(MOD_MQTT, "conn", "Connection failed (%s), state=%d", reason, _client.state());
+    
+    _connectPhase = ConnectPhase::NONE;
+    _reconnectCount++;
+    _reconnectTotal++;
+    _calculateBackoff();
+    _lastReconnectTime = millis();
+    _setState(MqttState::DISCONNECTED);
+}
+
 void MqttManager::_calculateBackoff() {
     // Exponential backoff: 2s -> 4s -> 8s -> 16s -> 30s (max)
     _reconnectDelay *= 2;
@@ -336,41 +567,51 @@ void MqttManager::_calculateBackoff() {
 }
 
 bool MqttManager::_queueMessage(const char* topic, const char* payload, uint8_t qos, bool retain) {
-    // Find empty slot
-    for (int i = 0; i < MQTT_QUEUE_SIZE; i++) {
-        if (!_queue[i].used) {
-            strncpy(_queue[i].topic, topic, MQTT_TOPIC_MAX_LEN - 1);
-            _queue[i].topic[MQTT_TOPIC_MAX_LEN - 1] = '\0';
-            
-            strncpy(_queue[i].payload, payload, MQTT_PAYLOAD_MAX - 1);
-            _queue[i].payload[MQTT_PAYLOAD_MAX - 1] = '\0';
-            
-            _queue[i].qos = qos;
-            _queue[i].retain = retain;
-            _queue[i].used = true;
-            
-            LOG_DBG(MOD_MQTT, "queue", "Queued [%d]: %s", i, topic);
-            return true;
-        }
+    if (_queueCount >= MQTT_QUEUE_SIZE) {
+        LOG_WRN(MOD_MQTT, "queue", "Queue full! Dropping: %s", topic);
+        return false;
     }
     
-    LOG_WRN(MOD_MQTT, "queue", "Queue full! Dropping: %s", topic);
-    return false;
+    uint8_t i = (_queueHead + _queueCount) % MQTT_QUEUE_SIZE;
+    
+    strncpy(_queue[i].topic, topic, MQTT_TOPIC_MAX_LEN - 1);
+    _queue[i].topic[MQTT_TOPIC_MAX_LEN - 1] = '\0';
+    
+    strncpy(_queue[i].payload, payload, MQTT_PAYLOAD_MAX - 1);
+    _queue[i].payload[MQTT_PAYLOAD_MAX - 1] = '\0';
+    
+    _queue[i].qos = qos;
+    _queue[i].retain = retain;
+    _queueCount++;
+    
+    LOG_DBG(MOD_MQTT, "queue", "Queued [%d]: %s", i, topic);
+    return true;
 }
 
 void MqttManager::_flushQueue() {
     uint8_t flushed = 0;
     
-    for (int i = 0; i < MQTT_QUEUE_SIZE; i++) {
-        if (_queue[i].used) {
-            if (_client.publish(_queue[i].topic, _queue[i].payload, _queue[i].retain)) {
-                LOG_DBG(MOD_MQTT, "flush", "Sent [%d]: %s", i, _queue[i].topic);
-                _queue[i].used = false;
-                flushed++;
-            } else {
-                LOG_WRN(MOD_MQTT, "flush", "Failed [%d]: %s", i, _queue[i].topic);
-            }
+    // Oldest first; stop when the in-flight window is full (PUBACKs pending)
+    while (_queueCount > 0) {
+        QueuedMessage& msg = _queue[_queueHead];
+        
+        bool sent;
+        if (msg.qos > 0) {
+            if (!_client.canPublishQos1()) break;
+            sent = _client.publishQos1(msg.topic, msg.payload, msg.retain) != 0;
+        } else {
+            sent = _client.publish(msg.topic, msg.payload, msg.retain);
+        }
+        
+        if (!sent) {
+            LOG_WRN(MOD_MQTT, "flush", "Failed [%d]: %s", _queueHead, msg.topic);
+            break;
         }
+        
+        LOG_DBG(MOD_MQTT, "flush", "Sent [%d]: %s", _queueHead, msg.topic);
+        _queueHead = (_queueHead + 1) % MQTT_QUEUE_SIZE;
+        _queueCount--;
+        flushed++;
     }
     
     if (flushed > 0) {
@@ -380,8 +621,8 @@ void MqttManager::_flushQueue() {
 
 void MqttManager::_resubscribeAll() {
     for (uint8_t i = 0; i < _subscriptionCount; i++) {
-        _client.subscribe(_subscriptions[i].c_str(), _subscriptionQos[i]);
-        LOG_DBG(MOD_MQTT, "resub", "<- %s", _subscriptions[i].c_str());
+        _client.subscribe(_subscriptions[i], _subscriptionQos[i]);
+        LOG_DBG(MOD_MQTT, "resub", "<- %s", _subscriptions[i]);
     }
     
     if (_subscriptionCount > 0) {
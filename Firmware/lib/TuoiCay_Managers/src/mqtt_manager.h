@@ -6,7 +6,16 @@
  * - Connect to broker with LWT (Last Will Testament)
  * - Auto-reconnect with exponential backoff
  * - Offline message queue (max 10 messages)
- * - QoS support for publish/subscribe
+ * - QoS 1 publish tracked until PUBACK (bounded in-flight window)
+ * - Queue doubles as backlog while the in-flight window is full
+ * - Connect is a state machine driven by update(): TCP (TcpConnector)
+ *   -> CONNECT sent -> CONNACK; loop() is never blocked while waiting
+ * - Port MQTT_TLS_PORT selects TLS (BearSSL) pinned to the CA or
+ *   fingerprint stored in LittleFS; the TLS session is cached so
+ *   reconnects use an abbreviated handshake
+ * - TLS is outside the loop() latency budget: the handshake blocks (up
+ *   to MQTT_TLS_TIMEOUT_MS), only after a non-blocking TCP check found
+ *   the broker reachable. MFLN is probed once per broker and remembered
  * 
  * RULES: #MQTT(9) #ERROR(6)
  */
@@ -16,8 +25,10 @@
 
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
-#include <PubSubClient.h>
+#include <WiFiClientSecure.h>
 #include <config.h>
+#include "mqtt_client.h"
+#include "tcp_connector.h"
 
 //=============================================================================
 // MQTT STATE ENUM
@@ -33,20 +44,18 @@ enum class MqttState : uint8_t {
 // OFFLINE MESSAGE QUEUE
 //=============================================================================
 #define MQTT_QUEUE_SIZE     10      // Max messages in offline queue
-#define MQTT_TOPIC_MAX_LEN  64      // Max topic length
-#define MQTT_PAYLOAD_MAX    256     // Max payload length
 
 struct QueuedMessage {
     char topic[MQTT_TOPIC_MAX_LEN];
     char payload[MQTT_PAYLOAD_MAX];
     uint8_t qos;
     bool retain;
-    bool used;
 };
 
 //=============================================================================
 // CALLBACK TYPES
 //=============================================================================
+// payload is NUL-terminated (payload[length] == '\0')
 typedef void (*MqttMessageCallback)(const char* topic, const uint8_t* payload, unsigned int length);
 typedef void (*MqttEventCallback)(MqttState newState);
 
@@ -95,7 +104,7 @@ public:
     /**
      * @brief Update MQTT state (call in loop)
      * Handles:
-     * - Connection timeout
+     * - Connect progress (TCP handshake, CONNACK) and timeout
      * - Reconnection with exponential backoff
      * - Process incoming messages
      * - Flush offline queue when connected
@@ -103,7 +112,7 @@ public:
     void update();
     
     /**
-     * @brief Alias for update() - compatibility with PubSubClient
+     * @brief Alias for update() - compatibility with PubSubClient API
      */
     void loop() { update(); }
     
@@ -111,10 +120,10 @@ public:
      * @brief Publish message to topic
      * @param topic Topic string (without deviceId prefix)
      * @param payload Message payload
-     * @param qos QoS level (0, 1, or 2)
+     * @param qos QoS level (0 or 1; 2 is sent as 1)
      * @param retain Retain flag
      * @param addPrefix Add deviceId prefix to topic
-     * @return true if published or queued (if offline)
+     * @return true if published, handed to the in-flight window or queued
      */
     bool publish(const char* topic, const char* payload, uint8_t qos = 0, bool retain = false, bool addPrefix = true);
     
@@ -127,6 +136,14 @@ public:
      */
     bool subscribe(const char* topic, uint8_t qos = 0, bool addPrefix = true);
     
+    /**
+     * @brief Unsubscribe and forget topic (no resubscribe after reconnect)
+     * @param topic Topic string (without deviceId prefix)
+     * @param addPrefix Add deviceId prefix to topic
+     * @return true if removed
+     */
+    bool unsubscribe(const char* topic, bool addPrefix = true);
+    
     /**
      * @brief Check if connected to broker
      */
@@ -150,7 +167,18 @@ public:
     /**
      * @brief Get number of queued messages
      */
-    uint8_t getQueuedCount() const;
+    uint8_t getQueuedCount() const { return _queueCount; }
+    
+    /**
+     * @brief Get number of QoS 1 messages waiting for PUBACK
+     */
+    uint8_t getInflightCount() const { return _client.getInflightCount(); }
+    
+    /**
+     * @brief Inside the message callback: the message is a retained copy
+     *        (may be old), not a live publish
+     */
+    bool isRetained() const { return _client.isRetained(); }
     
     /**
      * @brief Set callback for incoming messages
@@ -163,14 +191,34 @@ public:
     void setEventCallback(MqttEventCallback callback) { _eventCallback = callback; }
     
     /**
-     * @brief Get reconnect attempt count
+     * @brief Get reconnect attempt count (current backoff, 0 once connected)
      */
     uint8_t getReconnectCount() const { return _reconnectCount; }
     
     /**
-     * @brief Get PubSubClient for advanced usage
+     * @brief Get reconnect attempts since boot (never reset)
+     */
+    uint32_t getReconnectTotal() const { return _reconnectTotal; }
+    
+    /**
+     * @brief Check if TLS transport is used
+     */
+    bool isTls() const { return _useTls; }
+    
+    /**
+     * @brief Duration of last TCP + TLS handshake (ms)
+     */
+    uint32_t getTlsHandshakeMs() const { return _tlsHandshakeMs; }
+    
+    /**
+     * @brief Heap taken by the TLS session after last handshake (bytes)
      */
-    PubSubClient& getClient() { return _client; }
+    uint32_t getTlsHeapUsed() const { return _tlsHeapUsed; }
+    
+    /**
+     * @brief Get MQTT client for advanced usage
+     */
+    MqttClient& getClient() { return _client; }
 
     /**
      * @brief Build full topic with device prefix
@@ -181,8 +229,42 @@ public:
     void buildTopic(const char* topic, char* buffer, size_t bufSize);
 
 private:
+    // Steps of a connection attempt while _state == CONNECTING
+    enum class ConnectPhase : uint8_t {
+        NONE = 0,           // No attempt in progress
+        TCP = 1,            // DNS + TCP handshake
+        CONNACK = 2         // CONNECT sent, waiting for broker
+    };
+    
+    // How the broker certificate is verified
+    enum class TlsPin : uint8_t {
+        NONE = 0,           // Not configured yet
+        CA = 1,             // Chain must end at MQTT_CA_FILE
+        FINGERPRINT = 2,    // Leaf cert SHA1 must match MQTT_FP_FILE
+        INSECURE = 3        // No check (MQTT_TLS_ALLOW_INSECURE builds only)
+    };
+    
+    // Broker answer to the MFLN probe (kept until the broker changes)
+    enum class TlsMfln : uint8_t {
+        UNKNOWN = 0,        // Not probed yet
+        ACCEPTED = 1,       // Small buffers
+        REFUSED = 2         // Full size RX buffer
+    };
+    
     WiFiClient _wifiClient;
-    PubSubClient _client;
+    MqttClient _client;
+    TcpConnector _connector;
+    ConnectPhase _connectPhase;
+    
+    // TLS transport (used when port == MQTT_TLS_PORT)
+    BearSSL::WiFiClientSecure _secureClient;
+    BearSSL::Session _tlsSession;       // Reused for session resumption
+    BearSSL::X509List _tlsTrustAnchors;
+    bool _useTls;
+    TlsPin _tlsPin;
+    TlsMfln _tlsMfln;
+    uint32_t _tlsHandshakeMs;
+    uint32_t _tlsHeapUsed;
     
     String _broker;
     uint16_t _port;
@@ -198,24 +280,72 @@ private:
     unsigned long _lastReconnectTime;   // Last reconnect attempt
     unsigned long _reconnectDelay;      // Current backoff delay
     uint8_t _reconnectCount;            // Number of reconnect attempts
+    uint32_t _reconnectTotal;           // Reconnect attempts since boot
     
     bool _initialized;
     bool _hasCredentials;
     
-    // Offline message queue
+    // Offline message queue (FIFO ring buffer)
     QueuedMessage _queue[MQTT_QUEUE_SIZE];
+    uint8_t _queueHead;
+    uint8_t _queueCount;
     
     // Topics to resubscribe after reconnect
     static const uint8_t MAX_SUBSCRIPTIONS = 10;
-    String _subscriptions[MAX_SUBSCRIPTIONS];
+    char _subscriptions[MAX_SUBSCRIPTIONS][MQTT_TOPIC_MAX_LEN];
     uint8_t _subscriptionQos[MAX_SUBSCRIPTIONS];
     uint8_t _subscriptionCount;
     
+    /**
+     * @brief Build full topic, optionally with devices/{id}/ prefix
+     */
+    void _fullTopic(const char* topic, bool addPrefix, char* buffer, size_t bufSize);
+    
     /**
      * @brief Handle state transition
      */
     void _setState(MqttState newState);
     
+    /**
+     * @brief Advance connection attempt (called from update())
+     */
+    void _updateConnecting();
+    
+    /**
+     * @brief Load pins from LittleFS (first connect only)
+     * @return true if TLS can be used
+     */
+    bool _configureTls();
+    
+    /**
+     * @brief Size TLS buffers from the broker's MFLN answer (blocking,
+     *        first connect to a broker only)
+     */
+    void _probeMfln();
+    
+    /**
+     * @brief Open TCP + TLS connection (blocks for the handshake; call once
+     *        the broker answered the non-blocking TCP check)
+     * @return true if secure channel is up
+     */
+    bool _connectTls();
+    
+    /**
+     * @brief Send CONNECT with LWT once TCP is up
+     * @return true if CONNECT was written
+     */
+    bool _sendConnect();
+    
+    /**
+     * @brief Broker accepted: publish status, resubscribe, flush queue
+     */
+    void _onConnected();
+    
+    /**
+     * @brief Attempt failed: schedule retry with backoff
+     */
+    void _onConnectFailed(const char* reason);
+    
     /**
      * @brief Calculate next backoff delay
      */
@@ -227,7 +357,7 @@ private:
     bool _queueMessage(const char* topic, const char* payload, uint8_t qos, bool retain);
     
     /**
-     * @brief Flush queued messages
+     * @brief Flush queued messages (QoS 1 only as fast as the window allows)
      */
     void _flushQueue();
     
@@ -242,7 +372,7 @@ private:
     void _publishOnlineStatus();
     
     /**
-     * @brief Static callback wrapper for PubSubClient
+     * @brief Static callback wrapper for MqttClient
      */
     static void _staticCallback(char* topic, uint8_t* payload, unsigned int length);
     
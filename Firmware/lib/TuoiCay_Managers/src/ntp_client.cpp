@@ -0,0 +1,150 @@
+/**
+ * @file ntp_client.cpp
+ * @brief Implementation of the multi-server SNTP client
+ *
+ * LOGIC:
+ * - T1 is read right before the packet is written and T4 right after
+ *   parsePacket() sees it, so loop() latency inflates the measured delay
+ *   (and the error bound) instead of biasing the offset
+ * - Replies from another address or to an older request are dropped; the
+ *   server keeps waiting until its timeout
+ *
+ * RULES: #TIME(12)
+ */
+
+#include "ntp_client.h"
+#include <ESP8266WiFi.h>
+#include <sys/time.h>
+#include <logger.h>
+
+//=============================================================================
+// NTP CLIENT IMPLEMENTATION
+//=============================================================================
+
+NtpClient::NtpClient() : _udpOpen(false), _current(-1), _best(-1), _finished(false), _sentMs(0) {
+    for (uint8_t i = 0; i < NTP_SERVER_COUNT; i++) {
+        _servers[i] = NtpServerStats();     // Zeroed, IPAddress constructed
+    }
+    memset(_request, 0, sizeof(_request));
+}
+
+void NtpClient::begin(const char* server1, const char* server2, const char* server3) {
+    const char* hosts[NTP_SERVER_COUNT] = { server1, server2, server3 };
+    for (uint8_t i = 0; i < NTP_SERVER_COUNT; i++) {
+        _servers[i].host = hosts[i];
+    }
+}
+
+bool NtpClient::startRound() {
+    if (busy() || WiFi.status() != WL_CONNECTED) return false;
+    
+    if (!_udpOpen) {
+        _udpOpen = _udp.begin(NTP_LOCAL_PORT);
+        if (!_udpOpen) {
+            LOG_ERR(MOD_TIME, "ntp", "UDP port %d unavailable", NTP_LOCAL_PORT);
+            return false;
+        }
+    }
+    
+    for (uint8_t i = 0; i < NTP_SERVER_COUNT; i++) {
+        _servers[i].fresh = false;
+    }
+    _best = -1;
+    _current = 0;
+    if (!_sendNext()) {
+        _current = -1;
+        _finished = true;       // Nothing sent (DNS): report on next update()
+    }
+    return true;
+}
+
+bool NtpClient::update() {
+    if (!busy()) {
+        bool finished = _finished;
+        _finished = false;
+        return finished;
+    }
+    
+    NtpServerStats& s = _servers[_current];
+    int size = _udp.parsePacket();
+    if (size > 0) {
+        int64_t t4 = _nowUs();
+        uint8_t packet[NTP_PACKET_SIZE];
+        int length = _udp.read(packet, sizeof(packet));
+        _udp.flush();
+        
+        // Stray datagram, or a late reply to an earlier request: keep waiting
+        if ((uint32_t)_udp.remoteIP() != (uint32_t)s.ip ||
+            (length >= NTP_PACKET_SIZE && memcmp(&packet[24], &_request[40], 8) != 0)) {
+            return false;
+        }
+        
+        NtpSample sample;
+        const char* error = ntpParseResponse(packet, length > 0 ? length : 0, _request, t4, sample);
+        if (error) {
+            _fail(s, error);
+        } else {
+            s.sample = sample;
+            s.fresh = true;
+            s.answered++;
+            s.failStreak = 0;
+            s.lastError = nullptr;
+            if (_best < 0 || sample.delayUs < _servers[_best].sample.delayUs) {
+                _best = _current;
+            }
+            LOG_DBG(MOD_TIME, "ntp", "%s: offset %ld ms, delay %ld ms, stratum %d", s.host,
+                    (long)(sample.offsetUs / 1000), (long)(sample.delayUs / 1000), sample.stratum);
+        }
+    } else if (millis() - _sentMs < NTP_TIMEOUT_MS) {
+        return false;
+    } else {
+        _fail(s, "timeout");
+    }
+    
+    _current++;
+    if (_sendNext()) return false;
+    
+    _current = -1;
+    return true;
+}
+
+bool NtpClient::_sendNext() {
+    for (; _current < NTP_SERVER_COUNT; _current++) {
+        NtpServerStats& s = _servers[_current];
+        if (!s.host || s.host[0] == '\0') continue;
+        
+        if (!s.resolved) {
+            s.resolved = WiFi.hostByName(s.host, s.ip, NTP_DNS_TIMEOUT_MS) == 1;
+            if (!s.resolved) {
+                _fail(s, "DNS failed");
+                continue;
+            }
+        }
+        
+        ntpBuildRequest(_request, _nowUs());
+        if (!_udp.beginPacket(s.ip, NTP_PORT) ||
+            _udp.write(_request, NTP_PACKET_SIZE) != NTP_PACKET_SIZE ||
+            !_udp.endPacket()) {
+            _fail(s, "send failed");
+            continue;
+        }
+        _sentMs = millis();
+        return true;
+    }
+    return false;
+}
+
+void NtpClient::_fail(NtpServerStats& s, const char* error) {
+    s.failed++;
+    s.lastError = error;
+    if (++s.failStreak >= 2) {
+        s.resolved = false;     // Resolve again next round
+    }
+    LOG_DBG(MOD_TIME, "ntp", "%s: %s", s.host, error);
+}
+
+int64_t NtpClient::_nowUs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
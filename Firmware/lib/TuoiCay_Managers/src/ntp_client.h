@@ -0,0 +1,106 @@
+/**
+ * @file ntp_client.h
+ * @brief Non-blocking SNTP client that measures every configured server
+ *
+ * LOGIC:
+ * - A round queries NTP_SERVER_1..3 one after another over one UDP
+ *   socket; each gets NTP_TIMEOUT_MS to answer, update() only polls
+ * - Per server: last offset, round-trip delay, stratum, answer / failure
+ *   counts (kept across rounds for /api/status)
+ * - Best server of a round = answered this round with the lowest delay
+ *   (its offset has the smallest error bound, delay / 2)
+ * - Host names are resolved once and cached; a server that fails twice in
+ *   a row is resolved again (pool.ntp.org rotates addresses). DNS is the
+ *   only blocking call, bounded by NTP_DNS_TIMEOUT_MS
+ * - The client only measures: TimeManager decides how to apply the result
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef NTP_CLIENT_H
+#define NTP_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <ntp_packet.h>
+
+#define NTP_SERVER_COUNT    3
+#define NTP_TIMEOUT_MS      1500    // Per server
+#define NTP_DNS_TIMEOUT_MS  2000
+#define NTP_LOCAL_PORT      4123
+
+/**
+ * @brief What one server answered (last round it took part in)
+ */
+struct NtpServerStats {
+    const char* host;
+    IPAddress ip;
+    bool resolved;
+    bool fresh;                 // Answered in the last round
+    NtpSample sample;           // Valid when answered > 0
+    uint16_t answered;
+    uint16_t failed;
+    uint8_t failStreak;
+    const char* lastError;      // nullptr = last query answered
+};
+
+//=============================================================================
+// NTP CLIENT CLASS
+//=============================================================================
+
+/**
+ * @class NtpClient
+ * @brief Query rounds over NTP_SERVER_COUNT servers, best answer picked
+ */
+class NtpClient {
+public:
+    NtpClient();
+    
+    void begin(const char* server1, const char* server2, const char* server3);
+    
+    /**
+     * @brief Start a round (needs WiFi)
+     * @return false if one is running or WiFi is down
+     */
+    bool startRound();
+    
+    bool busy() const { return _current >= 0; }
+    
+    /**
+     * @brief Poll the socket / timeout (call in loop)
+     * @return true once when a round has finished (see best())
+     */
+    bool update();
+    
+    /**
+     * @brief Best server of the last round (-1 = none answered)
+     */
+    int8_t best() const { return _best; }
+    
+    const NtpServerStats& server(uint8_t i) const { return _servers[i]; }
+
+private:
+    NtpServerStats _servers[NTP_SERVER_COUNT];
+    WiFiUDP _udp;
+    bool _udpOpen;
+    int8_t _current;            // Server being queried (-1 = idle)
+    int8_t _best;
+    bool _finished;             // Round ended without a reply to wait for
+    uint8_t _request[NTP_PACKET_SIZE];
+    unsigned long _sentMs;
+    
+    /**
+     * @brief Query servers from _current on until one is sent or none left
+     * @return false when the round is over
+     */
+    bool _sendNext();
+    
+    void _fail(NtpServerStats& s, const char* error);
+    
+    /**
+     * @brief Our clock, us since 1970
+     */
+    static int64_t _nowUs();
+};
+
+#endif // NTP_CLIENT_H
@@ -13,6 +13,7 @@
 #include "ota_manager.h"
 #include <logger.h>
 #include <pins.h>
+#include "time_manager.h"     // persist() before the post-update restart
 
 // Global instance
 OtaManager otaManager;
@@ -87,6 +88,9 @@ void OtaManager::_setupCallbacks() {
             digitalWrite(PIN_LED_STATUS, LED_ON);
             delay(100);
         }
+        
+        // ArduinoOTA restarts next: keep the clock for the new firmware
+        timeManager.persist();
     });
     
     // On progress
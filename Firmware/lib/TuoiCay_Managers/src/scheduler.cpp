@@ -3,10 +3,16 @@
  * @brief Implementation of Watering Scheduler
  * 
  * LOGIC:
- * - Check time every loop iteration
- * - Trigger only once per minute (prevent multiple triggers)
+ * - update(): SchedulePlan::poll() returns NONE after one compare while
+ *   nothing is due; otherwise events are handled until it does
+ * - Run history is written to flash only when poll() changed it (a slot
+ *   was handled or a new entry got its baseline)
+ * - Next-run text marked stale on every plan change and minute edge;
+ *   /api/state polls then cost no localtime_r()
  * - Check moisture before watering (skip if wet)
- * - Auto-stop after duration
+ * - Duration callback last: the budget only sees runs that would start
+ * - A run still going when its entry comes due again is the arbiter's
+ *   duplicate; another entry due meanwhile waits there in line
  * 
  * RULES: #TIME(12) #ACTUATOR(15)
  */
@@ -28,20 +34,21 @@ bool Scheduler::begin() {
     
     _config.setDefaults();
     _moistureCb = nullptr;
-    _pumpCb = nullptr;
-    _isWatering = false;
-    _lastCheckedMinute = 255;  // Invalid value to trigger first check
-    _currentEntryIndex = 0;
-    _wateringStartTime = 0;
-    _wateringDuration = 0;
-    
-    // Load saved schedule
+    _runCb = nullptr;
+    _durationCb = nullptr;
+    _nextRunStale = true;
+    timeManager.onChange(_onTimeChange);
+    
+    // Load saved schedule and its run history
     loadSchedule();
+    time_t lastRun[MAX_SCHEDULE_ENTRIES];
+    storage.loadScheduleRuns(lastRun, MAX_SCHEDULE_ENTRIES);
+    _plan.setLastRuns(lastRun, MAX_SCHEDULE_ENTRIES);
     
     _initialized = true;
     
-    LOG_INF(MOD_SCHED, "init", "Scheduler ready (enabled=%d, entries=%d)",
-            _config.enabled, getEnabledCount());
+    LOG_INF(MOD_SCHED, "init", "Scheduler ready (enabled=%d, entries=%d/%d)",
+            _config.enabled, getEnabledCount(), _config.count);
     
     return true;
 }
@@ -49,59 +56,73 @@ bool Scheduler::begin() {
 void Scheduler::update() {
     if (!_initialized) return;
     
-    // Check if currently watering (scheduled)
-    if (_isWatering) {
-        // Check if duration elapsed
-        if (millis() - _wateringStartTime >= _wateringDuration * 1000UL) {
-            _stopWatering();
-        }
+    // Don't plan on a clock that was never set, nor while disabled
+    if (!_config.enabled || !timeManager.isSynced()) return;
+    
+    ScheduleRun run;
+    ScheduleEvent event;
+    while ((event = _plan.poll(timeManager.getEpoch(), run)) != ScheduleEvent::NONE) {
+        _nextRunStale = true;
+        _handle(event, run);
+    }
+    
+    if (_plan.takeDirty()) {
+        storage.saveScheduleRuns(_plan.lastRuns(), _config.count);
+    }
+}
+
+void Scheduler::_handle(ScheduleEvent event, const ScheduleRun& run) {
+    if (event == ScheduleEvent::REPLANNED) {
+        LOG_INF(MOD_SCHED, "plan", "Planned %d entries (%d gave up missed slots), next: %s",
+                _config.count, run.index, getNextScheduleString());
+        return;
+    }
+    
+    time_t late = timeManager.getEpoch() - run.due;
+    if (event == ScheduleEvent::MISSED) {
+        LOG_WRN(MOD_SCHED, "skip", "Schedule #%d missed by %lds, skipped", run.index, (long)late);
+        return;
+    }
+    
+    if (late > SCHEDULE_LATE_MAX_SEC) {
+        LOG_INF(MOD_SCHED, "trigger", "Schedule #%d catching up (%ld min late)",
+                run.index, (long)(late / 60));
+    } else {
+        LOG_INF(MOD_SCHED, "trigger", "Schedule #%d triggered at %s",
+                run.index, timeManager.getTimeString().c_str());
+    }
+    
+    // Check if soil needs water
+    if (_moistureCb && !_moistureCb()) {
+        LOG_INF(MOD_SCHED, "skip", "Skipping - soil is wet enough");
         return;
     }
     
-    // Don't check if scheduler is disabled
-    if (!_config.enabled) return;
-    
-    // Don't check if time not synced
-    if (!timeManager.isSynced()) return;
-    
-    // Get current time
-    uint8_t currentHour = timeManager.getHour();
-    uint8_t currentMinute = timeManager.getMinute();
-    
-    // Only check once per minute
-    if (currentMinute == _lastCheckedMinute) return;
-    _lastCheckedMinute = currentMinute;
-    
-    // Check each schedule entry
-    for (uint8_t i = 0; i < MAX_SCHEDULE_ENTRIES; i++) {
-        if (!_config.entries[i].enabled) continue;
-        
-        if (_matchesTime(_config.entries[i])) {
-            LOG_INF(MOD_SCHED, "trigger", "Schedule #%d triggered at %02d:%02d",
-                    i, currentHour, currentMinute);
-            
-            // Check if soil needs water
-            if (_moistureCb && !_moistureCb()) {
-                LOG_INF(MOD_SCHED, "skip", "Skipping - soil is wet enough");
-                continue;
-            }
-            
-            // Start watering
-            _startWatering(i);
-            break;  // Only one schedule at a time
+    uint16_t duration = _config.entries[run.index].duration;
+    if (_durationCb) {
+        duration = _durationCb(run.index, duration);
+        if (duration == 0) {
+            LOG_INF(MOD_SCHED, "skip", "Skipping - water budget");
+            return;
         }
     }
+    
+    LOG_INF(MOD_SCHED, "start", "Schedule #%d: %ds", run.index, duration);
+    if (!_runCb || !_runCb(run.index, duration)) {
+        LOG_INF(MOD_SCHED, "skip", "Skipping - schedule #%d not taken by the pump", run.index);
+    }
 }
 
 bool Scheduler::loadSchedule() {
-    if (storage.loadSchedule(_config)) {
+    bool loaded = storage.loadSchedule(_config);
+    if (!loaded) {
+        LOG_WRN(MOD_SCHED, "load", "No saved schedule, using defaults");
+        _config.setDefaults();
+    } else {
         LOG_INF(MOD_SCHED, "load", "Schedule loaded from storage");
-        return true;
     }
-    
-    LOG_WRN(MOD_SCHED, "load", "No saved schedule, using defaults");
-    _config.setDefaults();
-    return false;
+    _plan.attach(_config.entries, _config.count);
+    return loaded;
 }
 
 bool Scheduler::saveSchedule() {
@@ -115,99 +136,102 @@ bool Scheduler::saveSchedule() {
 }
 
 void Scheduler::setEnabled(bool enabled) {
+    if (enabled && !_config.enabled) {
+        _plan.forget();     // Slots while disabled are not caught up
+    }
     _config.enabled = enabled;
+    _nextRunStale = true;
     LOG_INF(MOD_SCHED, "cfg", "Scheduler %s", enabled ? "ENABLED" : "DISABLED");
 }
 
-ScheduleEntry* Scheduler::getEntry(uint8_t index) {
-    if (index >= MAX_SCHEDULE_ENTRIES) return nullptr;
+const ScheduleEntry* Scheduler::getEntry(uint8_t index) const {
+    if (index >= _config.count) return nullptr;
     return &_config.entries[index];
 }
 
-void Scheduler::setEntry(uint8_t index, uint8_t hour, uint8_t minute,
-                         uint16_t duration, bool enabled) {
-    if (index >= MAX_SCHEDULE_ENTRIES) return;
-    
-    _config.entries[index].hour = hour;
-    _config.entries[index].minute = minute;
-    _config.entries[index].duration = duration;
-    _config.entries[index].enabled = enabled;
+void Scheduler::setConfig(const ScheduleConfig& config) {
+    _config = config;
+    if (_config.count > MAX_SCHEDULE_ENTRIES) {
+        _config.count = MAX_SCHEDULE_ENTRIES;
+    }
+    _plan.attach(_config.entries, _config.count);
+    _plan.forget();
+    _nextRunStale = true;
+    LOG_INF(MOD_SCHED, "cfg", "Schedule replaced (enabled=%d, entries=%d)",
+            _config.enabled, _config.count);
+}
+
+void Scheduler::setEntries(const ScheduleEntry* entries, uint8_t count) {
+    if (count > MAX_SCHEDULE_ENTRIES) {
+        count = MAX_SCHEDULE_ENTRIES;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        _config.entries[i] = entries[i];
+    }
+    for (uint8_t i = count; i < MAX_SCHEDULE_ENTRIES; i++) {
+        _config.entries[i].setDefaults();
+    }
+    _config.count = count;
+    _plan.attach(_config.entries, _config.count);
+    _plan.forget();
+    _nextRunStale = true;
+    
+    for (uint8_t i = 0; i < count; i++) {
+        const ScheduleEntry& e = entries[i];
+        LOG_INF(MOD_SCHED, "cfg", "Entry #%d: %s %02d:%02d, days=0x%02X, %ds, catch-up %s, %s",
+                i, scheduleKindName(e.kind), e.hour, e.minute, e.days, e.duration,
+                catchUpPolicyName(e.catchUp), e.enabled ? "ON" : "OFF");
+    }
+}
+
+void Scheduler::setSunCallback(ScheduleSunFunc cb) {
+    _plan.setSunFunc(cb);
+    _nextRunStale = true;
+}
+
+void Scheduler::_onTimeChange(uint8_t changes, const struct tm& now) {
+    scheduler._nextRunStale = true;
     
-    LOG_INF(MOD_SCHED, "cfg", "Entry #%d: %02d:%02d, %ds, %s",
-            index, hour, minute, duration, enabled ? "ON" : "OFF");
+    // New TZ or location: same slots fall on other epochs; history keeps
+    // handled ones
+    if (changes & (TIME_CHANGE_ZONE | TIME_CHANGE_SUN)) {
+        scheduler._plan.invalidate();
+    }
 }
 
 uint8_t Scheduler::getEnabledCount() const {
     uint8_t count = 0;
-    for (uint8_t i = 0; i < MAX_SCHEDULE_ENTRIES; i++) {
+    for (uint8_t i = 0; i < _config.count; i++) {
         if (_config.entries[i].enabled) count++;
     }
     return count;
 }
 
-String Scheduler::getNextScheduleString() const {
-    if (!_config.enabled) return "Disabled";
-    
-    uint8_t currentHour = timeManager.getHour();
-    uint8_t currentMinute = timeManager.getMinute();
-    
-    // Find next schedule
-    int bestIndex = -1;
-    int bestDiff = 24 * 60 + 1;  // Max minutes in a day + 1
-    
-    for (uint8_t i = 0; i < MAX_SCHEDULE_ENTRIES; i++) {
-        if (!_config.entries[i].enabled) continue;
-        
-        int schedMinutes = _config.entries[i].hour * 60 + _config.entries[i].minute;
-        int currentMinutes = currentHour * 60 + currentMinute;
-        
-        int diff = schedMinutes - currentMinutes;
-        if (diff <= 0) diff += 24 * 60;  // Wrap to next day
-        
-        if (diff < bestDiff) {
-            bestDiff = diff;
-            bestIndex = i;
-        }
-    }
-    
-    if (bestIndex < 0) return "None";
-    
-    char buf[12];
-    snprintf(buf, sizeof(buf), "%02d:%02d",
-             _config.entries[bestIndex].hour,
-             _config.entries[bestIndex].minute);
-    return String(buf);
+time_t Scheduler::getNextRunEpoch() const {
+    return _config.enabled ? _plan.nextEpoch() : 0;
 }
 
-bool Scheduler::_matchesTime(const ScheduleEntry& entry) const {
-    return (entry.hour == timeManager.getHour() &&
-            entry.minute == timeManager.getMinute());
-}
-
-void Scheduler::_startWatering(uint8_t entryIndex) {
-    if (entryIndex >= MAX_SCHEDULE_ENTRIES) return;
-    
-    _currentEntryIndex = entryIndex;
-    _wateringDuration = _config.entries[entryIndex].duration;
-    _wateringStartTime = millis();
-    _isWatering = true;
+const char* Scheduler::getNextScheduleString() const {
+    if (!_config.enabled) return "Disabled";
+    if (!_plan.isPlanned()) return timeManager.isSynced() ? "Pending" : "No time";
     
-    LOG_INF(MOD_SCHED, "start", "Starting scheduled watering for %ds",
-            _wateringDuration);
+    if (!_nextRunStale) return _nextRunText;
+    _nextRunStale = false;
     
-    // Turn on pump via callback
-    if (_pumpCb) {
-        _pumpCb(true, _wateringDuration);
+    time_t next = getNextRunEpoch();
+    if (next == 0) {
+        strcpy(_nextRunText, "None");
+        return _nextRunText;
     }
-}
-
-void Scheduler::_stopWatering() {
-    LOG_INF(MOD_SCHED, "stop", "Scheduled watering complete");
     
-    _isWatering = false;
+    struct tm t;
+    localtime_r(&next, &t);
     
-    // Turn off pump via callback
-    if (_pumpCb) {
-        _pumpCb(false, 0);
+    if (next - timeManager.getEpoch() < 24 * 3600L) {
+        snprintf(_nextRunText, sizeof(_nextRunText), "%02d:%02d", t.tm_hour, t.tm_min);
+    } else {
+        snprintf(_nextRunText, sizeof(_nextRunText), "%04d-%02d-%02d %02d:%02d",
+                 t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min);
     }
+    return _nextRunText;
 }
@@ -3,10 +3,26 @@
  * @brief Watering Schedule Manager
  * 
  * LOGIC:
- * - Schedule watering at specific times
+ * - Up to MAX_SCHEDULE_ENTRIES entries: daily, every N hours, sunrise /
+ *   sunset relative; each with a weekday mask and optional date range
+ * - Next-event engine (SchedulePlan, schedule_plan.h): next fire epochs in
+ *   a sorted queue, so update() only compares the clock with its head
+ * - Last run epoch per entry persisted (SCHEDULE_RUNS_FILE) whenever it
+ *   changes; after a reboot, a late first NTP sync or a clock jump, each
+ *   entry's catch-up policy (skip / within N minutes / always) decides
+ *   whether its newest missed slot still runs, once
+ * - Clock stepping back never fires a slot twice (planning starts after
+ *   the last run)
+ * - Replacing entries or re-enabling the schedule drops the history:
+ *   slots from before the change are not caught up
  * - Skip if soil is already wet enough
- * - Multiple schedule entries support
- * - Integrates with TimeManager for time checks
+ * - Next-run text (polled by the dashboard) is formatted once and reused
+ *   until the plan changes or the minute changes (TimeManager event)
+ * - Duration callback may scale the entry duration (water budget) or
+ *   skip the run (returns 0)
+ * - Due runs go to the run callback (irrigation arbiter), which owns the
+ *   pump and the run's length: the scheduler only decides when and how
+ *   long, so no watering state is kept here that could drift from the pump
  * 
  * RULES: #TIME(12) #ACTUATOR(15)
  */
@@ -17,12 +33,14 @@
 #include <Arduino.h>
 #include <storage_manager.h>
 #include <time_manager.h>
+#include <schedule_plan.h>
 
 //=============================================================================
 // SCHEDULER CALLBACKS
 //=============================================================================
 typedef bool (*SchedulerMoistureCallback)();    // Returns true if soil needs water
-typedef void (*SchedulerPumpCallback)(bool on, uint16_t duration);  // Control pump
+typedef bool (*SchedulerRunCallback)(uint8_t index, uint16_t duration);  // false = not taken
+typedef uint16_t (*SchedulerDurationCallback)(uint8_t index, uint16_t duration);  // 0 = skip run
 
 //=============================================================================
 // SCHEDULER CLASS
@@ -42,7 +60,7 @@ public:
     
     /**
      * @brief Update scheduler (call in loop)
-     * Checks if it's time to water
+     * Fast path is one compare of time(nullptr) with the queue head
      */
     void update();
     
@@ -68,25 +86,24 @@ public:
     
     /**
      * @brief Get schedule entry
-     * @param index Entry index (0 to MAX_SCHEDULE_ENTRIES-1)
+     * @param index Entry index (0 to count-1)
      */
-    ScheduleEntry* getEntry(uint8_t index);
+    const ScheduleEntry* getEntry(uint8_t index) const;
     
     /**
-     * @brief Set schedule entry
-     * @param index Entry index
-     * @param hour Hour (0-23)
-     * @param minute Minute (0-59)
-     * @param duration Duration in seconds
-     * @param enabled Enable this entry
+     * @brief Get schedule config reference
      */
-    void setEntry(uint8_t index, uint8_t hour, uint8_t minute, 
-                  uint16_t duration, bool enabled);
+    const ScheduleConfig& getConfig() const { return _config; }
     
     /**
-     * @brief Get schedule config reference
+     * @brief Replace the whole schedule (entries, count, enabled) and replan
      */
-    ScheduleConfig& getConfig() { return _config; }
+    void setConfig(const ScheduleConfig& config);
+    
+    /**
+     * @brief Replace the entry list, keeping the global enable, and replan
+     */
+    void setEntries(const ScheduleEntry* entries, uint8_t count);
     
     /**
      * @brief Set callback to check if watering is needed
@@ -94,9 +111,19 @@ public:
     void setMoistureCallback(SchedulerMoistureCallback cb) { _moistureCb = cb; }
     
     /**
-     * @brief Set callback to control pump
+     * @brief Set callback that runs (or queues) a due entry
      */
-    void setPumpCallback(SchedulerPumpCallback cb) { _pumpCb = cb; }
+    void setRunCallback(SchedulerRunCallback cb) { _runCb = cb; }
+    
+    /**
+     * @brief Set callback that adjusts a due run's duration (0 = skip it)
+     */
+    void setDurationCallback(SchedulerDurationCallback cb) { _durationCb = cb; }
+    
+    /**
+     * @brief Set sunrise/sunset provider (sun entries need it) and replan
+     */
+    void setSunCallback(ScheduleSunFunc cb);
     
     /**
      * @brief Get number of enabled entries
@@ -104,43 +131,38 @@ public:
     uint8_t getEnabledCount() const;
     
     /**
-     * @brief Get next scheduled time string
+     * @brief Get next scheduled time string (cached per minute)
+     * @return "HH:MM" within 24 h, else "YYYY-MM-DD HH:MM"; points at the
+     *         cache or a literal, valid until the next update()
      */
-    String getNextScheduleString() const;
+    const char* getNextScheduleString() const;
     
     /**
-     * @brief Check if currently in scheduled watering
+     * @brief Epoch of the next planned run (0 = none planned)
      */
-    bool isWatering() const { return _isWatering; }
+    time_t getNextRunEpoch() const;
 
 private:
     ScheduleConfig _config;
+    SchedulePlan _plan;
     SchedulerMoistureCallback _moistureCb;
-    SchedulerPumpCallback _pumpCb;
+    SchedulerRunCallback _runCb;
+    SchedulerDurationCallback _durationCb;
     
     bool _initialized;
-    bool _isWatering;
-    uint8_t _lastCheckedMinute;     // To prevent multiple triggers per minute
-    uint8_t _currentEntryIndex;     // Currently running schedule entry
-    unsigned long _wateringStartTime;
-    uint16_t _wateringDuration;
     
-    /**
-     * @brief Check if current time matches a schedule entry
-     * @param entry Schedule entry to check
-     * @return true if matches
-     */
-    bool _matchesTime(const ScheduleEntry& entry) const;
+    mutable char _nextRunText[20];  // getNextScheduleString() cache
+    mutable bool _nextRunStale;
     
     /**
-     * @brief Start scheduled watering
+     * @brief TimeManager minute edge: next-run text may read differently
      */
-    void _startWatering(uint8_t entryIndex);
+    static void _onTimeChange(uint8_t changes, const struct tm& now);
     
     /**
-     * @brief Stop scheduled watering
+     * @brief Handle one plan event (log, busy / wet / budget checks, start)
      */
-    void _stopWatering();
+    void _handle(ScheduleEvent event, const ScheduleRun& run);
 };
 
 // Global instance
@@ -4,7 +4,9 @@
  * 
  * LOGIC:
  * - Each config type stored in separate JSON file
- * - CRC16 verification on load
+ * - CRC16 verification on load; the device config CRC covers its serialized
+ *   JSON fields, so a key added later falls back to its default instead of
+ *   failing the check (CONFIG_VERSION 1 files are migrated, not reset)
  * - Factory reset clears all files
  * 
  * RULES: #NVS(18) #FS(25)
@@ -59,15 +61,29 @@ bool StorageManager::saveConfig(const DeviceConfig& config) {
     if (!_initialized) return false;
     
     JsonDocument doc;
+    doc["ver"] = CONFIG_VERSION;
     doc["thresholdDry"] = config.thresholdDry;
     doc["thresholdWet"] = config.thresholdWet;
     doc["maxRuntime"] = config.maxRuntime;
     doc["minOffTime"] = config.minOffTime;
+    if (config.latitudeE4 != LOCATION_UNSET) {
+        doc["latE4"] = config.latitudeE4;
+        doc["lonE4"] = config.longitudeE4;
+    }
     doc["autoMode"] = config.autoMode;
+    doc["group"] = config.group;
     
-    // Calculate CRC (excluding CRC field itself)
-    uint16_t crc = _calcCRC((const uint8_t*)&config, sizeof(DeviceConfig) - sizeof(uint16_t));
-    doc["crc"] = crc;
+    JsonArray calDry = doc["calDry"].to<JsonArray>();
+    JsonArray calWet = doc["calWet"].to<JsonArray>();
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        calDry.add(config.calDry[i]);
+        calWet.add(config.calWet[i]);
+    }
+    doc["timezone"] = config.timezone;
+    doc["timeHost"] = config.timeHost;
+    
+    // CRC over the fields as written (excluding CRC field itself)
+    doc["crc"] = _calcJsonCRC(doc);
     
     if (_writeJsonFile(CONFIG_FILE, doc)) {
         LOG_INF(MOD_STORAGE, "save", "Config saved (dry=%d%%, wet=%d%%, auto=%d)",
@@ -95,16 +111,40 @@ bool StorageManager::loadConfig(DeviceConfig& config) {
     config.thresholdWet = doc["thresholdWet"] | DEFAULT_THRESHOLD_WET;
     config.maxRuntime = doc["maxRuntime"] | PUMP_MAX_RUNTIME_SEC;
     config.minOffTime = doc["minOffTime"] | PUMP_MIN_OFF_TIME_MS;
+    config.latitudeE4 = doc["latE4"] | (int32_t)LOCATION_UNSET;
+    config.longitudeE4 = doc["lonE4"] | (int32_t)LOCATION_UNSET;
     config.autoMode = doc["autoMode"] | true;
+    memset(config.group, 0, sizeof(config.group));
+    strncpy(config.group, doc["group"] | "", sizeof(config.group) - 1);
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        config.calDry[i] = doc["calDry"][i] | ADC_DRY_VALUE;
+        config.calWet[i] = doc["calWet"][i] | ADC_WET_VALUE;
+    }
+    memset(config.timezone, 0, sizeof(config.timezone));
+    strncpy(config.timezone, doc["timezone"] | DEFAULT_TIMEZONE, sizeof(config.timezone) - 1);
+    memset(config.timeHost, 0, sizeof(config.timeHost));
+    strncpy(config.timeHost, doc["timeHost"] | "", sizeof(config.timeHost) - 1);
     config.crc = doc["crc"] | 0;
     
-    // Verify CRC
-    uint16_t calcCrc = _calcCRC((const uint8_t*)&config, sizeof(DeviceConfig) - sizeof(uint16_t));
-    if (config.crc != calcCrc) {
-        LOG_WRN(MOD_STORAGE, "load", "Config CRC mismatch (stored=0x%04X, calc=0x%04X), using defaults",
-                config.crc, calcCrc);
-        config.setDefaults();
-        return false;
+    uint8_t version = doc["ver"] | 1;
+    if (version >= 2) {
+        // Verify CRC over the stored fields; keys missing from an older
+        // file already took their defaults above
+        doc.remove("crc");
+        uint16_t calcCrc = _calcJsonCRC(doc);
+        if (config.crc != calcCrc) {
+            LOG_WRN(MOD_STORAGE, "load", "Config CRC mismatch (stored=0x%04X, calc=0x%04X), using defaults",
+                    config.crc, calcCrc);
+            config.setDefaults();
+            return false;
+        }
+    }
+    
+    if (version < CONFIG_VERSION) {
+        // Version 1 hashed the raw struct, which changes with every added
+        // field: the file parsed, so keep it and rewrite it in this format
+        LOG_WRN(MOD_STORAGE, "load", "Config v%u migrated to v%u", version, CONFIG_VERSION);
+        saveConfig(config);
     }
     
     LOG_INF(MOD_STORAGE, "load", "Config loaded (dry=%d%%, wet=%d%%, auto=%d)",
@@ -248,16 +288,13 @@ bool StorageManager::saveSchedule(const ScheduleConfig& config) {
     doc["enabled"] = config.enabled;
     
     JsonArray entries = doc["entries"].to<JsonArray>();
-    for (int i = 0; i < MAX_SCHEDULE_ENTRIES; i++) {
-        JsonObject entry = entries.add<JsonObject>();
-        entry["hour"] = config.entries[i].hour;
-        entry["minute"] = config.entries[i].minute;
-        entry["duration"] = config.entries[i].duration;
-        entry["enabled"] = config.entries[i].enabled;
+    for (uint8_t i = 0; i < config.count && i < MAX_SCHEDULE_ENTRIES; i++) {
+        scheduleEntryToJson(config.entries[i], entries.add<JsonObject>());
     }
     
     if (_writeJsonFile(SCHEDULE_FILE, doc)) {
-        LOG_INF(MOD_STORAGE, "save", "Schedule saved (enabled=%d)", config.enabled);
+        LOG_INF(MOD_STORAGE, "save", "Schedule saved (enabled=%d, entries=%d)",
+                config.enabled, config.count);
         return true;
     }
     
@@ -276,21 +313,239 @@ bool StorageManager::loadSchedule(ScheduleConfig& config) {
         return false;
     }
     
+    config.setDefaults();
     config.enabled = doc["enabled"] | false;
     
-    JsonArray entries = doc["entries"];
-    for (int i = 0; i < MAX_SCHEDULE_ENTRIES && i < entries.size(); i++) {
-        JsonObject entry = entries[i];
-        config.entries[i].hour = entry["hour"] | 0;
-        config.entries[i].minute = entry["minute"] | 0;
-        config.entries[i].duration = entry["duration"] | 30;
-        config.entries[i].enabled = entry["enabled"] | false;
+    // Files from before entry kinds only hold hour/minute/duration/enabled,
+    // which load as DAILY entries on every day
+    JsonArrayConst entries = doc["entries"];
+    config.count = 0;
+    for (JsonVariantConst entry : entries) {
+        if (config.count >= MAX_SCHEDULE_ENTRIES) break;
+        const char* error = scheduleEntryFromJson(entry, config.entries[config.count]);
+        if (error) {
+            LOG_WRN(MOD_STORAGE, "load", "Schedule entry %d dropped: %s", config.count, error);
+            continue;
+        }
+        config.count++;
     }
     
-    LOG_INF(MOD_STORAGE, "load", "Schedule loaded (enabled=%d)", config.enabled);
+    LOG_INF(MOD_STORAGE, "load", "Schedule loaded (enabled=%d, entries=%d)",
+            config.enabled, config.count);
     return true;
 }
 
+bool StorageManager::saveScheduleRuns(const time_t* lastRun, uint8_t count) {
+    if (!_initialized) return false;
+    
+    JsonDocument doc;
+    JsonArray last = doc["last"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++) {
+        last.add((uint32_t)lastRun[i]);
+    }
+    
+    if (_writeJsonFile(SCHEDULE_RUNS_FILE, doc)) {
+        LOG_DBG(MOD_STORAGE, "save", "Schedule run history saved (%d entries)", count);
+        return true;
+    }
+    
+    return false;
+}
+
+bool StorageManager::loadScheduleRuns(time_t* lastRun, uint8_t count) {
+    memset(lastRun, 0, count * sizeof(time_t));
+    if (!_initialized) return false;
+    
+    JsonDocument doc;
+    if (!_readJsonFile(SCHEDULE_RUNS_FILE, doc)) {
+        return false;
+    }
+    
+    JsonArrayConst last = doc["last"];
+    uint8_t i = 0;
+    for (JsonVariantConst epoch : last) {
+        if (i >= count) break;
+        lastRun[i++] = (time_t)(epoch | 0UL);
+    }
+    
+    LOG_INF(MOD_STORAGE, "load", "Schedule run history loaded (%d entries)", i);
+    return true;
+}
+
+//=============================================================================
+// COMMAND SEQUENCE
+//=============================================================================
+
+bool StorageManager::saveCommandSeqs(const uint32_t* seq, const int* code, uint8_t count, const char* group) {
+    if (!_initialized) return false;
+    
+    JsonDocument doc;
+    JsonArray seqs = doc["seq"].to<JsonArray>();
+    JsonArray codes = doc["code"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++) {
+        seqs.add(seq[i]);
+        codes.add(code[i]);
+    }
+    doc["group"] = group;
+    
+    return _writeJsonFile(COMMAND_SEQ_FILE, doc);
+}
+
+bool StorageManager::loadCommandSeqs(uint32_t* seq, int* code, uint8_t count, char* group, size_t groupLen) {
+    memset(seq, 0, count * sizeof(uint32_t));
+    memset(code, 0, count * sizeof(int));
+    group[0] = '\0';
+    if (!_initialized) return false;
+    
+    JsonDocument doc;
+    if (!_readJsonFile(COMMAND_SEQ_FILE, doc)) {
+        return false;
+    }
+    
+    for (uint8_t i = 0; i < count; i++) {
+        seq[i] = doc["seq"][i] | 0UL;
+        code[i] = doc["code"][i] | 0;
+    }
+    strncpy(group, doc["group"] | "", groupLen - 1);
+    group[groupLen - 1] = '\0';
+    
+    LOG_INF(MOD_STORAGE, "load", "Command seqs loaded (device=%lu)", (unsigned long)seq[0]);
+    return true;
+}
+
+//=============================================================================
+// SCHEDULE ENTRY CODEC
+//=============================================================================
+
+/**
+ * @brief Read an integer member; missing uses fallback, wrong type fails
+ */
+static bool readInt(JsonVariantConst obj, const char* key, long min, long max,
+                    long fallback, long& value) {
+    JsonVariantConst field = obj[key];
+    if (field.isNull()) {
+        value = fallback;
+    } else if (field.is<long>()) {
+        value = field.as<long>();
+    } else {
+        return false;
+    }
+    return value >= min && value <= max;
+}
+
+/**
+ * @brief MMDD date check (0 = unset is valid)
+ */
+static bool validMonthDay(long mmdd) {
+    static const uint8_t DAYS_IN_MONTH[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (mmdd == 0) return true;
+    long month = mmdd / 100;
+    long day = mmdd % 100;
+    return month >= 1 && month <= 12 && day >= 1 && day <= DAYS_IN_MONTH[month - 1];
+}
+
+static const char* kindNameAt(uint8_t i) { return scheduleKindName((ScheduleKind)i); }
+static const char* policyNameAt(uint8_t i) { return catchUpPolicyName((CatchUpPolicy)i); }
+
+/**
+ * @brief Match a string against a name table
+ * @return Index, or -1
+ */
+static int findName(const char* name, const char* (*nameOf)(uint8_t), uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp(name, nameOf(i)) == 0) return i;
+    }
+    return -1;
+}
+
+const char* scheduleEntryFromJson(JsonVariantConst obj, ScheduleEntry& entry) {
+    if (!obj.is<JsonObjectConst>()) {
+        return "entry must be an object";
+    }
+    
+    int kindIndex = findName(obj["type"] | "daily", kindNameAt, 4);
+    if (kindIndex < 0) {
+        return "type must be daily, interval, sunrise or sunset";
+    }
+    int policyIndex = findName(obj["catchup"] | "skip", policyNameAt, 3);
+    if (policyIndex < 0) {
+        return "catchup must be skip, within or always";
+    }
+    
+    ScheduleKind k = (ScheduleKind)kindIndex;
+    CatchUpPolicy policy = (CatchUpPolicy)policyIndex;
+    bool sun = k == ScheduleKind::SUNRISE || k == ScheduleKind::SUNSET;
+    bool within = policy == CatchUpPolicy::WITHIN;
+    long h, m, mask, every, offset, dFrom, dTo, dur, window;
+    if (!readInt(obj, "hour", 0, 23, sun ? 0 : -1, h) ||
+        !readInt(obj, "minute", 0, 59, sun ? 0 : -1, m)) {
+        return "hour 0-23 and minute 0-59 required";
+    }
+    if (!readInt(obj, "days", 1, SCHEDULE_ALL_DAYS, SCHEDULE_ALL_DAYS, mask)) {
+        return "days must be a weekday mask 1-127";
+    }
+    if (!readInt(obj, "every", k == ScheduleKind::INTERVAL ? 1 : 0, 23,
+                 k == ScheduleKind::INTERVAL ? -1 : 0, every)) {
+        return "every must be 1-23 hours";
+    }
+    if (!readInt(obj, "offset", -SCHEDULE_OFFSET_MAX, SCHEDULE_OFFSET_MAX, 0, offset)) {
+        return "offset must be -180..180 minutes";
+    }
+    if (!readInt(obj, "from", 0, 1231, 0, dFrom) || !readInt(obj, "to", 0, 1231, 0, dTo) ||
+        !validMonthDay(dFrom) || !validMonthDay(dTo) || ((dFrom == 0) != (dTo == 0))) {
+        return "from/to must both be MMDD dates";
+    }
+    if (!readInt(obj, "duration", 1, PUMP_MAX_RUNTIME_SEC, 30, dur)) {
+        return "duration must be 1-3600 s";
+    }
+    if (!readInt(obj, "window", within ? 1 : 0, SCHEDULE_WINDOW_MAX, within ? 60 : 0, window)) {
+        return "window must be 1-1440 minutes";
+    }
+    JsonVariantConst en = obj["enabled"];
+    if (!en.isNull() && !en.is<bool>()) {
+        return "enabled must be a boolean";
+    }
+    
+    entry.kind = k;
+    entry.hour = (uint8_t)h;
+    entry.minute = (uint8_t)m;
+    entry.days = (uint8_t)mask;
+    entry.everyHours = k == ScheduleKind::INTERVAL ? (uint8_t)every : 0;
+    entry.offsetMin = sun ? (int16_t)offset : 0;
+    entry.from = (uint16_t)dFrom;
+    entry.to = (uint16_t)dTo;
+    entry.duration = (uint16_t)dur;
+    entry.catchUp = policy;
+    entry.windowMin = within ? (uint16_t)window : 0;
+    entry.enabled = en | false;
+    return nullptr;
+}
+
+void scheduleEntryToJson(const ScheduleEntry& entry, JsonObject obj) {
+    obj["type"] = scheduleKindName(entry.kind);
+    obj["hour"] = entry.hour;
+    obj["minute"] = entry.minute;
+    obj["duration"] = entry.duration;
+    obj["enabled"] = entry.enabled;
+    obj["days"] = entry.days;
+    if (entry.kind == ScheduleKind::INTERVAL) {
+        obj["every"] = entry.everyHours;
+    }
+    if (entry.isSun()) {
+        obj["offset"] = entry.offsetMin;
+    }
+    if (entry.from != 0) {
+        obj["from"] = entry.from;
+        obj["to"] = entry.to;
+    }
+    if (entry.catchUp != CatchUpPolicy::SKIP) {
+        obj["catchup"] = catchUpPolicyName(entry.catchUp);
+    }
+    if (entry.catchUp == CatchUpPolicy::WITHIN) {
+        obj["window"] = entry.windowMin;
+    }
+}
+
 //=============================================================================
 // UTILITIES
 //=============================================================================
@@ -342,6 +597,29 @@ void StorageManager::listFiles() {
     LOG_INF(MOD_STORAGE, "list", "-------------");
 }
 
+bool StorageManager::readTextFile(const char* filename, String& out, size_t maxLen) {
+    if (!_initialized) return false;
+    
+    File file = LittleFS.open(filename, "r");
+    if (!file) {
+        LOG_DBG(MOD_STORAGE, "read", "Failed to open %s", filename);
+        return false;
+    }
+    
+    size_t size = file.size();
+    if (size == 0 || size > maxLen) {
+        LOG_WRN(MOD_STORAGE, "read", "%s has bad size (%u bytes, max %u)", filename, size, maxLen);
+        file.close();
+        return false;
+    }
+    
+    out = file.readString();
+    file.close();
+    
+    LOG_DBG(MOD_STORAGE, "read", "Read %s (%u bytes)", filename, size);
+    return out.length() == size;
+}
+
 //=============================================================================
 // PRIVATE METHODS
 //=============================================================================
@@ -350,6 +628,12 @@ uint16_t StorageManager::_calcCRC(const uint8_t* data, size_t length) {
     return crc16(data, length);
 }
 
+uint16_t StorageManager::_calcJsonCRC(const JsonDocument& doc) {
+    String json;
+    serializeJson(doc, json);
+    return _calcCRC((const uint8_t*)json.c_str(), json.length());
+}
+
 bool StorageManager::_readJsonFile(const char* filename, JsonDocument& doc) {
     File file = LittleFS.open(filename, "r");
     if (!file) {
@@ -18,13 +18,19 @@
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 #include <config.h>
+#include <schedule_plan.h>
 
 //=============================================================================
 // FILE PATHS
 //=============================================================================
 #define CONFIG_FILE         "/config.json"
+#define CONFIG_VERSION      2   // "ver" in CONFIG_FILE (1 = CRC over the raw struct)
 #define WIFI_FILE           "/wifi.json"
 #define SCHEDULE_FILE       "/schedule.json"
+#define SCHEDULE_RUNS_FILE  "/schedule_runs.json"  // Last run epoch per entry
+#define COMMAND_SEQ_FILE    "/cmd_seq.json"    // Last applied MQTT seq per source
+#define MQTT_CA_FILE        "/mqtt_ca.pem"     // Broker CA (PEM), TLS pinning
+#define MQTT_FP_FILE        "/mqtt_fp.txt"     // Broker cert SHA1 fingerprint
 
 //=============================================================================
 // CONFIGURATION STRUCTURES
@@ -42,9 +48,27 @@ struct DeviceConfig {
     uint16_t maxRuntime;        // Max pump runtime in seconds
     uint32_t minOffTime;        // Min time between pump runs (ms)
     
+    // Site location for sunrise / sunset entries, 1e-4 degrees (north /
+    // east +), LOCATION_UNSET = none
+    int32_t latitudeE4;
+    int32_t longitudeE4;
+    
     // Operating mode
     bool autoMode;              // true = auto, false = manual
     
+    // Fleet membership (subscribes groups/{group}/config); empty = none
+    char group[DEVICE_GROUP_MAX_LEN + 1];
+    
+    // Per-sensor raw ADC calibration
+    uint16_t calDry[SENSOR_COUNT];
+    uint16_t calWet[SENSOR_COUNT];
+    
+    // Local time rules, POSIX TZ (e.g. "ICT-7")
+    char timezone[TIMEZONE_MAX_LEN + 1];
+    
+    // Local HTTP server read for time while NTP is out ("" = none)
+    char timeHost[TIME_HOST_MAX_LEN + 1];
+    
     // CRC for verification
     uint16_t crc;
     
@@ -54,7 +78,17 @@ struct DeviceConfig {
         thresholdWet = DEFAULT_THRESHOLD_WET;
         maxRuntime = PUMP_MAX_RUNTIME_SEC;
         minOffTime = PUMP_MIN_OFF_TIME_MS;
+        latitudeE4 = LOCATION_UNSET;
+        longitudeE4 = LOCATION_UNSET;
         autoMode = true;
+        memset(group, 0, sizeof(group));
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+            calDry[i] = ADC_DRY_VALUE;
+            calWet[i] = ADC_WET_VALUE;
+        }
+        memset(timezone, 0, sizeof(timezone));
+        strncpy(timezone, DEFAULT_TIMEZONE, sizeof(timezone) - 1);
+        memset(timeHost, 0, sizeof(timeHost));
         crc = 0;
     }
 };
@@ -97,35 +131,20 @@ struct MqttConfig {
     }
 };
 
-/**
- * @brief Schedule entry
- */
-struct ScheduleEntry {
-    uint8_t hour;               // Hour (0-23)
-    uint8_t minute;             // Minute (0-59)
-    uint16_t duration;          // Duration in seconds
-    bool enabled;               // Is this entry enabled
-    
-    void setDefaults() {
-        hour = 6;               // 6:00 AM
-        minute = 0;
-        duration = 30;          // 30 seconds
-        enabled = false;
-    }
-};
-
 /**
  * @brief Schedule configuration
  */
-#define MAX_SCHEDULE_ENTRIES    4
+#define DEFAULT_SCHEDULE_ENTRIES 4
 
 struct ScheduleConfig {
     bool enabled;                               // Global schedule enable
+    uint8_t count;                              // Entries in use
     ScheduleEntry entries[MAX_SCHEDULE_ENTRIES];
     uint16_t crc;
     
     void setDefaults() {
         enabled = false;
+        count = DEFAULT_SCHEDULE_ENTRIES;
         for (int i = 0; i < MAX_SCHEDULE_ENTRIES; i++) {
             entries[i].setDefaults();
         }
@@ -136,6 +155,18 @@ struct ScheduleConfig {
     }
 };
 
+/**
+ * @brief Validate and load a schedule entry from JSON (missing optional
+ *        fields -> defaults); shared by storage, /api/schedule and batches
+ * @return nullptr on success, else error message (entry unchanged)
+ */
+const char* scheduleEntryFromJson(JsonVariantConst obj, ScheduleEntry& entry);
+
+/**
+ * @brief Store a schedule entry into JSON (optional fields only when they apply)
+ */
+void scheduleEntryToJson(const ScheduleEntry& entry, JsonObject obj);
+
 //=============================================================================
 // STORAGE MANAGER CLASS
 //=============================================================================
@@ -232,6 +263,36 @@ public:
      */
     bool loadSchedule(ScheduleConfig& config);
     
+    /**
+     * @brief Save last run epoch per schedule entry (catch-up history)
+     * @return true if successful
+     */
+    bool saveScheduleRuns(const time_t* lastRun, uint8_t count);
+    
+    /**
+     * @brief Load last run epochs; entries without history get 0
+     * @return true if loaded
+     */
+    bool loadScheduleRuns(time_t* lastRun, uint8_t count);
+    
+    //-------------------------------------------------------------------------
+    // Command Sequence
+    //-------------------------------------------------------------------------
+    
+    /**
+     * @brief Save last applied command seq and its result per source
+     * @param group Group the group source's seq belongs to
+     * @return true if successful
+     */
+    bool saveCommandSeqs(const uint32_t* seq, const int* code, uint8_t count, const char* group);
+    
+    /**
+     * @brief Load last applied seqs; missing sources get 0
+     * @param group Output: group the group source's seq belongs to
+     * @return true if loaded
+     */
+    bool loadCommandSeqs(uint32_t* seq, int* code, uint8_t count, char* group, size_t groupLen);
+    
     //-------------------------------------------------------------------------
     // Utilities
     //-------------------------------------------------------------------------
@@ -260,6 +321,15 @@ public:
      * @brief List all files (for debugging)
      */
     void listFiles();
+    
+    /**
+     * @brief Read a small text file (certificates, pins...)
+     * @param filename File path
+     * @param out Output string
+     * @param maxLen Reject files larger than this
+     * @return true if read successfully
+     */
+    bool readTextFile(const char* filename, String& out, size_t maxLen);
 
 private:
     bool _initialized;
@@ -269,6 +339,11 @@ private:
      */
     uint16_t _calcCRC(const uint8_t* data, size_t length);
     
+    /**
+     * @brief Calculate CRC16 of a document's serialized JSON
+     */
+    uint16_t _calcJsonCRC(const JsonDocument& doc);
+    
     /**
      * @brief Read JSON file
      * @param filename File path
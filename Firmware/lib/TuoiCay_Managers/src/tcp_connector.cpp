@@ -0,0 +1,188 @@
+/**
+ * @file tcp_connector.cpp
+ * @brief Implementation of non-blocking TCP connector
+ *
+ * LOGIC:
+ * - IP literal or cached name -> tcp_connect() directly
+ * - Otherwise dns_gethostbyname() -> _onDnsFound -> tcp_connect()
+ * - _onConnected / _onError run in lwIP context between loop() calls
+ *   and only flip _state; all decisions are made in poll()/claim()
+ * - claim() wraps the pcb in a ClientContext, the same way WiFiServer
+ *   does for accepted connections
+ *
+ * RULES: #WIFI(8) #MQTT(9)
+ */
+
+#include "tcp_connector.h"
+#include <logger.h>
+
+extern "C" {
+#include <lwip/tcp.h>
+#include <lwip/dns.h>
+}
+#include <include/ClientContext.h>
+
+//=============================================================================
+// WIFICLIENT ADAPTER
+//=============================================================================
+
+// WiFiClient(ClientContext*) is protected; WiFiServer uses it via friendship
+class ConnectedWiFiClient : public WiFiClient {
+public:
+    explicit ConnectedWiFiClient(ClientContext* ctx) : WiFiClient(ctx) {}
+};
+
+//=============================================================================
+// TCP CONNECTOR IMPLEMENTATION
+//=============================================================================
+
+TcpConnector::TcpConnector()
+    : _state(TcpConnectState::IDLE)
+    , _pcb(nullptr)
+    , _port(0)
+    , _cacheValid(false)
+{
+    _host[0] = '\0';
+    _cachedHost[0] = '\0';
+}
+
+bool TcpConnector::begin(const char* host, uint16_t port) {
+    abort();
+
+    strncpy(_host, host, sizeof(_host) - 1);
+    _host[sizeof(_host) - 1] = '\0';
+    _port = port;
+
+    // IP literal - no DNS needed
+    IPAddress literal;
+    if (literal.fromString(_host)) {
+        _addr = literal;
+        _startTcp();
+        return _state != TcpConnectState::FAILED;
+    }
+
+    // Cached DNS answer
+    if (_cacheValid && strcmp(_cachedHost, _host) == 0) {
+        _addr = _cachedAddr;
+        _startTcp();
+        return _state != TcpConnectState::FAILED;
+    }
+
+    _state = TcpConnectState::RESOLVING;
+    err_t err = dns_gethostbyname(_host, &_addr, _onDnsFound, this);
+
+    if (err == ERR_OK) {
+        // Answer was already in lwIP's DNS table
+        _startTcp();
+    } else if (err != ERR_INPROGRESS) {
+        LOG_WRN(MOD_MQTT, "tcp", "DNS lookup failed for %s (err=%d)", _host, err);
+        _state = TcpConnectState::FAILED;
+    }
+
+    return _state != TcpConnectState::FAILED;
+}
+
+TcpConnectState TcpConnector::poll() {
+    return _state;
+}
+
+bool TcpConnector::claim(WiFiClient& client) {
+    if (_state != TcpConnectState::CONNECTED || _pcb == nullptr) {
+        return false;
+    }
+
+    tcp_pcb* pcb = _pcb;
+    _pcb = nullptr;
+    _state = TcpConnectState::IDLE;
+
+    // ClientContext installs its own callbacks on the pcb
+    tcp_arg(pcb, nullptr);
+    tcp_err(pcb, nullptr);
+    client = ConnectedWiFiClient(new ClientContext(pcb, nullptr, nullptr));
+    client.setNoDelay(true);
+
+    return true;
+}
+
+void TcpConnector::abort() {
+    if (_pcb) {
+        // Detach first: tcp_abort() would call _onError on this object
+        tcp_arg(_pcb, nullptr);
+        tcp_err(_pcb, nullptr);
+        tcp_abort(_pcb);
+        _pcb = nullptr;
+    }
+    // A pending DNS callback sees IDLE and is ignored
+    _state = TcpConnectState::IDLE;
+}
+
+const char* TcpConnector::getStateString() const {
+    switch (_state) {
+        case TcpConnectState::IDLE:       return "IDLE";
+        case TcpConnectState::RESOLVING:  return "RESOLVING";
+        case TcpConnectState::CONNECTING: return "CONNECTING";
+        case TcpConnectState::CONNECTED:  return "CONNECTED";
+        case TcpConnectState::FAILED:     return "FAILED";
+        default:                          return "UNKNOWN";
+    }
+}
+
+//=============================================================================
+// PRIVATE METHODS
+//=============================================================================
+
+void TcpConnector::_startTcp() {
+    _pcb = tcp_new();
+    if (_pcb == nullptr) {
+        LOG_ERR(MOD_MQTT, "tcp", "tcp_new() failed (out of memory)");
+        _state = TcpConnectState::FAILED;
+        return;
+    }
+
+    tcp_arg(_pcb, this);
+    tcp_err(_pcb, _onError);
+
+    _state = TcpConnectState::CONNECTING;
+    err_t err = tcp_connect(_pcb, &_addr, _port, _onConnected);
+    if (err != ERR_OK) {
+        LOG_WRN(MOD_MQTT, "tcp", "tcp_connect() failed (err=%d)", err);
+        abort();
+        _state = TcpConnectState::FAILED;
+    }
+}
+
+void TcpConnector::_onDnsFound(const char* name, const ip_addr_t* addr, void* arg) {
+    TcpConnector* self = static_cast<TcpConnector*>(arg);
+    if (self->_state != TcpConnectState::RESOLVING) return;  // Aborted meanwhile
+
+    if (addr == nullptr) {
+        self->_state = TcpConnectState::FAILED;
+        return;
+    }
+
+    self->_addr = *addr;
+    self->_cachedAddr = *addr;
+    strncpy(self->_cachedHost, self->_host, sizeof(self->_cachedHost) - 1);
+    self->_cachedHost[sizeof(self->_cachedHost) - 1] = '\0';
+    self->_cacheValid = true;
+
+    self->_startTcp();
+}
+
+err_t TcpConnector::_onConnected(void* arg, tcp_pcb* pcb, err_t err) {
+    TcpConnector* self = static_cast<TcpConnector*>(arg);
+    if (self == nullptr || self->_pcb != pcb) return ERR_OK;
+
+    self->_state = (err == ERR_OK) ? TcpConnectState::CONNECTED : TcpConnectState::FAILED;
+    return ERR_OK;
+}
+
+void TcpConnector::_onError(void* arg, err_t err) {
+    TcpConnector* self = static_cast<TcpConnector*>(arg);
+    if (self == nullptr) return;
+
+    // lwIP has already freed the pcb when this is called
+    self->_pcb = nullptr;
+    self->_state = TcpConnectState::FAILED;
+    self->_cacheValid = false;  // Broker may have moved, resolve again
+}
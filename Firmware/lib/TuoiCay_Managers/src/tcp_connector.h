@@ -0,0 +1,112 @@
+/**
+ * @file tcp_connector.h
+ * @brief Non-blocking TCP connect (DNS + SYN) on top of lwIP raw API
+ *
+ * LOGIC:
+ * - WiFiClient::connect() blocks loop() until the TCP handshake finishes
+ *   or times out; with an unreachable broker that is several seconds
+ * - TcpConnector starts DNS lookup and tcp_connect() and returns at once;
+ *   lwIP callbacks update the state between loop() iterations
+ * - Once connected, the pcb is handed over to a regular WiFiClient, so
+ *   the rest of the code keeps using the normal Client API
+ * - Resolved address is cached so reconnects skip DNS
+ *
+ * RULES: #WIFI(8) #MQTT(9)
+ */
+
+#ifndef TCP_CONNECTOR_H
+#define TCP_CONNECTOR_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+extern "C" {
+#include <lwip/ip_addr.h>
+#include <lwip/err.h>
+}
+
+struct tcp_pcb;
+
+//=============================================================================
+// CONNECTOR STATE ENUM
+//=============================================================================
+enum class TcpConnectState : uint8_t {
+    IDLE = 0,           // Nothing in progress
+    RESOLVING = 1,      // Waiting for DNS answer
+    CONNECTING = 2,     // SYN sent, waiting for SYN-ACK
+    CONNECTED = 3,      // Handshake done, ready to claim()
+    FAILED = 4          // DNS or TCP error
+};
+
+//=============================================================================
+// TCP CONNECTOR CLASS
+//=============================================================================
+
+/**
+ * @class TcpConnector
+ * @brief Starts a TCP connection without blocking the caller
+ */
+class TcpConnector {
+public:
+    /**
+     * @brief Constructor
+     */
+    TcpConnector();
+
+    /**
+     * @brief Start connecting (returns immediately)
+     * @param host Hostname or IP string
+     * @param port TCP port
+     * @return true if attempt started
+     */
+    bool begin(const char* host, uint16_t port);
+
+    /**
+     * @brief Get current state (call in loop)
+     */
+    TcpConnectState poll();
+
+    /**
+     * @brief Hand connected socket over to a WiFiClient
+     * @param client Client that takes ownership of the connection
+     * @return true if a connected socket was transferred
+     */
+    bool claim(WiFiClient& client);
+
+    /**
+     * @brief Abort attempt in progress
+     */
+    void abort();
+
+    /**
+     * @brief Forget cached DNS result (e.g. broker changed)
+     */
+    void clearCache() { _cacheValid = false; }
+
+    /**
+     * @brief Get state as string
+     */
+    const char* getStateString() const;
+
+private:
+    volatile TcpConnectState _state;
+    tcp_pcb* _pcb;
+    ip_addr_t _addr;
+    uint16_t _port;
+    char _host[65];
+
+    bool _cacheValid;
+    ip_addr_t _cachedAddr;
+    char _cachedHost[65];
+
+    /**
+     * @brief Send SYN to resolved address
+     */
+    void _startTcp();
+
+    static void _onDnsFound(const char* name, const ip_addr_t* addr, void* arg);
+    static err_t _onConnected(void* arg, tcp_pcb* pcb, err_t err);
+    static void _onError(void* arg, err_t err);
+};
+
+#endif // TCP_CONNECTOR_H
@@ -3,27 +3,59 @@
  * @brief Implementation of NTP Time Manager
  * 
  * LOGIC:
- * - Uses ESP8266 built-in SNTP
- * - Configures timezone and DST
- * - Periodic sync every 6 hours
+ * - Own SNTP client (ntp_client.h) instead of the core's configTime():
+ *   every round measures each server, the lowest-delay answer is applied
+ * - Configures timezone and DST from a POSIX TZ string (setenv + tzset)
+ * - Adaptive poll: NTP_POLL_MIN_SEC while drift is unknown or the clock
+ *   was found off by more than NTP_UNSTABLE_MS, doubling up to
+ *   NTP_POLL_MAX_SEC while it stays within NTP_STABLE_MS
+ * - _tm cache keyed by the epoch second: getters compare one time_t,
+ *   localtime_r() runs when the second changed
+ * - Change flags come from comparing field by field with the previous
+ *   tick, so a step of the clock reports what actually changed
+ * - Slew: an offset small enough is queued (_slewUs) and applied in
+ *   steps, mid-second so a step back never repeats a second; no step
+ *   while a query is in flight (it would show up as offset)
+ * - Drift: each NTP-to-NTP span gives residual / span; the estimate is
+ *   smoothed (1/4 gain) and compensated every second by adding
+ *   drift x elapsed to the slew, so between syncs the clock runs true
+ * - Accuracy = delay / 2 at sync, growing by TIME_DRIFT_RESIDUAL_PPM
+ *   (TIME_DRIFT_UNKNOWN_PPM before drift is known) of the time since
+ * - Fallback while NTP is out: the HTTP host is probed every
+ *   TIME_HTTP_POLL_SEC, NTP is retried every NTP_POLL_MIN_SEC instead of
+ *   NTP_RETRY_SEC once another source keeps the clock (blocked UDP, and
+ *   each failed round may cost DNS time). Fallback samples go through the
+ *   same slew / step as NTP but never feed the drift estimate
+ * - Sun cache keyed by the local date; a miss costs two sun_calc events
+ *   (table sine, bisection acos) plus two localtime_r(), timed at debug
+ *   level
+ * - Restore only after resets that keep RTC memory and take a known short
+ *   time (soft restart, WDT, exception); power-on, reset pin and deep
+ *   sleep wait for NTP
  * 
  * RULES: #TIME(12)
  */
 
 #include "time_manager.h"
 #include <logger.h>
+#include <posix_tz.h>
+#include <crc_utils.h>
+#include <sun_calc.h>
+#include <civil_date.h>
 #include <ESP8266WiFi.h>
-#include <coredecls.h>  // settimeofday_cb()
 
 // Global instance
 TimeManager timeManager;
 
-// Callback flag for time sync
-static volatile bool _timeSyncCallback = false;
+static const char* const SOURCE_NAMES[] = { "none", "rtc", "ntp", "http", "mqtt", "manual" };
 
-// Callback when time is set
-void _onTimeSync() {
-    _timeSyncCallback = true;
+// Priority by TimeSource (higher replaces lower regardless of accuracy)
+static const uint8_t SOURCE_RANK[] = { 0, 1, 5, 4, 3, 2 };
+
+static int64_t nowUs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
 }
 
 //=============================================================================
@@ -33,18 +65,43 @@ void _onTimeSync() {
 bool TimeManager::begin() {
     if (_initialized) return true;
     
-    LOG_INF(MOD_TIME, "init", "Initializing NTP (TZ=UTC+%d)...", NTP_TIMEZONE_OFFSET);
-    
-    // Set timezone
-    configTime(TZ_OFFSET_SEC, DST_OFFSET_SEC, NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
-    
-    // Register callback for time sync
-    settimeofday_cb(_onTimeSync);
+    if (_tz[0] == '\0') {
+        strncpy(_tz, DEFAULT_TIMEZONE, sizeof(_tz) - 1);
+    }
+    LOG_INF(MOD_TIME, "init", "Initializing NTP (TZ=%s)...", _tz);
     
     _initialized = true;
     _synced = false;
     _lastSyncTime = 0;
     _lastSyncEpoch = 0;
+    _tmEpoch = -1;
+    _lastTickEpoch = -1;
+    _tickValid = false;
+    _pendingChanges = 0;
+    _source = TimeSource::NONE;
+    _accuracyMs = 0;
+    _slewUs = 0;
+    _slewEpoch = 0;
+    _driftPpb = 0;
+    _driftValid = false;
+    _driftAccNs = 0;
+    _driftMs = millis();
+    _pollSec = NTP_POLL_MIN_SEC;
+    _lastAttemptMs = 0;
+    _waitMs = 0;                    // First round as soon as WiFi is up
+    _bestServer = -1;
+    _ntpOut = false;
+    _httpLastMs = 0;
+    _httpWaitMs = 0;                // First probe as soon as NTP fails
+    
+    // Set timezone
+    setenv("TZ", _tz, 1);
+    tzset();
+    
+    // Warm boot: run on the saved clock until NTP answers
+    _restore();
+    
+    _ntp.begin(NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
     
     LOG_INF(MOD_TIME, "init", "NTP initialized, waiting for sync...");
     return true;
@@ -53,32 +110,457 @@ bool TimeManager::begin() {
 void TimeManager::update() {
     if (!_initialized) return;
     
-    // Check if time was synced via callback
-    if (_timeSyncCallback) {
-        _timeSyncCallback = false;
+    if (_ntp.update()) {
+        _onRound();
+    } else if (!_ntp.busy() && !_http.busy() && millis() - _lastAttemptMs >= _waitMs) {
+        // WiFi down: startRound() fails and is tried again next loop
+        if (_ntp.startRound()) {
+            _lastAttemptMs = millis();
+        }
+    }
+    
+    _updateHttp();
+    
+    // Query in flight: a step now would show up in its offset
+    if (!_ntp.busy() && !_http.busy()) {
+        _slew();
+    }
+    
+    _tick();
+}
+
+void TimeManager::_tick() {
+    time_t now = time(nullptr);
+    if (now == _lastTickEpoch && !_pendingChanges) return;     // Same second
+    _lastTickEpoch = now;
+    
+    // Unsynced clock counts from 1970: no events until the first sync
+    if (!_synced) return;
+    
+    _compensate();
+    _save(0);
+    
+    const struct tm& t = getTm();
+    if (_tickValid) {
+        uint8_t changes = _pendingChanges;
+        _pendingChanges = 0;
+        if (t.tm_yday != _lastTick.tm_yday || t.tm_year != _lastTick.tm_year) {
+            changes |= TIME_CHANGE_DAY | TIME_CHANGE_HOUR | TIME_CHANGE_MINUTE;
+        } else if (t.tm_hour != _lastTick.tm_hour) {
+            changes |= TIME_CHANGE_HOUR | TIME_CHANGE_MINUTE;
+        } else if (t.tm_min != _lastTick.tm_min) {
+            changes |= TIME_CHANGE_MINUTE;
+        }
         
-        time_t now = time(nullptr);
-        if (now > 1609459200) {  // After 2021-01-01 (valid time)
-            _synced = true;
-            _lastSyncTime = millis();
-            _lastSyncEpoch = now;
-            
-            LOG_INF(MOD_TIME, "sync", "Time synced: %s", getDateTimeString().c_str());
+        if ((changes & TIME_CHANGE_DAY) && _hasLocation) {
+            int16_t sunrise, sunset;
+            if (getSunTimes(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, sunrise, sunset)) {
+                // Wall clock of events past / before midnight
+                sunrise = (sunrise + 1440) % 1440;
+                sunset = (sunset + 1440) % 1440;
+                LOG_INF(MOD_TIME, "sun", "Sunrise %02d:%02d, sunset %02d:%02d",
+                        sunrise / 60, sunrise % 60, sunset / 60, sunset % 60);
+            } else {
+                LOG_INF(MOD_TIME, "sun", "No sunrise / sunset today");
+            }
+        }
+        
+        if (changes) {
+            for (uint8_t i = 0; i < _listenerCount; i++) {
+                _listeners[i](changes, t);
+            }
+        }
+    }
+    _lastTick = t;
+    _tickValid = true;
+}
+
+void TimeManager::_onRound() {
+    int8_t best = _ntp.best();
+    if (best < 0) {
+        // Another source keeps the clock: NTP is likely blocked here
+        bool fallback = SOURCE_RANK[(uint8_t)_source] > SOURCE_RANK[(uint8_t)TimeSource::RTC];
+        uint32_t retrySec = fallback ? NTP_POLL_MIN_SEC : NTP_RETRY_SEC;
+        LOG_WRN(MOD_TIME, "sync", "No NTP server answered, retry in %lus", (unsigned long)retrySec);
+        _waitMs = retrySec * 1000UL;
+        _ntpOut = true;
+        return;
+    }
+    _ntpOut = false;
+    _bestServer = best;
+    _waitMs = _pollSec * 1000UL;
+    _applyNtp(_ntp.server(best));
+}
+
+void TimeManager::_applyNtp(const NtpServerStats& server) {
+    const NtpSample& s = server.sample;
+    bool first = _source != TimeSource::NTP;
+    
+    // Part of the offset not already queued as a correction
+    int64_t residualUs = s.offsetUs - _slewUs;
+    
+    // Drift: what built up over an NTP-to-NTP span despite compensation
+    unsigned long spanSec = (millis() - _lastSyncTime) / 1000;
+    if (!first && spanSec >= TIME_DRIFT_MIN_SEC) {
+        int64_t residualPpb = residualUs * 1000 / (int64_t)spanSec;
+        int64_t drift = _driftValid ? _driftPpb + residualPpb / 4 : residualPpb;
+        if (drift >= -TIME_DRIFT_MAX_PPB && drift <= TIME_DRIFT_MAX_PPB) {
+            _driftPpb = (int32_t)drift;
+            _driftValid = true;
+        } else {
+            LOG_WRN(MOD_TIME, "drift", "Drift sample %ld ppb ignored", (long)residualPpb);
+        }
+    }
+    
+    _apply(TimeSource::NTP, s.offsetUs, (uint32_t)s.delayUs / 2000 + 1);
+    
+    // Adaptive interval: poll less while the clock stays on time
+    uint32_t residualMs = (uint32_t)((residualUs < 0 ? -residualUs : residualUs) / 1000);
+    uint32_t pollSec = _pollSec;
+    if (!first && residualMs > NTP_UNSTABLE_MS) {
+        pollSec = _pollSec / 2 < NTP_POLL_MIN_SEC ? NTP_POLL_MIN_SEC : _pollSec / 2;
+    } else if (!first && residualMs <= NTP_STABLE_MS && _driftValid) {
+        pollSec = _pollSec * 2 > NTP_POLL_MAX_SEC ? NTP_POLL_MAX_SEC : _pollSec * 2;
+    }
+    if (pollSec != _pollSec) {
+        LOG_INF(MOD_TIME, "sync", "Poll interval %lus -> %lus (residual %lu ms)",
+                (unsigned long)_pollSec, (unsigned long)pollSec, (unsigned long)residualMs);
+        _pollSec = pollSec;
+        _waitMs = _pollSec * 1000UL;
+    }
+    
+    if (first) {
+        LOG_INF(MOD_TIME, "sync", "Time synced from %s: %s (offset %ld ms, +-%lu ms%s)", server.host,
+                getDateTimeString().c_str(), (long)(s.offsetUs / 1000), (unsigned long)_accuracyMs,
+                _slewUs ? ", slewing" : "");
+    } else {
+        LOG_DBG(MOD_TIME, "sync", "%s: offset %ld ms, delay %ld ms, drift %ld ppb", server.host,
+                (long)(s.offsetUs / 1000), (long)(s.delayUs / 1000), (long)_driftPpb);
+    }
+}
+
+void TimeManager::_updateHttp() {
+    if (_http.update()) {
+        if (_http.ok()) {
+            const HttpDateSample& s = _http.sample();
+            _offer(TimeSource::HTTP, s.offsetUs, s.accuracyMs);
+            _httpWaitMs = TIME_HTTP_POLL_SEC * 1000UL;
+        } else {
+            LOG_WRN(MOD_TIME, "http", "%s: %s, retry in %ds", _http.getHost(), _http.lastError(), NTP_RETRY_SEC);
+            _httpWaitMs = NTP_RETRY_SEC * 1000UL;
         }
+        return;
+    }
+    
+    // Only while NTP is out, never next to an NTP round
+    if (!_ntpOut || !_http.enabled() || _http.busy() || _ntp.busy() ||
+        millis() - _httpLastMs < _httpWaitMs) {
+        return;
+    }
+    _httpLastMs = millis();
+    if (!_http.start()) {
+        _httpWaitMs = NTP_RETRY_SEC * 1000UL;
+    }
+}
+
+bool TimeManager::setTime(TimeSource source, int64_t unixUs, uint32_t accuracyMs) {
+    // NTP and HTTP are measured here, RTC is restored here
+    if (!_initialized || (source != TimeSource::MQTT && source != TimeSource::MANUAL)) return false;
+    if (unixUs < TIME_VALID_EPOCH * 1000000LL) {
+        LOG_WRN(MOD_TIME, "sync", "%s time before 2021 ignored", sourceName(source));
+        return false;
+    }
+    return _offer(source, unixUs - nowUs(), accuracyMs);
+}
+
+bool TimeManager::_offer(TimeSource source, int64_t offsetUs, uint32_t accuracyMs) {
+    uint32_t current = getAccuracyMs();
+    bool better = SOURCE_RANK[(uint8_t)source] > SOURCE_RANK[(uint8_t)_source];
+    // NTP still answering: a fallback would only cut its drift span short
+    bool ntpHolds = _source == TimeSource::NTP && !_ntpOut;
+    if (_source != TimeSource::NONE && !better && (ntpHolds || accuracyMs > current)) {
+        LOG_DBG(MOD_TIME, "sync", "%s time ignored (+-%lu ms), clock from %s is +-%lu ms",
+                sourceName(source), (unsigned long)accuracyMs, sourceName(_source), (unsigned long)current);
+        return false;
+    }
+    
+    bool first = _source != source;
+    _apply(source, offsetUs, accuracyMs);
+    
+    if (first) {
+        LOG_INF(MOD_TIME, "sync", "Time set from %s: %s (offset %ld ms, +-%lu ms%s)", sourceName(source),
+                getDateTimeString().c_str(), (long)(offsetUs / 1000), (unsigned long)accuracyMs,
+                _slewUs ? ", slewing" : "");
+    } else {
+        LOG_DBG(MOD_TIME, "sync", "%s: offset %ld ms, +-%lu ms", sourceName(source),
+                (long)(offsetUs / 1000), (unsigned long)accuracyMs);
+    }
+    return true;
+}
+
+void TimeManager::_apply(TimeSource source, int64_t offsetUs, uint32_t accuracyMs) {
+    if (_source != TimeSource::NONE &&
+        offsetUs >= -TIME_SLEW_MAX_MS * 1000LL && offsetUs <= TIME_SLEW_MAX_MS * 1000LL) {
+        _slewUs = (int32_t)offsetUs;
+    } else {
+        _setClockUs(nowUs() + offsetUs);
+        _slewUs = 0;
     }
     
-    // Periodic resync
-    if (_synced && millis() - _lastSyncTime >= NTP_SYNC_INTERVAL_MS) {
-        LOG_INF(MOD_TIME, "sync", "Periodic NTP resync...");
-        syncNow();
+    _source = source;
+    _synced = true;
+    _accuracyMs = accuracyMs;
+    _lastSyncTime = millis();
+    _lastSyncEpoch = time(nullptr);
+    _save(0);
+}
+
+bool TimeManager::setTimeHost(const char* host) {
+    if (!_http.setHost(host)) {
+        LOG_WRN(MOD_TIME, "http", "Invalid time host '%s'", host ? host : "");
+        return false;
+    }
+    _httpWaitMs = 0;
+    if (_http.enabled()) {
+        LOG_INF(MOD_TIME, "http", "Fallback time host %s", _http.getHost());
     }
+    return true;
+}
+
+void TimeManager::_compensate() {
+    unsigned long now = millis();
+    unsigned long elapsedMs = now - _driftMs;
+    _driftMs = now;
+    if (!_driftValid) return;
+    
+    // ppb x ms / 1000 = ns; whole microseconds join the slew
+    _driftAccNs += (int64_t)_driftPpb * (int64_t)elapsedMs / 1000;
+    int32_t us = (int32_t)(_driftAccNs / 1000);
+    _driftAccNs -= (int64_t)us * 1000;
+    _slewUs += us;
+}
+
+void TimeManager::_slew() {
+    if (_slewUs == 0) return;
+    
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    
+    // Once per second, in its second half: |step| < 0.5 s cannot cross
+    // back into the previous second
+    if (tv.tv_sec == _slewEpoch || tv.tv_usec < 500000) return;
+    
+    int32_t step = _slewUs;
+    if (step > TIME_SLEW_RATE_US) step = TIME_SLEW_RATE_US;
+    if (step < -TIME_SLEW_RATE_US) step = -TIME_SLEW_RATE_US;
+    
+    _setClockUs((int64_t)tv.tv_sec * 1000000 + tv.tv_usec + step);
+    _slewUs -= step;
+    _slewEpoch = time(nullptr);
+}
+
+void TimeManager::_setClockUs(int64_t us) {
+    struct timeval tv;
+    tv.tv_sec = (time_t)(us / 1000000);
+    tv.tv_usec = (suseconds_t)(us % 1000000);
+    settimeofday(&tv, nullptr);
+    _tmEpoch = -1;
+}
+
+void TimeManager::_save(uint8_t flags) {
+    RtcTimeRecord r;
+    memset(&r, 0, sizeof(r));
+    
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    r.magic = TIME_RTC_MAGIC;
+    r.epoch = (uint32_t)tv.tv_sec;
+    r.epochUs = (uint32_t)tv.tv_usec;
+    r.driftPpb = _driftPpb;
+    r.accuracyMs = getAccuracyMs();
+    r.source = (uint8_t)_source;
+    r.flags = flags | (_driftValid ? TIME_RTC_DRIFT : 0);
+    r.crc = crc16((const uint8_t*)&r, offsetof(RtcTimeRecord, crc));
+    
+    ESP.rtcUserMemoryWrite(TIME_RTC_OFFSET, (uint32_t*)&r, sizeof(r));
+}
+
+bool TimeManager::_restore() {
+    const rst_info* info = ESP.getResetInfoPtr();
+    uint32_t reason = info ? info->reason : REASON_DEFAULT_RST;
+    if (reason != REASON_SOFT_RESTART && reason != REASON_SOFT_WDT_RST &&
+        reason != REASON_WDT_RST && reason != REASON_EXCEPTION_RST) {
+        return false;   // RTC memory lost, or time away unknown
+    }
+    
+    RtcTimeRecord r;
+    if (!ESP.rtcUserMemoryRead(TIME_RTC_OFFSET, (uint32_t*)&r, sizeof(r)) ||
+        r.magic != TIME_RTC_MAGIC ||
+        r.crc != crc16((const uint8_t*)&r, offsetof(RtcTimeRecord, crc)) ||
+        r.epoch < TIME_VALID_EPOCH) {
+        LOG_DBG(MOD_TIME, "rtc", "No saved clock");
+        return false;
+    }
+    
+    // Unplanned reset: somewhere in the last save interval (assume half)
+    uint32_t gapMs = TIME_RTC_BOOT_MS + ((r.flags & TIME_RTC_PLANNED) ? 0 : TIME_RTC_SAVE_MS / 2);
+    uint32_t accuracyMs = r.accuracyMs + gapMs;
+    if (accuracyMs > TIME_RTC_MAX_ERR_MS) {
+        LOG_WRN(MOD_TIME, "rtc", "Saved clock too uncertain (+-%lu ms), waiting for NTP",
+                (unsigned long)accuracyMs);
+        return false;
+    }
+    
+    _setClockUs((int64_t)r.epoch * 1000000 + r.epochUs + gapMs * 1000LL + micros());
+    _source = TimeSource::RTC;
+    _synced = true;
+    _accuracyMs = accuracyMs;
+    _driftPpb = r.driftPpb;
+    _driftValid = r.flags & TIME_RTC_DRIFT;
+    _lastSyncTime = millis();
+    _lastSyncEpoch = time(nullptr);
+    
+    LOG_INF(MOD_TIME, "rtc", "Clock restored: %s (+-%lu ms, saved from %s)", getDateTimeString().c_str(),
+            (unsigned long)accuracyMs, sourceName((TimeSource)(r.source <= (uint8_t)TimeSource::MANUAL ? r.source : 0)));
+    return true;
+}
+
+void TimeManager::persist() {
+    if (!_synced) return;
+    _save(TIME_RTC_PLANNED);
+}
+
+uint32_t TimeManager::getAccuracyMs() const {
+    if (_source == TimeSource::NONE) return 0;
+    
+    uint32_t pending = (uint32_t)(_slewUs < 0 ? -_slewUs : _slewUs) / 1000;
+    uint32_t ppm = _driftValid ? TIME_DRIFT_RESIDUAL_PPM : TIME_DRIFT_UNKNOWN_PPM;
+    uint32_t aged = (millis() - _lastSyncTime) / 1000 * ppm / 1000;
+    return _accuracyMs + pending + aged;
+}
+
+uint32_t TimeManager::getNextSyncInSec() const {
+    if (_ntp.busy()) return 0;
+    
+    unsigned long waited = millis() - _lastAttemptMs;
+    return waited >= _waitMs ? 0 : (_waitMs - waited) / 1000;
+}
+
+bool TimeManager::getDriftPpb(int32_t& ppb) const {
+    ppb = _driftPpb;
+    return _driftValid;
+}
+
+const char* TimeManager::sourceName(TimeSource source) {
+    return SOURCE_NAMES[(uint8_t)source];
+}
+
+bool TimeManager::onChange(TimeChangeCallback cb) {
+    if (_listenerCount >= TIME_MAX_LISTENERS) {
+        LOG_ERR(MOD_TIME, "event", "Too many time listeners");
+        return false;
+    }
+    _listeners[_listenerCount++] = cb;
+    return true;
+}
+
+bool TimeManager::setTimezone(const char* tz) {
+    if (!posixTzValid(tz, TIMEZONE_MAX_LEN)) {
+        LOG_WRN(MOD_TIME, "tz", "Invalid TZ '%s', keeping %s", tz ? tz : "", _tz);
+        return false;
+    }
+    if (strcmp(tz, _tz) == 0) return true;
+    
+    memset(_tz, 0, sizeof(_tz));
+    strncpy(_tz, tz, sizeof(_tz) - 1);
+    setenv("TZ", _tz, 1);
+    tzset();
+    
+    // Same epoch, different wall clock: drop the caches, tell listeners
+    _tmEpoch = -1;
+    _clearSun();
+    _pendingChanges |= TIME_CHANGE_ZONE;
+    
+    LOG_INF(MOD_TIME, "tz", "Timezone %s (UTC%+ld min)", _tz, (long)getUtcOffset() / 60);
+    return true;
+}
+
+bool TimeManager::setLocation(int32_t latE4, int32_t lonE4) {
+    bool unset = latE4 == LOCATION_UNSET && lonE4 == LOCATION_UNSET;
+    if (!unset && !sunLocationValid(latE4, lonE4)) {
+        LOG_WRN(MOD_TIME, "sun", "Invalid location %ld, %ld", (long)latE4, (long)lonE4);
+        return false;
+    }
+    if (unset ? !_hasLocation : _hasLocation && latE4 == _latE4 && lonE4 == _lonE4) {
+        return true;
+    }
+    
+    _hasLocation = !unset;
+    _latE4 = latE4;
+    _lonE4 = lonE4;
+    _clearSun();
+    _pendingChanges |= TIME_CHANGE_SUN;
+    
+    if (_hasLocation) {
+        LOG_INF(MOD_TIME, "sun", "Location %ld, %ld (1e-4 deg)", (long)latE4, (long)lonE4);
+    } else {
+        LOG_INF(MOD_TIME, "sun", "Location cleared");
+    }
+    return true;
+}
+
+bool TimeManager::getSunTimes(uint16_t year, uint8_t month, uint8_t day, int16_t& sunriseMin,
+                              int16_t& sunsetMin) {
+    if (!_hasLocation) return false;
+    
+    uint32_t date = (uint32_t)year << 9 | month << 5 | day;
+    for (uint8_t i = 0; i < TIME_SUN_CACHE; i++) {
+        if (_sun[i].date == date) {
+            sunriseMin = _sun[i].sunriseMin;
+            sunsetMin = _sun[i].sunsetMin;
+            return _sun[i].up;
+        }
+    }
+    
+    unsigned long startUs = micros();
+    SunDay& s = _sun[_sunNext];
+    _sunNext = (_sunNext + 1) % TIME_SUN_CACHE;
+    int64_t rise, set;
+    s.date = date;
+    s.up = ::sunTimes(year, month, day, _latE4, _lonE4, rise, set);
+    s.sunriseMin = s.up ? sunLocalMinute(rise, day) : 0;
+    s.sunsetMin = s.up ? sunLocalMinute(set, day) : 0;
+    LOG_DBG(MOD_TIME, "sun", "%04u-%02u-%02u: %d / %d min (%lu us)", year, month, day,
+            s.sunriseMin, s.sunsetMin, micros() - startUs);
+    
+    sunriseMin = s.sunriseMin;
+    sunsetMin = s.sunsetMin;
+    return s.up;
+}
+
+bool TimeManager::sunTimes(uint16_t year, uint8_t month, uint8_t day, int16_t* sunriseMin,
+                           int16_t* sunsetMin) {
+    return timeManager.getSunTimes(year, month, day, *sunriseMin, *sunsetMin);
+}
+
+void TimeManager::_clearSun() {
+    memset(_sun, 0, sizeof(_sun));
+    _sunNext = 0;
+}
+
+int32_t TimeManager::getUtcOffset() const {
+    // newlib has no tm_gmtoff: days-from-civil on the local fields
+    const struct tm& t = getTm();
+    int64_t days = daysFromCivil(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday);
+    int64_t local = days * 86400 + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
+    return (int32_t)(local - (int64_t)_tmEpoch);
 }
 
 bool TimeManager::syncNow() {
     if (!_initialized) return false;
     
-    // Trigger resync by reconfiguring
-    configTime(TZ_OFFSET_SEC, DST_OFFSET_SEC, NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
+    // Next update() starts a round (or joins the running one)
+    _waitMs = 0;
     
     LOG_INF(MOD_TIME, "sync", "NTP sync requested");
     return true;
@@ -88,80 +570,63 @@ time_t TimeManager::getEpoch() const {
     return time(nullptr);
 }
 
-struct tm* TimeManager::_getTimeInfo() const {
+const struct tm& TimeManager::getTm() const {
     time_t now = time(nullptr);
-    return localtime(&now);
+    if (now != _tmEpoch) {
+        _tmEpoch = now;
+        localtime_r(&now, &_tm);
+    }
+    return _tm;
 }
 
 uint8_t TimeManager::getHour() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? ti->tm_hour : 0;
+    return getTm().tm_hour;
 }
 
 uint8_t TimeManager::getMinute() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? ti->tm_min : 0;
+    return getTm().tm_min;
 }
 
 uint8_t TimeManager::getSecond() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? ti->tm_sec : 0;
+    return getTm().tm_sec;
 }
 
 uint8_t TimeManager::getDayOfWeek() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? ti->tm_wday : 0;
+    return getTm().tm_wday;
 }
 
 uint8_t TimeManager::getDay() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? ti->tm_mday : 1;
+    return getTm().tm_mday;
 }
 
 uint8_t TimeManager::getMonth() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? (ti->tm_mon + 1) : 1;  // tm_mon is 0-11
+    return getTm().tm_mon + 1;  // tm_mon is 0-11
 }
 
 uint16_t TimeManager::getYear() const {
-    struct tm* ti = _getTimeInfo();
-    return ti ? (ti->tm_year + 1900) : 2000;  // tm_year is years since 1900
+    return getTm().tm_year + 1900;  // tm_year is years since 1900
 }
 
 String TimeManager::getTimeString() const {
     char buf[12];
-    struct tm* ti = _getTimeInfo();
-    if (ti) {
-        snprintf(buf, sizeof(buf), "%02d:%02d:%02d", 
-                 ti->tm_hour, ti->tm_min, ti->tm_sec);
-    } else {
-        strcpy(buf, "00:00:00");
-    }
+    const struct tm& t = getTm();
+    snprintf(buf, sizeof(buf), "%02d:%02d:%02d", t.tm_hour, t.tm_min, t.tm_sec);
     return String(buf);
 }
 
 String TimeManager::getDateString() const {
     char buf[12];
-    struct tm* ti = _getTimeInfo();
-    if (ti) {
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d",
-                 ti->tm_year + 1900, ti->tm_mon + 1, ti->tm_mday);
-    } else {
-        strcpy(buf, "2000-01-01");
-    }
+    const struct tm& t = getTm();
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d", t.tm_year + 1900, t.tm_mon + 1, t.tm_mday);
     return String(buf);
 }
 
 String TimeManager::getDateTimeString() const {
     char buf[24];
-    struct tm* ti = _getTimeInfo();
-    if (ti) {
-        snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d",
-                 ti->tm_year + 1900, ti->tm_mon + 1, ti->tm_mday,
-                 ti->tm_hour, ti->tm_min, ti->tm_sec);
-    } else {
-        strcpy(buf, "2000-01-01 00:00:00");
-    }
+    const struct tm& t = getTm();
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d",
+             t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+             t.tm_hour, t.tm_min, t.tm_sec);
     return String(buf);
 }
 
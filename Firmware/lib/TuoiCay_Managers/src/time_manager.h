@@ -3,9 +3,41 @@
  * @brief NTP Time Synchronization Manager
  * 
  * LOGIC:
- * - Sync time from NTP server on boot and periodically
- * - Timezone support (Vietnam UTC+7)
+ * - Sync time from NTP servers on boot and at an adaptive interval
+ *   (NTP_POLL_MIN_SEC..NTP_POLL_MAX_SEC); each round queries all servers
+ *   and applies the best answer (ntp_client.h)
+ * - Timezone is a POSIX TZ string (default DEFAULT_TIMEZONE, Vietnam
+ *   UTC+7): DST rules come from the string, the C library applies them
+ *   in localtime_r() / mktime()
+ * - setTimezone() checks the string first (posix_tz.h): a malformed TZ
+ *   would silently become UTC
  * - Formatted time strings for logging and display
+ * - Broken-down local time cached per second: getters share one
+ *   localtime_r() per second instead of one per call
+ * - Warm boot: the clock is written to RTC user memory every second (and
+ *   right before a planned restart, persist()); after a soft reset, WDT or
+ *   exception the record is read back and the clock runs again before
+ *   WiFi is up, with an error bound (accuracy) that grows per reboot
+ * - NTP corrections up to TIME_SLEW_MAX_MS are slewed (spread over
+ *   TIME_SLEW_RATE_US per second) instead of stepping the clock; larger
+ *   ones step. Successive NTP offsets give a crystal drift estimate,
+ *   compensated every second between syncs
+ * - getAccuracyMs(): error bound from the last sync's delay, grown with
+ *   time since by the drift uncertainty
+ * - Fallback sources for networks that block NTP: the HTTP Date header
+ *   of a local host (probed here while NTP gets no answer), the MQTT
+ *   time topic and a manual set (both handed in through setTime()).
+ *   Priority NTP > HTTP > MQTT > manual > RTC: a higher one always
+ *   replaces the clock, a lower or equal one only when NTP is not
+ *   answering and it is at least as accurate as the clock is by now
+ * - update() ticks once per second and tells subscribers when the minute,
+ *   hour or day changed (after the first sync; a clock jump counts too),
+ *   and when the timezone changed (TIME_CHANGE_ZONE)
+ * - Sunrise / sunset for the configured location (sun_calc.h, integer
+ *   math, well under 1 ms): computed per local date on first use and
+ *   cached (TIME_SUN_CACHE dates), today's warmed at each new day.
+ *   setLocation() / setTimezone() drop the cache; setLocation() reports
+ *   TIME_CHANGE_SUN so schedules anchored to the sun replan
  * 
  * RULES: #TIME(12)
  */
@@ -15,7 +47,10 @@
 
 #include <Arduino.h>
 #include <time.h>
+#include <sys/time.h>
 #include <config.h>
+#include "ntp_client.h"
+#include "http_date_client.h"
 
 //=============================================================================
 // NTP CONFIGURATION
@@ -23,10 +58,75 @@
 #define NTP_SERVER_1        "pool.ntp.org"
 #define NTP_SERVER_2        "time.nist.gov"
 #define NTP_SERVER_3        "time.google.com"
+#define NTP_STABLE_MS       50      // Off by at most this: poll half as often
+#define NTP_UNSTABLE_MS     250     // Off by more: poll twice as often
 
-// Vietnam timezone: UTC+7, no DST
-#define TZ_OFFSET_SEC       (NTP_TIMEZONE_OFFSET * 3600)
-#define DST_OFFSET_SEC      0
+#define TIME_VALID_EPOCH    1609459200  // 2021-01-01: earlier = clock not set
+
+// Warm boot restore (RTC user memory, 4-byte blocks; 0-31 belong to the
+// OTA updater's eboot command)
+#define TIME_RTC_OFFSET     32
+#define TIME_RTC_MAGIC      0x54494D45  // "TIME"
+#define TIME_RTC_SAVE_MS    1000        // Saved on every tick
+#define TIME_RTC_BOOT_MS    250         // Reset + boot ROM before micros() counts
+#define TIME_RTC_MAX_ERR_MS 60000       // Less sure than this: wait for NTP
+
+// Slew
+#define TIME_SLEW_MAX_MS    5000        // Larger NTP offsets step the clock
+#define TIME_SLEW_RATE_US   20000       // Correction applied per second (2%)
+#define TIME_DRIFT_MIN_SEC  600         // Shorter NTP spans give no drift sample
+#define TIME_DRIFT_MAX_PPB  500000      // Larger estimates are bad samples (500 ppm)
+#define TIME_DRIFT_UNKNOWN_PPM 50       // Error growth before drift is measured
+#define TIME_DRIFT_RESIDUAL_PPM 5       // Error growth with drift compensated
+
+// Fallback sources (NTP blocked)
+#define TIME_HTTP_POLL_SEC  900         // HTTP Date probe interval while NTP is out
+#define TIME_MQTT_INTERVAL_SEC 60       // Time topic republish period when not sent
+#define TIME_MQTT_TRANSIT_MS 250        // Publisher -> broker -> device
+#define TIME_MANUAL_ACCURACY_MS 2000    // Browser clock + request transit
+
+// Sunrise / sunset
+#define TIME_SUN_CACHE      4           // Local dates kept (planning looks a few days ahead)
+
+// Change events (TimeChangeCallback flags, combined: a new day is also a
+// new hour and a new minute)
+#define TIME_CHANGE_MINUTE  0x01
+#define TIME_CHANGE_HOUR    0x02
+#define TIME_CHANGE_DAY     0x04
+#define TIME_CHANGE_ZONE    0x08    // setTimezone(): local times moved
+#define TIME_CHANGE_SUN     0x10    // setLocation(): sun times moved
+#define TIME_MAX_LISTENERS  4
+
+typedef void (*TimeChangeCallback)(uint8_t changes, const struct tm& now);
+
+/**
+ * @brief Where the current time came from
+ */
+enum class TimeSource : uint8_t {
+    NONE = 0,       // Not set (counts from 1970)
+    RTC,            // Restored from RTC memory after a warm reboot
+    NTP,
+    HTTP,           // Date header of the configured local host
+    MQTT,           // Broker's time topic
+    MANUAL          // Set from the dashboard / POST /api/time
+};
+
+/**
+ * @brief Clock snapshot kept in RTC user memory (survives a soft reset)
+ */
+struct RtcTimeRecord {
+    uint32_t magic;
+    uint32_t epoch;             // Wall clock when saved ...
+    uint32_t epochUs;           // ... and its microseconds
+    int32_t driftPpb;           // Crystal drift, + = local clock slow
+    uint32_t accuracyMs;        // Error bound of epoch when saved
+    uint8_t source;             // TimeSource of the saved time
+    uint8_t flags;              // TIME_RTC_PLANNED, TIME_RTC_DRIFT
+    uint16_t crc;               // crc16 of the fields above
+};
+
+#define TIME_RTC_PLANNED    0x01        // Saved by persist() right before restart
+#define TIME_RTC_DRIFT      0x02        // driftPpb was measured
 
 //=============================================================================
 // TIME MANAGER CLASS
@@ -56,15 +156,126 @@ public:
     bool syncNow();
     
     /**
-     * @brief Check if time has been synchronized
+     * @brief Apply a POSIX TZ string, e.g. "ICT-7" or "CET-1CEST,M3.5.0,M10.5.0/3"
+     * @return false if the string is malformed (timezone unchanged)
+     */
+    bool setTimezone(const char* tz);
+    
+    /**
+     * @brief POSIX TZ string in use
+     */
+    const char* getTimezone() const { return _tz; }
+    
+    /**
+     * @brief Local time is daylight saving time now
+     */
+    bool isDst() const { return getTm().tm_isdst > 0; }
+    
+    /**
+     * @brief Current local - UTC offset in seconds (DST included)
+     */
+    int32_t getUtcOffset() const;
+    
+    /**
+     * @brief Offer the time from a fallback source (MQTT, manual)
+     * @param unixUs The source's time now, us since 1970
+     * @param accuracyMs Its error bound
+     * @return false if implausible, or the clock is better already (see
+     *         the priority order above)
+     */
+    bool setTime(TimeSource source, int64_t unixUs, uint32_t accuracyMs);
+    
+    /**
+     * @brief Local HTTP server read while NTP is out, "name[:port]" ("" = none)
+     * @return false if malformed (host unchanged)
+     */
+    bool setTimeHost(const char* host);
+    
+    const HttpDateClient& getHttp() const { return _http; }
+    
+    /**
+     * @brief Site location for sunrise / sunset, 1e-4 degrees (north / east +);
+     *        both LOCATION_UNSET clears it
+     * @return false if out of range (location unchanged)
+     */
+    bool setLocation(int32_t latE4, int32_t lonE4);
+    
+    bool hasLocation() const { return _hasLocation; }
+    int32_t getLatitudeE4() const { return _latE4; }
+    int32_t getLongitudeE4() const { return _lonE4; }
+    
+    /**
+     * @brief Sunrise / sunset of a local date, minutes after local midnight
+     *        (past midnight reads as 1440+), cached per date
+     * @return false without a location, or if the sun does not rise / set
+     */
+    bool getSunTimes(uint16_t year, uint8_t month, uint8_t day, int16_t& sunriseMin,
+                     int16_t& sunsetMin);
+    
+    /**
+     * @brief getSunTimes() of the global instance, as a ScheduleSunFunc
+     */
+    static bool sunTimes(uint16_t year, uint8_t month, uint8_t day, int16_t* sunriseMin,
+                         int16_t* sunsetMin);
+    
+    /**
+     * @brief Check if time is valid (any source, or restored after a warm reboot)
      */
     bool isSynced() const { return _synced; }
     
+    TimeSource getSource() const { return _source; }
+    
+    static const char* sourceName(TimeSource source);
+    
+    /**
+     * @brief Error bound of the clock (ms), including a pending slew
+     */
+    uint32_t getAccuracyMs() const;
+    
+    /**
+     * @brief Crystal drift estimate, parts per billion (+ = local clock slow)
+     * @return false if not measured yet
+     */
+    bool getDriftPpb(int32_t& ppb) const;
+    
+    /**
+     * @brief Current sync interval (adaptive), seconds
+     */
+    uint32_t getPollSec() const { return _pollSec; }
+    
+    /**
+     * @brief Seconds until the next NTP round (0 = running or due)
+     */
+    uint32_t getNextSyncInSec() const;
+    
+    /**
+     * @brief Per-server results; best server of the last good round
+     */
+    const NtpClient& getNtp() const { return _ntp; }
+    int8_t getNtpServer() const { return _bestServer; }
+    
+    /**
+     * @brief Save the clock for the next boot; call right before a planned
+     *        restart (OTA, provisioning) so no save interval is lost
+     */
+    void persist();
+    
     /**
      * @brief Get current epoch time (seconds since 1970)
      */
     time_t getEpoch() const;
     
+    /**
+     * @brief Local time, converted at most once per second
+     */
+    const struct tm& getTm() const;
+    
+    /**
+     * @brief Subscribe to minute / hour / day changes (called from update())
+     * @return false if TIME_MAX_LISTENERS are already registered
+     */
+    bool onChange(TimeChangeCallback cb);
+    
     /**
      * @brief Get current hour (0-23)
      */
@@ -124,12 +335,108 @@ private:
     bool _initialized;
     bool _synced;
     unsigned long _lastSyncTime;    // millis() when last synced
+    char _tz[TIMEZONE_MAX_LEN + 1];
     time_t _lastSyncEpoch;          // epoch when last synced
     
+    // Per-second cache (refreshed by whichever getter runs first)
+    mutable struct tm _tm;
+    mutable time_t _tmEpoch;        // Second _tm was converted for
+    
+    // Change events
+    TimeChangeCallback _listeners[TIME_MAX_LISTENERS];
+    uint8_t _listenerCount;
+    struct tm _lastTick;            // Local time at the previous tick
+    time_t _lastTickEpoch;
+    bool _tickValid;                // _lastTick is a synced time
+    uint8_t _pendingChanges;        // Flags for the next tick (ZONE)
+    
+    // Clock discipline
+    TimeSource _source;
+    uint32_t _accuracyMs;           // Error bound at the last sync / restore
+    int32_t _slewUs;                // Correction still to apply
+    time_t _slewEpoch;              // Second of the last slew step
+    int32_t _driftPpb;
+    bool _driftValid;
+    int64_t _driftAccNs;            // Compensation below 1 us, carried over
+    unsigned long _driftMs;         // millis() of the last compensation
+    
+    // NTP rounds
+    NtpClient _ntp;
+    uint32_t _pollSec;
+    unsigned long _lastAttemptMs;   // millis() when the last round started
+    unsigned long _waitMs;          // Until the next round
+    int8_t _bestServer;
+    bool _ntpOut;                   // Last round got no answer
+    
+    // HTTP Date fallback
+    HttpDateClient _http;
+    unsigned long _httpLastMs;      // millis() when the last probe started
+    unsigned long _httpWaitMs;      // Until the next probe
+    
+    // Sunrise / sunset (valid before begin(): the global is zeroed)
+    struct SunDay {
+        uint32_t date;              // year << 9 | month << 5 | day, 0 = empty
+        int16_t sunriseMin;
+        int16_t sunsetMin;
+        bool up;                    // false: no sunrise / sunset that day
+    };
+    bool _hasLocation;
+    int32_t _latE4;
+    int32_t _lonE4;
+    SunDay _sun[TIME_SUN_CACHE];
+    uint8_t _sunNext;               // Slot to overwrite next (round robin)
+    
     /**
-     * @brief Get current time struct
+     * @brief Once per second: compare with the last tick, notify listeners
      */
-    struct tm* _getTimeInfo() const;
+    void _tick();
+    
+    /**
+     * @brief Round over: apply the best server or schedule a retry
+     */
+    void _onRound();
+    
+    /**
+     * @brief Slew or step by the measured offset, update drift / interval
+     */
+    void _applyNtp(const NtpServerStats& server);
+    
+    /**
+     * @brief Probe the HTTP host while NTP is out, offer what it answers
+     */
+    void _updateHttp();
+    
+    /**
+     * @brief Apply a fallback sample if its source / accuracy wins
+     */
+    bool _offer(TimeSource source, int64_t offsetUs, uint32_t accuracyMs);
+    
+    /**
+     * @brief Slew or step by offsetUs and make source the clock's source
+     */
+    void _apply(TimeSource source, int64_t offsetUs, uint32_t accuracyMs);
+    
+    /**
+     * @brief Add drift x elapsed time to the slew (every tick)
+     */
+    void _compensate();
+    
+    /**
+     * @brief Apply up to TIME_SLEW_RATE_US of _slewUs, once per second
+     */
+    void _slew();
+    
+    void _setClockUs(int64_t us);
+    
+    void _save(uint8_t flags);
+    
+    /**
+     * @brief Warm boot: restore the clock from RTC memory
+     * @return true if the clock was set
+     */
+    bool _restore();
+    
+    void _clearSun();
 };
 
 // Global instance
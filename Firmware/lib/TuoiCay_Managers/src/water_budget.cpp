@@ -0,0 +1,206 @@
+/**
+ * @file water_budget.cpp
+ * @brief Implementation of the weather-aware water budget
+ *
+ * LOGIC:
+ * - ingest() validates every field before touching the stored forecast:
+ *   a bad payload leaves the previous one in use
+ * - _recompute() runs only on ingest / clear / expiry; the getters used
+ *   by the scheduler and autoWatering() are plain reads
+ *
+ * RULES: #ACTUATOR(15) #MQTT(9)
+ */
+
+#include "water_budget.h"
+#include <logger.h>
+
+// Global instance
+WaterBudget waterBudget;
+
+static const char* const SOURCE_NAMES[] = { "none", "device", "group" };
+
+/**
+ * @brief Optional number field scaled to tenths, range-checked
+ * @param present Output: field was sent
+ */
+static bool readTenths(JsonVariantConst obj, const char* key, long min10, long max10,
+                       bool& present, long& value10) {
+    JsonVariantConst field = obj[key];
+    present = !field.isNull();
+    if (!present) return true;
+    if (!field.is<float>()) return false;
+    
+    float v = field.as<float>() * 10.0f;
+    value10 = (long)(v < 0 ? v - 0.5f : v + 0.5f);
+    return value10 >= min10 && value10 <= max10;
+}
+
+//=============================================================================
+// WATER BUDGET IMPLEMENTATION
+//=============================================================================
+
+WaterBudget::WaterBudget()
+    : _source(WeatherSource::NONE), _percent(100), _dryShift(0),
+      _et0Mm10(BUDGET_ET0_REF_MM10), _rainMm10(0) {
+    memset(_forecasts, 0, sizeof(_forecasts));
+}
+
+const char* WaterBudget::ingest(JsonVariantConst data, WeatherSource source) {
+    if (source == WeatherSource::NONE) return "no source";
+    if (!data.is<JsonObjectConst>()) return "forecast must be an object";
+    
+    WeatherForecast f;
+    memset(&f, 0, sizeof(f));
+    long rain = 0, temp = 0, et0 = 0;
+    
+    if (!readTenths(data, "rain", 0, 5000, f.hasRain, rain)) {
+        return "rain must be 0-500 mm";
+    }
+    if (!readTenths(data, "temp", -300, 600, f.hasTemp, temp)) {
+        return "temp must be -30..60 C";
+    }
+    if (!readTenths(data, "et0", 0, 200, f.hasEt0, et0)) {
+        return "et0 must be 0-20 mm/day";
+    }
+    if (!f.hasRain && !f.hasTemp && !f.hasEt0) {
+        return "rain, temp or et0 required";
+    }
+    
+    JsonVariantConst prob = data["rain_prob"];
+    if (!prob.isNull() && (!prob.is<long>() || prob.as<long>() < 0 || prob.as<long>() > 100)) {
+        return "rain_prob must be 0-100 %";
+    }
+    JsonVariantConst ttl = data["ttl"];
+    if (!ttl.isNull() && (!ttl.is<long>() || ttl.as<long>() < 1 || ttl.as<long>() > BUDGET_TTL_MAX_H)) {
+        return "ttl must be 1-72 hours";
+    }
+    
+    f.valid = true;
+    f.rainMm10 = (uint16_t)rain;
+    f.rainProb = prob.isNull() ? 100 : (uint8_t)prob.as<long>();
+    f.tempC10 = (int16_t)temp;
+    f.et0Mm10 = (uint16_t)et0;
+    f.receivedMs = millis();
+    f.ttlMs = (ttl.isNull() ? BUDGET_TTL_DEFAULT_H : (unsigned long)ttl.as<long>()) * 3600000UL;
+    
+    _forecasts[(uint8_t)source - 1] = f;
+    _recompute();
+    
+    LOG_INF(MOD_BUDGET, "ingest", "%s forecast: rain=%d.%dmm@%d%%, et0=%d.%dmm -> %d%%%s",
+            sourceName(source), f.rainMm10 / 10, f.rainMm10 % 10, f.rainProb,
+            _et0Mm10 / 10, _et0Mm10 % 10, _percent,
+            _source == source ? "" : " (device forecast wins)");
+    return nullptr;
+}
+
+void WaterBudget::clear(WeatherSource source) {
+    if (source == WeatherSource::NONE) return;
+    
+    WeatherForecast& f = _forecasts[(uint8_t)source - 1];
+    if (!f.valid) return;
+    
+    f.valid = false;
+    _recompute();
+    LOG_INF(MOD_BUDGET, "clear", "%s forecast cleared, budget %d%%", sourceName(source), _percent);
+}
+
+void WaterBudget::update() {
+    for (uint8_t i = 0; i < 2; i++) {
+        WeatherForecast& f = _forecasts[i];
+        if (f.valid && millis() - f.receivedMs >= f.ttlMs) {
+            f.valid = false;
+            _recompute();
+            LOG_WRN(MOD_BUDGET, "expire", "%s forecast expired, budget %d%%",
+                    sourceName((WeatherSource)(i + 1)), _percent);
+        }
+    }
+}
+
+void WaterBudget::_recompute() {
+    const WeatherForecast& device = _forecasts[(uint8_t)WeatherSource::DEVICE - 1];
+    const WeatherForecast& group = _forecasts[(uint8_t)WeatherSource::GROUP - 1];
+    
+    _source = device.valid ? WeatherSource::DEVICE
+            : group.valid ? WeatherSource::GROUP : WeatherSource::NONE;
+    
+    const WeatherForecast* f = getForecast();
+    if (!f) {
+        _percent = 100;
+        _dryShift = 0;
+        _et0Mm10 = BUDGET_ET0_REF_MM10;
+        _rainMm10 = 0;
+        return;
+    }
+    
+    long et0 = BUDGET_ET0_REF_MM10;
+    if (f->hasEt0) {
+        et0 = f->et0Mm10;
+    } else if (f->hasTemp) {
+        // 0.1 C * 0.01 mm/C -> 0.1 mm: divide by 100
+        et0 += ((long)f->tempC10 - BUDGET_TEMP_REF_C10) * BUDGET_ET0_PER_C_MM100 / 100;
+        if (et0 < 0) et0 = 0;
+    }
+    long rain = f->hasRain ? (long)f->rainMm10 * f->rainProb / 100 : 0;
+    
+    _et0Mm10 = (uint16_t)et0;
+    _rainMm10 = (uint16_t)rain;
+    
+    if (rain >= BUDGET_RAIN_SKIP_MM10 || (rain > 0 && rain >= et0)) {
+        _percent = 0;
+        _dryShift = -BUDGET_DRY_SHIFT_MAX;
+        return;
+    }
+    
+    long percent = (et0 - rain) * 100 / BUDGET_ET0_REF_MM10;
+    if (percent < BUDGET_MIN_PERCENT) percent = BUDGET_MIN_PERCENT;
+    if (percent > BUDGET_MAX_PERCENT) percent = BUDGET_MAX_PERCENT;
+    _percent = (uint8_t)percent;
+    
+    long shift = (percent - 100) / 10;
+    if (shift < -BUDGET_DRY_SHIFT_MAX) shift = -BUDGET_DRY_SHIFT_MAX;
+    if (shift > BUDGET_DRY_SHIFT_MAX) shift = BUDGET_DRY_SHIFT_MAX;
+    _dryShift = (int8_t)shift;
+}
+
+uint16_t WaterBudget::scaleDuration(uint16_t seconds) const {
+    if (_percent == 0) return 0;
+    
+    uint32_t scaled = ((uint32_t)seconds * _percent + 50) / 100;
+    if (scaled < 1) scaled = 1;
+    if (scaled > PUMP_MAX_RUNTIME_SEC) scaled = PUMP_MAX_RUNTIME_SEC;
+    return (uint16_t)scaled;
+}
+
+void WaterBudget::adjustThresholds(uint8_t& dry, uint8_t& wet) const {
+    int d = dry + _dryShift;
+    int w = wet + _dryShift;
+    
+    // Same shift on both keeps the hysteresis gap; slide back inside 0-100
+    if (w > MOISTURE_MAX_VALID) {
+        d -= w - MOISTURE_MAX_VALID;
+        w = MOISTURE_MAX_VALID;
+    }
+    if (d < MOISTURE_MIN_VALID) {
+        w += MOISTURE_MIN_VALID - d;
+        d = MOISTURE_MIN_VALID;
+    }
+    dry = (uint8_t)d;
+    wet = (uint8_t)w;
+}
+
+const WeatherForecast* WaterBudget::getForecast() const {
+    if (_source == WeatherSource::NONE) return nullptr;
+    return &_forecasts[(uint8_t)_source - 1];
+}
+
+uint32_t WaterBudget::getExpiresInSec() const {
+    const WeatherForecast* f = getForecast();
+    if (!f) return 0;
+    
+    unsigned long age = millis() - f->receivedMs;
+    return age >= f->ttlMs ? 0 : (f->ttlMs - age) / 1000;
+}
+
+const char* WaterBudget::sourceName(WeatherSource source) {
+    return SOURCE_NAMES[(uint8_t)source];
+}
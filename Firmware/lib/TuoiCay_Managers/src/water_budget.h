@@ -0,0 +1,146 @@
+/**
+ * @file water_budget.h
+ * @brief Weather-aware water budget for scheduled and auto watering
+ *
+ * LOGIC:
+ * - Forecasts arrive as retained MQTT messages on devices/{id}/weather or
+ *   groups/{group}/weather: {"rain": 2.5, "rain_prob": 60, "temp": 34,
+ *   "et0": 6.1, "ttl": 24}; an empty retained message clears one
+ * - A device forecast wins over the group one while it is valid; each
+ *   expires after its ttl (hours) and the budget falls back to 100%
+ * - Demand = ET0 (sent, else estimated from max temp, else reference)
+ *   minus expected rain (rain x probability)
+ * - Budget percent = demand / BUDGET_ET0_REF_MM10, clamped to
+ *   BUDGET_MIN_PERCENT..BUDGET_MAX_PERCENT; 0 (skip) when expected rain
+ *   reaches BUDGET_RAIN_SKIP_MM10 or covers the whole ET0
+ * - Schedule durations are scaled by the percent; auto thresholds shift
+ *   by (percent - 100) / 10 moisture points (hot: start earlier, stop later)
+ * - All values are integer tenths (mm, C): no float after ingest
+ *
+ * RULES: #ACTUATOR(15) #MQTT(9)
+ */
+
+#ifndef WATER_BUDGET_H
+#define WATER_BUDGET_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <config.h>
+
+enum class WeatherSource : uint8_t {
+    NONE = 0,       // No valid forecast: budget 100%
+    DEVICE = 1,     // devices/{id}/weather
+    GROUP = 2       // groups/{group}/weather
+};
+
+/**
+ * @brief One ingested forecast (fields not sent have has* = false)
+ */
+struct WeatherForecast {
+    bool valid;
+    bool hasRain;
+    bool hasTemp;
+    bool hasEt0;
+    uint16_t rainMm10;          // Forecast rain, 0.1 mm
+    uint8_t rainProb;           // Rain probability %
+    int16_t tempC10;            // Max temperature, 0.1 C
+    uint16_t et0Mm10;           // Reference evapotranspiration, 0.1 mm/day
+    unsigned long receivedMs;   // millis() at ingest
+    unsigned long ttlMs;
+};
+
+//=============================================================================
+// WATER BUDGET CLASS
+//=============================================================================
+
+/**
+ * @class WaterBudget
+ * @brief Turns the active forecast into a duration scale and threshold shift
+ */
+class WaterBudget {
+public:
+    WaterBudget();
+    
+    /**
+     * @brief Validate and store a forecast payload
+     * @return nullptr on success, else the reason it was rejected
+     */
+    const char* ingest(JsonVariantConst data, WeatherSource source);
+    
+    /**
+     * @brief Drop the forecast of one source (empty retained message)
+     */
+    void clear(WeatherSource source);
+    
+    /**
+     * @brief Expire forecasts past their ttl (call in loop)
+     */
+    void update();
+    
+    /**
+     * @brief Budget in percent of configured durations (0 = skip runs)
+     */
+    uint8_t getPercent() const { return _percent; }
+    
+    bool isSkipping() const { return _percent == 0; }
+    
+    /**
+     * @brief Auto threshold shift in moisture points (+ = water earlier)
+     */
+    int8_t getDryShift() const { return _dryShift; }
+    
+    /**
+     * @brief Duration scaled by the budget (0 when skipping)
+     */
+    uint16_t scaleDuration(uint16_t seconds) const;
+    
+    /**
+     * @brief Shift both auto thresholds, keeping them 0-100 and apart
+     */
+    void adjustThresholds(uint8_t& dry, uint8_t& wet) const;
+    
+    /**
+     * @brief Source of the forecast in use
+     */
+    WeatherSource getSource() const { return _source; }
+    
+    /**
+     * @brief Forecast in use (nullptr = none)
+     */
+    const WeatherForecast* getForecast() const;
+    
+    /**
+     * @brief ET0 the budget used (sent or estimated), 0.1 mm/day
+     */
+    uint16_t getEt0Mm10() const { return _et0Mm10; }
+    
+    /**
+     * @brief Expected rain (rain x probability), 0.1 mm
+     */
+    uint16_t getRainMm10() const { return _rainMm10; }
+    
+    /**
+     * @brief Seconds until the forecast in use expires (0 = none)
+     */
+    uint32_t getExpiresInSec() const;
+    
+    static const char* sourceName(WeatherSource source);
+
+private:
+    WeatherForecast _forecasts[2];  // Indexed by source - 1
+    WeatherSource _source;
+    uint8_t _percent;
+    int8_t _dryShift;
+    uint16_t _et0Mm10;
+    uint16_t _rainMm10;
+    
+    /**
+     * @brief Pick the forecast in use and derive percent / shift from it
+     */
+    void _recompute();
+};
+
+// Global instance
+extern WaterBudget waterBudget;
+
+#endif // WATER_BUDGET_H
@@ -4,7 +4,64 @@
  * 
  * LOGIC:
  * - REST API with JSON responses
- * - Simple HTML dashboard in PROGMEM
+ * - Dashboard built from web/index.html by tools/build_dashboard.py into
+ *   two forms: data/www on LittleFS (index.html.gz + app.<hash>.css/js.gz,
+ *   image made with `pio run -t buildfs`) and a single gzip page in PROGMEM
+ *   (dashboard_html.h). GET / serves the LittleFS index when begin() found
+ *   one, else the PROGMEM page, so a device without a filesystem image
+ *   still has a UI. A UI change then only needs uploadfs, not a firmware OTA
+ * - Index served with Content-Encoding: gzip + strong ETag + no-cache; a
+ *   matching If-None-Match is answered with 304 and no body. Assets under
+ *   /assets/ carry their content hash in the name, so they are sent with a
+ *   one-year immutable Cache-Control and never revalidated
+ * - Files are streamed from flash WEB_FILE_CHUNK_SIZE bytes at a time
+ * - GET /api/events keeps up to WEB_EVENTS_MAX_CLIENTS Server-Sent Events
+ *   streams open: full snapshot on connect, then only changed fields
+ *   (moisture, pump, mode, thresholds), checked every WEB_EVENTS_CHECK_MS
+ * - A stream whose socket buffer cannot take the next event is closed
+ *   instead of blocking loop(); the browser reconnects and resyncs
+ * - Routes live in one table (ROUTES). ROUTE_INDEX is a perfect hash of
+ *   method + path built by the compiler (route_table.h); a collision fails
+ *   the build. Each backend registers a single catch-all that looks the
+ *   request up (one hash, one strcmp) instead of matching routes linearly.
+ *   Known path with the wrong method -> 405, unknown path -> 404
+ * - Request bodies are parsed once in _dispatch, before the handler, into
+ *   _doc whose memory comes from a fixed arena (json_arena.h): no String
+ *   copy of the body, no heap allocation per parse. Missing body on a
+ *   route that needs one, malformed JSON or an arena overflow are answered
+ *   there; handlers validate fields (_readInt) and answer with _sendError
+ * - Backends:
+ *   - sync (default): HttpConnectionPool (http_pool.h) keeps up to
+ *     WEB_MAX_CONNECTIONS sockets open between requests (HTTP/1.1
+ *     keep-alive, pipelined requests answered in order); one complete
+ *     request is handled per update(). Responses carry Content-Length or
+ *     chunked encoding so the socket can stay open; event streams are
+ *     detached from the pool but still count against its socket budget
+ *   - WEB_ASYNC_BACKEND: ESPAsyncWebServer accepts connections, parses
+ *     headers and collects the body incrementally (onBody chunks, max
+ *     WEB_MAX_BODY_SIZE) in lwIP callbacks; the request is queued and one
+ *     handler runs per update(), so pump/storage callbacks never execute
+ *     in network context. Responses are streamed by the library as TCP
+ *     window allows (dashboard straight from PROGMEM), never blocking loop()
+ * - Handlers only use the backend adapter (_isGet, _header, _send...)
+ * - JSON responses are written with JsonWriter into a Response: a
+ *   WEB_RESPONSE_BUFFER_SIZE stack buffer sent with Content-Length when the
+ *   body fits, streamed as chunked transfer encoding when it does not -
+ *   no String building, no JsonDocument for output
+ * - GET /api/state returns status, schedule, speed, thresholds and
+ *   sensor/WiFi/MQTT health from one callback pass. The snapshot (minus
+ *   uptime, heap and RSSI, which tick constantly) is hashed; a changed hash
+ *   bumps the state version, sent as ETag. If-None-Match with the current
+ *   version is answered 304 without a body. The version starts at a random
+ *   offset each boot so a pre-reboot version is not mistaken for current.
+ * - POST /api/batch runs every operation through ConfigBatch first; one
+ *   bad operation rejects the batch with its index and nothing changes.
+ *   A valid batch goes to the apply callback, which persists once
+ * - GET /api/perf reports loop latency, heap and request counters;
+ *   POST /api/perf resets the peak values (used by tools/web_load_test.py)
+ * - GET /metrics writes OpenMetrics text with MetricsWriter into the same
+ *   Response (chunked once past the buffer): sensors, pump, MQTT, WiFi,
+ *   heap, loop histogram and NTP age from one callback pass, no heap
  * - CORS headers for development
  * 
  * RULES: #HTTP(24) #JSON(23)
@@ -12,399 +69,193 @@
 
 #include "web_server.h"
 #include <logger.h>
-#include <ArduinoJson.h>
+#include <json_writer.h>
+#include <metrics_writer.h>
+#include <error_codes.h>
+#include "config_batch.h"
+#include "dashboard_html.h"
+#include <stdarg.h>
+#include <LittleFS.h>
+
+#ifdef WEB_ASYNC_BACKEND
+#include <ESPAsyncWebServer.h>
+#endif
+
+/**
+ * @class StateHasher
+ * @brief Print sink that only hashes what is written (FNV-1a 32 bit)
+ * Running the /api/state writer through it detects content changes
+ * without keeping a copy of the previous snapshot.
+ */
+class StateHasher : public Print {
+public:
+    StateHasher() : _hash(2166136261UL) {}
+    
+    size_t write(uint8_t c) override {
+        _hash = (_hash ^ c) * 16777619UL;
+        return 1;
+    }
+    
+    size_t write(const uint8_t* data, size_t len) override {
+        for (size_t i = 0; i < len; i++) {
+            _hash = (_hash ^ data[i]) * 16777619UL;
+        }
+        return len;
+    }
+    
+    uint32_t hash() const { return _hash; }
+    
+private:
+    uint32_t _hash;
+};
+
+/**
+ * @brief Parse an If-None-Match value: "123", W/"123" or bare 123
+ * @return true if it names the given version
+ */
+static bool matchesVersion(const char* value, uint32_t version) {
+    if (strncmp(value, "W/", 2) == 0) {
+        value += 2;
+    }
+    if (*value == '"') {
+        value++;
+    }
+    
+    char* end;
+    unsigned long parsed = strtoul(value, &end, 10);
+    return end != value && (*end == '\0' || *end == '"') && parsed == version;
+}
+
+/**
+ * @brief Dotted IPv4 into a caller buffer (IPAddress::toString allocates)
+ */
+static void formatIp(char* buf, size_t size, const IPAddress& addr) {
+    snprintf(buf, size, "%u.%u.%u.%u", addr[0], addr[1], addr[2], addr[3]);
+}
 
 //=============================================================================
-// HTML DASHBOARD (PROGMEM to save RAM)
+// SERVER-SENT EVENTS HELPERS
 //=============================================================================
-static const char INDEX_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>TuoiCay v1.0</title>
-    <style>*{box-sizing:border-box;margin:0;padding:0}body{font-family:Arial,sans-serif;background:#1a1a2e;color:#eee;padding:20px}.container{max-width:500px;margin:0 auto}h1{color:#00d9ff;text-align:center;margin-bottom:20px}.card{background:#16213e;border-radius:10px;padding:20px;margin-bottom:15px}.card h2{color:#00d9ff;font-size:14px;margin-bottom:10px;text-transform:uppercase}.value{font-size:36px;font-weight:bold;color:#fff}.unit{font-size:18px;color:#888}.status{display:inline-block;padding:5px 15px;border-radius:20px;font-weight:bold}.status.on{background:#00c853;color:#fff}.status.off{background:#ff5252;color:#fff}.status.auto{background:#2196f3;color:#fff}.status.manual{background:#ff9800;color:#fff}.btn{display:block;width:100%;padding:15px;border:none;border-radius:8px;font-size:16px;font-weight:bold;cursor:pointer;margin-top:10px}.btn-pump{background:#00d9ff;color:#1a1a2e}.btn-mode{background:#7c4dff;color:#fff}.btn:active{transform:scale(0.98)}.row{display:flex;gap:15px}.row .card{flex:1}.config{display:flex;align-items:center;gap:10px;margin-top:10px}.config input{flex:1;padding:10px;border:1px solid #333;border-radius:5px;background:#0f0f23;color:#fff}.info{font-size:12px;color:#666;text-align:center;margin-top:20px}.schedule-item{display:flex;align-items:center;gap:8px;margin:8px 0;padding:10px;background:#0f0f23;border-radius:8px}.schedule-item input[type="time"]{padding:8px;border:1px solid #333;border-radius:5px;background:#1a1a2e;color:#fff}.schedule-item input[type="number"]{width:60px;padding:8px;border:1px solid #333;border-radius:5px;background:#1a1a2e;color:#fff}.schedule-item label{font-size:12px;color:#888}.switch{position:relative;width:50px;height:26px}.switch input{opacity:0;width:0;height:0}.slider{position:absolute;cursor:pointer;top:0;left:0;right:0;bottom:0;background:#333;border-radius:26px;transition:0.3s}.slider:before{position:absolute;content:"";height:20px;width:20px;left:3px;bottom:3px;background:#fff;border-radius:50%;transition:0.3s}input:checked+.slider{background:#00c853}input:checked+.slider:before{transform:translateX(24px)}.btn-small{padding:8px 15px;font-size:14px}</style>
-</head>
-<body>
-    <div class="container">
-        <h1>🌱 TuoiCay v1.0</h1>
-        
-        <div class="card">
-            <h2>Độ ẩm đất</h2>
-            <span class="value" id="moisture">--</span><span class="unit">%</span>
-        </div>
-        
-        <div class="row">
-            <div class="card">
-                <h2>Máy bơm</h2>
-                <span class="status off" id="pumpStatus">OFF</span>
-                <div id="pumpInfo" style="font-size:12px; color:#888; margin-top:5px;"></div>
-                <button class="btn btn-pump" onclick="togglePump()">BẬT/TẮT BƠM</button>
-            </div>
-            <div class="card">
-                <h2>Chế độ</h2>
-                <span class="status manual" id="modeStatus">MANUAL</span>
-                <button class="btn btn-mode" onclick="toggleMode()">ĐỔI CHẾ ĐỘ</button>
-            </div>
-        </div>
-        
-        <div class="card">
-            <h2>🎚️ Tốc độ bơm</h2>
-            <div style="display:flex; align-items:center; gap:15px; margin:10px 0;">
-                <input type="range" id="pumpSpeed" min="30" max="100" value="100" 
-                       style="flex:1; height:8px;" oninput="updateSpeedLabel(this.value)">
-                <span id="speedLabel" style="min-width:50px; font-weight:bold;">100%</span>
-            </div>
-            <button class="btn btn-mode" onclick="setSpeed()">💾 Áp dụng tốc độ</button>
-        </div>
-        
-        <div class="card">
-            <h2>Cài đặt ngưỡng</h2>
-            <div class="config">
-                <label>Khô:</label>
-                <input type="number" id="dryThreshold" min="0" max="100" value="30">
-                <label>Ướt:</label>
-                <input type="number" id="wetThreshold" min="0" max="100" value="50">
-                <button class="btn" style="width:auto; padding:10px 20px;" onclick="saveConfig()">Lưu</button>
-            </div>
-        </div>
-        
-        <div class="card">
-            <h2>⏰ Lịch tưới tự động</h2>
-            <div style="display:flex; align-items:center; justify-content:space-between; margin-bottom:10px;">
-                <span>Bật lịch tưới</span>
-                <label class="switch">
-                    <input type="checkbox" id="scheduleEnabled" onchange="toggleSchedule()">
-                    <span class="slider"></span>
-                </label>
-            </div>
-            <div id="scheduleList">
-                <div class="schedule-item">
-                    <label>Lịch 1:</label>
-                    <input type="time" id="sched0_time" value="06:00">
-                    <input type="number" id="sched0_dur" min="10" max="300" value="30" placeholder="giây">
-                    <label>giây</label>
-                    <label class="switch">
-                        <input type="checkbox" id="sched0_en">
-                        <span class="slider"></span>
-                    </label>
-                </div>
-                <div class="schedule-item">
-                    <label>Lịch 2:</label>
-                    <input type="time" id="sched1_time" value="18:00">
-                    <input type="number" id="sched1_dur" min="10" max="300" value="30" placeholder="giây">
-                    <label>giây</label>
-                    <label class="switch">
-                        <input type="checkbox" id="sched1_en">
-                        <span class="slider"></span>
-                    </label>
-                </div>
-                <div class="schedule-item">
-                    <label>Lịch 3:</label>
-                    <input type="time" id="sched2_time" value="12:00">
-                    <input type="number" id="sched2_dur" min="10" max="300" value="30" placeholder="giây">
-                    <label>giây</label>
-                    <label class="switch">
-                        <input type="checkbox" id="sched2_en">
-                        <span class="slider"></span>
-                    </label>
-                </div>
-                <div class="schedule-item">
-                    <label>Lịch 4:</label>
-                    <input type="time" id="sched3_time" value="00:00">
-                    <input type="number" id="sched3_dur" min="10" max="300" value="30" placeholder="giây">
-                    <label>giây</label>
-                    <label class="switch">
-                        <input type="checkbox" id="sched3_en">
-                        <span class="slider"></span>
-                    </label>
-                </div>
-            </div>
-            <button class="btn btn-mode" onclick="saveSchedule()">💾 Lưu lịch tưới</button>
-            <div id="scheduleInfo" style="font-size:12px; color:#888; margin-top:10px; text-align:center;"></div>
-        </div>
-        
-        <div class="info">
-            Uptime: <span id="uptime">--</span>s | IP: <span id="ip">--</span>
-        </div>
-    </div>
+
+// Event framing: "data: {json}\n\n"
+static const char EVENT_PREFIX[] = "data: ";
+static const char EVENT_SUFFIX[] = "\n\n";
+
+/**
+ * @brief Strip SSE framing in place (AsyncEventSource adds its own)
+ * @return JSON payload inside buf
+ */
+static const char* eventPayload(char* buf, int len) {
+    buf[len - (sizeof(EVENT_SUFFIX) - 1)] = '\0';
+    return buf + (sizeof(EVENT_PREFIX) - 1);
+}
+
+/**
+ * @brief Append one "key":value field to an event being built
+ * @param len Current length, set to -1 once the buffer overflows
+ */
+static void appendEventField(char* buf, size_t size, int& len, const char* fmt, ...) {
+    if (len < 0 || (size_t)len + 1 >= size) {
+        len = -1;
+        return;
+    }
+    if (buf[len - 1] != '{') {
+        buf[len++] = ',';
+    }
     
-    <script>
-        console.log('TuoiCay script loaded');
-        
-        function fetchStatus() {
-            fetch('/api/status')
-                .then(r => {
-                    console.log('Status response:', r.status);
-                    return r.json();
-                })
-                .then(d => {
-                    console.log('Status data:', d);
-                    document.getElementById('moisture').textContent = d.moisture;
-                    
-                    const ps = document.getElementById('pumpStatus');
-                    ps.textContent = d.pump ? 'ON' : 'OFF';
-                    ps.className = 'status ' + (d.pump ? 'on' : 'off');
-                    
-                    const info = d.pump ? `${d.reason} - ${d.runtime}s` : '';
-                    document.getElementById('pumpInfo').textContent = info;
-                    
-                    const ms = document.getElementById('modeStatus');
-                    ms.textContent = d.autoMode ? 'AUTO' : 'MANUAL';
-                    ms.className = 'status ' + (d.autoMode ? 'auto' : 'manual');
-                    
-                    // Only update threshold inputs if not focused (user is not editing)
-                    const dryInput = document.getElementById('dryThreshold');
-                    const wetInput = document.getElementById('wetThreshold');
-                    if (document.activeElement !== dryInput) {
-                        dryInput.value = d.thresholdDry;
-                    }
-                    if (document.activeElement !== wetInput) {
-                        wetInput.value = d.thresholdWet;
-                    }
-                    
-                    document.getElementById('uptime').textContent = d.uptime;
-                    document.getElementById('ip').textContent = d.ip;
-                })
-                .catch(e => {
-                    console.error('fetchStatus error:', e);
-                });
-        }
-        
-        function togglePump() {
-            console.log('togglePump called');
-            fetch('/api/pump', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({action: 'toggle'})
-            })
-            .then(r => {
-                console.log('Pump response status:', r.status);
-                return r.json();
-            })
-            .then(d => {
-                console.log('Pump response:', d);
-                if (d.ok) {
-                    const ps = document.getElementById('pumpStatus');
-                    ps.textContent = d.pump ? 'ON' : 'OFF';
-                    ps.className = 'status ' + (d.pump ? 'on' : 'off');
-                } else if (d.error) {
-                    alert(d.error);
-                }
-                setTimeout(fetchStatus, 500);
-            })
-            .catch(e => {
-                console.error('togglePump error:', e);
-                alert('Lỗi: ' + e.message);
-            });
-        }
-        
-        function toggleMode() {
-            console.log('toggleMode called');
-            fetch('/api/mode', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({toggle: true})
-            })
-            .then(r => {
-                console.log('Mode response status:', r.status);
-                return r.json();
-            })
-            .then(d => {
-                console.log('Mode response:', d);
-                if (d.ok) {
-                    const ms = document.getElementById('modeStatus');
-                    ms.textContent = d.autoMode ? 'AUTO' : 'MANUAL';
-                    ms.className = 'status ' + (d.autoMode ? 'auto' : 'manual');
-                }
-                setTimeout(fetchStatus, 500);
-            })
-            .catch(e => {
-                console.error('toggleMode error:', e);
-                alert('Lỗi: ' + e.message);
-            });
-        }
-        
-        function saveConfig() {
-            const dry = parseInt(document.getElementById('dryThreshold').value);
-            const wet = parseInt(document.getElementById('wetThreshold').value);
-            console.log('saveConfig called with: dry=' + dry + ', wet=' + wet);
-            
-            if (dry >= wet) {
-                alert('Lỗi: Ngưỡng khô phải nhỏ hơn ngưỡng ướt!');
-                return;
-            }
-            
-            fetch('/api/config', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({threshold_dry: dry, threshold_wet: wet})
-            })
-            .then(r => {
-                console.log('Config response status:', r.status);
-                return r.json();
-            })
-            .then(d => {
-                console.log('Config response:', d);
-                if (d.ok) {
-                    alert('Đã lưu ngưỡng: Khô=' + dry + '%, Ướt=' + wet + '%');
-                    fetchStatus();
-                } else if (d.error) {
-                    alert('Lỗi: ' + d.error);
-                }
-            })
-            .catch(e => {
-                console.error('saveConfig error:', e);
-                alert('Lỗi khi lưu: ' + e.message);
-            });
-        }
-        
-        // Speed control functions
-        function updateSpeedLabel(val) {
-            document.getElementById('speedLabel').textContent = val + '%';
-        }
-        
-        function setSpeed() {
-            const speed = parseInt(document.getElementById('pumpSpeed').value);
-            console.log('setSpeed called with:', speed);
-            fetch('/api/speed', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({speed: speed})
-            })
-            .then(r => {
-                console.log('Speed response status:', r.status);
-                return r.json();
-            })
-            .then(d => {
-                console.log('Speed response:', d);
-                if (d.ok) {
-                    alert('Đã áp dụng tốc độ ' + d.speed + '%');
-                } else if (d.error) {
-                    alert('Lỗi: ' + d.error);
-                }
-            })
-            .catch(e => {
-                console.error('setSpeed error:', e);
-                alert('Lỗi: ' + e.message);
-            });
-        }
-        
-        function fetchSpeed() {
-            fetch('/api/speed')
-                .then(r => r.json())
-                .then(d => {
-                    if (d.speed) {
-                        document.getElementById('pumpSpeed').value = d.speed;
-                        document.getElementById('speedLabel').textContent = d.speed + '%';
-                    }
-                })
-                .catch(e => console.error('Error:', e));
-        }
-        
-        // Schedule functions
-        function fetchSchedule() {
-            fetch('/api/schedule')
-                .then(r => r.json())
-                .then(d => {
-                    document.getElementById('scheduleEnabled').checked = d.enabled;
-                    if (d.schedules) {
-                        for (let i = 0; i < 4; i++) {
-                            const s = d.schedules[i];
-                            if (s) {
-                                const h = String(s.hour).padStart(2,'0');
-                                const m = String(s.minute).padStart(2,'0');
-                                document.getElementById('sched'+i+'_time').value = h+':'+m;
-                                document.getElementById('sched'+i+'_dur').value = s.duration;
-                                document.getElementById('sched'+i+'_en').checked = s.enabled;
-                            }
-                        }
-                    }
-                    updateScheduleInfo(d);
-                })
-                .catch(e => console.error('Schedule error:', e));
-        }
-        
-        function updateScheduleInfo(d) {
-            const info = document.getElementById('scheduleInfo');
-            if (d.nextRun) {
-                info.textContent = 'Lịch tiếp theo: ' + d.nextRun;
-            } else if (!d.enabled) {
-                info.textContent = 'Lịch tưới đang TẮT';
-            } else {
-                info.textContent = '';
-            }
-        }
-        
-        function toggleSchedule() {
-            const enabled = document.getElementById('scheduleEnabled').checked;
-            fetch('/api/schedule', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({enabled: enabled, toggle: true})
-            })
-            .then(r => r.json())
-            .then(d => {
-                if (d.ok) {
-                    document.getElementById('scheduleEnabled').checked = d.enabled;
-                    updateScheduleInfo(d);
-                }
-            })
-            .catch(e => console.error('Toggle schedule error:', e));
-        }
-        
-        function saveSchedule() {
-            const schedules = [];
-            for (let i = 0; i < 4; i++) {
-                const time = document.getElementById('sched'+i+'_time').value.split(':');
-                schedules.push({
-                    hour: parseInt(time[0]),
-                    minute: parseInt(time[1]),
-                    duration: parseInt(document.getElementById('sched'+i+'_dur').value),
-                    enabled: document.getElementById('sched'+i+'_en').checked
-                });
-            }
-            fetch('/api/schedule', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({schedules: schedules})
-            })
-            .then(r => r.json())
-            .then(d => {
-                if (d.ok) {
-                    alert('Đã lưu lịch tưới!');
-                    fetchSchedule();
-                }
-            })
-            .catch(e => console.error('Save schedule error:', e));
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(buf + len, size - len, fmt, args);
+    va_end(args);
+    
+    len = (written < 0 || (size_t)(len + written) >= size) ? -1 : len + written;
+}
+
+#ifdef WEB_ASYNC_BACKEND
+/**
+ * @brief Collect request body chunks as they arrive (async backend)
+ * Body is freed by the library together with the request (_tempObject).
+ * Oversized bodies are not stored; the request is then answered with 413.
+ */
+static void collectBody(AsyncWebServerRequest* request, uint8_t* data,
+                        size_t len, size_t index, size_t total) {
+    if (index == 0) {
+        if (total > WEB_MAX_BODY_SIZE) {
+            return;
         }
-        
-        // Initialize
-        try {
-            console.log('Initializing...');
-            fetchStatus();
-            fetchSchedule();
-            fetchSpeed();
-            setInterval(fetchStatus, 1000);   // Update every 1s (fastest)
-            setInterval(fetchSchedule, 30000);
-            console.log('Initialization complete');
-        } catch (e) {
-            console.error('Init error:', e);
-            alert('Lỗi khởi tạo: ' + e.message);
-        }
-    </script>
-</body>
-</html>
-)rawliteral";
+        request->_tempObject = malloc(total + 1);
+    }
+    
+    char* body = (char*)request->_tempObject;
+    if (body && index + len <= total) {
+        memcpy(body + index, data, len);
+        body[index + len] = '\0';
+    }
+}
+#endif
+
+//=============================================================================
+// ROUTE TABLE (shared by both backends)
+//=============================================================================
+constexpr WebServerManager::Route WebServerManager::ROUTES[] = {
+    // path             POST   body   handler
+    { "/",              false, false, &WebServerManager::_handleRoot },
+    { "/api/status",    false, false, &WebServerManager::_handleStatus },
+    { "/api/state",     false, false, &WebServerManager::_handleState },
+    { "/api/events",    false, false, &WebServerManager::_handleEvents },
+    { "/api/perf",      false, false, &WebServerManager::_handlePerf },
+    { "/api/perf",      true,  false, &WebServerManager::_handlePerf },
+    { "/api/pump",      true,  true,  &WebServerManager::_handlePump },
+    { "/api/mode",      true,  true,  &WebServerManager::_handleMode },
+    { "/api/config",    true,  true,  &WebServerManager::_handleConfig },
+    { "/api/speed",     false, false, &WebServerManager::_handleSpeed },
+    { "/api/speed",     true,  true,  &WebServerManager::_handleSpeed },
+    { "/api/schedule",  false, false, &WebServerManager::_handleSchedule },
+    { "/api/schedule",  true,  true,  &WebServerManager::_handleSchedule },
+    { "/api/batch",     true,  true,  &WebServerManager::_handleBatch },
+    { "/metrics",       false, false, &WebServerManager::_handleMetrics },
+    { "/api/budget",    false, false, &WebServerManager::_handleBudget },
+    { "/api/jobs",      false, false, &WebServerManager::_handleJobs },
+    { "/api/time",      true,  true,  &WebServerManager::_handleTime },
+};
+
+constexpr RouteSlots WebServerManager::ROUTE_INDEX = buildRouteSlots(ROUTES);
+
+const WebServerManager::Route* WebServerManager::_findRoute(const char* path, bool post) {
+    static_assert(ROUTE_INDEX.perfect, "Route hash collision: change WEB_ROUTE_HASH_SEED");
+    
+    int index = findRoute(ROUTE_INDEX, ROUTES, path, post);
+    return index < 0 ? nullptr : &ROUTES[index];
+}
 
 //=============================================================================
 // WEB SERVER IMPLEMENTATION
 //=============================================================================
 
 WebServerManager::WebServerManager(uint16_t port)
-    : _server(port)
+    : _port(port)
     , _running(false)
+#ifdef WEB_ASYNC_BACKEND
+    , _async(nullptr)
+    , _asyncEvents(nullptr)
+    , _pendingHead(0)
+    , _pendingCount(0)
+    , _request(nullptr)
+    , _stream(nullptr)
+#else
+    , _pool(port)
+    , _conn(nullptr)
+#endif
+    , _responded(false)
+    , _respHeaderCount(0)
+    , _doc(&_arena)
+    , _requestCount(0)
+    , _rejectedCount(0)
+    , _badRequestCount(0)
+    , _maxHandlerUs(0)
+    , _minFreeHeap(UINT32_MAX)
+    , _minMaxBlock(UINT32_MAX)
+    , _lastHeapSample(0)
     , _getMoisture(nullptr)
     , _getPumpState(nullptr)
     , _getPumpReason(nullptr)
@@ -419,40 +270,120 @@ WebServerManager::WebServerManager(uint16_t port)
     , _thresholdWet(nullptr)
     , _getSchedule(nullptr)
     , _setScheduleEnabled(nullptr)
-    , _setScheduleEntry(nullptr)
+    , _setScheduleEntries(nullptr)
     , _saveSchedule(nullptr)
+    , _getPerf(nullptr)
+    , _resetPerf(nullptr)
+    , _getHealth(nullptr)
+    , _getMetrics(nullptr)
+    , _getBudget(nullptr)
+    , _getJobs(nullptr)
+    , _getTimeInfo(nullptr)
+    , _setManualTime(nullptr)
+    , _applyBatch(nullptr)
+    , _lastEventCheck(0)
+    , _lastEventPing(0)
+    , _eventStateValid(false)
+    , _stateVersion(0)
+    , _stateHash(0)
+    , _fsDashboard(false)
 {
+    _stateEtag[0] = '\0';
+    _fsEtag[0] = '\0';
 }
 
 bool WebServerManager::begin() {
-    // Set up routes
-    _server.on("/", HTTP_GET, [this]() { _handleRoot(); });
-    _server.on("/api/status", HTTP_GET, [this]() { _handleStatus(); });
-    _server.on("/api/pump", HTTP_POST, [this]() { _handlePump(); });
-    _server.on("/api/mode", HTTP_POST, [this]() { _handleMode(); });
-    _server.on("/api/config", HTTP_POST, [this]() { _handleConfig(); });
-    _server.on("/api/speed", HTTP_GET, [this]() { _handleSpeed(); });
-    _server.on("/api/speed", HTTP_POST, [this]() { _handleSpeed(); });
-    _server.on("/api/schedule", HTTP_GET, [this]() { _handleSchedule(); });
-    _server.on("/api/schedule", HTTP_POST, [this]() { _handleSchedule(); });
-    _server.onNotFound([this]() { _handleNotFound(); });
-    
-    _server.begin();
+    // Random upper half: versions from before a reboot never look current
+    if (_stateVersion == 0) {
+        _stateVersion = (ESP.random() & 0x7FFF0000UL) + 1;
+    }
+    
+    _loadFsDashboard();
+    
+#ifdef WEB_ASYNC_BACKEND
+    // Called again after every WiFi reconnect: build server only once
+    if (!_async) {
+        _async = new AsyncWebServer(_port);
+        _asyncEvents = new AsyncEventSource("/api/events");
+        
+        // When all streams are taken, request falls through to the
+        // /api/events route which answers 503
+        _asyncEvents->setFilter([this](AsyncWebServerRequest*) {
+            return _asyncEvents->count() < WEB_EVENTS_MAX_CLIENTS;
+        });
+        _asyncEvents->onConnect([this](AsyncEventSourceClient* client) {
+            _onEventClient(client);
+        });
+        _async->addHandler(_asyncEvents);
+        
+        // Everything except event streams goes through the route table
+        _async->onRequestBody(collectBody);
+        _async->onNotFound([this](AsyncWebServerRequest* request) {
+            _queueRequest(request);
+        });
+    }
+    
+    _async->begin();
+#else
+    _pool.begin();
+#endif
     _running = true;
     
-    LOG_INF(MOD_WEB, "init", "Web server started on port 80");
+    LOG_INF(MOD_WEB, "init", "Web server started on port %u (%s)", _port,
+#ifdef WEB_ASYNC_BACKEND
+            "async"
+#else
+            "sync"
+#endif
+    );
     
     return true;
 }
 
 void WebServerManager::update() {
     if (_running) {
-        _server.handleClient();
+#ifdef WEB_ASYNC_BACKEND
+        _processPending();
+#else
+        // At most one request per loop() iteration, like the async queue
+        HttpConnection* conn = _pool.poll(_eventStreamCount());
+        if (conn) {
+            _conn = conn;
+            _respHeaderCount = 0;
+            bool known = _isGet() || _isPost();
+            _dispatch(known ? _findRoute(_uri(), _isPost()) : nullptr);
+            _pool.finish(conn);
+            _conn = nullptr;
+        }
+#endif
+        _updateEvents();
+        
+        // Heap low-water mark between requests (soak tests, /api/perf)
+        unsigned long now = millis();
+        if (now - _lastHeapSample >= WEB_HEAP_SAMPLE_MS) {
+            _lastHeapSample = now;
+            _sampleHeap();
+        }
     }
 }
 
 void WebServerManager::stop() {
-    _server.stop();
+#ifdef WEB_ASYNC_BACKEND
+    if (_async) {
+        _asyncEvents->close();
+        _async->end();
+    }
+    for (uint8_t i = 0; i < WEB_ASYNC_QUEUE_SIZE; i++) {
+        _pending[i].request = nullptr;
+    }
+    _pendingCount = 0;
+#else
+    for (uint8_t i = 0; i < WEB_EVENTS_MAX_CLIENTS; i++) {
+        _eventClients[i].stop();
+    }
+    _pool.stop();
+#endif
+    _eventStateValid = false;
     _running = false;
     LOG_INF(MOD_WEB, "stop", "Web server stopped");
 }
@@ -483,349 +414,1684 @@ void WebServerManager::setControlCallbacks(
 
 void WebServerManager::_handleRoot() {
     LOG_DBG(MOD_WEB, "req", "GET /");
-    _server.send_P(200, "text/html", INDEX_HTML);
+    
+    // no-cache = always revalidate, so a new filesystem image or firmware
+    // is picked up at once; the hashed assets it links never change
+    if (_fsDashboard) {
+        if (_headerContains("If-None-Match", _fsEtag)) {
+            _sendHeader("ETag", _fsEtag);
+            _sendEmpty(304);
+            return;
+        }
+        _sendHeader("Content-Encoding", "gzip");
+        _sendHeader("ETag", _fsEtag);
+        _sendHeader("Cache-Control", "no-cache");
+        if (_sendFile(200, "text/html", WEB_FS_ROOT "/index.html.gz")) {
+            return;
+        }
+        LOG_WRN(MOD_WEB, "req", "LittleFS dashboard unreadable, using PROGMEM");
+        _respHeaderCount = 0;
+    }
+    
+    // Browser already has this build of the dashboard
+    if (_headerContains("If-None-Match", DASHBOARD_ETAG)) {
+        _sendHeader("ETag", DASHBOARD_ETAG);
+        _sendEmpty(304);
+        return;
+    }
+    
+    _sendHeader("Content-Encoding", "gzip");
+    _sendHeader("ETag", DASHBOARD_ETAG);
+    _sendHeader("Cache-Control", "no-cache");
+    _sendProgmem(200, "text/html", DASHBOARD_HTML_GZ, DASHBOARD_HTML_GZ_LEN);
 }
 
 void WebServerManager::_handleStatus() {
     LOG_DBG(MOD_WEB, "req", "GET /api/status");
     
-    JsonDocument doc;
+    Response out(*this, 200);
+    JsonWriter json(out);
     
-    doc["moisture"] = _getMoisture ? _getMoisture() : 0;
-    doc["pump"] = _getPumpState ? _getPumpState() : false;
-    doc["reason"] = _getPumpReason ? _getPumpReason() : "none";
-    doc["runtime"] = _getPumpRuntime ? _getPumpRuntime() : 0;
-    doc["autoMode"] = _getAutoMode ? _getAutoMode() : false;
+    json.beginObject();
+    json.add("moisture", _getMoisture ? _getMoisture() : 0);
+    json.add("pump", _getPumpState ? _getPumpState() : false);
+    json.add("reason", _getPumpReason ? _getPumpReason() : "none");
+    json.add("runtime", _getPumpRuntime ? _getPumpRuntime() : 0);
+    json.add("autoMode", _getAutoMode ? _getAutoMode() : false);
     
     uint8_t dryVal = _thresholdDry ? *_thresholdDry : 30;
     uint8_t wetVal = _thresholdWet ? *_thresholdWet : 50;
-    doc["thresholdDry"] = dryVal;
-    doc["thresholdWet"] = wetVal;
+    json.add("thresholdDry", dryVal);
+    json.add("thresholdWet", wetVal);
     
     LOG_DBG(MOD_WEB, "status", "Returning thresholds: dry=%d, wet=%d", dryVal, wetVal);
     
-    doc["uptime"] = millis() / 1000;
-    doc["ip"] = WiFi.localIP().toString();
-    doc["heap"] = ESP.getFreeHeap();
+    char ip[16];
+    formatIp(ip, sizeof(ip), WiFi.localIP());
     
-    String json;
-    serializeJson(doc, json);
-    _sendJson(200, json);
+    json.add("uptime", millis() / 1000);
+    json.add("ip", ip);
+    json.add("heap", ESP.getFreeHeap());
+    
+    if (_getTimeInfo) {
+        WebTimeInfo t;
+        _getTimeInfo(&t);
+        json.beginObject("time");
+        json.add("synced", t.synced);
+        json.add("source", t.source);
+        json.add("timezone", t.timezone);
+        json.add("local", t.local);
+        json.add("dst", t.dst);
+        json.add("utcOffset", (long)t.utcOffset);
+        json.add("accuracyMs", (unsigned long)t.accuracyMs);
+        if (t.hasDrift) {
+            json.add("driftPpm", t.driftPpb / 1000.0f, 3);
+        }
+        json.add("pollSec", (unsigned long)t.pollSec);
+        json.add("nextSyncIn", (unsigned long)t.nextSyncIn);
+        json.add("server", t.server >= 0 ? t.servers[t.server].host : "");
+        
+        json.beginArray("ntp");
+        for (uint8_t i = 0; i < t.serverCount; i++) {
+            const NtpServerStats& s = t.servers[i];
+            json.beginObject();
+            json.add("host", s.host);
+            json.add("ok", s.fresh);
+            if (s.answered > 0) {
+                json.add("offsetMs", (long)(s.sample.offsetUs / 1000));
+                json.add("delayMs", s.sample.delayUs / 1000.0f, 1);
+                json.add("stratum", s.sample.stratum);
+            }
+            json.add("answered", s.answered);
+            json.add("failed", s.failed);
+            if (s.lastError) json.add("error", s.lastError);
+            json.endObject();
+        }
+        json.endArray();
+        
+        const HttpDateClient* http = t.http;
+        if (http && http->enabled()) {
+            json.beginObject("http");
+            json.add("host", http->getHost());
+            json.add("ok", http->ok());
+            if (http->getAnswered() > 0) {
+                json.add("offsetMs", (long)(http->sample().offsetUs / 1000));
+                json.add("accuracyMs", (unsigned long)http->sample().accuracyMs);
+            }
+            json.add("answered", http->getAnswered());
+            json.add("failed", http->getFailed());
+            if (http->lastError()) json.add("error", http->lastError());
+            json.endObject();
+        }
+        
+        if (t.hasLocation) {
+            json.add("lat", t.latE4 / 10000.0f, 4);
+            json.add("lon", t.lonE4 / 10000.0f, 4);
+        }
+        if (t.hasSun) {
+            char hhmm[6];
+            int16_t m = (t.sunriseMin + 1440) % 1440;
+            snprintf(hhmm, sizeof(hhmm), "%02d:%02d", m / 60, m % 60);
+            json.add("sunrise", hhmm);
+            m = (t.sunsetMin + 1440) % 1440;
+            snprintf(hhmm, sizeof(hhmm), "%02d:%02d", m / 60, m % 60);
+            json.add("sunset", hhmm);
+        }
+        json.endObject();
+    }
+    json.endObject();
+    out.end();
 }
 
-void WebServerManager::_handlePump() {
-    LOG_DBG(MOD_WEB, "req", "POST /api/pump");
+void WebServerManager::_handleState() {
+    LOG_DBG(MOD_WEB, "req", "GET /api/state");
     
-    if (!_server.hasArg("plain")) {
-        _sendError(400, "No body");
-        return;
+    StateSnapshot snap;
+    _readState(snap);
+    
+    StateHasher hasher;
+    JsonWriter hashJson(hasher);
+    hashJson.beginObject();
+    _writeState(hashJson, snap, false);
+    hashJson.endObject();
+    
+    if (hasher.hash() != _stateHash) {
+        _stateHash = hasher.hash();
+        _stateVersion++;
     }
     
-    // Check if in AUTO mode - cannot manually control pump
-    bool isAutoMode = _getAutoMode ? _getAutoMode() : false;
-    if (isAutoMode) {
-        LOG_WRN(MOD_WEB, "pump", "Cannot control pump in AUTO mode!");
-        _sendJson(200, "{\"ok\":false,\"error\":\"Đang ở chế độ TỰ ĐỘNG. Chuyển sang THỦ CÔNG để điều khiển bơm.\",\"autoMode\":true}");
+    snprintf(_stateEtag, sizeof(_stateEtag), "\"%lu\"", (unsigned long)_stateVersion);
+    _sendHeader("ETag", _stateEtag);
+    _sendHeader("Cache-Control", "no-cache");
+    
+    char ifNoneMatch[WEB_STATE_ETAG_SIZE + 2];
+    if (_header("If-None-Match", ifNoneMatch, sizeof(ifNoneMatch)) &&
+        matchesVersion(ifNoneMatch, _stateVersion)) {
+        _sendEmpty(304);
         return;
     }
     
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, _server.arg("plain"));
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("version", _stateVersion);
+    _writeState(json, snap, true);
+    json.endObject();
+    out.end();
+}
+
+void WebServerManager::_readState(StateSnapshot& snap) {
+    _readEventState(snap.status);
+    snap.speed = _getSpeed ? _getSpeed() : 100;
     
-    if (err) {
-        LOG_WRN(MOD_WEB, "pump", "JSON parse error: %s", err.c_str());
-        _sendError(400, "Invalid JSON");
-        return;
+    snap.hasSchedule = _getSchedule != nullptr;
+    snap.nextRun = "";
+    if (snap.hasSchedule) {
+        _getSchedule(&snap.schedule, &snap.nextRun);
     }
     
-    const char* action = doc["action"] | "";
+    memset(&snap.health, 0, sizeof(snap.health));
+    snap.health.wifiState = "UNKNOWN";
+    snap.health.mqttState = "UNKNOWN";
+    if (_getHealth) {
+        _getHealth(&snap.health);
+    }
+}
+
+void WebServerManager::_writeState(JsonWriter& json, const StateSnapshot& snap, bool live) {
+    const EventState& st = snap.status;
+    json.add("moisture", st.moisture);
+    json.add("pump", st.pump);
+    json.add("reason", st.reason);
+    json.add("runtime", st.runtime);
+    json.add("autoMode", st.autoMode);
+    json.add("thresholdDry", st.thresholdDry);
+    json.add("thresholdWet", st.thresholdWet);
+    json.add("speed", snap.speed);
     
-    if (_setPump) {
-        if (strcmp(action, "on") == 0) {
-            _setPump(true);
-            LOG_INF(MOD_WEB, "pump", "Pump ON via web");
-        } else if (strcmp(action, "off") == 0) {
-            _setPump(false);
-            LOG_INF(MOD_WEB, "pump", "Pump OFF via web");
-        } else if (strcmp(action, "toggle") == 0) {
-            bool current = _getPumpState ? _getPumpState() : false;
-            _setPump(!current);
-            LOG_INF(MOD_WEB, "pump", "Pump TOGGLE -> %s via web", !current ? "ON" : "OFF");
+    json.beginObject("schedule");
+    if (snap.hasSchedule) {
+        json.add("enabled", snap.schedule.enabled);
+        json.add("nextRun", snap.nextRun);
+        json.beginArray("entries");
+        for (uint8_t i = 0; i < snap.schedule.count; i++) {
+            _writeScheduleEntry(json, snap.schedule.entries[i]);
         }
+        json.endArray();
+    } else {
+        json.add("enabled", false);
     }
+    json.endObject();
     
-    // Return current state so UI can update immediately
-    bool pumpState = _getPumpState ? _getPumpState() : false;
-    String response = "{\"ok\":true,\"pump\":";
-    response += pumpState ? "true" : "false";
-    response += "}";
-    _sendJson(200, response);
+    const WebSystemHealth& h = snap.health;
+    json.beginArray("sensors");
+    for (uint8_t i = 0; i < WEB_SENSOR_COUNT; i++) {
+        json.beginObject();
+        json.add("moisture", h.sensors[i].moisture);
+        json.add("valid", h.sensors[i].valid);
+        json.endObject();
+    }
+    json.endArray();
+    
+    char ip[16];
+    formatIp(ip, sizeof(ip), WiFi.localIP());
+    
+    json.beginObject("wifi");
+    json.add("state", h.wifiState);
+    json.add("ip", ip);
+    json.add("reconnects", h.wifiReconnects);
+    if (live) {
+        json.add("rssi", h.rssi);
+    }
+    json.endObject();
+    
+    json.beginObject("mqtt");
+    json.add("state", h.mqttState);
+    json.add("queued", h.mqttQueued);
+    json.add("reconnects", h.mqttReconnects);
+    json.endObject();
+    
+    if (live) {
+        json.add("uptime", millis() / 1000);
+        json.add("heap", ESP.getFreeHeap());
+    }
 }
 
-void WebServerManager::_handleMode() {
-    LOG_DBG(MOD_WEB, "req", "POST /api/mode");
+void WebServerManager::_handlePump() {
+    LOG_DBG(MOD_WEB, "req", "POST /api/pump");
+    
+    // Any mode: the irrigation queue arbitrates against auto / schedule
+    const char* action = _doc["action"] | "";
+    bool current = _getPumpState ? _getPumpState() : false;
+    bool on;
     
-    if (!_server.hasArg("plain")) {
-        _sendError(400, "No body");
+    if (strcmp(action, "on") == 0) {
+        on = true;
+    } else if (strcmp(action, "off") == 0) {
+        on = false;
+    } else if (strcmp(action, "toggle") == 0) {
+        on = !current;
+    } else {
+        _sendError(400, "action must be on, off or toggle");
         return;
     }
     
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, _server.arg("plain"));
+    IrrigationVerdict verdict = IrrigationVerdict::STARTED;
+    if (_setPump) {
+        verdict = _setPump(on);
+        LOG_INF(MOD_WEB, "pump", "Pump %s via web (%s): %s", on ? "ON" : "OFF", action,
+                on ? irrigationVerdictName(verdict) : "stopped");
+    }
     
-    if (err) {
-        _sendError(400, "Invalid JSON");
-        return;
+    // Same rule as MQTT (8004): the run was neither started nor queued
+    int status = 200;
+    const char* error = nullptr;
+    if (on && verdict == IrrigationVerdict::REFUSED) {
+        status = 409;
+        error = "Bơm đang nghỉ (cooldown), thử lại sau.";
+    } else if (on && verdict == IrrigationVerdict::FULL) {
+        status = 503;
+        error = "Hàng đợi tưới đầy, thử lại sau.";
     }
     
-    if (_setAutoMode) {
-        if (doc["toggle"].is<bool>() && doc["toggle"].as<bool>()) {
-            bool current = _getAutoMode ? _getAutoMode() : false;
-            _setAutoMode(!current);
-            LOG_INF(MOD_WEB, "mode", "Mode TOGGLE -> %s via web", !current ? "AUTO" : "MANUAL");
-        } else if (doc["mode"].is<const char*>()) {
-            const char* mode = doc["mode"];
-            _setAutoMode(strcmp(mode, "auto") == 0);
-            LOG_INF(MOD_WEB, "mode", "Mode SET -> %s via web", mode);
+    // Return current state so UI can update immediately
+    Response out(*this, status);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("ok", error == nullptr);
+    if (error) {
+        json.add("error", error);
+    }
+    json.add("pump", _getPumpState ? _getPumpState() : false);
+    if (on) {
+        json.add("verdict", irrigationVerdictName(verdict));
+    }
+    json.endObject();
+    out.end();
+}
+
+void WebServerManager::_handleMode() {
+    LOG_DBG(MOD_WEB, "req", "POST /api/mode");
+    
+    bool current = _getAutoMode ? _getAutoMode() : false;
+    bool autoMode;
+    
+    if (_doc["toggle"] | false) {
+        autoMode = !current;
+    } else {
+        const char* mode = _doc["mode"] | "";
+        if (strcmp(mode, "auto") == 0) {
+            autoMode = true;
+        } else if (strcmp(mode, "manual") == 0) {
+            autoMode = false;
+        } else {
+            _sendError(400, "mode must be auto or manual");
+            return;
         }
     }
     
+    if (_setAutoMode) {
+        _setAutoMode(autoMode);
+        LOG_INF(MOD_WEB, "mode", "Mode -> %s via web", autoMode ? "AUTO" : "MANUAL");
+    }
+    
     // Return current state so UI can update immediately
     bool modeState = _getAutoMode ? _getAutoMode() : false;
-    String response = "{\"ok\":true,\"autoMode\":";
-    response += modeState ? "true" : "false";
-    response += "}";
-    _sendJson(200, response);
+    _sendJson(200, modeState ? "{\"ok\":true,\"autoMode\":true}" : "{\"ok\":true,\"autoMode\":false}");
 }
 
 void WebServerManager::_handleConfig() {
     LOG_DBG(MOD_WEB, "req", "POST /api/config");
     
-    if (!_server.hasArg("plain")) {
-        LOG_WRN(MOD_WEB, "config", "No body in request");
-        _sendError(400, "No body");
+    if (_doc["threshold_dry"].isNull() || _doc["threshold_wet"].isNull()) {
+        LOG_WRN(MOD_WEB, "config", "Missing threshold parameters");
+        _sendError(400, "Thiếu tham số ngưỡng");
         return;
     }
     
-    LOG_DBG(MOD_WEB, "config", "Request body: %s", _server.arg("plain").c_str());
-    
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, _server.arg("plain"));
-    
-    if (err) {
-        LOG_WRN(MOD_WEB, "config", "JSON parse error: %s", err.c_str());
-        _sendError(400, "Invalid JSON");
+    long dry, wet;
+    if (!_readInt("threshold_dry", 0, 100, dry) ||
+        !_readInt("threshold_wet", 0, 100, wet) || dry >= wet) {
+        LOG_WRN(MOD_WEB, "config", "Invalid thresholds");
+        _sendError(400, "Ngưỡng không hợp lệ (phải: 0 <= khô < ướt <= 100)");
         return;
     }
     
-    if (_setThresholds && doc["threshold_dry"].is<int>() && doc["threshold_wet"].is<int>()) {
-        uint8_t dry = doc["threshold_dry"];
-        uint8_t wet = doc["threshold_wet"];
-        
-        LOG_DBG(MOD_WEB, "config", "Received: dry=%d, wet=%d", dry, wet);
-        
-        if (dry < wet && dry >= 0 && wet <= 100) {
-            _setThresholds(dry, wet);
-            LOG_INF(MOD_WEB, "config", "Thresholds updated: dry=%d, wet=%d", dry, wet);
-            
-            // Return success with actual values
-            String response = "{\"ok\":true,\"dry\":";
-            response += dry;
-            response += ",\"wet\":";
-            response += wet;
-            response += "}";
-            _sendJson(200, response);
-        } else {
-            LOG_WRN(MOD_WEB, "config", "Invalid range: dry=%d, wet=%d", dry, wet);
-            _sendJson(400, "{\"ok\":false,\"error\":\"Ngưỡng không hợp lệ (phải: 0 <= khô < ướt <= 100)\"}");
-            return;
-        }
-    } else {
-        LOG_WRN(MOD_WEB, "config", "Missing threshold parameters");
-        _sendJson(400, "{\"ok\":false,\"error\":\"Thiếu tham số ngưỡng\"}");
+    if (_setThresholds) {
+        _setThresholds((uint8_t)dry, (uint8_t)wet);
+        LOG_INF(MOD_WEB, "config", "Thresholds updated: dry=%ld, wet=%ld", dry, wet);
     }
+    
+    // Return success with actual values
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("ok", true);
+    json.add("dry", dry);
+    json.add("wet", wet);
+    json.endObject();
+    out.end();
 }
 
 void WebServerManager::_handleSpeed() {
     // Handle GET - return current speed
-    if (_server.method() == HTTP_GET) {
+    if (_isGet()) {
         LOG_DBG(MOD_WEB, "req", "GET /api/speed");
         
-        uint8_t speed = _getSpeed ? _getSpeed() : 100;
-        String response = "{\"speed\":";
-        response += speed;
-        response += "}";
-        _sendJson(200, response);
+        Response out(*this, 200);
+        JsonWriter json(out);
+        json.beginObject();
+        json.add("speed", _getSpeed ? _getSpeed() : 100);
+        json.endObject();
+        out.end();
         return;
     }
     
     // Handle POST - set speed
     LOG_DBG(MOD_WEB, "req", "POST /api/speed");
     
-    if (!_server.hasArg("plain")) {
-        _sendError(400, "No body");
+    long speed;
+    if (!_readInt("speed", 30, 100, speed)) {
+        _sendError(400, "Speed must be 30-100%");
         return;
     }
     
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, _server.arg("plain"));
-    
-    if (err) {
-        _sendError(400, "Invalid JSON");
-        return;
+    if (_setSpeed) {
+        _setSpeed((uint8_t)speed);
+        LOG_INF(MOD_WEB, "speed", "Pump speed set to %ld%%", speed);
     }
     
-    if (_setSpeed && doc["speed"].is<int>()) {
-        uint8_t speed = doc["speed"];
-        if (speed >= 30 && speed <= 100) {
-            _setSpeed(speed);
-            LOG_INF(MOD_WEB, "speed", "Pump speed set to %d%%", speed);
-            
-            String response = "{\"ok\":true,\"speed\":";
-            response += speed;
-            response += "}";
-            _sendJson(200, response);
-        } else {
-            _sendError(400, "Speed must be 30-100%");
-        }
-    } else {
-        _sendError(400, "Missing speed parameter");
-    }
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("ok", true);
+    json.add("speed", speed);
+    json.endObject();
+    out.end();
 }
 
 void WebServerManager::setScheduleCallbacks(
     GetScheduleConfigFunc getSchedule,
     SetScheduleEnabledFunc setEnabled,
-    SetScheduleEntryFunc setEntry,
+    SetScheduleEntriesFunc setEntries,
     SaveScheduleFunc saveSchedule
 ) {
     _getSchedule = getSchedule;
     _setScheduleEnabled = setEnabled;
-    _setScheduleEntry = setEntry;
+    _setScheduleEntries = setEntries;
     _saveSchedule = saveSchedule;
 }
 
 void WebServerManager::_handleSchedule() {
     // Handle GET - return schedule config
-    if (_server.method() == HTTP_GET) {
+    if (_isGet()) {
         LOG_DBG(MOD_WEB, "req", "GET /api/schedule");
         
-        JsonDocument doc;
+        Response out(*this, 200);
+        JsonWriter json(out);
+        json.beginObject();
         
         if (_getSchedule) {
             WebScheduleConfig config;
-            String nextRun;
+            const char* nextRun = "";
             _getSchedule(&config, &nextRun);
             
-            doc["enabled"] = config.enabled;
-            doc["nextRun"] = nextRun;
+            json.add("enabled", config.enabled);
+            json.add("nextRun", nextRun);
             
-            JsonArray schedules = doc["schedules"].to<JsonArray>();
-            for (int i = 0; i < 4; i++) {
-                JsonObject s = schedules.add<JsonObject>();
-                s["hour"] = config.entries[i].hour;
-                s["minute"] = config.entries[i].minute;
-                s["duration"] = config.entries[i].duration;
-                s["enabled"] = config.entries[i].enabled;
+            json.add("max", MAX_SCHEDULE_ENTRIES);
+            
+            json.beginArray("schedules");
+            for (uint8_t i = 0; i < config.count; i++) {
+                _writeScheduleEntry(json, config.entries[i]);
             }
+            json.endArray();
         } else {
-            doc["enabled"] = false;
-            doc["error"] = "Schedule not available";
+            json.add("enabled", false);
+            json.add("error", "Schedule not available");
         }
         
-        String json;
-        serializeJson(doc, json);
-        _sendJson(200, json);
+        json.endObject();
+        out.end();
         return;
     }
     
     // Handle POST - update schedule
     LOG_DBG(MOD_WEB, "req", "POST /api/schedule");
     
-    if (!_server.hasArg("plain")) {
-        _sendError(400, "No body");
+    // Handle toggle enabled
+    if (_doc["toggle"] | false) {
+        if (!_doc["enabled"].is<bool>()) {
+            _sendError(400, "Missing enabled");
+            return;
+        }
+        
+        bool enabled = _doc["enabled"].as<bool>();
+        if (_setScheduleEnabled) {
+            _setScheduleEnabled(enabled);
+            LOG_INF(MOD_WEB, "schedule", "Schedule %s via web", enabled ? "ENABLED" : "DISABLED");
+            if (_saveSchedule) _saveSchedule();
+        }
+        
+        Response out(*this, 200);
+        JsonWriter json(out);
+        json.beginObject();
+        json.add("ok", true);
+        json.add("enabled", enabled);
+        
+        if (_getSchedule) {
+            WebScheduleConfig config;
+            const char* nextRun = "";
+            _getSchedule(&config, &nextRun);
+            json.add("nextRun", nextRun);
+        }
+        
+        json.endObject();
+        out.end();
         return;
     }
     
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, _server.arg("plain"));
-    
-    if (err) {
-        _sendError(400, "Invalid JSON");
+    // Handle update schedules: the list replaces every entry, and is
+    // validated completely before anything is applied
+    JsonArrayConst schedules = _doc["schedules"].as<JsonArrayConst>();
+    if (schedules.isNull() || schedules.size() > MAX_SCHEDULE_ENTRIES) {
+        _sendError(400, "schedules must be an array of up to 16 entries");
         return;
     }
     
-    // Handle toggle enabled
-    if (doc["toggle"].is<bool>() && doc["toggle"].as<bool>()) {
-        if (_setScheduleEnabled) {
-            bool enabled = doc["enabled"].as<bool>();
-            _setScheduleEnabled(enabled);
-            LOG_INF(MOD_WEB, "schedule", "Schedule %s via web", enabled ? "ENABLED" : "DISABLED");
-            
-            // Save and return new state
-            if (_saveSchedule) _saveSchedule();
-            
-            JsonDocument resp;
-            resp["ok"] = true;
-            resp["enabled"] = enabled;
-            
-            if (_getSchedule) {
-                WebScheduleConfig config;
-                String nextRun;
-                _getSchedule(&config, &nextRun);
-                resp["nextRun"] = nextRun;
-            }
-            
-            String json;
-            serializeJson(resp, json);
-            _sendJson(200, json);
+    ScheduleEntry entries[MAX_SCHEDULE_ENTRIES];
+    uint8_t count = 0;
+    for (JsonVariantConst s : schedules) {
+        entries[count].setDefaults();
+        const char* error = scheduleEntryFromJson(s, entries[count]);
+        if (error) {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "schedules[%d]: %s", count, error);
+            _sendError(400, msg);
             return;
         }
+        count++;
     }
     
-    // Handle update schedules
-    if (doc["schedules"].is<JsonArray>()) {
-        JsonArray schedules = doc["schedules"].as<JsonArray>();
-        
-        if (_setScheduleEntry) {
-            int i = 0;
-            for (JsonObject s : schedules) {
-                if (i >= 4) break;
-                
-                uint8_t hour = s["hour"] | 0;
-                uint8_t minute = s["minute"] | 0;
-                uint16_t duration = s["duration"] | 30;
-                bool enabled = s["enabled"] | false;
-                
-                _setScheduleEntry(i, hour, minute, duration, enabled);
-                LOG_INF(MOD_WEB, "schedule", "Entry %d: %02d:%02d dur=%ds en=%d", 
-                        i, hour, minute, duration, enabled);
-                i++;
-            }
-            
-            // Save changes
-            if (_saveSchedule) _saveSchedule();
-        }
+    if (_setScheduleEntries) {
+        _setScheduleEntries(entries, count);
+        LOG_INF(MOD_WEB, "schedule", "%d entries set via web", count);
         
-        _sendJson(200, "{\"ok\":true}");
-        return;
+        // Save changes
+        if (_saveSchedule) _saveSchedule();
     }
     
-    _sendError(400, "Invalid request");
+    _sendJson(200, "{\"ok\":true}");
 }
 
-void WebServerManager::_handleNotFound() {
-    _sendError(404, "Not found");
+void WebServerManager::_writeScheduleEntry(JsonWriter& json, const ScheduleEntry& entry) {
+    json.beginObject();
+    json.add("type", scheduleKindName(entry.kind));
+    json.add("hour", entry.hour);
+    json.add("minute", entry.minute);
+    json.add("duration", entry.duration);
+    json.add("enabled", entry.enabled);
+    json.add("days", entry.days);
+    if (entry.kind == ScheduleKind::INTERVAL) {
+        json.add("every", entry.everyHours);
+    }
+    if (entry.isSun()) {
+        json.add("offset", entry.offsetMin);
+    }
+    if (entry.from != 0) {
+        json.add("from", entry.from);
+        json.add("to", entry.to);
+    }
+    if (entry.catchUp != CatchUpPolicy::SKIP) {
+        json.add("catchup", catchUpPolicyName(entry.catchUp));
+    }
+    if (entry.catchUp == CatchUpPolicy::WITHIN) {
+        json.add("window", entry.windowMin);
+    }
+    json.endObject();
 }
 
-void WebServerManager::_sendJson(int code, const String& json) {
-    _server.sendHeader("Access-Control-Allow-Origin", "*");
-    _server.send(code, "application/json", json);
+void WebServerManager::_handleBatch() {
+    LOG_DBG(MOD_WEB, "req", "POST /api/batch");
+    
+    if (!_applyBatch) {
+        _sendError(503, "Batch not available");
+        return;
+    }
+    
+    // ~620 B: static rather than on the stack, parse() clears it
+    static ConfigBatch batch;
+    if (!batch.parse(_doc["ops"])) {
+        Response out(*this, 400);
+        JsonWriter json(out);
+        json.beginObject();
+        json.add("ok", false);
+        json.add("error", batch.error());
+        if (batch.errorIndex() >= 0) {
+            json.add("op", (int)batch.errorIndex());
+        }
+        json.endObject();
+        out.end();
+        return;
+    }
+    
+    int code = _applyBatch(batch);
+    if (code != TC_ERR_OK) {
+        LOG_ERR(MOD_WEB, "batch", "Apply failed: %s", error_to_string(code));
+        _sendError(500, error_to_string(code));
+        return;
+    }
+    LOG_INF(MOD_WEB, "batch", "%d ops applied via web", batch.count());
+    
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("ok", true);
+    json.add("applied", (int)batch.count());
+    json.endObject();
+    out.end();
 }
 
-void WebServerManager::_sendError(int code, const char* message) {
-    String json = "{\"error\":\"";
-    json += message;
-    json += "\"}";
-    _sendJson(code, json);
+void WebServerManager::_handleTime() {
+    LOG_DBG(MOD_WEB, "req", "POST /api/time");
+    
+    if (!_setManualTime) {
+        _sendError(503, "Manual time not available");
+        return;
+    }
+    
+    long epoch;
+    long ms = 0;
+    if (!_readInt("epoch", 0, 0x7FFFFFFF, epoch) ||
+        (!_doc["ms"].isNull() && !_readInt("ms", 0, 999, ms))) {
+        _sendError(400, "epoch (s) and optional ms 0-999 required");
+        return;
+    }
+    
+    int code = _setManualTime((uint32_t)epoch, (uint16_t)ms);
+    if (code == TC_ERR_CMD_INVALID_STATE) {
+        _sendError(409, "Clock held by a better source");
+        return;
+    }
+    if (code != TC_ERR_OK) {
+        _sendError(400, error_to_string(code));
+        return;
+    }
+    LOG_INF(MOD_WEB, "time", "Clock set by hand: %ld", epoch);
+    
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("ok", true);
+    if (_getTimeInfo) {
+        WebTimeInfo t;
+        _getTimeInfo(&t);
+        json.add("source", t.source);
+        json.add("local", t.local);
+        json.add("accuracyMs", (unsigned long)t.accuracyMs);
+    }
+    json.endObject();
+    out.end();
 }
+
+void WebServerManager::_handleEvents() {
+    LOG_DBG(MOD_WEB, "req", "GET /api/events");
+    
+#ifdef WEB_ASYNC_BACKEND
+    // Only reached when AsyncEventSource refused the stream (all taken)
+    _sendError(503, "Too many event streams");
+#else
+    int slot = -1;
+    for (uint8_t i = 0; i < WEB_EVENTS_MAX_CLIENTS; i++) {
+        if (!_eventClients[i].connected()) {
+            slot = i;
+            break;
+        }
+    }
+    
+    if (slot < 0) {
+        // Dashboard falls back to polling /api/status
+        _sendError(503, "Too many event streams");
+        return;
+    }
+    
+    // Take over the socket: it leaves the keep-alive pool (pipelined
+    // requests behind this one are dropped) but still uses its budget
+    WiFiClient& client = _eventClients[slot];
+    client = _pool.detach(_conn);
+    _responded = true;
+    
+    char buf[WEB_EVENT_BUFFER_SIZE];
+    int len = snprintf(buf, sizeof(buf),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: keep-alive\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "\r\n"
+        "retry: %u\n\n", (unsigned)WEB_EVENTS_RETRY_MS);
+    client.write((const uint8_t*)buf, len);
+    
+    EventState state;
+    _readEventState(state);
+    len = _formatEvent(buf, sizeof(buf), state, nullptr);
+    if (len > 0) {
+        client.write((const uint8_t*)buf, len);
+    }
+    
+    // Other streams already share a baseline; they get the difference on
+    // the next check, which this stream receives too (harmless repeat)
+    if (!_eventStateValid) {
+        _lastEvent = state;
+        _eventStateValid = true;
+    }
+    
+    LOG_INF(MOD_WEB, "events", "Stream %d opened (%s)", slot,
+            client.remoteIP().toString().c_str());
+#endif
+}
+
+void WebServerManager::_updateEvents() {
+    unsigned long now = millis();
+    if (now - _lastEventCheck < WEB_EVENTS_CHECK_MS) {
+        return;
+    }
+    _lastEventCheck = now;
+    
+#ifdef WEB_ASYNC_BACKEND
+    uint8_t active = _asyncEvents ? _asyncEvents->count() : 0;
+#else
+    uint8_t active = _eventStreamCount();
+#endif
+    
+    if (active == 0) {
+        _eventStateValid = false;
+        return;
+    }
+    
+    EventState state;
+    _readEventState(state);
+    
+    char buf[WEB_EVENT_BUFFER_SIZE];
+    int len = _formatEvent(buf, sizeof(buf), state, _eventStateValid ? &_lastEvent : nullptr);
+    
+    if (len > 0) {
+        _broadcastEvent(buf, len);
+        _lastEvent = state;
+        _eventStateValid = true;
+        _lastEventPing = now;
+    } else if (now - _lastEventPing >= WEB_EVENTS_PING_MS) {
+#ifdef WEB_ASYNC_BACKEND
+        // The library drops events for a lagging client instead of closing
+        // it; a periodic full snapshot doubles as keep-alive and resync
+        len = _formatEvent(buf, sizeof(buf), state, nullptr);
+        if (len > 0) {
+            _broadcastEvent(buf, len);
+        }
+#else
+        static const char PING[] = ": ping\n\n";
+        _broadcastEvent(PING, sizeof(PING) - 1);
+#endif
+        _lastEventPing = now;
+    }
+}
+
+void WebServerManager::_readEventState(EventState& state) {
+    state.moisture = _getMoisture ? _getMoisture() : 0;
+    state.pump = _getPumpState ? _getPumpState() : false;
+    state.reason = _getPumpReason ? _getPumpReason() : "none";
+    state.runtime = _getPumpRuntime ? _getPumpRuntime() : 0;
+    state.autoMode = _getAutoMode ? _getAutoMode() : false;
+    state.thresholdDry = _thresholdDry ? *_thresholdDry : 30;
+    state.thresholdWet = _thresholdWet ? *_thresholdWet : 50;
+}
+
+int WebServerManager::_formatEvent(char* buf, size_t size, const EventState& state,
+                                   const EventState* prev) {
+    int len = snprintf(buf, size, "%s{", EVENT_PREFIX);
+    
+    if (!prev || state.moisture != prev->moisture) {
+        appendEventField(buf, size, len, "\"moisture\":%u", state.moisture);
+    }
+    if (!prev || state.pump != prev->pump) {
+        appendEventField(buf, size, len, "\"pump\":%s", state.pump ? "true" : "false");
+    }
+    if (!prev || strcmp(state.reason, prev->reason) != 0) {
+        appendEventField(buf, size, len, "\"reason\":\"%s\"", state.reason);
+    }
+    if (!prev || state.runtime != prev->runtime) {
+        appendEventField(buf, size, len, "\"runtime\":%u", state.runtime);
+    }
+    if (!prev || state.autoMode != prev->autoMode) {
+        appendEventField(buf, size, len, "\"autoMode\":%s", state.autoMode ? "true" : "false");
+    }
+    if (!prev || state.thresholdDry != prev->thresholdDry) {
+        appendEventField(buf, size, len, "\"thresholdDry\":%u", state.thresholdDry);
+    }
+    if (!prev || state.thresholdWet != prev->thresholdWet) {
+        appendEventField(buf, size, len, "\"thresholdWet\":%u", state.thresholdWet);
+    }
+    
+    // Snapshot only: the page ticks uptime locally from here
+    if (!prev) {
+        char ip[16];
+        formatIp(ip, sizeof(ip), WiFi.localIP());
+        appendEventField(buf, size, len, "\"uptime\":%lu", (unsigned long)(millis() / 1000));
+        appendEventField(buf, size, len, "\"ip\":\"%s\"", ip);
+    }
+    
+    if (len < 0) {
+        LOG_ERR(MOD_WEB, "events", "Event buffer overflow");
+        return 0;
+    }
+    
+    // Nothing changed
+    if (buf[len - 1] == '{') {
+        return 0;
+    }
+    
+    int tail = snprintf(buf + len, size - len, "}%s", EVENT_SUFFIX);
+    if (tail < 0 || (size_t)(len + tail) >= size) {
+        LOG_ERR(MOD_WEB, "events", "Event buffer overflow");
+        return 0;
+    }
+    return len + tail;
+}
+
+void WebServerManager::_broadcastEvent(const char* data, size_t len) {
+#ifdef WEB_ASYNC_BACKEND
+    char buf[WEB_EVENT_BUFFER_SIZE];
+    if (len >= sizeof(buf) || len < sizeof(EVENT_PREFIX) + sizeof(EVENT_SUFFIX) - 2) {
+        return;
+    }
+    memcpy(buf, data, len);
+    _asyncEvents->send(eventPayload(buf, len));
+#else
+    for (uint8_t i = 0; i < WEB_EVENTS_MAX_CLIENTS; i++) {
+        WiFiClient& client = _eventClients[i];
+        if (!client.connected()) {
+            continue;
+        }
+        
+        // A full socket buffer would make write() block loop()
+        if (client.availableForWrite() < len) {
+            LOG_WRN(MOD_WEB, "events", "Stream %d too slow, closing", i);
+            client.stop();
+            continue;
+        }
+        
+        client.write((const uint8_t*)data, len);
+    }
+#endif
+}
+
+void WebServerManager::_handlePerf() {
+    // POST: start a new measurement (load tests reset before each run)
+    if (!_isGet()) {
+        LOG_DBG(MOD_WEB, "req", "POST /api/perf");
+        if (_resetPerf) _resetPerf();
+        _maxHandlerUs = 0;
+        _arena.resetPeak();
+        _minFreeHeap = UINT32_MAX;
+        _minMaxBlock = UINT32_MAX;
+#ifndef WEB_ASYNC_BACKEND
+        _pool.resetPeak();
+#endif
+        _sendJson(200, "{\"ok\":true}");
+        return;
+    }
+    
+    LOG_DBG(MOD_WEB, "req", "GET /api/perf");
+    
+    _sampleHeap();
+    
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    
+    json.beginObject("loop");
+    if (_getPerf) {
+        WebPerfStats stats;
+        _getPerf(&stats);
+        json.add("maxUs", stats.loopMaxUs);
+        json.add("peakUs", stats.loopPeakUs);
+        json.add("stalls", stats.loopStalls);
+        json.add("iterations", stats.loopIterations);
+    }
+    json.endObject();
+    
+    json.beginObject("heap");
+    json.add("free", ESP.getFreeHeap());
+    json.add("maxBlock", ESP.getMaxFreeBlockSize());
+    json.add("fragmentation", ESP.getHeapFragmentation());
+    json.add("minFree", _minFreeHeap);
+    json.add("minMaxBlock", _minMaxBlock);
+    json.endObject();
+    
+    json.beginObject("web");
+#ifdef WEB_ASYNC_BACKEND
+    json.add("backend", "async");
+    json.add("queued", _pendingCount);
+    json.add("eventStreams", _asyncEvents ? _asyncEvents->count() : 0);
+#else
+    json.add("backend", "sync");
+    uint8_t streams = _eventStreamCount();
+    json.add("eventStreams", streams);
+    
+    const HttpPoolStats& pool = _pool.stats();
+    json.beginObject("connections");
+    json.add("open", _pool.openCount() + streams);
+    json.add("peak", pool.peak);
+    json.add("max", WEB_MAX_CONNECTIONS);
+    json.add("accepted", pool.accepted);
+    json.add("reused", pool.reused);
+    json.add("evicted", pool.evicted);
+    json.add("rejected", pool.rejected);
+    json.add("timeouts", pool.timeouts);
+    json.add("idleClosed", pool.idleClosed);
+    json.endObject();
+#endif
+    json.add("dashboard", _fsDashboard ? "littlefs" : "progmem");
+    json.add("requests", _requestCount);
+    json.add("rejected", _rejectedCount);
+    json.add("badRequests", _badRequestCount);
+    json.add("maxHandlerUs", _maxHandlerUs);
+    json.add("jsonArenaPeak", _arena.peak());
+    json.endObject();
+    
+    json.endObject();
+    out.end();
+}
+
+void WebServerManager::_handleMetrics() {
+    static const char* const SENSOR_LABELS[WEB_SENSOR_COUNT] = { "1", "2" };
+    static const char* const REASON_LABELS[WEB_PUMP_REASON_COUNT] = { "manual", "auto", "schedule" };
+    
+    LOG_DBG(MOD_WEB, "req", "GET /metrics");
+    
+    if (!_getMetrics) {
+        _sendError(503, "Metrics not available");
+        return;
+    }
+    
+    WebMetrics m;
+    _getMetrics(&m);
+    _sampleHeap();
+    
+    Response out(*this, 200, METRICS_CONTENT_TYPE);
+    MetricsWriter metrics(out);
+    
+    // Sensors
+    metrics.family("tuoicay_soil_moisture_percent", MetricType::GAUGE, "percent",
+                   "Filtered soil moisture");
+    for (uint8_t i = 0; i < WEB_SENSOR_COUNT; i++) {
+        if (m.analog[i]) {
+            metrics.add("sensor", SENSOR_LABELS[i], m.health.sensors[i].moisture);
+        }
+    }
+    metrics.family("tuoicay_soil_adc_raw", MetricType::GAUGE, nullptr,
+                   "Last unfiltered ADC sample (0-1023, higher = drier)");
+    for (uint8_t i = 0; i < WEB_SENSOR_COUNT; i++) {
+        if (m.analog[i]) {
+            metrics.add("sensor", SENSOR_LABELS[i], m.adcRaw[i]);
+        }
+    }
+    metrics.family("tuoicay_soil_sensor_valid", MetricType::GAUGE, nullptr,
+                   "Reading within calibration range (1) or not (0)");
+    for (uint8_t i = 0; i < WEB_SENSOR_COUNT; i++) {
+        metrics.add("sensor", SENSOR_LABELS[i], m.health.sensors[i].valid ? 1 : 0);
+    }
+    
+    // Pump
+    metrics.family("tuoicay_pump_on_seconds", MetricType::COUNTER, "seconds",
+                   "Time the pump ran since boot");
+    metrics.add((int64_t)m.pumpOnMs, 1000);
+    metrics.family("tuoicay_pump_starts", MetricType::COUNTER, nullptr,
+                   "Pump starts since boot by reason");
+    for (uint8_t i = 0; i < WEB_PUMP_REASON_COUNT; i++) {
+        metrics.add("reason", REASON_LABELS[i], m.pumpStarts[i]);
+    }
+    
+    // Connectivity
+    metrics.family("tuoicay_mqtt_reconnects", MetricType::COUNTER, nullptr,
+                   "MQTT reconnect attempts since boot");
+    metrics.add(m.health.mqttReconnectTotal);
+    metrics.family("tuoicay_mqtt_reconnect_attempts", MetricType::GAUGE, nullptr,
+                   "Failed attempts since the last MQTT connect (backoff)");
+    metrics.add(m.health.mqttReconnects);
+    metrics.family("tuoicay_mqtt_queued_messages", MetricType::GAUGE, nullptr,
+                   "Messages waiting for the broker");
+    metrics.add(m.health.mqttQueued);
+    metrics.family("tuoicay_wifi_rssi_dbm", MetricType::GAUGE, "dbm",
+                   "WiFi signal strength");
+    metrics.add(m.health.rssi);
+    metrics.family("tuoicay_wifi_reconnects", MetricType::COUNTER, nullptr,
+                   "WiFi reconnect attempts since boot");
+    metrics.add(m.health.wifiReconnectTotal);
+    metrics.family("tuoicay_wifi_reconnect_attempts", MetricType::GAUGE, nullptr,
+                   "Failed attempts since the last WiFi connect (backoff)");
+    metrics.add(m.health.wifiReconnects);
+    
+    // Heap
+    metrics.family("tuoicay_heap_free_bytes", MetricType::GAUGE, "bytes",
+                   "Free heap");
+    metrics.add(ESP.getFreeHeap());
+    metrics.family("tuoicay_heap_max_block_bytes", MetricType::GAUGE, "bytes",
+                   "Largest free heap block");
+    metrics.add(ESP.getMaxFreeBlockSize());
+    metrics.family("tuoicay_heap_fragmentation_percent", MetricType::GAUGE, "percent",
+                   "Heap fragmentation");
+    metrics.add(ESP.getHeapFragmentation());
+    metrics.family("tuoicay_heap_min_free_bytes", MetricType::GAUGE, "bytes",
+                   "Lowest free heap seen (reset by POST /api/perf)");
+    metrics.add(_minFreeHeap);
+    
+    // Loop
+    metrics.family("tuoicay_loop_duration_seconds", MetricType::HISTOGRAM, "seconds",
+                   "loop() iteration time since boot");
+    metrics.histogram(m.loopBoundsUs, m.loopCounts, m.loopBuckets, m.loopSumUs, 1000000);
+    
+    // Time
+    metrics.family("tuoicay_ntp_synced", MetricType::GAUGE, nullptr,
+                   "Clock set from NTP (1) or not yet (0)");
+    metrics.add(m.timeSynced ? 1 : 0);
+    if (m.timeSynced) {
+        metrics.family("tuoicay_ntp_since_sync_seconds", MetricType::GAUGE, "seconds",
+                       "Time since the last NTP sync");
+        metrics.add(m.secondsSinceSync);
+    }
+    
+    metrics.end();
+    out.end();
+}
+
+void WebServerManager::_handleBudget() {
+    static const char* const REASON_NAMES[] = { "none", "manual", "auto", "schedule" };
+    
+    LOG_DBG(MOD_WEB, "req", "GET /api/budget");
+    
+    if (!_getBudget) {
+        _sendError(503, "Budget not available");
+        return;
+    }
+    
+    WebBudget b;
+    _getBudget(&b);
+    
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("percent", b.percent);
+    json.add("skip", b.percent == 0);
+    json.add("dryShift", b.dryShift);
+    json.add("thresholdDry", b.thresholdDry);
+    json.add("thresholdWet", b.thresholdWet);
+    json.add("et0", b.et0Mm10 / 10.0f, 1);
+    json.add("rain", b.rainMm10 / 10.0f, 1);
+    
+    json.beginObject("forecast");
+    json.add("source", b.source);
+    if (b.forecast) {
+        const WeatherForecast& f = *b.forecast;
+        if (f.hasRain) {
+            json.add("rain", f.rainMm10 / 10.0f, 1);
+            json.add("rainProb", f.rainProb);
+        }
+        if (f.hasTemp) json.add("temp", f.tempC10 / 10.0f, 1);
+        if (f.hasEt0) json.add("et0", f.et0Mm10 / 10.0f, 1);
+        json.add("expiresIn", b.expiresIn);
+    }
+    json.endObject();
+    
+    // Newest first
+    json.add("ledgerTotal", b.ledger->total());
+    json.beginArray("ledger");
+    for (uint8_t i = 0; i < b.ledger->count(); i++) {
+        const PumpLedgerEntry& e = b.ledger->at(i);
+        json.beginObject();
+        json.add("epoch", (unsigned long)e.epoch);
+        json.add("reason", REASON_NAMES[e.reason < 4 ? e.reason : 0]);
+        json.add("action", e.action == LedgerAction::RUN ? "run" : "skip");
+        json.add("percent", e.percent);
+        json.add("dryShift", e.dryShift);
+        json.add("planned", e.plannedSec);
+        json.add("applied", e.appliedSec);
+        json.endObject();
+    }
+    json.endArray();
+    
+    json.endObject();
+    out.end();
+}
+
+void WebServerManager::_handleJobs() {
+    LOG_DBG(MOD_WEB, "req", "GET /api/jobs");
+    
+    if (!_getJobs) {
+        _sendError(503, "Jobs not available");
+        return;
+    }
+    
+    const IrrigationQueue& q = *_getJobs();
+    uint32_t now = millis();
+    
+    Response out(*this, 200);
+    JsonWriter json(out);
+    json.beginObject();
+    
+    // Elapsed / remaining count from the last (re)start: "done" is what a
+    // preempted job had already run
+    if (q.hasActive()) {
+        const IrrigationJob& job = q.active();
+        uint32_t elapsed = q.elapsedSec(now);
+        json.beginObject("active");
+        json.add("id", job.id);
+        json.add("source", irrigationSourceName(job.source));
+        if (job.entry != IRRIGATION_NO_ENTRY) json.add("entry", job.entry);
+        json.add("duration", job.durationSec);
+        json.add("done", job.doneSec);
+        json.add("elapsed", (unsigned long)elapsed);
+        if (job.durationSec) {
+            json.add("remaining", (unsigned long)(elapsed < job.runSec() ? job.runSec() - elapsed : 0));
+        }
+        json.endObject();
+    } else {
+        json.add("active", (const char*)nullptr);
+    }
+    
+    // Start order
+    json.beginArray("waiting");
+    for (uint8_t i = 0; i < q.waitingCount(); i++) {
+        const IrrigationJob& job = q.waiting(i);
+        json.beginObject();
+        json.add("id", job.id);
+        json.add("source", irrigationSourceName(job.source));
+        if (job.entry != IRRIGATION_NO_ENTRY) json.add("entry", job.entry);
+        json.add("duration", job.durationSec);
+        json.add("done", job.doneSec);
+        json.add("waited", (unsigned long)((now - job.sinceMs) / 1000));
+        json.endObject();
+    }
+    json.endArray();
+    
+    json.add("max", IRRIGATION_QUEUE_MAX);
+    json.add("waitMax", IRRIGATION_WAIT_MAX_SEC);
+    json.add("started", (unsigned long)q.getStarted());
+    json.add("preempted", (unsigned long)q.getPreempted());
+    json.add("expired", (unsigned long)q.getExpired());
+    
+    json.endObject();
+    out.end();
+}
+
+void WebServerManager::_loadFsDashboard() {
+    _fsDashboard = false;
+    
+    File etag = LittleFS.open(WEB_FS_ROOT "/index.etag", "r");
+    if (etag) {
+        int len = etag.read((uint8_t*)_fsEtag, sizeof(_fsEtag) - 1);
+        etag.close();
+        _fsEtag[len > 0 ? len : 0] = '\0';
+        _fsDashboard = len > 2 && LittleFS.exists(WEB_FS_ROOT "/index.html.gz");
+    }
+    
+    LOG_INF(MOD_WEB, "init", "Dashboard from %s", _fsDashboard ? "LittleFS" : "PROGMEM");
+}
+
+bool WebServerManager::_handleAsset(const char* path) {
+    static const struct {
+        const char* ext;
+        const char* type;
+    } TYPES[] = {
+        { ".js",   "application/javascript" },
+        { ".css",  "text/css" },
+        { ".svg",  "image/svg+xml" },
+        { ".png",  "image/png" },
+        { ".ico",  "image/x-icon" },
+        { ".json", "application/json" },
+    };
+    
+    // Names are plain file names made by the build script: no '/', no '..'
+    const char* name = path + strlen(WEB_ASSET_PREFIX);
+    size_t len = strlen(path);
+    if (len > WEB_ASSET_PATH_MAX || *name == '.' || strchr(name, '/')) {
+        return false;
+    }
+    
+    const char* ext = strrchr(name, '.');
+    const char* contentType = nullptr;
+    for (const auto& t : TYPES) {
+        if (ext && strcmp(ext, t.ext) == 0) {
+            contentType = t.type;
+            break;
+        }
+    }
+    if (!contentType) {
+        return false;
+    }
+    
+    char fsPath[sizeof(WEB_FS_ROOT) + WEB_ASSET_PATH_MAX + 3];
+    snprintf(fsPath, sizeof(fsPath), WEB_FS_ROOT "%s.gz", path);
+    
+    LOG_DBG(MOD_WEB, "req", "GET %s", path);
+    _sendHeader("Content-Encoding", "gzip");
+    _sendHeader("Cache-Control", "public, max-age=31536000, immutable");
+    if (_sendFile(200, contentType, fsPath)) {
+        return true;
+    }
+    _respHeaderCount = 0;
+    return false;
+}
+
+void WebServerManager::_handleNotFound() {
+    const char* path = _uri();
+    
+    // Hashed static assets share one prefix instead of a route each
+    if (_isGet() && strncmp(path, WEB_ASSET_PREFIX, strlen(WEB_ASSET_PREFIX)) == 0 &&
+        _handleAsset(path)) {
+        return;
+    }
+    
+    if (_findRoute(path, false) || _findRoute(path, true)) {
+        _sendError(405, "Method not allowed");
+        return;
+    }
+    _sendError(404, "Not found");
+}
+
+void WebServerManager::_sendJson(int code, const char* json) {
+    _sendHeader("Access-Control-Allow-Origin", "*");
+    _sendBuffer(code, "application/json", json, strlen(json));
+}
+
+void WebServerManager::_sendError(int code, const char* message) {
+    Response out(*this, code);
+    JsonWriter json(out);
+    json.beginObject();
+    json.add("ok", false);
+    json.add("error", message);
+    json.endObject();
+    out.end();
+}
+
+void WebServerManager::_sampleHeap() {
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t maxBlock = ESP.getMaxFreeBlockSize();
+    
+    if (freeHeap < _minFreeHeap) {
+        _minFreeHeap = freeHeap;
+    }
+    if (maxBlock < _minMaxBlock) {
+        _minMaxBlock = maxBlock;
+    }
+}
+
+//=============================================================================
+// RESPONSE (body streamed through the active backend)
+//=============================================================================
+
+WebServerManager::Response::Response(WebServerManager& owner, int code, const char* contentType)
+    : _owner(owner)
+    , _code(code)
+    , _contentType(contentType)
+{
+    _owner._sendHeader("Access-Control-Allow-Origin", "*");
+}
+
+void WebServerManager::Response::_sendWhole(const char* data, size_t len) {
+    _owner._sendBuffer(_code, _contentType, data, len);
+}
+
+void WebServerManager::Response::_beginStream() {
+    _owner._beginStream(_code, _contentType);
+}
+
+void WebServerManager::Response::_sendChunk(const char* data, size_t len) {
+    _owner._sendChunk(data, len);
+}
+
+void WebServerManager::Response::_endStream() {
+    _owner._endStream();
+}
+
+void WebServerManager::_dispatch(const Route* route) {
+    uint32_t start = micros();
+    
+    _responded = false;
+    if (!route) {
+        _handleNotFound();
+    } else if (_parseBody(*route)) {
+        (this->*route->handler)();
+    }
+    
+    // Every request gets an answer, even if a handler path forgot one
+    if (!_responded) {
+        LOG_ERR(MOD_WEB, "req", "Handler sent no response");
+        _sendError(500, "No response");
+    }
+    
+    uint32_t elapsed = micros() - start;
+    if (elapsed > _maxHandlerUs) {
+        _maxHandlerUs = elapsed;
+    }
+    _requestCount++;
+}
+
+bool WebServerManager::_parseBody(const Route& route) {
+    // Previous request's document stays in the arena until here
+    _doc.clear();
+    _arena.reset();
+    
+    const char* data;
+    size_t len;
+    if (!_body(data, len) || len == 0) {
+        if (route.body) {
+            _badRequestCount++;
+            _sendError(400, "No body");
+            return false;
+        }
+        return true;
+    }
+    
+    DeserializationError err = deserializeJson(_doc, data, len);
+    if (err) {
+        _badRequestCount++;
+        LOG_WRN(MOD_WEB, "req", "JSON parse error: %s", err.c_str());
+        if (err == DeserializationError::NoMemory) {
+            _sendError(413, "Body too complex");
+        } else {
+            _sendError(400, "Invalid JSON");
+        }
+        return false;
+    }
+    
+    if (route.body && !_doc.is<JsonObject>()) {
+        _badRequestCount++;
+        _sendError(400, "Body must be a JSON object");
+        return false;
+    }
+    return true;
+}
+
+bool WebServerManager::_readInt(const char* key, long min, long max, long& value) {
+    const JsonDocument& doc = _doc;
+    JsonVariantConst field = doc[key];
+    if (!field.is<long>()) {
+        return false;
+    }
+    value = field.as<long>();
+    return value >= min && value <= max;
+}
+
+//=============================================================================
+// BACKEND ADAPTER
+//=============================================================================
+void WebServerManager::_sendHeader(const char* name, const char* value) {
+    if (_respHeaderCount >= WEB_MAX_RESPONSE_HEADERS) {
+        LOG_WRN(MOD_WEB, "resp", "Header dropped: %s", name);
+        return;
+    }
+    _respHeaders[_respHeaderCount].name = name;
+    _respHeaders[_respHeaderCount].value = value;
+    _respHeaderCount++;
+}
+
+#ifndef WEB_ASYNC_BACKEND
+
+// Every event stream must leave room for at least one request socket
+static_assert(WEB_EVENTS_MAX_CLIENTS < WEB_MAX_CONNECTIONS,
+              "WEB_MAX_CONNECTIONS must exceed WEB_EVENTS_MAX_CLIENTS");
+
+/**
+ * @brief Append one header line, skipping it if the head buffer is full
+ * Keeps 2 bytes for the blank line that ends the head.
+ */
+static void appendHead(char* buf, size_t size, int& len, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(buf + len, size - 2 - len, fmt, args);
+    va_end(args);
+    
+    if (written < 0 || (size_t)(len + written) >= size - 2) {
+        buf[len] = '\0';
+        LOG_WRN(MOD_WEB, "resp", "Response head full, header skipped");
+        return;
+    }
+    len += written;
+}
+
+/**
+ * @brief Value of a request header kept by the pool (nullptr = absent)
+ * Only If-None-Match is kept; handlers need no other request header.
+ */
+static const char* keptHeader(const HttpConnection& conn, const char* name) {
+    if (strcasecmp(name, "If-None-Match") == 0 && conn.ifNoneMatch[0] != '\0') {
+        return conn.ifNoneMatch;
+    }
+    return nullptr;
+}
+
+bool WebServerManager::_isGet() {
+    return _conn->method == HttpMethod::GET;
+}
+
+bool WebServerManager::_isPost() {
+    return _conn->method == HttpMethod::POST;
+}
+
+const char* WebServerManager::_uri() {
+    return _conn->path;
+}
+
+bool WebServerManager::_body(const char*& data, size_t& len) {
+    // Pool's shared body buffer, valid until the request is finished
+    return _pool.body(_conn, data, len);
+}
+
+bool WebServerManager::_headerContains(const char* name, const char* token) {
+    const char* value = keptHeader(*_conn, name);
+    return value && strstr(value, token) != nullptr;
+}
+
+bool WebServerManager::_header(const char* name, char* buf, size_t size) {
+    const char* value = keptHeader(*_conn, name);
+    if (!value) {
+        return false;
+    }
+    strncpy(buf, value, size - 1);
+    buf[size - 1] = '\0';
+    return true;
+}
+
+void WebServerManager::_writeHead(int code, const char* contentType, long length) {
+    HttpConnection& conn = *_conn;
+    
+    // HTTP/1.0 has no chunked encoding: the body ends when the socket does
+    if (length < 0 && !conn.http11) {
+        conn.keepAlive = false;
+    }
+    
+    char head[WEB_HEAD_BUFFER_SIZE];
+    int len = 0;
+    appendHead(head, sizeof(head), len, "HTTP/1.1 %d %s\r\n",
+               code, HttpConnectionPool::statusText(code));
+    if (contentType) {
+        appendHead(head, sizeof(head), len, "Content-Type: %s\r\n", contentType);
+    }
+    if (code == 204 || code == 304) {
+        // No body by definition, no length needed to keep the socket
+    } else if (length >= 0) {
+        appendHead(head, sizeof(head), len, "Content-Length: %ld\r\n", length);
+    } else if (conn.http11) {
+        appendHead(head, sizeof(head), len, "Transfer-Encoding: chunked\r\n");
+    }
+    if (conn.keepAlive) {
+        appendHead(head, sizeof(head), len, "Connection: keep-alive\r\nKeep-Alive: timeout=%u\r\n",
+                   (unsigned)(WEB_KEEPALIVE_TIMEOUT_MS / 1000));
+    } else {
+        appendHead(head, sizeof(head), len, "Connection: close\r\n");
+    }
+    for (uint8_t i = 0; i < _respHeaderCount; i++) {
+        appendHead(head, sizeof(head), len, "%s: %s\r\n",
+                   _respHeaders[i].name, _respHeaders[i].value);
+    }
+    _respHeaderCount = 0;
+    
+    head[len++] = '\r';
+    head[len++] = '\n';
+    conn.client.write((const uint8_t*)head, len);
+}
+
+uint8_t WebServerManager::_eventStreamCount() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < WEB_EVENTS_MAX_CLIENTS; i++) {
+        if (_eventClients[i].connected()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void WebServerManager::_sendBuffer(int code, const char* contentType,
+                                   const char* data, size_t len) {
+    _sampleHeap();
+    _writeHead(code, contentType, (long)len);
+    if (len > 0) {
+        _conn->client.write((const uint8_t*)data, len);
+    }
+    _responded = true;
+}
+
+void WebServerManager::_beginStream(int code, const char* contentType) {
+    _sampleHeap();
+    _writeHead(code, contentType, -1);
+    _responded = true;
+}
+
+void WebServerManager::_sendChunk(const char* data, size_t len) {
+    if (!_conn->http11) {
+        _conn->client.write((const uint8_t*)data, len);
+        return;
+    }
+    char size[12];
+    int n = snprintf(size, sizeof(size), "%x\r\n", (unsigned)len);
+    _conn->client.write((const uint8_t*)size, n);
+    _conn->client.write((const uint8_t*)data, len);
+    _conn->client.write((const uint8_t*)"\r\n", 2);
+}
+
+void WebServerManager::_endStream() {
+    if (_conn->http11) {
+        _conn->client.write((const uint8_t*)"0\r\n\r\n", 5);
+    }
+}
+
+void WebServerManager::_sendProgmem(int code, const char* contentType,
+                                    const uint8_t* data, size_t len) {
+    _writeHead(code, contentType, (long)len);
+    _conn->client.write_P((PGM_P)data, len);
+    _responded = true;
+}
+
+bool WebServerManager::_sendFile(int code, const char* contentType, const char* path) {
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return false;
+    }
+    
+    _writeHead(code, contentType, (long)file.size());
+    uint8_t chunk[WEB_FILE_CHUNK_SIZE];
+    int n;
+    while ((n = file.read(chunk, sizeof(chunk))) > 0) {
+        if (_conn->client.write(chunk, n) != (size_t)n) {
+            _conn->keepAlive = false;   // Body cut short: length no longer matches
+            break;
+        }
+    }
+    file.close();
+    _responded = true;
+    return true;
+}
+
+void WebServerManager::_sendEmpty(int code) {
+    _writeHead(code, nullptr, 0);
+    _responded = true;
+}
+
+#else // WEB_ASYNC_BACKEND
+
+bool WebServerManager::_isGet() {
+    return _request->method() == HTTP_GET;
+}
+
+bool WebServerManager::_isPost() {
+    return _request->method() == HTTP_POST;
+}
+
+const char* WebServerManager::_uri() {
+    return _request->url().c_str();
+}
+
+bool WebServerManager::_body(const char*& data, size_t& len) {
+    if (_request->_tempObject == nullptr) {
+        return false;
+    }
+    data = (const char*)_request->_tempObject;
+    len = strlen(data);
+    return true;
+}
+
+bool WebServerManager::_headerContains(const char* name, const char* token) {
+    AsyncWebHeader* header = _request->getHeader(name);
+    return header && strstr(header->value().c_str(), token) != nullptr;
+}
+
+bool WebServerManager::_header(const char* name, char* buf, size_t size) {
+    AsyncWebHeader* header = _request->getHeader(name);
+    if (!header) {
+        return false;
+    }
+    strncpy(buf, header->value().c_str(), size - 1);
+    buf[size - 1] = '\0';
+    return true;
+}
+
+void WebServerManager::_sendBuffer(int code, const char* contentType,
+                                   const char* data, size_t len) {
+    // data is NUL-terminated (BufferedResponse / literals)
+    (void)len;
+    _sampleHeap();
+    AsyncWebServerResponse* response = _request->beginResponse(code, contentType, String(data));
+    _applyHeaders(response);
+    _request->send(response);
+    _responded = true;
+}
+
+void WebServerManager::_beginStream(int code, const char* contentType) {
+    // The library sends after the handler returns, so a large body has to
+    // be kept until then: AsyncResponseStream holds it on the heap
+    _sampleHeap();
+    _stream = _request->beginResponseStream(contentType);
+    _stream->setCode(code);
+}
+
+void WebServerManager::_sendChunk(const char* data, size_t len) {
+    _stream->write((const uint8_t*)data, len);
+}
+
+void WebServerManager::_endStream() {
+    _applyHeaders(_stream);
+    _request->send(_stream);
+    _stream = nullptr;
+    _responded = true;
+}
+
+void WebServerManager::_sendProgmem(int code, const char* contentType,
+                                    const uint8_t* data, size_t len) {
+    // Library copies from flash chunk by chunk as the TCP window opens
+    AsyncWebServerResponse* response = _request->beginResponse_P(code, contentType, data, len);
+    _applyHeaders(response);
+    _request->send(response);
+    _responded = true;
+}
+
+bool WebServerManager::_sendFile(int code, const char* contentType, const char* path) {
+    if (!LittleFS.exists(path)) {
+        return false;
+    }
+    // Library keeps the file open and reads it as the TCP window allows
+    AsyncWebServerResponse* response = _request->beginResponse(LittleFS, path, contentType);
+    response->setCode(code);
+    _applyHeaders(response);
+    _request->send(response);
+    _responded = true;
+    return true;
+}
+
+void WebServerManager::_sendEmpty(int code) {
+    AsyncWebServerResponse* response = _request->beginResponse(code);
+    _applyHeaders(response);
+    _request->send(response);
+    _responded = true;
+}
+
+void WebServerManager::_applyHeaders(AsyncWebServerResponse* response) {
+    for (uint8_t i = 0; i < _respHeaderCount; i++) {
+        response->addHeader(_respHeaders[i].name, _respHeaders[i].value);
+    }
+    _respHeaderCount = 0;
+}
+
+void WebServerManager::_queueRequest(AsyncWebServerRequest* request) {
+    // Runs in lwIP context: only look up and queue here, handlers run from update()
+    if (request->contentLength() > 0 && request->_tempObject == nullptr) {
+        _rejectedCount++;
+        request->send(413, "application/json", "{\"error\":\"Body too large\"}");
+        return;
+    }
+    
+    if (_pendingCount >= WEB_ASYNC_QUEUE_SIZE) {
+        _rejectedCount++;
+        request->send(503, "application/json", "{\"error\":\"Server busy\"}");
+        return;
+    }
+    
+    WebRequestMethodComposite method = request->method();
+    bool known = method == HTTP_GET || method == HTTP_POST;
+    
+    uint8_t slot = (_pendingHead + _pendingCount) % WEB_ASYNC_QUEUE_SIZE;
+    _pending[slot].request = request;
+    _pending[slot].route = known ? _findRoute(request->url().c_str(), method == HTTP_POST) : nullptr;
+    _pendingCount++;
+    
+    // Library frees the request on disconnect; never touch it afterwards
+    request->onDisconnect([this, request]() { _dropRequest(request); });
+}
+
+void WebServerManager::_dropRequest(AsyncWebServerRequest* request) {
+    for (uint8_t i = 0; i < WEB_ASYNC_QUEUE_SIZE; i++) {
+        if (_pending[i].request == request) {
+            _pending[i].request = nullptr;
+        }
+    }
+}
+
+void WebServerManager::_processPending() {
+    // One request per loop() iteration keeps worst-case latency bounded
+    while (_pendingCount > 0) {
+        PendingRequest pending = _pending[_pendingHead];
+        _pending[_pendingHead].request = nullptr;
+        _pendingHead = (_pendingHead + 1) % WEB_ASYNC_QUEUE_SIZE;
+        _pendingCount--;
+        
+        if (pending.request == nullptr) {
+            continue;       // Client disconnected while queued
+        }
+        
+        _request = pending.request;
+        _respHeaderCount = 0;
+        _dispatch(pending.route);
+        _request = nullptr;
+        return;
+    }
+}
+
+void WebServerManager::_onEventClient(AsyncEventSourceClient* client) {
+    EventState state;
+    _readEventState(state);
+    
+    char buf[WEB_EVENT_BUFFER_SIZE];
+    int len = _formatEvent(buf, sizeof(buf), state, nullptr);
+    if (len > 0) {
+        client->send(eventPayload(buf, len), nullptr, millis(), WEB_EVENTS_RETRY_MS);
+    }
+    
+    if (!_eventStateValid) {
+        _lastEvent = state;
+        _eventStateValid = true;
+    }
+    
+    LOG_INF(MOD_WEB, "events", "Stream opened (%u active)", (unsigned)_asyncEvents->count());
+}
+
+#endif // WEB_ASYNC_BACKEND
@@ -4,15 +4,46 @@
  * 
  * LOGIC:
  * - REST API endpoints for status and control
- * - HTML dashboard served from PROGMEM or LittleFS
+ * - HTML dashboard served gzip-compressed from LittleFS (index + hashed,
+ *   immutable CSS/JS assets), falling back to the PROGMEM copy (ETag/304)
  * - JSON responses for API calls
+ * - One route table (method + path) looked up through a compile-time
+ *   perfect hash; one catch-all handler per backend does the dispatch
+ * - POST bodies parsed once, before the handler, into a JsonDocument
+ *   backed by a fixed arena; handlers read _doc and report problems
+ *   through _sendError ({"ok":false,"error":...})
+ * - Two interchangeable backends behind the route table:
+ *   - default: own HTTP/1.1 connection pool (http_pool.h) with keep-alive,
+ *     pipelining, idle timeouts and backpressure; one request handled
+ *     inside update()
+ *   - WEB_ASYNC_BACKEND: ESPAsyncWebServer; sockets, header/body parsing and
+ *     response streaming run in lwIP callbacks, the parsed request is queued
+ *     and its handler runs from update() so callbacks keep loop() context
  * 
  * ENDPOINTS:
  * - GET /           -> HTML dashboard
- * - GET /api/status -> JSON status
+ * - GET /assets/<name> -> Hashed dashboard assets from LittleFS (cached 1 year)
+ * - GET /api/status -> JSON status, with the clock (sync, timezone, DST)
+ * - GET /api/state  -> Status, schedule, speed and health in one snapshot,
+ *                      versioned (ETag) so an unchanged poll is a bare 304
+ * - GET /api/events -> Server-Sent Events stream of status changes
+ * - GET /api/perf   -> Loop latency, heap and web server counters
+ * - GET /metrics    -> Prometheus scrape, OpenMetrics text streamed
+ *                      through the response buffer (no heap)
+ * - GET/POST /api/schedule -> Schedule entries (daily, every N hours,
+ *                      sunrise/sunset, weekdays, date range); POST
+ *                      replaces the whole list
+ * - GET /api/budget -> Weather forecast in use, water budget and the
+ *                      pump ledger (recent runs / skips it decided)
+ * - GET /api/jobs   -> Irrigation job queue: the running job and the
+ *                      ones waiting for the pump, in start order
  * - POST /api/pump  -> Pump control
  * - POST /api/mode  -> Mode control
  * - POST /api/config -> Configuration
+ * - POST /api/batch -> Several config operations, validated together,
+ *                      applied and persisted once (all or nothing)
+ * - POST /api/time  -> Set the clock by hand (dashboard), taken only when
+ *                      no better source (NTP / HTTP / MQTT) holds it
  * 
  * RULES: #HTTP(24) #JSON(23)
  */
@@ -21,12 +52,42 @@
 #define WEB_SERVER_H
 
 #include <Arduino.h>
-#include <ESP8266WebServer.h>
+#include <ESP8266WiFi.h>
 #include <config.h>
+#include <buffered_response.h>
+#include <ArduinoJson.h>
+#include <json_arena.h>
+#include <route_table.h>
+#include <pump_ledger.h>
+#include <irrigation_queue.h>
+#include "storage_manager.h"    // ScheduleEntry, MAX_SCHEDULE_ENTRIES
+#include "water_budget.h"       // WeatherForecast
+#include "ntp_client.h"         // NtpServerStats
+#include "http_date_client.h"   // HttpDateClient
+
+// ESPAsyncWebServer and ESP8266WebServer both define HTTP_GET/HTTP_POST,
+// so the async types stay out of this header (main.cpp sees both servers)
+#ifdef WEB_ASYNC_BACKEND
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+class AsyncResponseStream;
+class AsyncEventSource;
+class AsyncEventSourceClient;
+#else
+#include "http_pool.h"
+#endif
+
+#define WEB_EVENT_BUFFER_SIZE   256     // One SSE event / stream header
+#define WEB_HEAD_BUFFER_SIZE    320     // Status line + headers (sync backend)
+#define WEB_STATE_ETAG_SIZE     12      // "4294967295" with quotes + NUL
+#define WEB_FS_ETAG_SIZE        20      // 16 hex digits with quotes + NUL
 
 // Forward declarations
 class SensorManager;
 class PumpController;
+class JsonWriter;
+class ConfigBatch;
 
 //=============================================================================
 // CALLBACK TYPES FOR GETTING DATA
@@ -37,7 +98,8 @@ typedef const char* (*GetPumpReasonFunc)();
 typedef uint16_t (*GetPumpRuntimeFunc)();
 typedef bool (*GetAutoModeFunc)();
 
-typedef void (*SetPumpFunc)(bool on);
+// on: verdict of the manual job; off always succeeds (STARTED)
+typedef IrrigationVerdict (*SetPumpFunc)(bool on);
 typedef void (*SetAutoModeFunc)(bool enabled);
 typedef void (*SetThresholdsFunc)(uint8_t dry, uint8_t wet);
 
@@ -46,23 +108,123 @@ typedef uint8_t (*GetPumpSpeedFunc)();
 typedef void (*SetPumpSpeedFunc)(uint8_t percent);
 
 // Schedule callbacks
-struct WebScheduleEntry {
-    uint8_t hour;
-    uint8_t minute;
-    uint16_t duration;
-    bool enabled;
-};
-
 struct WebScheduleConfig {
     bool enabled;
-    WebScheduleEntry entries[4];
+    uint8_t count;
+    ScheduleEntry entries[MAX_SCHEDULE_ENTRIES];
 };
 
-typedef bool (*GetScheduleConfigFunc)(WebScheduleConfig* config, String* nextRun);
+// nextRun: the scheduler's cached text, valid until its next update()
+typedef bool (*GetScheduleConfigFunc)(WebScheduleConfig* config, const char** nextRun);
 typedef void (*SetScheduleEnabledFunc)(bool enabled);
-typedef void (*SetScheduleEntryFunc)(uint8_t index, uint8_t hour, uint8_t minute, uint16_t duration, bool enabled);
+typedef void (*SetScheduleEntriesFunc)(const ScheduleEntry* entries, uint8_t count);
 typedef void (*SaveScheduleFunc)();
 
+// Performance statistics (loop latency from LoopMonitor)
+struct WebPerfStats {
+    uint32_t loopMaxUs;         // Worst iteration, last completed window
+    uint32_t loopPeakUs;        // Worst iteration since last reset
+    uint32_t loopStalls;        // Stalls since last reset
+    uint32_t loopIterations;    // Iterations since last reset
+};
+
+typedef void (*GetPerfStatsFunc)(WebPerfStats* stats);
+typedef void (*ResetPerfStatsFunc)();
+
+// Sensor and connectivity health (/api/state)
+#define WEB_SENSOR_COUNT        2
+
+struct WebSensorHealth {
+    uint8_t moisture;           // %, SENSOR_INVALID_VALUE without analog
+    bool valid;
+};
+
+struct WebSystemHealth {
+    WebSensorHealth sensors[WEB_SENSOR_COUNT];
+    const char* wifiState;
+    int8_t rssi;                // dBm
+    uint8_t wifiReconnects;     // Current backoff attempts
+    uint32_t wifiReconnectTotal; // Since boot, only ever grows
+    const char* mqttState;
+    uint8_t mqttQueued;         // Messages waiting for the broker
+    uint8_t mqttReconnects;
+    uint32_t mqttReconnectTotal;
+};
+
+typedef void (*GetSystemHealthFunc)(WebSystemHealth* health);
+
+// Device metrics (/metrics)
+#define WEB_PUMP_REASON_COUNT   3       // manual, auto, schedule (PumpReason 1-3)
+
+struct WebMetrics {
+    WebSystemHealth health;
+    bool analog[WEB_SENSOR_COUNT];      // Sensor has an analog input
+    uint16_t adcRaw[WEB_SENSOR_COUNT];  // Last ADC sample (analog sensors)
+    uint64_t pumpOnMs;                  // Pump on-time since boot
+    uint32_t pumpStarts[WEB_PUMP_REASON_COUNT];
+    bool timeSynced;
+    uint32_t secondsSinceSync;
+    const uint32_t* loopBoundsUs;       // LoopMonitor histogram
+    const uint64_t* loopCounts;         // loopBuckets + 1 entries
+    uint8_t loopBuckets;
+    uint64_t loopSumUs;
+};
+
+typedef void (*GetMetricsFunc)(WebMetrics* metrics);
+
+// Water budget (/api/budget)
+struct WebBudget {
+    uint8_t percent;                    // 0 = runs skipped
+    int8_t dryShift;                    // Auto threshold shift
+    uint8_t thresholdDry;               // Auto thresholds after the shift
+    uint8_t thresholdWet;
+    const char* source;                 // "none", "device", "group"
+    const WeatherForecast* forecast;    // nullptr = none
+    uint16_t et0Mm10;                   // ET0 used (sent or estimated)
+    uint16_t rainMm10;                  // Expected rain (rain x probability)
+    uint32_t expiresIn;                 // Seconds
+    const PumpLedger* ledger;
+};
+
+typedef void (*GetBudgetFunc)(WebBudget* budget);
+
+// Irrigation jobs (/api/jobs)
+typedef const IrrigationQueue* (*GetJobsFunc)();
+
+// Clock (/api/status "time" block)
+struct WebTimeInfo {
+    bool synced;
+    const char* source;                 // "none", "rtc" (warm boot), "ntp",
+                                        // "http", "mqtt", "manual"
+    const char* timezone;               // POSIX TZ string in use
+    char local[20];                     // "YYYY-MM-DD HH:MM:SS"
+    bool dst;                           // Daylight saving time now
+    int32_t utcOffset;                  // Seconds, DST included
+    uint32_t accuracyMs;                // Error bound of the clock
+    bool hasDrift;
+    int32_t driftPpb;                   // Compensated crystal drift
+    uint32_t pollSec;                   // NTP interval (adaptive)
+    uint32_t nextSyncIn;                // Seconds
+    int8_t server;                      // Best server (-1 = none yet)
+    const NtpServerStats* servers;
+    uint8_t serverCount;
+    const HttpDateClient* http;         // Local HTTP Date fallback
+    bool hasLocation;
+    int32_t latE4;                      // 1e-4 degrees, north / east +
+    int32_t lonE4;
+    bool hasSun;                        // Today's sunrise / sunset known
+    int16_t sunriseMin;                 // Minutes after local midnight (may
+    int16_t sunsetMin;                  // be 1440+ past midnight)
+};
+
+typedef void (*GetTimeInfoFunc)(WebTimeInfo* info);
+
+// Manual clock (/api/time): TC_ERR_* result
+typedef int (*SetManualTimeFunc)(uint32_t epoch, uint16_t ms);
+
+// Config batch (/api/batch): apply a validated batch, TC_ERR_* result
+typedef int (*ApplyBatchFunc)(const ConfigBatch& batch);
+
 //=============================================================================
 // WEB SERVER CLASS
 //=============================================================================
@@ -142,14 +304,125 @@ public:
     void setScheduleCallbacks(
         GetScheduleConfigFunc getSchedule,
         SetScheduleEnabledFunc setEnabled,
-        SetScheduleEntryFunc setEntry,
+        SetScheduleEntriesFunc setEntries,
         SaveScheduleFunc saveSchedule
     );
+    
+    /**
+     * @brief Set performance statistics callbacks (/api/perf)
+     */
+    void setPerfCallbacks(GetPerfStatsFunc getPerf, ResetPerfStatsFunc resetPerf) {
+        _getPerf = getPerf;
+        _resetPerf = resetPerf;
+    }
+    
+    /**
+     * @brief Set sensor/connectivity health callback (/api/state)
+     */
+    void setHealthCallback(GetSystemHealthFunc getHealth) {
+        _getHealth = getHealth;
+    }
+    
+    /**
+     * @brief Set device metrics callback (/metrics)
+     */
+    void setMetricsCallback(GetMetricsFunc getMetrics) {
+        _getMetrics = getMetrics;
+    }
+    
+    /**
+     * @brief Set water budget callback (/api/budget)
+     */
+    void setBudgetCallback(GetBudgetFunc getBudget) {
+        _getBudget = getBudget;
+    }
+    
+    /**
+     * @brief Set irrigation queue callback (/api/jobs)
+     */
+    void setJobsCallback(GetJobsFunc getJobs) {
+        _getJobs = getJobs;
+    }
+    
+    /**
+     * @brief Set clock callback (/api/status)
+     */
+    void setTimeInfoCallback(GetTimeInfoFunc getTimeInfo) {
+        _getTimeInfo = getTimeInfo;
+    }
+    
+    /**
+     * @brief Set manual clock callback (/api/time)
+     */
+    void setManualTimeCallback(SetManualTimeFunc setManualTime) {
+        _setManualTime = setManualTime;
+    }
+    
+    /**
+     * @brief Set config batch callback (/api/batch)
+     */
+    void setBatchCallback(ApplyBatchFunc applyBatch) {
+        _applyBatch = applyBatch;
+    }
 
 private:
-    ESP8266WebServer _server;
+    typedef void (WebServerManager::*RouteHandler)();
+    
+    struct Route {
+        const char* path;
+        bool post;              // false = GET
+        bool body;              // JSON body required (parsed into _doc)
+        RouteHandler handler;
+    };
+    
+    static const Route ROUTES[];
+    static const RouteSlots ROUTE_INDEX;    // Perfect hash over ROUTES
+    
+    uint16_t _port;
     bool _running;
     
+#ifdef WEB_ASYNC_BACKEND
+    // Request parsed by the async server, waiting for update()
+    struct PendingRequest {
+        AsyncWebServerRequest* request;     // nullptr = client went away
+        const Route* route;                 // nullptr = no such route
+    };
+    
+    AsyncWebServer* _async;
+    AsyncEventSource* _asyncEvents;
+    PendingRequest _pending[WEB_ASYNC_QUEUE_SIZE];
+    uint8_t _pendingHead;
+    uint8_t _pendingCount;
+    AsyncWebServerRequest* _request;    // Request being handled
+    AsyncResponseStream* _stream;       // Large body of current response
+#else
+    HttpConnectionPool _pool;
+    HttpConnection* _conn;              // Connection being served
+#endif
+    bool _responded;
+    
+    // Extra headers of the current response (applied when it is sent)
+    struct ResponseHeader {
+        const char* name;
+        const char* value;
+    };
+    
+    ResponseHeader _respHeaders[WEB_MAX_RESPONSE_HEADERS];
+    uint8_t _respHeaderCount;
+    
+    // Request body, parsed once per request (arena declared first)
+    JsonArena<WEB_JSON_ARENA_SIZE> _arena;
+    JsonDocument _doc;
+    
+    // Web server counters (/api/perf)
+    uint32_t _requestCount;
+    uint32_t _rejectedCount;            // Queue full / body too large
+    uint32_t _badRequestCount;          // Missing or malformed body
+    uint32_t _maxHandlerUs;             // Slowest handler since reset
+    uint32_t _minFreeHeap;              // Heap low-water mark since reset
+    uint32_t _minMaxBlock;              // Largest-free-block low-water mark
+    unsigned long _lastHeapSample;
+    
     // Data providers
     GetMoistureFunc _getMoisture;
     GetPumpStateFunc _getPumpState;
@@ -173,28 +446,257 @@ private:
     // Schedule callbacks
     GetScheduleConfigFunc _getSchedule;
     SetScheduleEnabledFunc _setScheduleEnabled;
-    SetScheduleEntryFunc _setScheduleEntry;
+    SetScheduleEntriesFunc _setScheduleEntries;
     SaveScheduleFunc _saveSchedule;
     
+    // Perf callbacks
+    GetPerfStatsFunc _getPerf;
+    ResetPerfStatsFunc _resetPerf;
+    
+    // Health callback
+    GetSystemHealthFunc _getHealth;
+    
+    // Metrics callback
+    GetMetricsFunc _getMetrics;
+    
+    // Water budget callback
+    GetBudgetFunc _getBudget;
+    
+    // Irrigation queue callback
+    GetJobsFunc _getJobs;
+    
+    // Clock callback
+    GetTimeInfoFunc _getTimeInfo;
+    SetManualTimeFunc _setManualTime;
+    
+    // Config batch callback
+    ApplyBatchFunc _applyBatch;
+    
+    // Live status streams (/api/events)
+    struct EventState {
+        uint8_t moisture;
+        bool pump;
+        const char* reason;
+        uint16_t runtime;
+        bool autoMode;
+        uint8_t thresholdDry;
+        uint8_t thresholdWet;
+    };
+    
+#ifndef WEB_ASYNC_BACKEND
+    WiFiClient _eventClients[WEB_EVENTS_MAX_CLIENTS];
+#endif
+    EventState _lastEvent;              // State last sent to all streams
+    unsigned long _lastEventCheck;
+    unsigned long _lastEventPing;
+    bool _eventStateValid;
+    
+    // Aggregated state (/api/state)
+    struct StateSnapshot {
+        EventState status;
+        uint8_t speed;
+        bool hasSchedule;
+        WebScheduleConfig schedule;
+        const char* nextRun;            // Scheduler's cache, no heap copy
+        WebSystemHealth health;
+    };
+    
+    uint32_t _stateVersion;             // Bumped when the snapshot content changes
+    uint32_t _stateHash;                // Hash of the last versioned snapshot
+    char _stateEtag[WEB_STATE_ETAG_SIZE];   // Must outlive the response headers
+    
+    // Dashboard on LittleFS (checked once in begin())
+    bool _fsDashboard;
+    char _fsEtag[WEB_FS_ETAG_SIZE];
+    
     // Route handlers
     void _handleRoot();
     void _handleStatus();
+    void _handleState();
+    void _handleEvents();
+    void _handlePerf();
     void _handlePump();
     void _handleMode();
     void _handleConfig();
     void _handleSpeed();
     void _handleSchedule();
+    void _handleBatch();
+    void _handleMetrics();
+    void _handleBudget();
+    void _handleJobs();
+    void _handleTime();
     void _handleNotFound();
     
     /**
-     * @brief Send JSON response
+     * @brief Serve a hashed file under WEB_ASSET_PREFIX from LittleFS
+     * @return false if there is no such asset
+     */
+    bool _handleAsset(const char* path);
+    
+    /**
+     * @brief Look for the LittleFS dashboard and read its ETag
+     */
+    void _loadFsDashboard();
+    
+    /**
+     * @brief Look up method + path in the route table
+     * @return nullptr if there is no such route
+     */
+    static const Route* _findRoute(const char* path, bool post);
+    
+    /**
+     * @brief Run a route handler (nullptr = 404/405), timing it and
+     *        guaranteeing a response
+     */
+    void _dispatch(const Route* route);
+    
+    /**
+     * @brief Parse request body into _doc (error response sent on failure)
+     * @return true if the handler may run
+     */
+    bool _parseBody(const Route& route);
+    
+    /**
+     * @brief Read an integer field of the body within [min, max]
+     * @return false if missing, not an integer or out of range
+     */
+    bool _readInt(const char* key, long min, long max, long& value);
+    
+    //-------------------------------------------------------------------------
+    // Backend adapter (request access / response output)
+    //-------------------------------------------------------------------------
+    
+    bool _isGet();
+    bool _isPost();
+    const char* _uri();
+    
+    /**
+     * @brief Raw request body, without copying
+     * @return false if the request has none
+     */
+    bool _body(const char*& data, size_t& len);
+    
+    /**
+     * @brief Check whether a request header contains a token
+     */
+    bool _headerContains(const char* name, const char* token);
+    
+    /**
+     * @brief Copy a request header value (truncated to fit)
+     * @return false if the header is absent
+     */
+    bool _header(const char* name, char* buf, size_t size);
+    
+    /**
+     * @brief Add header to the next response (name/value must be literals)
+     */
+    void _sendHeader(const char* name, const char* value);
+    void _sendBuffer(int code, const char* contentType, const char* data, size_t len);
+    void _beginStream(int code, const char* contentType);
+    void _sendChunk(const char* data, size_t len);
+    void _endStream();
+    void _sendProgmem(int code, const char* contentType, const uint8_t* data, size_t len);
+    
+    /**
+     * @brief Stream a LittleFS file as the body (WEB_FILE_CHUNK_SIZE at a time)
+     * @return false if the file cannot be opened (nothing sent)
+     */
+    bool _sendFile(int code, const char* contentType, const char* path);
+    void _sendEmpty(int code);
+    
+#ifndef WEB_ASYNC_BACKEND
+    /**
+     * @brief Status line + headers; length < 0 = body of unknown length
+     *        (chunked on HTTP/1.1, close-delimited on HTTP/1.0)
+     */
+    void _writeHead(int code, const char* contentType, long length);
+    
+    /**
+     * @brief Open sockets taken over by event streams
+     */
+    uint8_t _eventStreamCount();
+#else
+    void _queueRequest(AsyncWebServerRequest* request);
+    void _dropRequest(AsyncWebServerRequest* request);
+    void _processPending();
+    void _applyHeaders(AsyncWebServerResponse* response);
+    void _onEventClient(AsyncEventSourceClient* client);
+#endif
+    
+    /**
+     * @brief Push changed fields to open event streams (rate limited)
+     */
+    void _updateEvents();
+    
+    /**
+     * @brief Snapshot values watched by event streams
+     */
+    void _readEventState(EventState& state);
+    
+    /**
+     * @brief Format "data: {...}\n\n" with fields differing from prev
+     * @param prev Previous state, nullptr = full snapshot
+     * @return Event length, 0 if nothing changed
+     */
+    int _formatEvent(char* buf, size_t size, const EventState& state, const EventState* prev);
+    
+    /**
+     * @brief Write event to every stream, closing streams that lag behind
      */
-    void _sendJson(int code, const String& json);
+    void _broadcastEvent(const char* data, size_t len);
+    
+    /**
+     * @brief Read everything /api/state reports (one callback pass)
+     */
+    void _readState(StateSnapshot& snap);
+    
+    /**
+     * @brief Write snapshot fields into the open object
+     * @param live Include ticking values (uptime, heap, RSSI) that are
+     *             not part of the version
+     */
+    void _writeState(JsonWriter& json, const StateSnapshot& snap, bool live);
+    
+    /**
+     * @brief Write one schedule entry object (same keys storage uses)
+     */
+    void _writeScheduleEntry(JsonWriter& json, const ScheduleEntry& entry);
+    
+    /**
+     * @brief Send constant JSON response
+     */
+    void _sendJson(int code, const char* json);
     
     /**
      * @brief Send error response
      */
     void _sendError(int code, const char* message);
+    
+    /**
+     * @brief Update heap low-water marks
+     */
+    void _sampleHeap();
+    
+    /**
+     * @class Response
+     * @brief Response body streamed through the active backend
+     * Usage: Response out(*this, 200); JsonWriter json(out); ...; out.end();
+     */
+    class Response : public BufferedResponse {
+    public:
+        Response(WebServerManager& owner, int code, const char* contentType = "application/json");
+        
+    protected:
+        void _sendWhole(const char* data, size_t len) override;
+        void _beginStream() override;
+        void _sendChunk(const char* data, size_t len) override;
+        void _endStream() override;
+        
+    private:
+        WebServerManager& _owner;
+        int _code;
+        const char* _contentType;
+    };
 };
 
 #endif // WEB_SERVER_H
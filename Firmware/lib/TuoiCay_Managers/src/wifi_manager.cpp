@@ -26,6 +26,7 @@ WiFiManager::WiFiManager()
     , _lastReconnectTime(0)
     , _reconnectDelay(WIFI_RECONNECT_MIN_MS)
     , _reconnectCount(0)
+    , _reconnectTotal(0)
     , _ledPin(-1)
     , _initialized(false)
 {
@@ -111,6 +112,7 @@ void WiFiManager::update() {
                 
                 WiFi.disconnect(true);
                 _reconnectCount++;
+                _reconnectTotal++;
                 _calculateBackoff();
                 _lastReconnectTime = now;
                 _setState(TCWiFiState::DISCONNECTED);
@@ -128,10 +128,15 @@ public:
     void setCallback(WiFiEventCallback callback) { _callback = callback; }
     
     /**
-     * @brief Get reconnect attempt count
+     * @brief Get reconnect attempt count (current backoff, 0 once connected)
      */
     uint8_t getReconnectCount() const { return _reconnectCount; }
     
+    /**
+     * @brief Get reconnect attempts since boot (never reset)
+     */
+    uint32_t getReconnectTotal() const { return _reconnectTotal; }
+    
     /**
      * @brief Set LED pin for status indicator
      * @param pin GPIO pin (active LOW)
@@ -148,6 +153,7 @@ private:
     unsigned long _lastReconnectTime;   // Last reconnect attempt
     unsigned long _reconnectDelay;      // Current backoff delay
     uint8_t _reconnectCount;            // Number of reconnect attempts
+    uint32_t _reconnectTotal;           // Reconnect attempts since boot
     
     int8_t _ledPin;                     // Status LED pin (-1 = disabled)
     bool _initialized;
@@ -0,0 +1,125 @@
+/**
+ * @file buffered_response.h
+ * @brief Fixed-buffer Print that streams an HTTP response body
+ *
+ * LOGIC:
+ * - Body is written through Print into WEB_RESPONSE_BUFFER_SIZE bytes
+ *   held inside the object (the object lives on the handler's stack)
+ * - Whole body fits the buffer: sent once with Content-Length
+ * - Buffer fills up: response switches to streaming (chunked transfer
+ *   encoding), buffer is flushed as one chunk each time it fills
+ * - No heap allocation for the body in either case
+ * - Subclass provides the transport (which web server, which request)
+ *
+ * RULES: #HTTP(24) #PERF(15)
+ */
+
+#ifndef BUFFERED_RESPONSE_H
+#define BUFFERED_RESPONSE_H
+
+#include <Arduino.h>
+#include <config.h>
+
+//=============================================================================
+// BUFFERED RESPONSE CLASS
+//=============================================================================
+
+/**
+ * @class BufferedResponse
+ * @brief Print sink: single send when small, chunked stream when large
+ */
+class BufferedResponse : public Print {
+public:
+    virtual ~BufferedResponse() {}
+
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        size_t remaining = len;
+        while (remaining > 0) {
+            if (_len == WEB_RESPONSE_BUFFER_SIZE) {
+                _flush();
+            }
+            size_t n = WEB_RESPONSE_BUFFER_SIZE - _len;
+            if (n > remaining) {
+                n = remaining;
+            }
+            memcpy(_buf + _len, data, n);
+            _len += n;
+            data += n;
+            remaining -= n;
+        }
+        _total += len;
+        return len;
+    }
+
+    /**
+     * @brief Complete the response (must be called exactly once)
+     */
+    void end() {
+        if (_ended) {
+            return;
+        }
+        _ended = true;
+
+        if (!_streaming) {
+            _buf[_len] = '\0';
+            _sendWhole(_buf, _len);
+            return;
+        }
+
+        if (_len > 0) {
+            _sendChunk(_buf, _len);
+            _len = 0;
+        }
+        _endStream();
+    }
+
+    /**
+     * @brief Total body bytes written so far
+     */
+    size_t length() const { return _total; }
+
+protected:
+    BufferedResponse() : _len(0), _total(0), _streaming(false), _ended(false) {}
+
+    /**
+     * @brief Send complete body (NUL-terminated) with Content-Length
+     */
+    virtual void _sendWhole(const char* data, size_t len) = 0;
+
+    /**
+     * @brief Send status line and headers of a streamed response
+     */
+    virtual void _beginStream() = 0;
+
+    /**
+     * @brief Send one chunk of a streamed body
+     */
+    virtual void _sendChunk(const char* data, size_t len) = 0;
+
+    /**
+     * @brief Terminate a streamed body
+     */
+    virtual void _endStream() = 0;
+
+private:
+    char _buf[WEB_RESPONSE_BUFFER_SIZE + 1];   // +1 for NUL in _sendWhole
+    size_t _len;
+    size_t _total;
+    bool _streaming;
+    bool _ended;
+
+    void _flush() {
+        if (!_streaming) {
+            _streaming = true;
+            _beginStream();
+        }
+        _sendChunk(_buf, _len);
+        _len = 0;
+    }
+};
+
+#endif // BUFFERED_RESPONSE_H
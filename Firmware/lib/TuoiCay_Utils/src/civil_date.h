@@ -0,0 +1,34 @@
+/**
+ * @file civil_date.h
+ * @brief Days since 1970-01-01 from a calendar date
+ *
+ * LOGIC:
+ * - Proleptic Gregorian, Howard Hinnant's days_from_civil: years are
+ *   shifted to start in March so the leap day is the last of the year,
+ *   then counted in 400-year eras (146097 days)
+ * - Integer only, valid for any int32 year; no timegm() / TZ involved
+ * - Shared by http_date.h (Date header), sun_calc.h (Julian day) and
+ *   TimeManager::getUtcOffset() (newlib has no tm_gmtoff)
+ * - No Arduino dependency
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef CIVIL_DATE_H
+#define CIVIL_DATE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Days since 1970-01-01 (month 1-12, day 1-31)
+ */
+inline int32_t daysFromCivil(int32_t y, int32_t m, int32_t d) {
+    y -= m <= 2 ? 1 : 0;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    int32_t yoe = y - era * 400;
+    int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+#endif // CIVIL_DATE_H
@@ -0,0 +1,146 @@
+/**
+ * @file command_cache.h
+ * @brief Remembers results of recently executed commands by correlation ID
+ *
+ * LOGIC:
+ * - Backend retries a command (same "id") when it misses the ack
+ * - A retried ID is answered from the cache instead of being executed
+ *   again (e.g. "toggle" must not flip the pump twice)
+ * - Fixed ring of CMD_CACHE_SIZE entries, oldest overwritten first
+ * - SeqCache does the same per source for "seq": a replayed seq is acked
+ *   with the result it had, not re-applied
+ *
+ * RULES: #MQTT(9) #PROTOCOL(14)
+ */
+
+#ifndef COMMAND_CACHE_H
+#define COMMAND_CACHE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <config.h>
+
+//=============================================================================
+// COMMAND CACHE CLASS
+//=============================================================================
+
+/**
+ * @class CommandCache
+ * @brief Ring buffer of (id, result code)
+ */
+class CommandCache {
+public:
+    CommandCache() : _head(0) {
+        for (uint8_t i = 0; i < CMD_CACHE_SIZE; i++) {
+            _entries[i].id[0] = '\0';
+            _entries[i].code = 0;
+        }
+    }
+
+    /**
+     * @brief Look up a command ID
+     * @param id Correlation ID
+     * @param code Output: result of the earlier execution
+     * @return true if the ID was already handled
+     */
+    bool lookup(const char* id, int* code) const {
+        for (uint8_t i = 0; i < CMD_CACHE_SIZE; i++) {
+            if (_entries[i].id[0] != '\0' && strcmp(_entries[i].id, id) == 0) {
+                *code = _entries[i].code;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Store result of an executed command
+     */
+    void remember(const char* id, int code) {
+        Entry& e = _entries[_head];
+        strncpy(e.id, id, CMD_ID_MAX_LEN);
+        e.id[CMD_ID_MAX_LEN] = '\0';
+        e.code = code;
+        _head = (_head + 1) % CMD_CACHE_SIZE;
+    }
+
+private:
+    struct Entry {
+        char id[CMD_ID_MAX_LEN + 1];
+        int code;
+    };
+
+    Entry _entries[CMD_CACHE_SIZE];
+    uint8_t _head;
+};
+
+//=============================================================================
+// SEQUENCE CACHE CLASS
+//=============================================================================
+
+/**
+ * @class SeqCache
+ * @brief Highest applied "seq" of one source plus a ring of (seq, result code)
+ */
+class SeqCache {
+public:
+    SeqCache() { reset(); }
+
+    /**
+     * @brief Forget everything (e.g. new group, new sequence)
+     */
+    void reset() {
+        _last = 0;
+        _head = 0;
+        for (uint8_t i = 0; i < CMD_CACHE_SIZE; i++) {
+            _entries[i].seq = 0;
+            _entries[i].code = 0;
+        }
+    }
+
+    /**
+     * @brief Was this seq (or a later one) already applied?
+     */
+    bool isReplay(uint32_t seq) const { return seq <= _last; }
+
+    /**
+     * @brief Look up the result of an applied seq
+     * @param code Output: result of the earlier execution
+     * @return false if the seq is unknown or too old to be remembered
+     */
+    bool lookup(uint32_t seq, int* code) const {
+        if (seq == 0) return false;
+        for (uint8_t i = 0; i < CMD_CACHE_SIZE; i++) {
+            if (_entries[i].seq == seq) {
+                *code = _entries[i].code;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Store result of an applied seq; it becomes the highest seen
+     */
+    void remember(uint32_t seq, int code) {
+        Entry& e = _entries[_head];
+        e.seq = seq;
+        e.code = code;
+        _head = (_head + 1) % CMD_CACHE_SIZE;
+        if (seq > _last) _last = seq;
+    }
+
+    uint32_t last() const { return _last; }
+
+private:
+    struct Entry {
+        uint32_t seq;
+        int code;
+    };
+
+    Entry _entries[CMD_CACHE_SIZE];
+    uint32_t _last;
+    uint8_t _head;
+};
+
+#endif // COMMAND_CACHE_H
@@ -0,0 +1,117 @@
+/**
+ * @file http_date.h
+ * @brief HTTP Date header (RFC 7231 IMF-fixdate) -> Unix time
+ *
+ * LOGIC:
+ * - Format: "Sun, 06 Nov 1994 08:49:37 GMT" (always GMT, fixed width);
+ *   the obsolete RFC 850 / asctime forms are not accepted: every server
+ *   since HTTP/1.1 sends IMF-fixdate
+ * - Day name is skipped (not cross-checked), month by its 3-letter name,
+ *   fields range-checked; the date itself is not checked against the
+ *   month length (31 Feb = 3 Mar, like mktime)
+ * - Days from civil (civil_date.h), no timegm() / TZ involved
+ * - httpHostValid(): "name[:port]" as configured for the probe (letters,
+ *   digits, '.', '-'; port 1-65535), checked before it is stored
+ * - No Arduino dependency
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef HTTP_DATE_H
+#define HTTP_DATE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <civil_date.h>
+
+namespace http_date {
+
+/**
+ * @brief Exactly n digits
+ */
+inline bool digits(const char*& p, uint8_t n, int32_t& value) {
+    value = 0;
+    for (uint8_t i = 0; i < n; i++, p++) {
+        if (*p < '0' || *p > '9') return false;
+        value = value * 10 + (*p - '0');
+    }
+    return true;
+}
+
+inline bool expect(const char*& p, char c) {
+    if (*p != c) return false;
+    p++;
+    return true;
+}
+
+} // namespace http_date
+
+/**
+ * @brief Parse an IMF-fixdate (leading spaces allowed)
+ * @param epoch Seconds since 1970 (UTC)
+ * @return false if the string is not an IMF-fixdate
+ */
+inline bool httpDateParse(const char* s, int64_t& epoch) {
+    using namespace http_date;
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    const char* p = s;
+    while (*p == ' ') p++;
+
+    // "Sun, "
+    for (uint8_t i = 0; i < 3; i++, p++) {
+        if (!((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))) return false;
+    }
+    if (!expect(p, ',') || !expect(p, ' ')) return false;
+
+    int32_t day, month = 0, year, hour, minute, second;
+    if (!digits(p, 2, day) || !expect(p, ' ')) return false;
+    for (uint8_t i = 0; i < 12; i++) {
+        if (strncmp(p, &MONTHS[i * 3], 3) == 0) {
+            month = i + 1;
+            break;
+        }
+    }
+    if (month == 0) return false;
+    p += 3;
+    if (!expect(p, ' ') || !digits(p, 4, year) || !expect(p, ' ')) return false;
+    if (!digits(p, 2, hour) || !expect(p, ':') || !digits(p, 2, minute) || !expect(p, ':') ||
+        !digits(p, 2, second) || strncmp(p, " GMT", 4) != 0) {
+        return false;
+    }
+    if (day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+    epoch = (int64_t)daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+/**
+ * @brief Check a "name[:port]" host string ("" = none, valid)
+ * @param port Port given, else 80
+ * @param nameLen Length of the name part
+ */
+inline bool httpHostValid(const char* host, size_t maxLen, uint16_t& port, size_t& nameLen) {
+    if (!host || strlen(host) > maxLen) return false;
+
+    const char* p = host;
+    while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') || (*p >= '0' && *p <= '9') ||
+           *p == '.' || *p == '-') {
+        p++;
+    }
+    nameLen = p - host;
+    port = 80;
+    if (*p == '\0') return true;
+    if (*p++ != ':' || nameLen == 0) return false;
+
+    int32_t value = 0;
+    uint8_t n = 0;
+    while (*p >= '0' && *p <= '9' && n < 5) {
+        value = value * 10 + (*p++ - '0');
+        n++;
+    }
+    if (*p != '\0' || n == 0 || value < 1 || value > 65535) return false;
+    port = (uint16_t)value;
+    return true;
+}
+
+#endif // HTTP_DATE_H
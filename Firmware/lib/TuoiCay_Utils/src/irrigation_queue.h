@@ -0,0 +1,278 @@
+/**
+ * @file irrigation_queue.h
+ * @brief Watering jobs from all sources, run one at a time on the pump
+ *
+ * LOGIC:
+ * - Every run (manual, schedule, auto) is a job; only the active job
+ *   drives the pump, the others wait in line. There is one pump and it
+ *   can feed one run at a time, so runs are serialized and never overlap
+ * - Priority manual > schedule > auto. A higher job preempts the active
+ *   one. A preempted schedule run goes back to the front of its class
+ *   with the time it still had. A preempted auto run is dropped: auto
+ *   decides again from the soil once the pump is free
+ * - Equal or lower priority waits, FIFO within a priority. Auto never
+ *   waits (BUSY while anything runs)
+ * - One job per source: a second manual or auto request is a duplicate,
+ *   and so is a schedule entry that is already queued or running
+ * - A job that waited IRRIGATION_WAIT_MAX_SEC is dropped instead of
+ *   started, so a morning slot is not watered at noon
+ * - Bookkeeping only, on millis() values handed in: the owner
+ *   (IrrigationManager) switches the pump based on what the calls return
+ * - No Arduino dependency
+ *
+ * RULES: #ACTUATOR(15)
+ */
+
+#ifndef IRRIGATION_QUEUE_H
+#define IRRIGATION_QUEUE_H
+
+#include <stdint.h>
+#include <config.h>
+
+#define IRRIGATION_NO_ENTRY     0xFF    // Job not from a schedule entry
+
+/**
+ * @brief Who asked for water (same values as PumpReason)
+ */
+enum class IrrigationSource : uint8_t {
+    MANUAL = 1,     // Web / MQTT
+    AUTO = 2,       // Moisture threshold
+    SCHEDULE = 3
+};
+
+inline uint8_t irrigationPriority(IrrigationSource source) {
+    return source == IrrigationSource::MANUAL ? 3 : source == IrrigationSource::SCHEDULE ? 2 : 1;
+}
+
+inline const char* irrigationSourceName(IrrigationSource source) {
+    static const char* const NAMES[] = { "none", "manual", "auto", "schedule" };
+    return NAMES[(uint8_t)source < 4 ? (uint8_t)source : 0];
+}
+
+struct IrrigationJob {
+    uint16_t id;                // Increments per accepted job
+    IrrigationSource source;
+    uint8_t entry;              // Schedule entry, IRRIGATION_NO_ENTRY otherwise
+    uint16_t durationSec;       // 0 = until stopped (auto: until wet)
+    uint16_t doneSec;           // Run before being preempted
+    uint32_t sinceMs;           // Queued (waiting) / started (active)
+
+    /**
+     * @brief Seconds left to run when (re)started, 0 = until stopped
+     */
+    uint16_t runSec() const { return durationSec ? durationSec - doneSec : 0; }
+};
+
+/**
+ * @brief What submit() did
+ */
+enum class IrrigationVerdict : uint8_t {
+    STARTED = 0,    // Active now: switch the pump on
+    PREEMPTED,      // Active now, a lower job was replaced: switch over
+    QUEUED,         // Waits for the active job
+    DUPLICATE,      // Source / entry already has a job
+    BUSY,           // Auto while another job runs
+    FULL,           // IRRIGATION_QUEUE_MAX jobs waiting
+    REFUSED         // Pump would not start (owner: auto in cooldown)
+};
+
+inline const char* irrigationVerdictName(IrrigationVerdict verdict) {
+    static const char* const NAMES[] = {
+        "started", "preempted", "queued", "duplicate", "busy", "full", "refused"
+    };
+    return NAMES[(uint8_t)verdict];
+}
+
+//=============================================================================
+// IRRIGATION QUEUE CLASS
+//=============================================================================
+
+/**
+ * @class IrrigationQueue
+ * @brief Active job plus a priority-ordered waiting line
+ */
+class IrrigationQueue {
+public:
+    IrrigationQueue() : _active(), _hasActive(false), _count(0), _nextId(1), _started(0),
+                        _preempted(0), _expired(0) {}
+
+    /**
+     * @brief New job
+     * @param entry Schedule entry (IRRIGATION_NO_ENTRY for manual / auto)
+     */
+    IrrigationVerdict submit(IrrigationSource source, uint16_t durationSec, uint8_t entry,
+                             uint32_t nowMs) {
+        if (has(source, entry)) return IrrigationVerdict::DUPLICATE;
+
+        IrrigationJob job = { _nextId, source, entry, durationSec, 0, nowMs };
+        if (!_hasActive) {
+            _nextId++;
+            _activate(job, nowMs);
+            return IrrigationVerdict::STARTED;
+        }
+
+        if (irrigationPriority(source) > irrigationPriority(_active.source)) {
+            // The preempted schedule run resumes later with what it had left;
+            // with no room left it is dropped like an expired one
+            IrrigationJob old = _active;
+            if (old.source == IrrigationSource::SCHEDULE) {
+                uint32_t ran = old.doneSec + elapsedSec(nowMs);
+                old.doneSec = (uint16_t)(ran < old.durationSec ? ran : old.durationSec);
+                old.sinceMs = nowMs;
+                if (old.runSec() > 0 || old.durationSec == 0) {
+                    if (!_insert(old, true)) _expired++;
+                }
+            }
+            _preempted++;
+            _nextId++;
+            _activate(job, nowMs);
+            return IrrigationVerdict::PREEMPTED;
+        }
+
+        if (source == IrrigationSource::AUTO) return IrrigationVerdict::BUSY;
+        if (!_insert(job, false)) return IrrigationVerdict::FULL;
+        _nextId++;
+        return IrrigationVerdict::QUEUED;
+    }
+
+    /**
+     * @brief End the active job (if any) and make the next one active
+     * @param expired Waiting jobs dropped for waiting too long
+     * @return true if a job is active now (owner: switch the pump on)
+     */
+    bool next(uint32_t nowMs, uint8_t& expired) {
+        _hasActive = false;
+        expired = 0;
+        while (_count > 0) {
+            IrrigationJob job = _waiting[0];
+            _removeAt(0);
+            if (nowMs - job.sinceMs >= IRRIGATION_WAIT_MAX_SEC * 1000UL) {
+                expired++;
+                _expired++;
+                continue;
+            }
+            _activate(job, nowMs);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drop every job of a source
+     * @return true if the active job was one (owner: stop the pump, next())
+     */
+    bool cancel(IrrigationSource source) {
+        for (uint8_t i = _count; i-- > 0; ) {
+            if (_waiting[i].source == source) _removeAt(i);
+        }
+        if (_hasActive && _active.source == source) {
+            _hasActive = false;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drop all jobs
+     * @return true if one was active
+     */
+    bool clear() {
+        bool had = _hasActive;
+        _hasActive = false;
+        _count = 0;
+        return had;
+    }
+
+    /**
+     * @brief Source has a job, active or waiting; for schedules only that
+     *        entry counts unless entry is IRRIGATION_NO_ENTRY
+     */
+    bool has(IrrigationSource source, uint8_t entry = IRRIGATION_NO_ENTRY) const {
+        if (_hasActive && _same(_active, source, entry)) return true;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_same(_waiting[i], source, entry)) return true;
+        }
+        return false;
+    }
+
+    bool hasActive() const { return _hasActive; }
+    const IrrigationJob& active() const { return _active; }
+
+    /**
+     * @brief Active job ran its time (never for duration 0)
+     */
+    bool due(uint32_t nowMs) const {
+        return _hasActive && _active.durationSec > 0 && elapsedSec(nowMs) >= _active.runSec();
+    }
+
+    /**
+     * @brief Seconds the active job has run since it was (re)started
+     */
+    uint32_t elapsedSec(uint32_t nowMs) const {
+        return _hasActive ? (nowMs - _active.sinceMs) / 1000 : 0;
+    }
+
+    /**
+     * @brief Waiting jobs, in the order they will start
+     */
+    uint8_t waitingCount() const { return _count; }
+    const IrrigationJob& waiting(uint8_t i) const { return _waiting[i]; }
+
+    uint32_t getStarted() const { return _started; }
+    uint32_t getPreempted() const { return _preempted; }
+    uint32_t getExpired() const { return _expired; }
+
+private:
+    IrrigationJob _active;
+    bool _hasActive;
+    IrrigationJob _waiting[IRRIGATION_QUEUE_MAX];
+    uint8_t _count;
+    uint16_t _nextId;
+    uint32_t _started;
+    uint32_t _preempted;
+    uint32_t _expired;
+
+    static bool _same(const IrrigationJob& job, IrrigationSource source, uint8_t entry) {
+        return job.source == source &&
+               (source != IrrigationSource::SCHEDULE || entry == IRRIGATION_NO_ENTRY ||
+                job.entry == entry);
+    }
+
+    void _activate(IrrigationJob job, uint32_t nowMs) {
+        job.sinceMs = nowMs;
+        _active = job;
+        _hasActive = true;
+        _started++;
+    }
+
+    /**
+     * @brief Insert by priority: behind its class (FIFO), or ahead of it
+     *        (front = a preempted job resuming)
+     */
+    bool _insert(const IrrigationJob& job, bool front) {
+        if (_count >= IRRIGATION_QUEUE_MAX) return false;
+
+        uint8_t priority = irrigationPriority(job.source);
+        uint8_t pos = 0;
+        while (pos < _count) {
+            uint8_t other = irrigationPriority(_waiting[pos].source);
+            if (front ? other <= priority : other < priority) break;
+            pos++;
+        }
+        for (uint8_t i = _count; i > pos; i--) {
+            _waiting[i] = _waiting[i - 1];
+        }
+        _waiting[pos] = job;
+        _count++;
+        return true;
+    }
+
+    void _removeAt(uint8_t pos) {
+        for (uint8_t i = pos; i + 1 < _count; i++) {
+            _waiting[i] = _waiting[i + 1];
+        }
+        _count--;
+    }
+};
+
+#endif // IRRIGATION_QUEUE_H
@@ -0,0 +1,131 @@
+/**
+ * @file json_arena.h
+ * @brief Fixed-buffer allocator for ArduinoJson documents
+ *
+ * LOGIC:
+ * - JsonDocument(&arena) takes all its memory (variant pools, strings)
+ *   from SIZE bytes owned by the arena instead of the heap
+ * - Bump allocation; only the most recent block can be freed or grown in
+ *   place, anything else is reclaimed by reset()
+ * - Owner calls doc.clear() then reset() before each parse, so one
+ *   document is reused for every request without heap churn
+ * - Exhausted arena returns nullptr: deserializeJson reports NoMemory
+ * - peak() tracks the high-water mark for sizing SIZE
+ * - No Arduino dependency (also built by tools/route_bench.cpp on the host)
+ *
+ * RULES: #JSON(23) #PERF(15)
+ */
+
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+//=============================================================================
+// JSON ARENA CLASS
+//=============================================================================
+
+/**
+ * @class JsonArena
+ * @brief ArduinoJson Allocator over a fixed buffer
+ */
+template <size_t SIZE>
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    JsonArena() : _top(0), _last(NO_BLOCK), _peak(0) {}
+
+    void* allocate(size_t size) override {
+        size_t need = HEADER + _align(size);
+        if (need > SIZE - _top) {
+            return nullptr;
+        }
+
+        _last = _top;
+        _setSize(_last, size);
+        _top += need;
+        if (_top > _peak) {
+            _peak = _top;
+        }
+        return _buf + _last + HEADER;
+    }
+
+    void deallocate(void* ptr) override {
+        // Freeing the newest block (e.g. a discarded string) gives it back
+        if (ptr && _isLast(ptr)) {
+            _top = _last;
+            _last = NO_BLOCK;
+        }
+    }
+
+    void* reallocate(void* ptr, size_t newSize) override {
+        if (!ptr) {
+            return allocate(newSize);
+        }
+
+        // Newest block grows or shrinks in place
+        if (_isLast(ptr)) {
+            size_t need = HEADER + _align(newSize);
+            if (need > SIZE - _last) {
+                return nullptr;
+            }
+            _setSize(_last, newSize);
+            _top = _last + need;
+            if (_top > _peak) {
+                _peak = _top;
+            }
+            return ptr;
+        }
+
+        size_t oldSize = _getSize((uint8_t*)ptr - _buf - HEADER);
+        void* moved = allocate(newSize);
+        if (moved) {
+            memcpy(moved, ptr, oldSize < newSize ? oldSize : newSize);
+        }
+        return moved;
+    }
+
+    /**
+     * @brief Release everything (document must be cleared first)
+     */
+    void reset() {
+        _top = 0;
+        _last = NO_BLOCK;
+    }
+
+    size_t used() const { return _top; }
+    size_t peak() const { return _peak; }
+    void resetPeak() { _peak = _top; }
+
+private:
+    static const size_t HEADER = 8;         // Block size + padding (8-byte aligned data)
+    static const size_t NO_BLOCK = SIZE;
+
+    alignas(8) uint8_t _buf[SIZE];
+    size_t _top;
+    size_t _last;       // Offset of the newest block header
+    size_t _peak;
+
+    static size_t _align(size_t size) {
+        return (size + 7) & ~(size_t)7;
+    }
+
+    bool _isLast(void* ptr) const {
+        return _last != NO_BLOCK && ptr == _buf + _last + HEADER;
+    }
+
+    void _setSize(size_t offset, size_t size) {
+        uint32_t value = (uint32_t)size;
+        memcpy(_buf + offset, &value, sizeof(value));
+    }
+
+    size_t _getSize(size_t offset) const {
+        uint32_t value;
+        memcpy(&value, _buf + offset, sizeof(value));
+        return value;
+    }
+};
+
+#endif // JSON_ARENA_H
@@ -0,0 +1,164 @@
+/**
+ * @file json_writer.h
+ * @brief Streaming JSON serializer writing straight to a Print
+ *
+ * LOGIC:
+ * - Emits JSON tokens as they are added, no document and no String
+ * - Tracks nesting to insert commas (max JSON_WRITER_MAX_DEPTH levels)
+ * - Strings are escaped on the fly (quote, backslash, control chars)
+ * - Object members: add("key", value); array items: add(nullptr, value)
+ * - Typical sink: BufferedResponse (HTTP body), Serial, WiFiClient
+ *
+ * RULES: #JSON(23) #PERF(15)
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+#define JSON_WRITER_MAX_DEPTH   16
+
+//=============================================================================
+// JSON WRITER CLASS
+//=============================================================================
+
+/**
+ * @class JsonWriter
+ * @brief Forward-only JSON output
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(Print& out) : _out(out), _depth(0), _hasItems(0) {}
+
+    //-------------------------------------------------------------------------
+    // Containers (key = nullptr at top level or inside arrays)
+    //-------------------------------------------------------------------------
+
+    void beginObject(const char* key = nullptr) { _open(key, '{'); }
+    void endObject() { _close('}'); }
+    void beginArray(const char* key = nullptr) { _open(key, '['); }
+    void endArray() { _close(']'); }
+
+    //-------------------------------------------------------------------------
+    // Values
+    //-------------------------------------------------------------------------
+
+    /**
+     * @brief String value (escaped); nullptr writes null
+     */
+    void add(const char* key, const char* value) {
+        _key(key);
+        if (value) {
+            _string(value);
+        } else {
+            _out.print("null");
+        }
+    }
+
+    void add(const char* key, bool value) {
+        _key(key);
+        _out.print(value ? "true" : "false");
+    }
+
+    void add(const char* key, int value) { add(key, (long)value); }
+    void add(const char* key, unsigned int value) { add(key, (unsigned long)value); }
+
+    void add(const char* key, long value) {
+        _key(key);
+        _out.print(value);
+    }
+
+    void add(const char* key, unsigned long value) {
+        _key(key);
+        _out.print(value);
+    }
+
+    /**
+     * @brief Number with fixed decimals
+     */
+    void add(const char* key, float value, uint8_t decimals) {
+        _key(key);
+        if (isnan(value) || isinf(value)) {
+            _out.print("null");         // Not representable in JSON
+        } else {
+            _out.print((double)value, decimals);
+        }
+    }
+
+    /**
+     * @brief Pre-serialized JSON (trusted, written as-is)
+     */
+    void addRaw(const char* key, const char* json) {
+        _key(key);
+        _out.print(json);
+    }
+
+private:
+    Print& _out;
+    uint8_t _depth;
+    uint16_t _hasItems;     // Bit n: container at depth n already has an item
+
+    void _key(const char* key) {
+        if (_depth > 0) {
+            uint16_t bit = 1u << (_depth - 1);
+            if (_hasItems & bit) {
+                _out.write(',');
+            }
+            _hasItems |= bit;
+        }
+        if (key) {
+            _string(key);
+            _out.write(':');
+        }
+    }
+
+    void _open(const char* key, char bracket) {
+        _key(key);
+        _out.write(bracket);
+        if (_depth < JSON_WRITER_MAX_DEPTH) {
+            _depth++;
+            _hasItems &= ~(1u << (_depth - 1));
+        }
+    }
+
+    void _close(char bracket) {
+        if (_depth > 0) {
+            _depth--;
+        }
+        _out.write(bracket);
+    }
+
+    void _string(const char* s) {
+        static const char HEX_DIGITS[] = "0123456789abcdef";
+
+        _out.write('"');
+        const char* run = s;        // Start of bytes not needing escape
+        for (; *s; s++) {
+            uint8_t c = (uint8_t)*s;
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            _out.write((const uint8_t*)run, s - run);
+            run = s + 1;
+
+            switch (c) {
+                case '"':  _out.print("\\\""); break;
+                case '\\': _out.print("\\\\"); break;
+                case '\n': _out.print("\\n"); break;
+                case '\r': _out.print("\\r"); break;
+                case '\t': _out.print("\\t"); break;
+                default: {
+                    char esc[7] = { '\\', 'u', '0', '0',
+                                    HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F], '\0' };
+                    _out.print(esc);
+                    break;
+                }
+            }
+        }
+        _out.write((const uint8_t*)run, s - run);
+        _out.write('"');
+    }
+};
+
+#endif // JSON_WRITER_H
@@ -123,6 +123,8 @@ inline void _log_printf(const char* color, const char* level, const char* module
 #define MOD_TIME        "TIME"
 #define MOD_OTA         "OTA"
 #define MOD_SCHED       "SCHED"
+#define MOD_BUDGET      "BUDGET"
+#define MOD_JOBS        "JOBS"
 
 //=============================================================================
 // LOGGER INITIALIZATION
@@ -0,0 +1,183 @@
+/**
+ * @file loop_monitor.h
+ * @brief Main loop latency monitor
+ *
+ * LOGIC:
+ * - Measure time of each loop() iteration (excluding the final delay)
+ * - Track worst iteration and count iterations above LOOP_STALL_WARN_MS
+ * - Log a summary every LOOP_STATS_INTERVAL_MS, then start a new window
+ * - Separately keep peak/stalls/iterations since resetPeak(), so a load
+ *   test can measure exactly its own run (/api/perf)
+ * - Duration histogram since boot (fixed buckets, never reset) for
+ *   /metrics; counters only grow, as Prometheus expects
+ * - Any blocking call (network connect, flash write...) shows up as
+ *   a stall with its duration in the log; tools/mqtt_stall_test.py reads
+ *   the peak while the device reconnects to a slow or missing broker
+ *
+ * RULES: #SAFETY(2)
+ */
+
+#ifndef LOOP_MONITOR_H
+#define LOOP_MONITOR_H
+
+#include <Arduino.h>
+#include <config.h>
+#include "logger.h"
+
+#define LOOP_HIST_BUCKETS       8       // Finite buckets (+1 overflow bucket)
+
+//=============================================================================
+// LOOP MONITOR CLASS
+//=============================================================================
+
+/**
+ * @class LoopMonitor
+ * @brief Tracks worst-case loop() duration and stalls
+ */
+class LoopMonitor {
+public:
+    LoopMonitor()
+        : _startUs(0)
+        , _maxUs(0)
+        , _totalUs(0)
+        , _iterations(0)
+        , _stalls(0)
+        , _lastReport(0)
+        , _lastMaxUs(0)
+        , _lastStalls(0)
+        , _peakUs(0)
+        , _peakStalls(0)
+        , _peakIterations(0)
+        , _histSumUs(0) {
+        for (uint8_t i = 0; i <= LOOP_HIST_BUCKETS; i++) {
+            _hist[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Mark start of loop() iteration
+     */
+    void begin() { _startUs = micros(); }
+
+    /**
+     * @brief Mark end of loop() iteration (before delay/yield)
+     */
+    void end() {
+        uint32_t elapsed = micros() - _startUs;
+
+        _iterations++;
+        _peakIterations++;
+        _totalUs += elapsed;
+        if (elapsed > _maxUs) {
+            _maxUs = elapsed;
+        }
+        if (elapsed > _peakUs) {
+            _peakUs = elapsed;
+        }
+        uint8_t bucket = 0;
+        while (bucket < LOOP_HIST_BUCKETS && elapsed > HIST_BOUNDS_US[bucket]) {
+            bucket++;
+        }
+        _hist[bucket]++;
+        _histSumUs += elapsed;
+
+        if (elapsed > LOOP_STALL_WARN_MS * 1000UL) {
+            _stalls++;
+            _peakStalls++;
+            LOG_WRN(MOD_SYSTEM, "loop", "Stall: %lums", (unsigned long)(elapsed / 1000));
+        }
+
+        unsigned long now = millis();
+        if (now - _lastReport >= LOOP_STATS_INTERVAL_MS) {
+            _report();
+            _lastReport = now;
+        }
+    }
+
+    /**
+     * @brief Worst iteration in last completed window (microseconds)
+     */
+    uint32_t getMaxUs() const { return _lastMaxUs; }
+
+    /**
+     * @brief Stalls in last completed window
+     */
+    uint32_t getStallCount() const { return _lastStalls; }
+
+    /**
+     * @brief Worst iteration since resetPeak() (microseconds)
+     */
+    uint32_t getPeakUs() const { return _peakUs; }
+
+    /**
+     * @brief Stalls since resetPeak()
+     */
+    uint32_t getPeakStalls() const { return _peakStalls; }
+
+    /**
+     * @brief Iterations since resetPeak()
+     */
+    uint32_t getPeakIterations() const { return _peakIterations; }
+
+    /**
+     * @brief Histogram upper bounds (microseconds, LOOP_HIST_BUCKETS entries)
+     */
+    static const uint32_t* getHistogramBounds() { return HIST_BOUNDS_US; }
+
+    /**
+     * @brief Iterations per bucket since boot (LOOP_HIST_BUCKETS + 1 entries)
+     */
+    const uint64_t* getHistogram() const { return _hist; }
+
+    /**
+     * @brief Total loop time since boot (microseconds)
+     */
+    uint64_t getHistogramSumUs() const { return _histSumUs; }
+
+    /**
+     * @brief Start a new peak measurement
+     */
+    void resetPeak() {
+        _peakUs = 0;
+        _peakStalls = 0;
+        _peakIterations = 0;
+    }
+
+private:
+    static constexpr uint32_t HIST_BOUNDS_US[LOOP_HIST_BUCKETS] = {
+        500, 1000, 2000, 5000, 10000, 20000, 50000, 200000
+    };
+
+    uint32_t _startUs;
+    uint32_t _maxUs;
+    uint64_t _totalUs;
+    uint32_t _iterations;
+    uint32_t _stalls;
+    unsigned long _lastReport;
+    uint32_t _lastMaxUs;
+    uint32_t _lastStalls;
+    uint32_t _peakUs;
+    uint32_t _peakStalls;
+    uint32_t _peakIterations;
+    uint64_t _hist[LOOP_HIST_BUCKETS + 1];
+    uint64_t _histSumUs;
+
+    void _report() {
+        if (_iterations > 0) {
+            LOG_INF(MOD_SYSTEM, "loop", "max=%luus avg=%luus stalls=%lu (n=%lu)",
+                    (unsigned long)_maxUs,
+                    (unsigned long)(_totalUs / _iterations),
+                    (unsigned long)_stalls,
+                    (unsigned long)_iterations);
+        }
+
+        _lastMaxUs = _maxUs;
+        _lastStalls = _stalls;
+        _maxUs = 0;
+        _totalUs = 0;
+        _iterations = 0;
+        _stalls = 0;
+    }
+};
+
+#endif // LOOP_MONITOR_H
@@ -0,0 +1,188 @@
+/**
+ * @file metrics_writer.h
+ * @brief Streaming OpenMetrics text serializer writing straight to a Print
+ *
+ * LOGIC:
+ * - Same idea as JsonWriter: lines are emitted as samples are added, no
+ *   buffer, no String, no heap
+ * - family() writes the # TYPE / # UNIT / # HELP block and makes the family
+ *   current; add() writes one sample of it (counters get the _total suffix)
+ * - Values are integers with an optional decimal scale (1000 = value is in
+ *   thousandths), formatted with integer math: no float rounding, no dtostrf
+ * - histogram() takes per-bucket counts and writes the cumulative _bucket
+ *   lines, +Inf, _sum and _count
+ * - Names, label names and label values must be literals that need no
+ *   escaping (the caller owns the metric schema)
+ * - end() writes the mandatory "# EOF" terminator
+ *
+ * RULES: #PERF(15)
+ */
+
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+#include <Arduino.h>
+
+#define METRICS_CONTENT_TYPE    "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+enum class MetricType : uint8_t {
+    GAUGE = 0,
+    COUNTER,
+    HISTOGRAM
+};
+
+//=============================================================================
+// METRICS WRITER CLASS
+//=============================================================================
+
+/**
+ * @class MetricsWriter
+ * @brief Forward-only OpenMetrics exposition
+ */
+class MetricsWriter {
+public:
+    explicit MetricsWriter(Print& out) : _out(out), _name(""), _type(MetricType::GAUGE) {}
+
+    /**
+     * @brief Start a metric family
+     * @param unit Unit suffix the name ends with (nullptr = none)
+     */
+    void family(const char* name, MetricType type, const char* unit, const char* help) {
+        static const char* const TYPE_NAMES[] = { "gauge", "counter", "histogram" };
+
+        _name = name;
+        _type = type;
+        _comment("TYPE", TYPE_NAMES[(uint8_t)type]);
+        if (unit) {
+            _comment("UNIT", unit);
+        }
+        _comment("HELP", help);
+    }
+
+    /**
+     * @brief Sample without labels
+     * @param scale Decimal scale of value (1, 10, 100, ... 1000000)
+     */
+    void add(int64_t value, uint32_t scale = 1) {
+        add(nullptr, nullptr, value, scale);
+    }
+
+    /**
+     * @brief Sample with one label, e.g. add("sensor", "2", 45)
+     */
+    void add(const char* label, const char* labelValue, int64_t value, uint32_t scale = 1) {
+        _sampleName(_type == MetricType::COUNTER ? "_total" : nullptr);
+        if (label) {
+            _out.write('{');
+            _out.print(label);
+            _out.print("=\"");
+            _out.print(labelValue);
+            _out.print("\"}");
+        }
+        _out.write(' ');
+        _number(value, scale, false);
+        _out.write('\n');
+    }
+
+    /**
+     * @brief Histogram samples of the current family
+     * @param bounds Upper bounds (ascending, same scale as sum), count entries
+     * @param counts Observations per bucket, count + 1 entries (last: above
+     *               every bound)
+     */
+    void histogram(const uint32_t* bounds, const uint64_t* counts, uint8_t count,
+                   uint64_t sum, uint32_t scale) {
+        uint64_t total = 0;
+        for (uint8_t i = 0; i <= count; i++) {
+            total += counts[i];
+            _sampleName("_bucket");
+            _out.print("{le=\"");
+            if (i < count) {
+                _number(bounds[i], scale, true);
+            } else {
+                _out.print("+Inf");
+            }
+            _out.print("\"} ");
+            _number(total, 1, false);
+            _out.write('\n');
+        }
+
+        _sampleName("_sum");
+        _out.write(' ');
+        _number(sum, scale, false);
+        _out.write('\n');
+
+        _sampleName("_count");
+        _out.write(' ');
+        _number(total, 1, false);
+        _out.write('\n');
+    }
+
+    /**
+     * @brief Terminate the exposition (must be called exactly once)
+     */
+    void end() { _out.print("# EOF\n"); }
+
+private:
+    Print& _out;
+    const char* _name;
+    MetricType _type;
+
+    void _comment(const char* kind, const char* text) {
+        _out.print("# ");
+        _out.print(kind);
+        _out.write(' ');
+        _out.print(_name);
+        _out.write(' ');
+        _out.print(text);
+        _out.write('\n');
+    }
+
+    void _sampleName(const char* suffix) {
+        _out.print(_name);
+        if (suffix) {
+            _out.print(suffix);
+        }
+    }
+
+    /**
+     * @brief Write value / scale in decimal
+     * @param trim Drop trailing fractional zeros (canonical le="0.005")
+     */
+    void _number(int64_t value, uint32_t scale, bool trim) {
+        char buf[24];
+        char* p = buf + sizeof(buf);
+        *--p = '\0';
+
+        bool negative = value < 0;
+        uint64_t magnitude = negative ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+
+        // Fractional digits, least significant first
+        bool digits = !trim;
+        for (uint32_t s = scale; s > 1; s /= 10) {
+            char digit = '0' + (char)(magnitude % 10);
+            magnitude /= 10;
+            if (digit != '0') {
+                digits = true;
+            }
+            if (digits) {
+                *--p = digit;
+            }
+        }
+        if (digits && scale > 1) {
+            *--p = '.';
+        }
+
+        do {
+            *--p = '0' + (char)(magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+
+        if (negative) {
+            *--p = '-';
+        }
+        _out.print(p);
+    }
+};
+
+#endif // METRICS_WRITER_H
@@ -0,0 +1,108 @@
+/**
+ * @file ntp_packet.h
+ * @brief SNTP v4 request / response (RFC 4330) and the offset / delay math
+ *
+ * LOGIC:
+ * - Request: 48 bytes, LI 0, VN 4, mode 3 (client); our clock at send
+ *   (T1) goes in the transmit timestamp and must come back as the
+ *   server's originate timestamp (stale or spoofed replies are dropped)
+ * - Response: T2 receive and T3 transmit timestamps of the server; with
+ *   T4 = our clock at arrival:
+ *     offset = ((T2 - T1) + (T3 - T4)) / 2
+ *     delay  = (T4 - T1) - (T3 - T2)
+ *   offset error is at most delay / 2 (asymmetric path)
+ * - Rejected: not mode 4 (server), kiss-o'-death / unsynced (stratum 0
+ *   or > 15, LI 3), originate mismatch, negative delay
+ * - Timestamps are microseconds since 1970 (int64); NTP seconds count
+ *   from 1900 and wrap in 2036 (era 1 assumed below 0x80000000)
+ * - No Arduino dependency
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef NTP_PACKET_H
+#define NTP_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define NTP_PACKET_SIZE     48
+#define NTP_PORT            123
+#define NTP_UNIX_OFFSET     2208988800LL    // 1900-01-01 -> 1970-01-01 (s)
+
+/**
+ * @brief One usable answer
+ */
+struct NtpSample {
+    int64_t offsetUs;       // Server clock - our clock
+    int32_t delayUs;        // Round trip minus server processing
+    uint8_t stratum;
+};
+
+namespace ntp_packet {
+
+inline void writeTimestamp(uint8_t* p, int64_t unixUs) {
+    int64_t sec = unixUs / 1000000;
+    int64_t us = unixUs % 1000000;
+    uint32_t ntpSec = (uint32_t)(sec + NTP_UNIX_OFFSET);
+    uint32_t frac = (uint32_t)(((uint64_t)us << 32) / 1000000);
+    for (uint8_t i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(ntpSec >> (24 - 8 * i));
+        p[4 + i] = (uint8_t)(frac >> (24 - 8 * i));
+    }
+}
+
+inline int64_t readTimestamp(const uint8_t* p) {
+    uint32_t ntpSec = 0, frac = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        ntpSec = (ntpSec << 8) | p[i];
+        frac = (frac << 8) | p[4 + i];
+    }
+    int64_t sec = (int64_t)ntpSec - NTP_UNIX_OFFSET;
+    if (ntpSec < 0x80000000UL) {
+        sec += 0x100000000LL;       // Era 1 (after 2036-02-07)
+    }
+    return sec * 1000000 + (int64_t)(((uint64_t)frac * 1000000 + 0x80000000UL) >> 32);
+}
+
+} // namespace ntp_packet
+
+/**
+ * @brief Fill a client request stamped with our clock
+ * @param t1Us Our clock now (us since 1970)
+ */
+inline void ntpBuildRequest(uint8_t* packet, int64_t t1Us) {
+    memset(packet, 0, NTP_PACKET_SIZE);
+    packet[0] = 0x23;                   // LI 0, VN 4, mode 3
+    ntp_packet::writeTimestamp(&packet[40], t1Us);
+}
+
+/**
+ * @brief Check a server reply and compute offset / delay
+ * @param request The packet that was sent (its transmit timestamp)
+ * @param t4Us Our clock when the reply arrived
+ * @return nullptr if usable, else the reason it was dropped
+ */
+inline const char* ntpParseResponse(const uint8_t* packet, size_t length, const uint8_t* request,
+                                    int64_t t4Us, NtpSample& sample) {
+    if (length < NTP_PACKET_SIZE) return "short packet";
+    if ((packet[0] & 0x07) != 4) return "not a server reply";
+    if ((packet[0] >> 6) == 3) return "server not synchronized";
+    if (packet[1] == 0 || packet[1] > 15) return "bad stratum";
+    if (memcmp(&packet[24], &request[40], 8) != 0) return "originate mismatch";
+
+    int64_t t1 = ntp_packet::readTimestamp(&request[40]);
+    int64_t t2 = ntp_packet::readTimestamp(&packet[32]);
+    int64_t t3 = ntp_packet::readTimestamp(&packet[40]);
+
+    int64_t delay = (t4Us - t1) - (t3 - t2);
+    if (delay < 0 || delay > INT32_MAX) return "bad delay";
+
+    sample.offsetUs = ((t2 - t1) + (t3 - t4Us)) / 2;
+    sample.delayUs = (int32_t)delay;
+    sample.stratum = packet[1];
+    return nullptr;
+}
+
+#endif // NTP_PACKET_H
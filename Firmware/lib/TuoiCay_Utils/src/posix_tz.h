@@ -0,0 +1,113 @@
+/**
+ * @file posix_tz.h
+ * @brief Syntax check of POSIX TZ rules before they reach setenv("TZ")
+ *
+ * LOGIC:
+ * - newlib (and glibc) silently fall back to UTC on a malformed TZ, which
+ *   would shift every schedule by hours; strings are checked up front
+ * - Grammar: std offset [dst [offset] [,start[/time],end[/time]]]
+ *   - names: 3+ letters, or <...> quoted (e.g. <+07>)
+ *   - offset: [+-]hh[:mm[:ss]], hh 0-24 (positive = west of UTC)
+ *   - rules: Jn (1-365), n (0-365) or Mm.w.d (month 1-12, week 1-5,
+ *     weekday 0-6); time [+-]hh[:mm[:ss]], hh 0-167
+ * - Examples: "ICT-7", "<+07>-7", "CET-1CEST,M3.5.0,M10.5.0/3",
+ *   "AEST-10AEDT,M10.1.0,M4.1.0/3", "EST5EDT,M3.2.0/2,M11.1.0/2"
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef POSIX_TZ_H
+#define POSIX_TZ_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace posix_tz {
+
+inline bool isAlpha(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); }
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * @brief Unsigned decimal of 1..maxDigits digits, at most max
+ */
+inline bool number(const char*& p, uint8_t maxDigits, long max, long& value) {
+    value = 0;
+    uint8_t digits = 0;
+    while (isDigit(*p) && digits < maxDigits) {
+        value = value * 10 + (*p++ - '0');
+        digits++;
+    }
+    return digits > 0 && !isDigit(*p) && value <= max;
+}
+
+inline bool name(const char*& p) {
+    const char* start = p;
+    if (*p == '<') {
+        p++;
+        while (isAlpha(*p) || isDigit(*p) || *p == '+' || *p == '-') p++;
+        if (*p != '>' || p - start < 4) return false;
+        p++;
+        return true;
+    }
+    while (isAlpha(*p)) p++;
+    return p - start >= 3;
+}
+
+/**
+ * @brief [+-]hh[:mm[:ss]]
+ */
+inline bool offset(const char*& p, long maxHours) {
+    long v;
+    if (*p == '+' || *p == '-') p++;
+    if (!number(p, 3, maxHours, v)) return false;
+    for (uint8_t i = 0; i < 2 && *p == ':'; i++) {
+        p++;
+        if (!number(p, 2, 59, v)) return false;
+    }
+    return true;
+}
+
+inline bool rule(const char*& p) {
+    long v;
+    if (*p == 'J') {
+        p++;
+        if (!number(p, 3, 365, v) || v < 1) return false;
+    } else if (*p == 'M') {
+        p++;
+        if (!number(p, 2, 12, v) || v < 1 || *p++ != '.') return false;
+        if (!number(p, 1, 5, v) || v < 1 || *p++ != '.') return false;
+        if (!number(p, 1, 6, v)) return false;
+    } else if (!number(p, 3, 365, v)) {
+        return false;
+    }
+    if (*p == '/') {
+        p++;
+        return offset(p, 167);
+    }
+    return true;
+}
+
+} // namespace posix_tz
+
+/**
+ * @brief Check a POSIX TZ string (nullptr / empty = invalid)
+ * @param maxLen Longest accepted string (storage size - 1)
+ */
+inline bool posixTzValid(const char* tz, size_t maxLen) {
+    using namespace posix_tz;
+    if (!tz || strlen(tz) > maxLen) return false;
+
+    const char* p = tz;
+    if (!name(p) || !offset(p, 24)) return false;
+    if (*p == '\0') return true;                    // No DST
+
+    if (!name(p)) return false;
+    if (*p != ',' && *p != '\0' && !offset(p, 24)) return false;
+    if (*p == '\0') return true;                    // DST with default rules
+
+    if (*p++ != ',' || !rule(p)) return false;
+    if (*p++ != ',' || !rule(p)) return false;
+    return *p == '\0';
+}
+
+#endif // POSIX_TZ_H
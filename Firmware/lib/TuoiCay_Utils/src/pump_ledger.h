@@ -0,0 +1,82 @@
+/**
+ * @file pump_ledger.h
+ * @brief Recent pump starts and skipped runs with the water budget applied
+ *
+ * LOGIC:
+ * - One entry per decision: a run that started (planned vs applied
+ *   duration, dry threshold shift) or a run the budget skipped
+ * - Answers "why did it water 12 s instead of 30 s" after the fact
+ * - Fixed ring of PUMP_LEDGER_SIZE entries, oldest overwritten first;
+ *   RAM only, a reboot starts an empty ledger
+ *
+ * RULES: #ACTUATOR(15)
+ */
+
+#ifndef PUMP_LEDGER_H
+#define PUMP_LEDGER_H
+
+#include <stdint.h>
+#include <config.h>
+
+enum class LedgerAction : uint8_t {
+    RUN = 0,        // Pump started
+    SKIP            // Budget said no water
+};
+
+struct PumpLedgerEntry {
+    uint32_t epoch;         // Wall clock (0 = not synced yet)
+    uint8_t reason;         // PumpReason that asked for water
+    LedgerAction action;
+    uint8_t percent;        // Budget at decision time (100 = no change)
+    int8_t dryShift;        // Auto dry threshold shift (% moisture)
+    uint16_t plannedSec;    // Duration before the budget (0 = until wet)
+    uint16_t appliedSec;    // Duration after the budget
+};
+
+//=============================================================================
+// PUMP LEDGER CLASS
+//=============================================================================
+
+/**
+ * @class PumpLedger
+ * @brief Ring buffer of PumpLedgerEntry
+ */
+class PumpLedger {
+public:
+    PumpLedger() : _head(0), _count(0), _total(0) {}
+
+    void add(const PumpLedgerEntry& entry) {
+        _entries[_head] = entry;
+        _head = (_head + 1) % PUMP_LEDGER_SIZE;
+        if (_count < PUMP_LEDGER_SIZE) {
+            _count++;
+        }
+        _total++;
+    }
+
+    /**
+     * @brief Entries held (at most PUMP_LEDGER_SIZE)
+     */
+    uint8_t count() const { return _count; }
+
+    /**
+     * @brief Entries recorded since boot, including overwritten ones
+     */
+    uint32_t total() const { return _total; }
+
+    /**
+     * @brief Entry by age
+     * @param i 0 = newest, count() - 1 = oldest
+     */
+    const PumpLedgerEntry& at(uint8_t i) const {
+        return _entries[(_head + PUMP_LEDGER_SIZE - 1 - i) % PUMP_LEDGER_SIZE];
+    }
+
+private:
+    PumpLedgerEntry _entries[PUMP_LEDGER_SIZE];
+    uint8_t _head;
+    uint8_t _count;
+    uint32_t _total;
+};
+
+#endif // PUMP_LEDGER_H
@@ -0,0 +1,98 @@
+/**
+ * @file route_table.h
+ * @brief Compile-time perfect hash for HTTP method + path lookup
+ *
+ * LOGIC:
+ * - routeHash() is FNV-1a over the path, seeded differently for GET/POST;
+ *   it is constexpr, so hashes of the route table are computed by the compiler
+ * - routeSlot() maps a hash onto 2^WEB_ROUTE_SLOT_BITS slots (Fibonacci hashing)
+ * - buildRouteSlots() fills the slot table at compile time and flags any
+ *   collision; the owner static_asserts on it, so a new route that
+ *   collides breaks the build (fix: change WEB_ROUTE_HASH_SEED)
+ * - findRoute(): one hash, one slot read, one strcmp to confirm
+ * - No Arduino dependency (also built by tools/route_bench.cpp on the host)
+ *
+ * Route type T needs members: const char* path; bool post;
+ *
+ * RULES: #HTTP(24) #PERF(15)
+ */
+
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <config.h>
+
+#define ROUTE_SLOTS     (1u << WEB_ROUTE_SLOT_BITS)
+
+//=============================================================================
+// HASHING
+//=============================================================================
+
+/**
+ * @brief Hash of method + path (usable in constant expressions)
+ */
+constexpr uint32_t routeHash(const char* path, bool post) {
+    uint32_t hash = post ? (uint32_t)(WEB_ROUTE_HASH_SEED ^ 0x9E3779B9UL)
+                         : (uint32_t)WEB_ROUTE_HASH_SEED;
+    for (; *path; path++) {
+        hash = (uint32_t)((hash ^ (uint8_t)*path) * 16777619UL);
+    }
+    return hash;
+}
+
+constexpr uint8_t routeSlot(uint32_t hash) {
+    return (uint8_t)((uint32_t)(hash * 2654435769UL) >> (32 - WEB_ROUTE_SLOT_BITS));
+}
+
+//=============================================================================
+// SLOT TABLE
+//=============================================================================
+
+struct RouteSlots {
+    uint8_t index[ROUTE_SLOTS];     // Route index + 1, 0 = empty slot
+    bool perfect;                   // false: two routes share a slot
+};
+
+/**
+ * @brief Build the slot table (evaluate in a constexpr context)
+ */
+template <typename T, size_t N>
+constexpr RouteSlots buildRouteSlots(const T (&routes)[N]) {
+    static_assert(N < 255, "Too many routes");
+    
+    RouteSlots slots = {};
+    slots.perfect = N <= ROUTE_SLOTS;
+    for (size_t i = 0; i < N && slots.perfect; i++) {
+        uint8_t slot = routeSlot(routeHash(routes[i].path, routes[i].post));
+        if (slots.index[slot] != 0) {
+            slots.perfect = false;
+        }
+        slots.index[slot] = (uint8_t)(i + 1);
+    }
+    return slots;
+}
+
+/**
+ * @brief Look up a request
+ * @return Route index, -1 if no route has this method + path
+ */
+template <typename T, size_t N>
+inline int findRoute(const RouteSlots& slots, const T (&routes)[N],
+                     const char* path, bool post) {
+    uint8_t entry = slots.index[routeSlot(routeHash(path, post))];
+    if (entry == 0) {
+        return -1;
+    }
+    
+    // Unknown paths can land in a used slot: confirm the match
+    const T& route = routes[entry - 1];
+    if (route.post != post || strcmp(route.path, path) != 0) {
+        return -1;
+    }
+    return entry - 1;
+}
+
+#endif // ROUTE_TABLE_H
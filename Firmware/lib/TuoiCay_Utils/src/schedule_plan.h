@@ -0,0 +1,433 @@
+/**
+ * @file schedule_plan.h
+ * @brief Schedule entries and the next-event plan that decides when they run
+ *
+ * LOGIC:
+ * - Every entry's next run epoch is found through the local calendar
+ *   (TZ rule, DST included) and entry indices are kept sorted by it, so
+ *   poll() is one compare with the queue head while nothing is due
+ * - DST: a wall time that happens twice (clock set back) maps to its first
+ *   occurrence, one that does not exist (clock set forward) to the same
+ *   instant in standard time (02:30 -> 03:30); same answer on every call,
+ *   so a transition neither repeats nor drops a slot
+ * - lastRun per entry (persisted by the owner) is the newest slot already
+ *   handled; planning never goes back past it, so a clock stepping back
+ *   (NTP resync) cannot fire a slot twice
+ * - Catch-up policy per entry decides how late a slot may still run:
+ *   SKIP (SCHEDULE_LATE_MAX_SEC), WITHIN (window minutes), ALWAYS; after
+ *   a long gap only the newest missed slot runs, once
+ * - Replan (catch-up applied) on first poll, after invalidate() and when
+ *   the clock moved back or jumped more than SCHEDULE_JUMP_SEC ahead
+ * - lastRun 0 = no history (new entry): baseline is the planning time,
+ *   nothing before it is caught up
+ * - No Arduino dependency (also built by tools/schedule_sim.cpp on the host)
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef SCHEDULE_PLAN_H
+#define SCHEDULE_PLAN_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SCHEDULE_ENTRIES    16
+#define SCHEDULE_ALL_DAYS       0x7F    // Weekday mask, bit 0 = Sunday
+#define SCHEDULE_OFFSET_MAX     180     // Sun offset limit (minutes, +/-)
+#define SCHEDULE_WINDOW_MAX     1440    // Catch-up window limit (minutes)
+
+#define SCHEDULE_LATE_MAX_SEC   60      // SKIP policy: later than this is missed
+#define SCHEDULE_JUMP_SEC       120     // Clock moved further than this: replan
+#define SCHEDULE_AHEAD_MAX_SEC  86400   // lastRun further in the future: wrong clock
+#define SCHEDULE_SEARCH_DAYS    366     // Look-ahead for the next active day
+#define SCHEDULE_NEVER          ((time_t)0x7FFFFFFF)
+
+//=============================================================================
+// SCHEDULE ENTRY
+//=============================================================================
+
+/**
+ * @brief Schedule entry kinds
+ */
+enum class ScheduleKind : uint8_t {
+    DAILY = 0,                  // Once at hour:minute
+    INTERVAL,                   // From hour:minute every N hours until midnight
+    SUNRISE,                    // Sunrise + offsetMin
+    SUNSET                      // Sunset + offsetMin
+};
+
+/**
+ * @brief What to do with a slot that passed while the device could not run it
+ */
+enum class CatchUpPolicy : uint8_t {
+    SKIP = 0,                   // Only run on time (SCHEDULE_LATE_MAX_SEC)
+    WITHIN,                     // Run if at most windowMin minutes late
+    ALWAYS                      // Run the newest missed slot, however late
+};
+
+/**
+ * @brief Schedule entry
+ */
+struct ScheduleEntry {
+    ScheduleKind kind;
+    uint8_t hour;               // Hour (0-23), DAILY / INTERVAL
+    uint8_t minute;             // Minute (0-59), DAILY / INTERVAL
+    uint8_t days;               // Weekday mask (SCHEDULE_ALL_DAYS = every day)
+    uint8_t everyHours;         // INTERVAL period (1-23 hours)
+    int16_t offsetMin;          // SUNRISE / SUNSET offset in minutes
+    uint16_t from;              // Active date range as MMDD, 0 = whole year;
+    uint16_t to;                // from > to wraps over the new year
+    uint16_t duration;          // Duration in seconds
+    CatchUpPolicy catchUp;
+    uint16_t windowMin;         // WITHIN: latest start after the slot (minutes)
+    bool enabled;               // Is this entry enabled
+
+    void setDefaults() {
+        kind = ScheduleKind::DAILY;
+        hour = 6;               // 6:00 AM
+        minute = 0;
+        days = SCHEDULE_ALL_DAYS;
+        everyHours = 0;
+        offsetMin = 0;
+        from = 0;
+        to = 0;
+        duration = 30;          // 30 seconds
+        catchUp = CatchUpPolicy::SKIP;
+        windowMin = 0;
+        enabled = false;
+    }
+
+    bool isSun() const {
+        return kind == ScheduleKind::SUNRISE || kind == ScheduleKind::SUNSET;
+    }
+
+    /**
+     * @brief Check weekday mask and date range for one local day
+     * @param weekday 0 = Sunday
+     */
+    bool activeOn(uint8_t month, uint8_t day, uint8_t weekday) const {
+        if (!(days & (1u << weekday))) return false;
+        if (from == 0 || to == 0) return true;
+
+        uint16_t today = month * 100 + day;
+        if (from <= to) {
+            return today >= from && today <= to;
+        }
+        return today >= from || today <= to;    // Wraps over the new year
+    }
+
+    /**
+     * @brief How late (seconds) a slot of this entry may still start
+     */
+    time_t lateLimit() const {
+        switch (catchUp) {
+            case CatchUpPolicy::WITHIN: return (time_t)windowMin * 60;
+            case CatchUpPolicy::ALWAYS: return SCHEDULE_NEVER;
+            default:                    return SCHEDULE_LATE_MAX_SEC;
+        }
+    }
+};
+
+inline const char* scheduleKindName(ScheduleKind kind) {
+    static const char* const NAMES[] = { "daily", "interval", "sunrise", "sunset" };
+    return NAMES[(uint8_t)kind];
+}
+
+inline const char* catchUpPolicyName(CatchUpPolicy policy) {
+    static const char* const NAMES[] = { "skip", "within", "always" };
+    return NAMES[(uint8_t)policy];
+}
+
+/**
+ * @brief Sun times for a local date, in minutes after local midnight
+ * @return false if unknown (no location): sun entries stay dormant
+ */
+typedef bool (*ScheduleSunFunc)(uint16_t year, uint8_t month, uint8_t day,
+                                int16_t* sunriseMin, int16_t* sunsetMin);
+
+//=============================================================================
+// SCHEDULE PLAN CLASS
+//=============================================================================
+
+/**
+ * @brief What poll() found
+ */
+enum class ScheduleEvent : uint8_t {
+    NONE = 0,                   // Nothing due (fast path)
+    REPLANNED,                  // Queue rebuilt; run.index = entries that gave up slots
+    RUN,                        // run.index should start now (run.due = slot)
+    MISSED                      // run.index came due too late for its policy
+};
+
+struct ScheduleRun {
+    uint8_t index;
+    time_t due;
+};
+
+/**
+ * @class SchedulePlan
+ * @brief Sorted next-run queue over an entry array owned by the caller
+ */
+class SchedulePlan {
+public:
+    SchedulePlan() : _entries(nullptr), _count(0), _sun(nullptr), _queued(0),
+                     _planned(false), _dirty(false), _nextFire(0), _lastNow(0) {
+        memset(_lastRun, 0, sizeof(_lastRun));
+    }
+
+    /**
+     * @brief Use a new entry list (replan on next poll; history kept)
+     */
+    void attach(const ScheduleEntry* entries, uint8_t count) {
+        _entries = entries;
+        _count = count > MAX_SCHEDULE_ENTRIES ? MAX_SCHEDULE_ENTRIES : count;
+        invalidate();
+    }
+
+    void setSunFunc(ScheduleSunFunc sun) {
+        _sun = sun;
+        invalidate();
+    }
+
+    /**
+     * @brief Replan on the next poll (entries edited in place)
+     */
+    void invalidate() {
+        _planned = false;
+        _queued = 0;
+        _nextFire = 0;
+    }
+
+    /**
+     * @brief Drop run history: slots before the next plan are not caught up
+     *        (entries replaced, schedule re-enabled)
+     */
+    void forget() {
+        memset(_lastRun, 0, sizeof(_lastRun));
+        _dirty = true;
+        invalidate();
+    }
+
+    /**
+     * @brief Restore persisted history (before the first poll)
+     */
+    void setLastRuns(const time_t* lastRun, uint8_t count) {
+        memset(_lastRun, 0, sizeof(_lastRun));
+        for (uint8_t i = 0; i < count && i < MAX_SCHEDULE_ENTRIES; i++) {
+            _lastRun[i] = lastRun[i];
+        }
+        invalidate();
+    }
+
+    const time_t* lastRuns() const { return _lastRun; }
+    uint8_t count() const { return _count; }
+
+    /**
+     * @brief History changed since the last call (persist it)
+     */
+    bool takeDirty() {
+        bool dirty = _dirty;
+        _dirty = false;
+        return dirty;
+    }
+
+    /**
+     * @brief Advance to "now"; call until it returns NONE
+     */
+    ScheduleEvent poll(time_t now, ScheduleRun& run) {
+        if (now < _nextFire && now >= _lastNow) {
+            _lastNow = now;
+            return ScheduleEvent::NONE;
+        }
+
+        bool jumped = now < _lastNow || now - _lastNow > SCHEDULE_JUMP_SEC;
+        _lastNow = now;
+        if (!_planned || jumped) {
+            run.index = _plan(now);
+            run.due = now;
+            return ScheduleEvent::REPLANNED;
+        }
+
+        if (_queued == 0 || _next[_queue[0]] > now) {
+            _nextFire = _queued > 0 ? _next[_queue[0]] : SCHEDULE_NEVER;
+            return ScheduleEvent::NONE;
+        }
+
+        // Head is due: hand it out, queue its following slot
+        uint8_t index = _queue[0];
+        _queued--;
+        memmove(&_queue[0], &_queue[1], _queued);
+
+        run.index = index;
+        run.due = _next[index];
+        _lastRun[index] = run.due;
+        _dirty = true;
+
+        _next[index] = nextAfter(_entries[index], now, _sun);
+        if (_next[index] != SCHEDULE_NEVER) {
+            _enqueue(index);
+        }
+        _nextFire = 0;      // Next poll re-checks the head
+
+        return now - run.due > _entries[index].lateLimit() ? ScheduleEvent::MISSED
+                                                          : ScheduleEvent::RUN;
+    }
+
+    /**
+     * @brief Epoch of the next planned run (0 = not planned or none)
+     */
+    time_t nextEpoch() const {
+        return _planned && _queued > 0 ? _next[_queue[0]] : 0;
+    }
+
+    bool isPlanned() const { return _planned; }
+
+    /**
+     * @brief First run of an entry strictly after an epoch
+     * @return Epoch, or SCHEDULE_NEVER
+     */
+    static time_t nextAfter(const ScheduleEntry& entry, time_t after, ScheduleSunFunc sun) {
+        if (!entry.enabled) return SCHEDULE_NEVER;
+        if (entry.isSun() && !sun) return SCHEDULE_NEVER;
+
+        struct tm start;
+        localtime_r(&after, &start);
+
+        for (uint16_t d = 0; d <= SCHEDULE_SEARCH_DAYS; d++) {
+            // Local midnight of day d, normalized (month/year roll, weekday)
+            struct tm day = start;
+            day.tm_mday += d;
+            day.tm_hour = 0;
+            day.tm_min = 0;
+            day.tm_sec = 0;
+            day.tm_isdst = -1;
+            if (mktime(&day) == (time_t)-1) return SCHEDULE_NEVER;
+
+            if (!entry.activeOn(day.tm_mon + 1, day.tm_mday, day.tm_wday)) continue;
+
+            // Candidate minutes of this day, ascending
+            int16_t first = entry.hour * 60 + entry.minute;
+            int16_t step = 0;
+            if (entry.kind == ScheduleKind::INTERVAL) {
+                step = entry.everyHours * 60;
+            } else if (entry.isSun()) {
+                int16_t sunrise, sunset;
+                if (!sun(day.tm_year + 1900, day.tm_mon + 1, day.tm_mday, &sunrise, &sunset)) {
+                    continue;
+                }
+                first = (entry.kind == ScheduleKind::SUNRISE ? sunrise : sunset) + entry.offsetMin;
+            }
+
+            for (int16_t m = first; m >= 0 && m < 24 * 60; m += step) {
+                time_t fire = localEpoch(day, m);
+                if (fire > after) return fire;
+                if (step == 0) break;
+            }
+        }
+        return SCHEDULE_NEVER;
+    }
+
+    /**
+     * @brief Wall clock minute of a local day -> epoch, DST-deterministic
+     *
+     * mktime() with tm_isdst = -1 is free to pick either reading of an
+     * ambiguous time (glibc's choice depends on earlier calls), which could
+     * fire one slot at both readings. Both readings are tried explicitly:
+     * the earliest that reads back as the asked wall time wins; if neither
+     * does (DST gap), the later one is the standard-time instant.
+     */
+    static time_t localEpoch(const struct tm& day, int16_t minuteOfDay) {
+        time_t found = SCHEDULE_NEVER;
+        time_t latest = 0;
+        for (int dst = 0; dst <= 1; dst++) {
+            struct tm t = day;
+            t.tm_hour = minuteOfDay / 60;
+            t.tm_min = minuteOfDay % 60;
+            t.tm_sec = 0;
+            t.tm_isdst = dst;
+            time_t e = mktime(&t);
+            if (e == (time_t)-1) continue;
+            if (e > latest) latest = e;
+
+            struct tm back;
+            localtime_r(&e, &back);
+            if (back.tm_mday == day.tm_mday && back.tm_hour * 60 + back.tm_min == minuteOfDay &&
+                e < found) {
+                found = e;
+            }
+        }
+        return found != SCHEDULE_NEVER ? found : latest;
+    }
+
+private:
+    const ScheduleEntry* _entries;
+    uint8_t _count;
+    ScheduleSunFunc _sun;
+    time_t _lastRun[MAX_SCHEDULE_ENTRIES];  // Newest handled slot (0 = none)
+    time_t _next[MAX_SCHEDULE_ENTRIES];     // Next slot per entry
+    uint8_t _queue[MAX_SCHEDULE_ENTRIES];   // Entry indices sorted by _next
+    uint8_t _queued;
+    bool _planned;
+    bool _dirty;                            // _lastRun changed
+    time_t _nextFire;                       // Head epoch; 0 = slow path next
+    time_t _lastNow;                        // Previous poll (clock steps)
+
+    /**
+     * @brief Rebuild the queue: per entry, the newest slot its policy still
+     *        allows (not before its last run), else the first future slot
+     * @return Entries that gave up missed slots
+     */
+    uint8_t _plan(time_t now) {
+        uint8_t givenUp = 0;
+        _queued = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            const ScheduleEntry& entry = _entries[i];
+            if (_lastRun[i] == 0 || _lastRun[i] > now + SCHEDULE_AHEAD_MAX_SEC) {
+                // No history, or history written by a clock that was far ahead
+                _lastRun[i] = now - 1;
+                _dirty = true;
+            }
+
+            time_t limit = entry.lateLimit();
+            time_t from = limit < now - _lastRun[i] ? now - limit - 1 : _lastRun[i];
+            time_t slot = nextAfter(entry, from, _sun);
+            if (slot <= now) {
+                // Several slots passed: only the newest one is caught up
+                time_t recent = nextAfter(entry, from > now - 86400 ? from : now - 86400, _sun);
+                if (recent <= now) {
+                    slot = recent;
+                }
+                for (time_t n; (n = nextAfter(entry, slot, _sun)) <= now; ) {
+                    slot = n;
+                }
+            }
+            if (nextAfter(entry, _lastRun[i], _sun) < (slot <= now ? slot : now + 1)) {
+                givenUp++;
+            }
+
+            _next[i] = slot;
+            if (slot != SCHEDULE_NEVER) {
+                _enqueue(i);
+            }
+        }
+        _planned = true;
+        _nextFire = 0;
+        return givenUp;
+    }
+
+    /**
+     * @brief Insert entry into the queue at its sorted position
+     */
+    void _enqueue(uint8_t index) {
+        uint8_t pos = _queued;
+        while (pos > 0 && _next[_queue[pos - 1]] > _next[index]) {
+            _queue[pos] = _queue[pos - 1];
+            pos--;
+        }
+        _queue[pos] = index;
+        _queued++;
+    }
+};
+
+#endif // SCHEDULE_PLAN_H
@@ -0,0 +1,224 @@
+/**
+ * @file sun_calc.h
+ * @brief Sunrise / sunset from latitude, longitude and date, fixed point
+ *
+ * LOGIC:
+ * - Declination and equation of time from the USNO approximate solar
+ *   coordinates (mean longitude / anomaly, equation of center; ~1 arcmin
+ *   over two centuries), hour angle from
+ *   cos H = (sin h0 - sin lat sin dec) / (cos lat cos dec), h0 = -0.833 deg
+ *   (refraction + solar radius, the almanac definition)
+ * - Integer only: angles in binary units (65536 = full turn), sines in
+ *   Q15 from a quarter-wave table built by the compiler (65 entries,
+ *   linear interpolation), acos by bisection on that table. No float:
+ *   the ESP8266 has no FPU and soft-float trig is ~10x slower
+ * - Each event is solved twice: first at solar noon, then at the time the
+ *   first pass found (declination moves up to 0.4 deg a day)
+ * - Location in 1e-4 degrees (about 11 m), north and east positive
+ * - Results are UTC epochs; sunLocalMinute() turns them into minutes of
+ *   the local date (TZ / DST from the C library). An event past local
+ *   midnight (summer sunset far north) reads as 1440+, one before it as
+ *   negative, so it is not mistaken for an event of that morning
+ * - Within a minute of almanac times (see tools/schedule_sim.cpp); near
+ *   the polar circles the sun grazes the horizon and any error grows
+ * - No Arduino dependency
+ *
+ * RULES: #TIME(12)
+ */
+
+#ifndef SUN_CALC_H
+#define SUN_CALC_H
+
+#include <stdint.h>
+#include <time.h>
+#include <civil_date.h>
+
+#define SUN_LAT_MAX_E4      900000      // 90 deg
+#define SUN_LON_MAX_E4      1800000     // 180 deg
+#define SUN_SINE_STEPS      64          // Table segments per quarter turn
+
+namespace sun_calc {
+
+struct SineTable {
+    uint16_t v[SUN_SINE_STEPS + 1];     // sin(i / 64 * 90 deg), Q15 (32768 = 1)
+};
+
+/**
+ * @brief Quarter-wave sine table, evaluated by the compiler
+ */
+constexpr SineTable buildSineTable() {
+    SineTable t{};
+    for (int i = 0; i <= SUN_SINE_STEPS; i++) {
+        // Taylor series up to x^17: error < 1e-9 for x <= pi / 2
+        double x = 1.5707963267948966 * i / SUN_SINE_STEPS;
+        double term = x;
+        double sum = x;
+        for (int k = 1; k <= 8; k++) {
+            term *= -x * x / ((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        t.v[i] = (uint16_t)(sum * 32768 + 0.5);
+    }
+    return t;
+}
+
+inline constexpr SineTable SINE = buildSineTable();
+
+/**
+ * @brief sin of a binary angle (65536 = full turn), Q15
+ */
+inline int32_t sinQ(int32_t angle) {
+    uint16_t a = (uint16_t)angle;
+    uint8_t quadrant = a >> 14;
+    uint16_t x = a & 0x3FFF;
+    if (quadrant & 1) x = 0x4000 - x;
+
+    uint8_t i = x >> 8;
+    int32_t v = SINE.v[i];
+    if (i < SUN_SINE_STEPS) {
+        v += ((int32_t)SINE.v[i + 1] - v) * (x & 0xFF) >> 8;
+    }
+    return quadrant & 2 ? -v : v;
+}
+
+inline int32_t cosQ(int32_t angle) {
+    return sinQ(angle + 0x4000);
+}
+
+/**
+ * @brief acos of a Q15 value in [-32768, 32768], binary angle 0..32768
+ */
+inline int32_t acosQ(int32_t c) {
+    int32_t lo = 0;
+    int32_t hi = 0x8000;
+    while (hi - lo > 1) {
+        int32_t mid = (lo + hi) / 2;
+        if (cosQ(mid) > c) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// USNO approximate solar coordinates; angles as 2^32 = full turn, so
+// the mean longitude / anomaly wrap for free in uint32_t
+constexpr uint32_t MEAN_LON_0 = 3346006202u;     // 280.459 deg at J2000
+constexpr uint32_t MEAN_LON_DAY = 11759231u;     // 0.98564736 deg / day
+constexpr uint32_t ANOMALY_0 = 4265487118u;      // 357.529 deg
+constexpr uint32_t ANOMALY_DAY = 11758669u;      // 0.98560028 deg / day
+constexpr int32_t CENTER_1 = 22846840;          // 1.915 deg x sin g
+constexpr int32_t CENTER_2 = 238609;            // 0.020 deg x sin 2g
+constexpr int32_t SIN_OBLIQUITY = 13034;        // sin(23.439 deg), Q15
+constexpr int32_t EOT_G1 = -459600;             // Equation of time, ms x sin g
+constexpr int32_t EOT_G2 = -4800;               // ... sin 2g
+constexpr int32_t EOT_L2 = 591840;              // ... sin 2L
+constexpr int32_t EOT_L4 = -12720;              // ... sin 4L
+constexpr int32_t SIN_H0 = -476;                // sin(-0.833 deg), Q15
+constexpr int32_t J2000_DAYS = 10957;           // 2000-01-01, noon UTC = J2000
+
+/**
+ * @brief One event (dir -1 = rise, +1 = set), seconds from 00:00 UTC
+ * @param days Date, days since 1970
+ * @return false if the sun stays up / down that day
+ */
+inline bool event(int32_t days, int32_t sinLat, int32_t cosLat, int32_t lonSec, int8_t dir,
+                  int32_t& sec) {
+    int32_t t = 43200 - lonSec;
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        // Mean longitude q and anomaly g at t
+        int64_t j2000Sec = (int64_t)(days - J2000_DAYS) * 86400 + t - 43200;
+        uint32_t q = MEAN_LON_0 + (uint32_t)(j2000Sec * MEAN_LON_DAY / 86400);
+        uint32_t g = ANOMALY_0 + (uint32_t)(j2000Sec * ANOMALY_DAY / 86400);
+        int32_t sinG = sinQ(g >> 16);
+        int32_t sin2G = sinQ((g >> 15) & 0xFFFF);
+
+        // Ecliptic longitude L, declination from sin dec = sin e sin L
+        uint32_t l = q + (uint32_t)(((int64_t)CENTER_1 * sinG + (int64_t)CENTER_2 * sin2G) >> 15);
+        int32_t sinDec = (SIN_OBLIQUITY * sinQ(l >> 16) + (1 << 14)) >> 15;
+        int32_t cosDec = sinQ(acosQ(sinDec));
+        int32_t eotSec = (int32_t)(((int64_t)EOT_G1 * sinG + (int64_t)EOT_G2 * sin2G +
+                                    (int64_t)EOT_L2 * sinQ((l >> 15) & 0xFFFF) +
+                                    (int64_t)EOT_L4 * sinQ((l >> 14) & 0xFFFF)) / 32768 / 1000);
+
+        // cos H in Q15; outside [-1, 1]: no crossing of h0 that day
+        int64_t num = (int64_t)SIN_H0 * 32768 - (int64_t)sinLat * sinDec;
+        int64_t den = (int64_t)cosLat * cosDec;
+        if (den <= 0) return false;
+        int64_t cosH = num * 32768 / den;
+        if (cosH > 32768 || cosH < -32768) return false;
+
+        // Hour angle: 65536 = 86400 s
+        int32_t hourSec = acosQ((int32_t)cosH) * 675 / 512;
+        t = 43200 - lonSec - eotSec + dir * hourSec;
+    }
+    sec = t;
+    return true;
+}
+
+} // namespace sun_calc
+
+/**
+ * @brief Latitude / longitude in range
+ */
+inline bool sunLocationValid(int32_t latE4, int32_t lonE4) {
+    return latE4 >= -SUN_LAT_MAX_E4 && latE4 <= SUN_LAT_MAX_E4 &&
+           lonE4 >= -SUN_LON_MAX_E4 && lonE4 <= SUN_LON_MAX_E4;
+}
+
+/**
+ * @brief Degrees (as sent in JSON) -> 1e-4 degrees, range-checked
+ * @return false if latitude is not -90..90 or longitude not -180..180
+ */
+inline bool sunLocationFromDegrees(double lat, double lon, int32_t& latE4, int32_t& lonE4) {
+    if (!(lat >= -90 && lat <= 90 && lon >= -180 && lon <= 180)) return false;
+    latE4 = (int32_t)(lat * 10000 + (lat < 0 ? -0.5 : 0.5));
+    lonE4 = (int32_t)(lon * 10000 + (lon < 0 ? -0.5 : 0.5));
+    return true;
+}
+
+/**
+ * @brief Sunrise and sunset around solar noon of a date
+ * @param latE4 Latitude, 1e-4 deg (north +)
+ * @param lonE4 Longitude, 1e-4 deg (east +)
+ * @param rise Sunrise, Unix epoch (UTC)
+ * @param set Sunset, Unix epoch (UTC)
+ * @return false if the sun does not rise or set that day (polar)
+ */
+inline bool sunTimes(int32_t year, uint8_t month, uint8_t day, int32_t latE4, int32_t lonE4,
+                     int64_t& rise, int64_t& set) {
+    using namespace sun_calc;
+    int32_t days = daysFromCivil(year, month, day);
+
+    int32_t lat = (int32_t)((int64_t)latE4 * 65536 / 3600000);
+    int32_t sinLat = sinQ(lat);
+    int32_t cosLat = cosQ(lat);
+    int32_t lonSec = lonE4 * 24 / 1000;         // 4 min (240 s) per degree
+
+    int32_t riseSec, setSec;
+    if (!event(days, sinLat, cosLat, lonSec, -1, riseSec) ||
+        !event(days, sinLat, cosLat, lonSec, 1, setSec)) {
+        return false;
+    }
+    rise = (int64_t)days * 86400 + riseSec;
+    set = (int64_t)days * 86400 + setSec;
+    return true;
+}
+
+/**
+ * @brief Event epoch -> minutes after local midnight of the given date,
+ *        rounded to the minute (may be < 0 or >= 1440, see above)
+ */
+inline int16_t sunLocalMinute(int64_t epoch, uint8_t day) {
+    time_t t = (time_t)(epoch + 30);
+    struct tm local;
+    localtime_r(&t, &local);
+    int16_t minute = local.tm_hour * 60 + local.tm_min;
+    if (local.tm_mday != day) {
+        minute += local.tm_hour < 12 ? 1440 : -1440;
+    }
+    return minute;
+}
+
+#endif // SUN_CALC_H
@@ -29,6 +29,10 @@
 #include <pins.h>
 #include <error_codes.h>
 #include <logger.h>
+#include <loop_monitor.h>
+#include <command_cache.h>
+#include <pump_ledger.h>
+#include <sun_calc.h>
 
 // Drivers
 #include <sensor_driver.h>
@@ -43,6 +47,9 @@
 #include <time_manager.h>
 #include <scheduler.h>
 #include <captive_portal.h>
+#include <config_batch.h>
+#include <water_budget.h>
+#include <irrigation_manager.h>
 
 // JSON for MQTT payloads
 #include <ArduinoJson.h>
@@ -62,6 +69,7 @@ void print_boot_reason();
 //=============================================================================
 Ticker wdtTicker;                       // Software watchdog ticker
 volatile bool wdtFlag = false;          // Watchdog feed flag
+LoopMonitor loopMonitor;                // loop() latency tracking
 
 // Drivers (TASK 2.1, 2.2)
 SensorManager sensors;                  // Soil moisture sensors
@@ -85,6 +93,12 @@ bool autoModeEnabled = true;            // Auto watering mode
 uint8_t thresholdDry = DEFAULT_THRESHOLD_DRY;   // Start watering below this
 uint8_t thresholdWet = DEFAULT_THRESHOLD_WET;   // Stop watering above this
 
+// Budgeted runs and skips (GET /api/budget)
+PumpLedger pumpLedger;
+
+// Fleet membership (TASK 4.3)
+char deviceGroup[DEVICE_GROUP_MAX_LEN + 1] = "";    // groups/{group}/config
+
 // LED PWM breathing effect
 int ledBrightness = 0;                  // Current brightness (0-1023)
 int ledDirection = 5;                   // Brightness change direction
@@ -99,18 +113,14 @@ const char* getPumpReason() { return pump.getReasonString(); }
 uint16_t getPumpRuntime() { return pump.getRuntime(); }
 bool getAutoMode() { return autoModeEnabled; }
 
-void setPump(bool on) {
-    // Khi AUTO mode, không cho phép điều khiển thủ công
-    if (autoModeEnabled) {
-        LOG_WRN(MOD_PUMP, "manual", "Cannot control pump in AUTO mode!");
-        return;
-    }
-    
+IrrigationVerdict setPump(bool on) {
+    // Allowed in both modes: manual preempts a scheduled or auto run;
+    // off drops every job
     if (on) {
-        pump.turnOn(PumpReason::MANUAL);
-    } else {
-        pump.turnOff();
+        return irrigation.request(PumpReason::MANUAL, 0);
     }
+    irrigation.stop();
+    return IrrigationVerdict::STARTED;
 }
 
 void setAutoMode(bool enabled) {
@@ -163,21 +173,13 @@ void setPumpSpeed(uint8_t percent) {
 //=============================================================================
 // SCHEDULE CALLBACKS
 //=============================================================================
-bool getScheduleConfig(WebScheduleConfig* config, String* nextRun) {
+bool getScheduleConfig(WebScheduleConfig* config, const char** nextRun) {
     if (!config) return false;
     
-    ScheduleConfig& schedConfig = scheduler.getConfig();
+    const ScheduleConfig& schedConfig = scheduler.getConfig();
     config->enabled = schedConfig.enabled;
-    
-    for (int i = 0; i < 4; i++) {
-        ScheduleEntry* entry = scheduler.getEntry(i);
-        if (entry) {
-            config->entries[i].hour = entry->hour;
-            config->entries[i].minute = entry->minute;
-            config->entries[i].duration = entry->duration;
-            config->entries[i].enabled = entry->enabled;
-        }
-    }
+    config->count = schedConfig.count;
+    memcpy(config->entries, schedConfig.entries, sizeof(config->entries));
     
     if (nextRun) {
         *nextRun = scheduler.getNextScheduleString();
@@ -191,11 +193,8 @@ void setScheduleEnabled(bool enabled) {
     LOG_INF(MOD_SYSTEM, "schedule", "Schedule %s", enabled ? "enabled" : "disabled");
 }
 
-void setScheduleEntry(uint8_t index, uint8_t hour, uint8_t minute, 
-                      uint16_t duration, bool enabled) {
-    if (index < 4) {
-        scheduler.setEntry(index, hour, minute, duration, enabled);
-    }
+void setScheduleEntries(const ScheduleEntry* entries, uint8_t count) {
+    scheduler.setEntries(entries, count);
 }
 
 void saveScheduleConfig() {
@@ -204,6 +203,272 @@ void saveScheduleConfig() {
     }
 }
 
+//=============================================================================
+// CONFIG BATCH (/api/batch, MQTT config/batch)
+//=============================================================================
+
+/**
+ * @brief Push stored per-sensor calibration into the sensor drivers
+ */
+void applyCalibration(const DeviceConfig& config) {
+    SoilSensor* soil[SENSOR_COUNT] = { &sensors.getSensor1(), &sensors.getSensor2() };
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        soil[i]->setCalibration(config.calDry[i], config.calWet[i]);
+    }
+}
+
+/**
+ * @brief Apply a validated batch: all operations or none
+ * 
+ * Operations are staged on copies of the stored config and schedule,
+ * each file is written at most once, and runtime state only changes
+ * after storage accepted everything. A failed schedule write restores
+ * the config file written just before it.
+ * @return TC_ERR_OK or TC_ERR_STORAGE_WRITE_FAIL
+ */
+int applyConfigBatch(const ConfigBatch& batch) {
+    // Staging copies are static: this runs from the MQTT callback and web
+    // handlers (both in loop()) right before LittleFS writes
+    static DeviceConfig config;
+    static DeviceConfig previous;
+    static ScheduleConfig schedule;
+    if (!storage.loadConfig(config)) {
+        config.setDefaults();
+    }
+    previous = config;
+    schedule = scheduler.getConfig();
+    uint8_t speed = 0;
+    
+    for (uint8_t i = 0; i < batch.count(); i++) {
+        const BatchOp& op = batch.op(i);
+        switch (op.type) {
+            case BatchOpType::THRESHOLDS:
+                config.thresholdDry = op.thresholds.dry;
+                config.thresholdWet = op.thresholds.wet;
+                break;
+            case BatchOpType::MODE:
+                config.autoMode = op.mode.autoMode;
+                break;
+            case BatchOpType::SPEED:
+                speed = op.speed.percent;   // Runtime only, like /api/speed
+                break;
+            case BatchOpType::SCHEDULE:
+                schedule.entries[op.schedule.index] = op.schedule.entry;
+                if (op.schedule.index >= schedule.count) {
+                    // Appending: slots in between keep their disabled defaults
+                    for (uint8_t j = schedule.count; j < op.schedule.index; j++) {
+                        schedule.entries[j].setDefaults();
+                    }
+                    schedule.count = op.schedule.index + 1;
+                }
+                break;
+            case BatchOpType::CALIBRATION:
+                config.calDry[op.calibration.sensor] = op.calibration.dry;
+                config.calWet[op.calibration.sensor] = op.calibration.wet;
+                break;
+            case BatchOpType::TIMEZONE:
+                memset(config.timezone, 0, sizeof(config.timezone));
+                strncpy(config.timezone, op.timezone.tz, sizeof(config.timezone) - 1);
+                break;
+            case BatchOpType::TIME_HOST:
+                memset(config.timeHost, 0, sizeof(config.timeHost));
+                strncpy(config.timeHost, op.timeHost.host, sizeof(config.timeHost) - 1);
+                break;
+            case BatchOpType::LOCATION:
+                config.latitudeE4 = op.location.latE4;
+                config.longitudeE4 = op.location.lonE4;
+                break;
+        }
+    }
+    
+    const uint8_t configOps = BATCH_OP_MASK(BatchOpType::THRESHOLDS) |
+                              BATCH_OP_MASK(BatchOpType::MODE) |
+                              BATCH_OP_MASK(BatchOpType::CALIBRATION) |
+                              BATCH_OP_MASK(BatchOpType::TIMEZONE) |
+                              BATCH_OP_MASK(BatchOpType::TIME_HOST) |
+                              BATCH_OP_MASK(BatchOpType::LOCATION);
+    bool writeConfig = batch.mask() & configOps;
+    bool writeSchedule = batch.has(BatchOpType::SCHEDULE);
+    
+    if (writeConfig && !storage.saveConfig(config)) {
+        LOG_ERR(MOD_STORAGE, "batch", "Config write failed, batch dropped");
+        return TC_ERR_STORAGE_WRITE_FAIL;
+    }
+    if (writeSchedule && !storage.saveSchedule(schedule)) {
+        if (writeConfig) {
+            storage.saveConfig(previous);
+        }
+        LOG_ERR(MOD_STORAGE, "batch", "Schedule write failed, batch dropped");
+        return TC_ERR_STORAGE_WRITE_FAIL;
+    }
+    
+    // Storage holds the new state: switch runtime over in one go
+    if (batch.has(BatchOpType::THRESHOLDS)) {
+        thresholdDry = config.thresholdDry;
+        thresholdWet = config.thresholdWet;
+    }
+    if (batch.has(BatchOpType::MODE)) {
+        autoModeEnabled = config.autoMode;
+    }
+    if (batch.has(BatchOpType::CALIBRATION)) {
+        applyCalibration(config);
+    }
+    if (batch.has(BatchOpType::TIMEZONE)) {
+        timeManager.setTimezone(config.timezone);
+    }
+    if (batch.has(BatchOpType::TIME_HOST)) {
+        timeManager.setTimeHost(config.timeHost);
+    }
+    if (batch.has(BatchOpType::LOCATION)) {
+        timeManager.setLocation(config.latitudeE4, config.longitudeE4);
+    }
+    if (writeSchedule) {
+        scheduler.setConfig(schedule);
+    }
+    if (speed) {
+        pump.setSpeed(speed);
+    }
+    
+    LOG_INF(MOD_SYSTEM, "batch", "Applied %d ops (dry=%d%%, wet=%d%%, auto=%d)",
+            batch.count(), thresholdDry, thresholdWet, autoModeEnabled);
+    return TC_ERR_OK;
+}
+
+//=============================================================================
+// PERF CALLBACKS
+//=============================================================================
+void getPerfStats(WebPerfStats* stats) {
+    stats->loopMaxUs = loopMonitor.getMaxUs();
+    stats->loopPeakUs = loopMonitor.getPeakUs();
+    stats->loopStalls = loopMonitor.getPeakStalls();
+    stats->loopIterations = loopMonitor.getPeakIterations();
+}
+
+void resetPerfStats() {
+    loopMonitor.resetPeak();
+}
+
+//=============================================================================
+// HEALTH CALLBACK
+//=============================================================================
+void getSystemHealth(WebSystemHealth* health) {
+    SoilSensor* soil[WEB_SENSOR_COUNT] = { &sensors.getSensor1(), &sensors.getSensor2() };
+    for (uint8_t i = 0; i < WEB_SENSOR_COUNT; i++) {
+        health->sensors[i].moisture = soil[i]->getMoisturePercent();
+        health->sensors[i].valid = soil[i]->isValid();
+    }
+    
+    health->wifiState = wifiMgr.getStateString();
+    health->rssi = (int8_t)wifiMgr.getRSSI();
+    health->wifiReconnects = wifiMgr.getReconnectCount();
+    health->wifiReconnectTotal = wifiMgr.getReconnectTotal();
+    health->mqttState = mqttMgr.getStateString();
+    health->mqttQueued = mqttMgr.getQueuedCount();
+    health->mqttReconnects = mqttMgr.getReconnectCount();
+    health->mqttReconnectTotal = mqttMgr.getReconnectTotal();
+}
+
+//=============================================================================
+// METRICS CALLBACK
+//=============================================================================
+void getMetrics(WebMetrics* metrics) {
+    static_assert(WEB_PUMP_REASON_COUNT == PUMP_REASON_COUNT - 1, "PumpReason changed");
+    
+    getSystemHealth(&metrics->health);
+    
+    SoilSensor* soil[WEB_SENSOR_COUNT] = { &sensors.getSensor1(), &sensors.getSensor2() };
+    for (uint8_t i = 0; i < WEB_SENSOR_COUNT; i++) {
+        metrics->analog[i] = soil[i]->hasAnalog();
+        metrics->adcRaw[i] = soil[i]->getLastRaw();
+    }
+    
+    metrics->pumpOnMs = pump.getTotalOnMs();
+    for (uint8_t i = 0; i < WEB_PUMP_REASON_COUNT; i++) {
+        metrics->pumpStarts[i] = pump.getStartCount((PumpReason)(i + 1));   // Skip NONE
+    }
+    
+    metrics->timeSynced = timeManager.isSynced();
+    metrics->secondsSinceSync = timeManager.getSecondsSinceSync();
+    
+    metrics->loopBoundsUs = LoopMonitor::getHistogramBounds();
+    metrics->loopCounts = loopMonitor.getHistogram();
+    metrics->loopBuckets = LOOP_HIST_BUCKETS;
+    metrics->loopSumUs = loopMonitor.getHistogramSumUs();
+}
+
+//=============================================================================
+// WATER BUDGET
+//=============================================================================
+
+/**
+ * @brief Record a run or skip the budget decided
+ */
+void ledgerRecord(PumpReason reason, LedgerAction action, uint16_t plannedSec, uint16_t appliedSec) {
+    PumpLedgerEntry entry;
+    entry.epoch = timeManager.isSynced() ? (uint32_t)timeManager.getEpoch() : 0;
+    entry.reason = (uint8_t)reason;
+    entry.action = action;
+    entry.percent = waterBudget.getPercent();
+    entry.dryShift = reason == PumpReason::AUTO ? waterBudget.getDryShift() : 0;
+    entry.plannedSec = plannedSec;
+    entry.appliedSec = appliedSec;
+    pumpLedger.add(entry);
+}
+
+void getBudget(WebBudget* budget) {
+    budget->percent = waterBudget.getPercent();
+    budget->dryShift = waterBudget.getDryShift();
+    budget->thresholdDry = thresholdDry;
+    budget->thresholdWet = thresholdWet;
+    waterBudget.adjustThresholds(budget->thresholdDry, budget->thresholdWet);
+    budget->source = WaterBudget::sourceName(waterBudget.getSource());
+    budget->forecast = waterBudget.getForecast();
+    budget->et0Mm10 = waterBudget.getEt0Mm10();
+    budget->rainMm10 = waterBudget.getRainMm10();
+    budget->expiresIn = waterBudget.getExpiresInSec();
+    budget->ledger = &pumpLedger;
+}
+
+void getTimeInfo(WebTimeInfo* info) {
+    const struct tm& t = timeManager.getTm();
+    info->synced = timeManager.isSynced();
+    info->source = TimeManager::sourceName(timeManager.getSource());
+    info->timezone = timeManager.getTimezone();
+    snprintf(info->local, sizeof(info->local), "%04d-%02d-%02d %02d:%02d:%02d",
+             t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+    info->dst = timeManager.isDst();
+    info->utcOffset = timeManager.getUtcOffset();
+    info->accuracyMs = timeManager.getAccuracyMs();
+    info->hasDrift = timeManager.getDriftPpb(info->driftPpb);
+    info->pollSec = timeManager.getPollSec();
+    info->nextSyncIn = timeManager.getNextSyncInSec();
+    info->server = timeManager.getNtpServer();
+    info->servers = &timeManager.getNtp().server(0);
+    info->serverCount = NTP_SERVER_COUNT;
+    info->http = &timeManager.getHttp();
+    info->hasLocation = timeManager.hasLocation();
+    info->latE4 = timeManager.getLatitudeE4();
+    info->lonE4 = timeManager.getLongitudeE4();
+    info->hasSun = timeManager.isSynced() &&
+                   timeManager.getSunTimes(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+                                           info->sunriseMin, info->sunsetMin);
+}
+
+/**
+ * @brief Manual time from the dashboard (POST /api/time)
+ * @return TC_ERR_SYSTEM_INVALID_ARG if implausible, TC_ERR_CMD_INVALID_STATE
+ *         if the clock already has better time
+ */
+int setManualTime(uint32_t epoch, uint16_t ms) {
+    if (epoch < TIME_VALID_EPOCH) return TC_ERR_SYSTEM_INVALID_ARG;
+    
+    int64_t unixUs = (int64_t)epoch * 1000000 + (int64_t)ms * 1000;
+    if (!timeManager.setTime(TimeSource::MANUAL, unixUs, TIME_MANUAL_ACCURACY_MS)) {
+        return TC_ERR_CMD_INVALID_STATE;
+    }
+    return TC_ERR_OK;
+}
+
 //=============================================================================
 // MQTT FUNCTIONS (TASK 4.2, 4.3)
 //=============================================================================
@@ -266,23 +531,461 @@ void mqttPublishMode() {
     mqttMgr.publish("mode", payload, 1, true);  // QoS 1, retain
 }
 
+//=============================================================================
+// FLEET COMMANDS (group / broadcast topics)
+//=============================================================================
+
+/**
+ * @brief Where a command came from
+ */
+enum class CommandSource : uint8_t {
+    DEVICE = 0,     // devices/{deviceId}/...
+    GROUP = 1,      // groups/{group}/config
+    FLEET = 2       // fleet/config
+};
+
+static const char* const COMMAND_SOURCE_NAMES[] = {"device", "group", "fleet"};
+
+// Applied "seq" per source and their results; commands at or below the
+// highest one are replays
+static SeqCache commandSeqs[3];
+
+// Results of recent commands by "id" (retry dedupe)
+static CommandCache commandCache;
+
+/**
+ * @brief Persist the last applied seq per source
+ * 
+ * A QoS 1 command redelivered after a reboot must still be a replay
+ * (e.g. "toggle" must not flip the pump again).
+ */
+void saveCommandSeqs() {
+    uint32_t seq[3];
+    int code[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        seq[i] = commandSeqs[i].last();
+        if (!commandSeqs[i].lookup(seq[i], &code[i])) {
+            code[i] = TC_ERR_CMD_STALE;
+        }
+    }
+    storage.saveCommandSeqs(seq, code, 3, deviceGroup);
+}
+
+/**
+ * @brief Restore the seqs saved before reboot (after the group is known)
+ */
+void loadCommandSeqs() {
+    uint32_t seq[3];
+    int code[3];
+    char group[DEVICE_GROUP_MAX_LEN + 1];
+    if (!storage.loadCommandSeqs(seq, code, 3, group, sizeof(group))) return;
+    
+    for (uint8_t i = 0; i < 3; i++) {
+        // A group's sequence only applies to that group
+        if (i == (uint8_t)CommandSource::GROUP && strcmp(group, deviceGroup) != 0) continue;
+        if (seq[i] > 0) {
+            commandSeqs[i].remember(seq[i], code[i]);
+        }
+    }
+}
+
+/**
+ * @brief Group names become a topic level: [A-Za-z0-9_-], 1..16 chars
+ */
+bool isValidGroupName(const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len > DEVICE_GROUP_MAX_LEN) return false;
+    
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        if (!isalnum(c) && c != '_' && c != '-') return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Switch group subscription (empty = leave group)
+ */
+void mqttSubscribeGroup(const char* group) {
+    char topic[MQTT_TOPIC_MAX_LEN];
+    
+    if (deviceGroup[0] != '\0') {
+        snprintf(topic, sizeof(topic), "groups/%s/config", deviceGroup);
+        mqttMgr.unsubscribe(topic, false);
+        snprintf(topic, sizeof(topic), "groups/%s/weather", deviceGroup);
+        mqttMgr.unsubscribe(topic, false);
+        waterBudget.clear(WeatherSource::GROUP);
+    }
+    
+    strncpy(deviceGroup, group, sizeof(deviceGroup) - 1);
+    deviceGroup[sizeof(deviceGroup) - 1] = '\0';
+    commandSeqs[(uint8_t)CommandSource::GROUP].reset();  // New group, new sequence
+    
+    if (deviceGroup[0] != '\0') {
+        snprintf(topic, sizeof(topic), "groups/%s/config", deviceGroup);
+        mqttMgr.subscribe(topic, 1, false);
+        snprintf(topic, sizeof(topic), "groups/%s/weather", deviceGroup);
+        mqttMgr.subscribe(topic, 1, false);
+    }
+}
+
+/**
+ * @brief Join/leave a group and persist membership
+ * @return false if name is invalid
+ */
+bool setDeviceGroup(const char* group) {
+    if (group[0] != '\0' && !isValidGroupName(group)) {
+        LOG_WRN(MOD_SYSTEM, "group", "Invalid group name: %s", group);
+        return false;
+    }
+    if (strcmp(group, deviceGroup) == 0) return true;
+    
+    mqttSubscribeGroup(group);
+    LOG_INF(MOD_SYSTEM, "group", "Group -> %s", deviceGroup[0] ? deviceGroup : "(none)");
+    
+    // Save to storage - load existing config first to preserve all fields
+    DeviceConfig config;
+    if (!storage.loadConfig(config)) {
+        config.setDefaults();
+    }
+    memset(config.group, 0, sizeof(config.group));
+    strncpy(config.group, deviceGroup, sizeof(config.group) - 1);
+    
+    if (!storage.saveConfig(config)) {
+        LOG_ERR(MOD_STORAGE, "save", "Failed to save group");
+    }
+    return true;
+}
+
+/**
+ * @brief Switch timezone and persist it
+ * @return false if tz is not a valid POSIX TZ string
+ */
+bool setDeviceTimezone(const char* tz) {
+    if (!timeManager.setTimezone(tz)) return false;
+    
+    DeviceConfig config;
+    if (!storage.loadConfig(config)) {
+        config.setDefaults();
+    }
+    if (strcmp(config.timezone, tz) == 0) return true;
+    
+    memset(config.timezone, 0, sizeof(config.timezone));
+    strncpy(config.timezone, tz, sizeof(config.timezone) - 1);
+    if (!storage.saveConfig(config)) {
+        LOG_ERR(MOD_STORAGE, "save", "Failed to save timezone");
+    }
+    return true;
+}
+
+/**
+ * @brief Switch the HTTP fallback time host and persist it
+ * @return false if host is not "name[:port]"
+ */
+bool setDeviceTimeHost(const char* host) {
+    if (!timeManager.setTimeHost(host)) return false;
+    
+    DeviceConfig config;
+    if (!storage.loadConfig(config)) {
+        config.setDefaults();
+    }
+    if (strcmp(config.timeHost, host) == 0) return true;
+    
+    memset(config.timeHost, 0, sizeof(config.timeHost));
+    strncpy(config.timeHost, host, sizeof(config.timeHost) - 1);
+    if (!storage.saveConfig(config)) {
+        LOG_ERR(MOD_STORAGE, "save", "Failed to save time host");
+    }
+    return true;
+}
+
+/**
+ * @brief Move the site location (sunrise / sunset entries) and persist it
+ * @return false if out of range
+ */
+bool setDeviceLocation(int32_t latE4, int32_t lonE4) {
+    if (!timeManager.setLocation(latE4, lonE4)) return false;
+    
+    DeviceConfig config;
+    if (!storage.loadConfig(config)) {
+        config.setDefaults();
+    }
+    if (config.latitudeE4 == latE4 && config.longitudeE4 == lonE4) return true;
+    
+    config.latitudeE4 = latE4;
+    config.longitudeE4 = lonE4;
+    if (!storage.saveConfig(config)) {
+        LOG_ERR(MOD_STORAGE, "save", "Failed to save location");
+    }
+    return true;
+}
+
+/**
+ * @brief Publish command result
+ * Topic: devices/{deviceId}/ack
+ * @param id Correlation ID from the command (nullptr = none)
+ * @param hasSeq Include seq field
+ */
+void mqttPublishAck(CommandSource source, const char* id, bool hasSeq, uint32_t seq, int code) {
+    JsonDocument doc;
+    if (id) doc["id"] = id;
+    doc["src"] = COMMAND_SOURCE_NAMES[(uint8_t)source];
+    if (hasSeq) doc["seq"] = seq;
+    doc["code"] = code;
+    doc["msg"] = error_to_string(code);
+    doc["ts"] = millis() / 1000;
+    
+    char payload[160];
+    serializeJson(doc, payload, sizeof(payload));
+    
+    mqttMgr.publish("ack", payload, 1, false);  // QoS 1, no retain
+}
+
+/**
+ * @brief Apply config payload (same format for device, group and fleet)
+ * @return true if anything changed
+ */
+bool applyConfigCommand(JsonDocument& doc) {
+    bool changed = false;
+    
+    if (doc["threshold_dry"].is<int>()) {
+        thresholdDry = doc["threshold_dry"];
+        changed = true;
+    }
+    if (doc["threshold_wet"].is<int>()) {
+        thresholdWet = doc["threshold_wet"];
+        changed = true;
+    }
+    if (doc["max_runtime"].is<int>()) {
+        pump.setMaxRuntime(doc["max_runtime"]);
+        changed = true;
+    }
+    
+    if (changed) {
+        LOG_INF(MOD_MQTT, "cmd", "Config updated: dry=%d%%, wet=%d%%", thresholdDry, thresholdWet);
+    }
+    return changed;
+}
+
+/**
+ * @brief Execute pump/control command
+ * @return TC_ERR_OK or reason for rejection
+ */
+int handlePumpCommand(JsonDocument& doc) {
+    const char* action = doc["action"];
+    if (!action) return TC_ERR_CMD_INVALID;
+    
+    // Runs go through the irrigation queue; the pump's max runtime stays
+    // the safety cap, "duration" only sets this run (0 = up to the cap)
+    int code = TC_ERR_OK;
+    if (strcmp(action, "on") == 0) {
+        int duration = doc["duration"] | 0;
+        if (duration < 0 || duration > PUMP_MAX_RUNTIME_SEC) return TC_ERR_CMD_INVALID;
+        IrrigationVerdict verdict = irrigation.request(PumpReason::MANUAL, duration);
+        if (verdict == IrrigationVerdict::REFUSED || verdict == IrrigationVerdict::FULL) {
+            code = TC_ERR_CMD_INVALID_STATE;
+        }
+        LOG_INF(MOD_MQTT, "cmd", "Pump ON (duration=%ds): %s", duration,
+                irrigationVerdictName(verdict));
+    } else if (strcmp(action, "off") == 0) {
+        irrigation.stop();
+        LOG_INF(MOD_MQTT, "cmd", "Pump OFF");
+    } else if (strcmp(action, "toggle") == 0) {
+        if (irrigation.busy() || pump.isRunning()) {
+            irrigation.stop();
+        } else if (irrigation.request(PumpReason::MANUAL, 0) == IrrigationVerdict::REFUSED) {
+            code = TC_ERR_CMD_INVALID_STATE;
+        }
+        LOG_INF(MOD_MQTT, "cmd", "Pump TOGGLE -> %s", pump.isRunning() ? "ON" : "OFF");
+    } else {
+        return TC_ERR_CMD_INVALID;
+    }
+    
+    mqttPublishPumpStatus();  // Respond with status
+    return code;
+}
+
+/**
+ * @brief Execute mode/control command
+ */
+int handleModeCommand(JsonDocument& doc) {
+    const char* mode = doc["mode"];
+    if (!mode) return TC_ERR_CMD_INVALID;
+    
+    if (strcmp(mode, "auto") == 0) {
+        autoModeEnabled = true;
+        LOG_INF(MOD_MQTT, "cmd", "Mode -> AUTO");
+    } else if (strcmp(mode, "manual") == 0) {
+        autoModeEnabled = false;
+        LOG_INF(MOD_MQTT, "cmd", "Mode -> MANUAL");
+    } else {
+        return TC_ERR_CMD_INVALID;
+    }
+    
+    mqttPublishMode();  // Respond with status
+    return TC_ERR_OK;
+}
+
+/**
+ * @brief Execute config command (device, group or fleet topic)
+ */
+int handleConfigCommand(JsonDocument& doc, CommandSource source) {
+    int code = TC_ERR_OK;
+    
+    // Membership can only be changed on the device's own topic
+    const char* group = doc["group"];
+    if (group) {
+        if (source != CommandSource::DEVICE) {
+            code = TC_ERR_CMD_DENIED;
+        } else if (!setDeviceGroup(group)) {
+            code = TC_ERR_SYSTEM_INVALID_ARG;
+        }
+    }
+    
+    // Timezone is fine fleet-wide: devices of a site share local time
+    const char* tz = doc["tz"];
+    if (tz && !setDeviceTimezone(tz)) {
+        code = TC_ERR_SYSTEM_INVALID_ARG;
+    }
+    
+    // Same for the local time host (a site's router / NAS)
+    const char* timeHost = doc["time_host"];
+    if (timeHost && !setDeviceTimeHost(timeHost)) {
+        code = TC_ERR_SYSTEM_INVALID_ARG;
+    }
+    
+    // And for the location (degrees, both needed; the batch op clears it)
+    JsonVariant lat = doc["lat"];
+    JsonVariant lon = doc["lon"];
+    if (!lat.isNull() || !lon.isNull()) {
+        int32_t latE4, lonE4;
+        if (!lat.is<double>() || !lon.is<double>() ||
+            !sunLocationFromDegrees(lat.as<double>(), lon.as<double>(), latE4, lonE4) ||
+            !setDeviceLocation(latE4, lonE4)) {
+            code = TC_ERR_SYSTEM_INVALID_ARG;
+        }
+    }
+    
+    if (applyConfigCommand(doc)) {
+        mqttPublishMode();  // Respond with updated config
+    }
+    return code;
+}
+
+/**
+ * @brief Execute config/batch command
+ */
+int handleBatchCommand(JsonDocument& doc) {
+    // ~620 B: kept off the MQTT callback's stack, parse() clears it
+    static ConfigBatch batch;
+    if (!batch.parse(doc["ops"])) {
+        return TC_ERR_CMD_INVALID;
+    }
+    
+    int code = applyConfigBatch(batch);
+    if (code == TC_ERR_OK) {
+        mqttPublishMode();  // Respond with updated config
+    }
+    return code;
+}
+
+/**
+ * @brief Retained weather forecast -> water budget (no id/seq/ack)
+ * Topics: devices/{deviceId}/weather, groups/{group}/weather
+ * @return false if the topic is not a weather topic
+ */
+bool handleWeatherMessage(const char* topic, const char* payload, size_t length) {
+    String topicStr(topic);
+    if (!topicStr.endsWith("/weather")) return false;
+    
+    WeatherSource source = WeatherSource::DEVICE;
+    if (topicStr.startsWith("groups/")) {
+        // Late forecast for a group we just left
+        char expected[MQTT_TOPIC_MAX_LEN];
+        snprintf(expected, sizeof(expected), "groups/%s/weather", deviceGroup);
+        if (deviceGroup[0] == '\0' || strcmp(topic, expected) != 0) return true;
+        source = WeatherSource::GROUP;
+    }
+    
+    // Empty retained message = publisher withdrew the forecast
+    if (length == 0) {
+        waterBudget.clear(source);
+        return true;
+    }
+    
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, payload);
+    const char* reason = error ? error.c_str() : waterBudget.ingest(doc, source);
+    if (reason) {
+        LOG_WRN(MOD_BUDGET, "ingest", "%s forecast rejected: %s",
+                WaterBudget::sourceName(source), reason);
+    }
+    return true;
+}
+
+/**
+ * @brief Broker's time topic -> fallback clock (no id/seq/ack)
+ * Topic: time (not per device), {"epoch": 1767225600, "ms": 250, "interval": 10}
+ * A retained copy is up to "interval" seconds old: it counts as half that,
+ * +- half that
+ * @return false if the topic is not the time topic
+ */
+bool handleTimeMessage(const char* topic, const char* payload, size_t length) {
+    if (strcmp(topic, "time") != 0) return false;
+    if (length == 0) return true;   // Retained time withdrawn
+    
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, payload);
+    JsonVariantConst ms = doc["ms"];
+    bool hasMs = !ms.isNull();
+    uint32_t interval = doc["interval"] | TIME_MQTT_INTERVAL_SEC;
+    if (error || !doc["epoch"].is<uint32_t>() || interval == 0 || interval > 3600 ||
+        (hasMs && (!ms.is<uint16_t>() || ms.as<uint16_t>() > 999))) {
+        LOG_WRN(MOD_TIME, "mqtt", "Bad time payload: %s", payload);
+        return true;
+    }
+    
+    // Whole seconds: the publisher is somewhere in that second
+    int64_t unixUs = (int64_t)doc["epoch"].as<uint32_t>() * 1000000 +
+                     (hasMs ? ms.as<uint16_t>() * 1000LL : 500000);
+    uint32_t accuracyMs = (hasMs ? 1 : 500) + TIME_MQTT_TRANSIT_MS;
+    if (mqttMgr.isRetained()) {
+        unixUs += interval * 500000LL;
+        accuracyMs += interval * 500;
+    }
+    timeManager.setTime(TimeSource::MQTT, unixUs, accuracyMs);
+    return true;
+}
+
 /**
  * @brief MQTT message callback - handle incoming commands
  * 
  * Topics handled:
  * - devices/{deviceId}/pump/control   -> {"action": "on"|"off"|"toggle", "duration": 30}
- * - devices/{deviceId}/config         -> {"threshold_dry": 30, "threshold_wet": 50}
+ * - devices/{deviceId}/config         -> {"threshold_dry": 30, "threshold_wet": 50, "group": "zoneA"}
  * - devices/{deviceId}/mode/control   -> {"mode": "auto"|"manual"}
+ * - devices/{deviceId}/config/batch   -> {"ops": [{"op": "thresholds", ...}, ...]} (all or nothing)
+ * - groups/{group}/config, fleet/config -> same as config, without "group"
+ * - devices/{deviceId}/weather, groups/{group}/weather -> forecast (handleWeatherMessage)
+ * - time -> fallback clock (handleTimeMessage)
+ * 
+ * Commands with "id" and/or "seq" get a result on devices/{deviceId}/ack.
+ * - "id": correlation ID; a retried ID returns the cached result, no re-run
+ * - "seq": applied once per source; a replayed seq is acked with its
+ *   original result, not re-applied
  */
 void mqttMessageCallback(const char* topic, const uint8_t* payload, unsigned int length) {
-    // Null-terminate payload for parsing
-    char payloadStr[256];
-    size_t copyLen = (length < sizeof(payloadStr) - 1) ? length : sizeof(payloadStr) - 1;
-    memcpy(payloadStr, payload, copyLen);
-    payloadStr[copyLen] = '\0';
+    // The client NUL-terminates the payload in its packet buffer: no stack
+    // copy on this path (batches below already need ~1 KB of state)
+    const char* payloadStr = (const char*)payload;
+    
+    // Every few seconds: not worth a log line
+    if (handleTimeMessage(topic, payloadStr, length)) return;
     
     LOG_INF(MOD_MQTT, "recv", "%s: %s", topic, payloadStr);
     
+    if (handleWeatherMessage(topic, payloadStr, length)) return;
+    
     // Parse JSON
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, payloadStr);
@@ -294,70 +997,74 @@ void mqttMessageCallback(const char* topic, const uint8_t* payload, unsigned int
     // Check topic suffix
     String topicStr(topic);
     
-    // Handle pump/control
-    if (topicStr.endsWith("pump/control")) {
-        const char* action = doc["action"];
-        if (action) {
-            if (strcmp(action, "on") == 0) {
-                int duration = doc["duration"] | PUMP_MAX_RUNTIME_SEC;
-                pump.setMaxRuntime(duration);
-                pump.turnOn(PumpReason::MANUAL);
-                LOG_INF(MOD_MQTT, "cmd", "Pump ON (duration=%ds)", duration);
-            } else if (strcmp(action, "off") == 0) {
-                pump.turnOff();
-                LOG_INF(MOD_MQTT, "cmd", "Pump OFF");
-            } else if (strcmp(action, "toggle") == 0) {
-                if (pump.isRunning()) {
-                    pump.turnOff();
-                } else {
-                    pump.turnOn(PumpReason::MANUAL);
-                }
-                LOG_INF(MOD_MQTT, "cmd", "Pump TOGGLE -> %s", pump.isRunning() ? "ON" : "OFF");
-            }
-            mqttPublishPumpStatus();  // Respond with status
-        }
-        return;
+    CommandSource source = CommandSource::DEVICE;
+    if (topicStr.startsWith("fleet/")) {
+        source = CommandSource::FLEET;
+    } else if (topicStr.startsWith("groups/")) {
+        // Late message for a group we just left
+        char expected[MQTT_TOPIC_MAX_LEN];
+        snprintf(expected, sizeof(expected), "groups/%s/config", deviceGroup);
+        if (deviceGroup[0] == '\0' || strcmp(topic, expected) != 0) return;
+        source = CommandSource::GROUP;
     }
     
-    // Handle mode/control
-    if (topicStr.endsWith("mode/control")) {
-        const char* mode = doc["mode"];
-        if (mode) {
-            if (strcmp(mode, "auto") == 0) {
-                autoModeEnabled = true;
-                LOG_INF(MOD_MQTT, "cmd", "Mode -> AUTO");
-            } else if (strcmp(mode, "manual") == 0) {
-                autoModeEnabled = false;
-                LOG_INF(MOD_MQTT, "cmd", "Mode -> MANUAL");
-            }
-            mqttPublishMode();  // Respond with status
+    const char* cmdId = doc["id"];
+    bool hasSeq = doc["seq"].is<uint32_t>();
+    uint32_t seq = doc["seq"] | 0;
+    int code;
+    
+    // Retried command: answer from cache, do not execute twice
+    if (cmdId) {
+        if (strlen(cmdId) > CMD_ID_MAX_LEN) {
+            LOG_WRN(MOD_MQTT, "cmd", "Command id too long");
+            mqttPublishAck(source, nullptr, hasSeq, seq, TC_ERR_CMD_INVALID);
+            return;
+        }
+        if (commandCache.lookup(cmdId, &code)) {
+            LOG_DBG(MOD_MQTT, "cmd", "Retry id=%s, cached code=%d", cmdId, code);
+            mqttPublishAck(source, cmdId, hasSeq, seq, code);
+            return;
         }
-        return;
     }
     
-    // Handle config
-    if (topicStr.endsWith("config")) {
-        bool changed = false;
-        
-        if (doc["threshold_dry"].is<int>()) {
-            thresholdDry = doc["threshold_dry"];
-            changed = true;
-        }
-        if (doc["threshold_wet"].is<int>()) {
-            thresholdWet = doc["threshold_wet"];
-            changed = true;
-        }
-        if (doc["max_runtime"].is<int>()) {
-            pump.setMaxRuntime(doc["max_runtime"]);
-            changed = true;
-        }
-        
-        if (changed) {
-            LOG_INF(MOD_MQTT, "cmd", "Config updated: dry=%d%%, wet=%d%%", thresholdDry, thresholdWet);
-            mqttPublishMode();  // Respond with updated config
+    // Idempotency: skip commands already applied from this source, ack
+    // with the result they had
+    SeqCache& seqs = commandSeqs[(uint8_t)source];
+    if (hasSeq && seqs.isReplay(seq)) {
+        if (!seqs.lookup(seq, &code)) {
+            code = TC_ERR_CMD_STALE;
         }
+        LOG_DBG(MOD_MQTT, "cmd", "Replay %s seq=%lu ignored, code=%d", 
+                COMMAND_SOURCE_NAMES[(uint8_t)source], (unsigned long)seq, code);
+        mqttPublishAck(source, cmdId, hasSeq, seq, code);
         return;
     }
+    
+    if (source != CommandSource::DEVICE) {
+        // Group/broadcast topics only carry config
+        code = handleConfigCommand(doc, source);
+    } else if (topicStr.endsWith("pump/control")) {
+        code = handlePumpCommand(doc);
+    } else if (topicStr.endsWith("mode/control")) {
+        code = handleModeCommand(doc);
+    } else if (topicStr.endsWith("config/batch")) {
+        code = handleBatchCommand(doc);
+    } else if (topicStr.endsWith("config")) {
+        code = handleConfigCommand(doc, source);
+    } else {
+        code = TC_ERR_CMD_INVALID;
+    }
+    
+    if (cmdId) {
+        commandCache.remember(cmdId, code);
+    }
+    if (hasSeq) {
+        seqs.remember(seq, code);
+        saveCommandSeqs();
+    }
+    if (cmdId || hasSeq) {
+        mqttPublishAck(source, cmdId, hasSeq, seq, code);
+    }
 }
 
 /**
@@ -367,6 +1074,10 @@ void mqttSubscribeTopics() {
     mqttMgr.subscribe("pump/control", 1);
     mqttMgr.subscribe("config", 1);
     mqttMgr.subscribe("mode/control", 1);
+    mqttMgr.subscribe("config/batch", 1);
+    mqttMgr.subscribe("weather", 1);
+    mqttMgr.subscribe("fleet/config", 1, false);
+    mqttMgr.subscribe("time", 0, false);
 }
 
 //=============================================================================
@@ -416,6 +1127,7 @@ void enterProvisioningMode() {
     captivePortal.onTimeout([]() {
         LOG_WRN(MOD_SYSTEM, "prov", "Provisioning timeout, restarting...");
         delay(1000);
+        timeManager.persist();
         ESP.restart();
     });
     
@@ -431,6 +1143,7 @@ void exitProvisioningMode() {
         captivePortal.stop();
         LOG_INF(MOD_SYSTEM, "prov", "Exiting provisioning, restarting...");
         delay(1000);
+        timeManager.persist();
         ESP.restart();
     }
 }
@@ -569,6 +1282,7 @@ void setup() {
     if (!pump.begin()) {
         LOG_ERR(MOD_SYSTEM, "init", "Pump init failed!");
     }
+    irrigation.begin(&pump);
     
     //-------------------------------------------------------------------------
     // STEP 9: Initialize WiFi (TASK 3.1)
@@ -588,7 +1302,15 @@ void setup() {
     webServer.setControlCallbacks(setPump, setAutoMode, setThresholds);
     webServer.setThresholdPointers(&thresholdDry, &thresholdWet);
     webServer.setSpeedCallbacks(getPumpSpeed, setPumpSpeed);
-    webServer.setScheduleCallbacks(getScheduleConfig, setScheduleEnabled, setScheduleEntry, saveScheduleConfig);
+    webServer.setScheduleCallbacks(getScheduleConfig, setScheduleEnabled, setScheduleEntries, saveScheduleConfig);
+    webServer.setPerfCallbacks(getPerfStats, resetPerfStats);
+    webServer.setHealthCallback(getSystemHealth);
+    webServer.setMetricsCallback(getMetrics);
+    webServer.setBudgetCallback(getBudget);
+    webServer.setJobsCallback([]() { return &irrigation.getQueue(); });
+    webServer.setTimeInfoCallback(getTimeInfo);
+    webServer.setBatchCallback(applyConfigBatch);
+    webServer.setManualTimeCallback(setManualTime);
     
     //-------------------------------------------------------------------------
     // STEP 11: Initialize MQTT (TASK 4.1)
@@ -614,12 +1336,20 @@ void setup() {
             thresholdWet = savedConfig.thresholdWet;
             autoModeEnabled = savedConfig.autoMode;
             pump.setMaxRuntime(savedConfig.maxRuntime);
+            applyCalibration(savedConfig);
+            timeManager.setTimezone(savedConfig.timezone);  // Before NTP starts
+            timeManager.setTimeHost(savedConfig.timeHost);
+            timeManager.setLocation(savedConfig.latitudeE4, savedConfig.longitudeE4);
+            if (savedConfig.group[0] != '\0') {
+                mqttSubscribeGroup(savedConfig.group);  // Active after MQTT connects
+            }
             LOG_INF(MOD_STORAGE, "load", "Config loaded: dry=%d, wet=%d, auto=%d", 
                     thresholdDry, thresholdWet, autoModeEnabled);
         } else {
             LOG_WRN(MOD_STORAGE, "load", "No saved config, using defaults: dry=%d, wet=%d", 
                     thresholdDry, thresholdWet);
         }
+        loadCommandSeqs();
         storage.listFiles();  // Debug: show stored files
     } else {
         LOG_ERR(MOD_SYSTEM, "init", "Storage init failed!");
@@ -645,20 +1375,36 @@ void setup() {
     // STEP 15: Initialize Scheduler (TASK 6.2)
     //-------------------------------------------------------------------------
     if (scheduler.begin()) {
+        // Sunrise / sunset entries (dormant until a location is set)
+        scheduler.setSunCallback(TimeManager::sunTimes);
+        
         // Set moisture check callback
         scheduler.setMoistureCallback([]() -> bool {
             // Return true if soil NEEDS water (is dry)
             return sensors.getAverageMoisture() < thresholdDry;
         });
         
-        // Set pump control callback
-        scheduler.setPumpCallback([](bool on, uint16_t duration) {
-            if (on) {
-                pump.setMaxRuntime(duration);
-                pump.turnOn(PumpReason::SCHEDULE);
-            } else {
-                pump.turnOff();
+        // Hand due runs to the irrigation queue; a run is recorded once it
+        // is taken (running or waiting its turn)
+        scheduler.setRunCallback([](uint8_t index, uint16_t duration) -> bool {
+            IrrigationVerdict verdict = irrigation.request(PumpReason::SCHEDULE, duration, index);
+            if (verdict != IrrigationVerdict::STARTED && verdict != IrrigationVerdict::PREEMPTED &&
+                verdict != IrrigationVerdict::QUEUED) {
+                return false;
             }
+            const ScheduleEntry* entry = scheduler.getEntry(index);
+            ledgerRecord(PumpReason::SCHEDULE, LedgerAction::RUN,
+                         entry ? entry->duration : duration, duration);
+            return true;
+        });
+        
+        // Scale by the weather budget, record a skip
+        scheduler.setDurationCallback([](uint8_t index, uint16_t duration) -> uint16_t {
+            uint16_t applied = waterBudget.scaleDuration(duration);
+            if (!applied) {
+                ledgerRecord(PumpReason::SCHEDULE, LedgerAction::SKIP, duration, 0);
+            }
+            return applied;
         });
     } else {
         LOG_ERR(MOD_SYSTEM, "init", "Scheduler init failed!");
@@ -679,36 +1425,61 @@ void setup() {
  * - If moisture < thresholdDry (30%) -> Start pump
  * - If moisture > thresholdWet (50%) -> Stop pump
  * - Hysteresis prevents rapid on/off cycling
+ * - Both thresholds shifted by the water budget (hot: earlier, rain: later);
+ *   while the budget skips, a dry soil does not start the pump (one ledger
+ *   entry per dry spell)
+ * - Runs are AUTO jobs in the irrigation queue: auto only starts when the
+ *   pump is free and a wet soil only ends its own run, never a scheduled one
  */
 void autoWatering() {
-    if (!autoModeEnabled) return;
+    if (!autoModeEnabled) {
+        irrigation.cancel(PumpReason::AUTO);
+        return;
+    }
+    
+    static bool skipRecorded = false;
     
     uint8_t moisture = sensors.getAverageMoisture();
+    uint8_t dry = thresholdDry;
+    uint8_t wet = thresholdWet;
+    waterBudget.adjustThresholds(dry, wet);
     
-    if (!pump.isRunning()) {
+    if (!irrigation.has(PumpReason::AUTO)) {
         // Check if we should start watering
-        if (moisture < thresholdDry) {
-            // Soil is dry - start pump
-            if (pump.turnOn(PumpReason::AUTO)) {
+        if (moisture >= dry || !waterBudget.isSkipping()) {
+            skipRecorded = false;
+        }
+        if (moisture < dry && waterBudget.isSkipping()) {
+            if (!skipRecorded) {
+                skipRecorded = true;
+                ledgerRecord(PumpReason::AUTO, LedgerAction::SKIP, 0, 0);
+                LOG_INF(MOD_PUMP, "auto", "Soil dry (%d%% < %d%%), rain expected - not watering",
+                        moisture, dry);
+            }
+        } else if (moisture < dry) {
+            // Soil is dry - start pump (until wet, capped by max runtime)
+            IrrigationVerdict verdict = irrigation.request(PumpReason::AUTO, 0);
+            if (verdict == IrrigationVerdict::STARTED || verdict == IrrigationVerdict::PREEMPTED) {
+                ledgerRecord(PumpReason::AUTO, LedgerAction::RUN, 0, 0);
                 LOG_INF(MOD_PUMP, "auto", "Soil dry (%d%% < %d%%), starting pump",
-                        moisture, thresholdDry);
+                        moisture, dry);
             } else {
-                // Log why pump didn't start (likely cooldown)
+                // Log why pump didn't start (cooldown, another job running)
                 static unsigned long lastLogTime = 0;
                 if (millis() - lastLogTime > 10000) {  // Log every 10s max
-                    LOG_DBG(MOD_PUMP, "auto", "Pump not started (moisture=%d%%, state=%d, cooldown=%ds)",
-                            moisture, (int)pump.getState(), pump.getCooldownRemaining());
+                    LOG_DBG(MOD_PUMP, "auto", "Pump not started (moisture=%d%%, %s, cooldown=%ds)",
+                            moisture, irrigationVerdictName(verdict), pump.getCooldownRemaining());
                     lastLogTime = millis();
                 }
             }
         }
     } else {
-        // Pump is running - check if we should stop
-        if (moisture > thresholdWet) {
+        // Auto job running - check if we should stop
+        if (moisture > wet) {
             // Soil is wet enough - stop pump
-            pump.turnOff();
+            irrigation.cancel(PumpReason::AUTO);
             LOG_INF(MOD_PUMP, "auto", "Soil wet (%d%% > %d%%), stopping pump",
-                    moisture, thresholdWet);
+                    moisture, wet);
         }
     }
 }
@@ -733,6 +1504,7 @@ void loop() {
         if (captivePortal.hasConfig()) {
             LOG_INF(MOD_SYSTEM, "prov", "Config received, restarting in 2s...");
             delay(2000);
+            timeManager.persist();
             ESP.restart();
         }
         
@@ -748,6 +1520,7 @@ void loop() {
     }
     
     unsigned long now = millis();
+    loopMonitor.begin();
     
     //-------------------------------------------------------------------------
     // TASK 6.3: Handle OTA updates (PRIORITY #1 - must be fast!)
@@ -796,8 +1569,10 @@ void loop() {
     mqttMgr.update();
     
     //-------------------------------------------------------------------------
-    // TASK 2.2: Update pump (check safety timeouts)
+    // TASK 2.2: Update pump (check safety timeouts); the irrigation queue
+    // first, so a run ending on time is not taken for a safety auto-off
     //-------------------------------------------------------------------------
+    irrigation.update();
     pump.update();
     
     //-------------------------------------------------------------------------
@@ -810,8 +1585,9 @@ void loop() {
     }
     
     //-------------------------------------------------------------------------
-    // TASK 2.3: Auto watering logic
+    // TASK 2.3: Auto watering logic (budget first: drop expired forecasts)
     //-------------------------------------------------------------------------
+    waterBudget.update();
     autoWatering();
     
     // Publish sensor data periodically (every 5 seconds to reduce traffic)
@@ -858,6 +1634,8 @@ void loop() {
         analogWrite(PIN_LED_STATUS, 1023 - ledBrightness);
     }
     
+    loopMonitor.end();
+    
     //-------------------------------------------------------------------------
     // Non-blocking delay - reduced for faster OTA response
     //-------------------------------------------------------------------------
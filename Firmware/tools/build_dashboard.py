@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+"""
+Đóng gói dashboard web/index.html: bản PROGMEM (dự phòng) và file tĩnh cho LittleFS
+
+Cách dùng:
+    python tools/build_dashboard.py        # chạy tay
+    (tự chạy trước mỗi lần build / buildfs qua extra_scripts trong platformio.ini)
+    pio run -t buildfs                     # tạo ảnh LittleFS từ data/
+    pio run -t uploadfs                    # nạp ảnh (USB hoặc OTA với env _ota)
+
+Script sẽ:
+1. Rút gọn HTML/JS: bỏ console.log, thụt lề, dòng trống, comment // (không đụng tới
+   nội dung chuỗi, template literal và comment khối)
+2. Nén gzip (mức 9, mtime=0 để kết quả không đổi giữa các lần build)
+3. Tính ETag từ SHA-256 của dữ liệu nén
+4. Ghi lib/TuoiCay_Managers/src/dashboard_html.h (chỉ ghi khi nội dung thay đổi)
+5. Tách <style> và <script> thành data/www/assets/app.<hash>.css|js.gz (tên chứa
+   hash nội dung -> trình duyệt cache vĩnh viễn), ghi data/www/index.html.gz trỏ tới
+   chúng và data/www/index.etag; xóa asset cũ không còn dùng
+"""
+
+import gzip
+import hashlib
+import io
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 - chạy trong PlatformIO (SCons)
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SRC_FILE = os.path.join(PROJECT_DIR, "web", "index.html")
+OUT_FILE = os.path.join(PROJECT_DIR, "lib", "TuoiCay_Managers", "src", "dashboard_html.h")
+FS_DIR = os.path.join(PROJECT_DIR, "data", "www")        # WEB_FS_ROOT
+ASSET_DIR = os.path.join(FS_DIR, "assets")               # WEB_ASSET_PREFIX
+
+STYLE_RE = re.compile(r"<style>(.*?)</style>", re.S)
+SCRIPT_RE = re.compile(r"<script>(.*?)</script>", re.S)
+
+# Ký tự code đứng trước "/" khiến nó mở regex chứ không phải phép chia
+REGEX_PREV = set("(,=:[!&|?{};+-*%<>~^")
+CODE_MODES = ("code", "expr", "brace")
+QUOTE_MODES = {"'": "sq", '"': "dq", "`": "tpl"}
+
+
+def scan(text):
+    """Duyệt từng ký tự, trả về (ký tự, ngữ cảnh): "html", "code" (JS trong <script>)
+    hoặc "lit" (chuỗi '...' "...", template `...`, comment /* */, regex /.../).
+    Với "\n", ngữ cảnh là của dòng tiếp theo"""
+    stack = ["html"]
+    prev = ""
+    i, n = 0, len(text)
+    while i < n:
+        c = text[i]
+        nxt = text[i + 1] if i + 1 < n else ""
+        mode = stack[-1]
+        if mode == "html":
+            if text.startswith("<script", i):
+                end = text.find(">", i)
+                end = n - 1 if end < 0 else end
+                for k in range(i, end + 1):
+                    yield text[k], "html"
+                stack, prev = ["code"], ""
+                i = end + 1
+                continue
+            yield c, "html"
+        elif mode in CODE_MODES:
+            if text.startswith("</script", i):
+                stack = ["html"]
+                continue
+            if c == "/" and nxt == "/":
+                end = text.find("\n", i)
+                end = n if end < 0 else end
+                for k in range(i, end):
+                    yield text[k], "code"
+                i = end
+                continue
+            if c == "/" and nxt == "*":
+                stack.append("block")
+                yield c, "lit"
+            elif c in QUOTE_MODES:
+                stack.append(QUOTE_MODES[c])
+                yield c, "lit"
+            elif c == "/" and (prev == "" or prev in REGEX_PREV):
+                stack.append("regex")
+                yield c, "lit"
+            else:
+                if c == "{":
+                    stack.append("brace")
+                elif c == "}" and len(stack) > 1:
+                    stack.pop()
+                if not c.isspace():
+                    prev = c
+                yield c, "code" if stack[-1] in CODE_MODES else "lit"
+        elif c == "\\" and mode != "block":
+            yield c, "lit"
+            if nxt:
+                yield nxt, "lit"
+            i += 2
+            continue
+        elif mode == "block":
+            if c == "*" and nxt == "/":
+                stack.pop()
+                yield c, "lit"
+                i += 1
+                c = nxt
+            yield c, "code" if stack[-1] in CODE_MODES else "lit"
+        elif mode == "tpl":
+            if c == "`":
+                stack.pop()
+                prev = ")"
+            elif c == "$" and nxt == "{":
+                stack.append("expr")
+                yield c, "lit"
+                i += 1
+                c = nxt
+            yield c, "lit"
+        else:
+            # Chuỗi / regex một dòng; xuống dòng mà chưa đóng thì coi như đóng
+            if c == "\n" or (mode == "sq" and c == "'") or (mode == "dq" and c == '"') or \
+                    (mode == "regex" and c == "/"):
+                while stack[-1] not in CODE_MODES and stack[-1] != "tpl":
+                    stack.pop()
+                prev = ")"
+            elif mode == "regex" and c == "[":
+                stack.append("rclass")
+            elif mode == "rclass" and c == "]":
+                stack.pop()
+            yield c, "code" if c == "\n" and stack[-1] in CODE_MODES else "lit"
+        i += 1
+
+
+def is_console_log(line):
+    """Dòng chỉ gồm một lời gọi console.log(...) (ngoặc cân bằng, ngoài chuỗi)"""
+    if not line.startswith("console.log("):
+        return False
+    depth = 0
+    for i, (c, ctx) in enumerate(scan("<script>" + line)):
+        i -= len("<script>")
+        if ctx != "code" or i < 0:
+            continue
+        if c == "(":
+            depth += 1
+        elif c == ")":
+            depth -= 1
+            if depth == 0:
+                return line[i + 1:].strip() in ("", ";")
+    return False
+
+
+def minify(html):
+    """Rút gọn theo dòng, giữ nguyên xuống dòng cho JS (ASI).
+    Dòng bắt đầu trong chuỗi / template / comment khối được giữ nguyên; comment //
+    và console.log chỉ bị bỏ khi cả dòng là code JS"""
+    out = []
+    line, start = [], "html"
+    for c, ctx in scan(html + "\n"):
+        if c != "\n":
+            line.append(c)
+            continue
+        text, end = "".join(line), ctx
+        line = []
+        if start == "lit":
+            out.append(text)
+        else:
+            text = text.strip() if end != "lit" else text.lstrip()
+            drop = not text
+            if start == "code" and end == "code":
+                drop = drop or text.startswith("//")
+                # Không bỏ thân của if / else không có ngoặc nhọn
+                if is_console_log(text) and not (out and out[-1].endswith((")", "else"))):
+                    drop = True
+            if not drop:
+                out.append(text)
+        start = ctx
+    return "\n".join(out) + "\n"
+
+
+def compress(data):
+    """Gzip tất định: không tên file, mtime=0"""
+    buf = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", fileobj=buf, compresslevel=9, mtime=0) as gz:
+        gz.write(data)
+    return buf.getvalue()
+
+
+def render_header(gz, etag, raw_len, min_len):
+    lines = [
+        "/**",
+        " * @file dashboard_html.h",
+        " * @brief Gzip-compressed dashboard (GENERATED - do not edit)",
+        " *",
+        " * LOGIC:",
+        " * - Generated by tools/build_dashboard.py from web/index.html",
+        " * - Source %d bytes, minified %d bytes, gzip %d bytes" % (raw_len, min_len, len(gz)),
+        " * - DASHBOARD_ETAG changes whenever the compressed content changes",
+        " *",
+        " * RULES: #HTTP(24)",
+        " */",
+        "",
+        "#ifndef DASHBOARD_HTML_H",
+        "#define DASHBOARD_HTML_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#define DASHBOARD_ETAG      \"\\\"%s\\\"\"" % etag,
+        "#define DASHBOARD_HTML_GZ_LEN   %d" % len(gz),
+        "",
+        "static const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(gz), 16):
+        chunk = gz[i:i + 16]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += [
+        "};",
+        "",
+        "#endif // DASHBOARD_HTML_H",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def write_if_changed(path, data):
+    """Ghi file nhị phân khi nội dung khác, trả về True nếu đã ghi"""
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == data:
+                return False
+    with open(path, "wb") as f:
+        f.write(data)
+    return True
+
+
+def build_fs(minified):
+    """Tách CSS/JS ra file có hash, ghi bản gzip cho LittleFS"""
+    html = minified.decode("utf-8")
+    assets = {}
+
+    def extract(match, ext, tag):
+        body = match.group(1).encode("utf-8")
+        name = "app.%s.%s" % (hashlib.sha256(body).hexdigest()[:8], ext)
+        assets[name + ".gz"] = compress(body)
+        return tag % name
+
+    html = STYLE_RE.sub(lambda m: extract(m, "css", '<link rel="stylesheet" href="/assets/%s">'), html, 1)
+    html = SCRIPT_RE.sub(lambda m: extract(m, "js", '<script src="/assets/%s"></script>'), html, 1)
+
+    index = compress(html.encode("utf-8"))
+    etag = hashlib.sha256(index).hexdigest()[:16]
+
+    os.makedirs(ASSET_DIR, exist_ok=True)
+    changed = write_if_changed(os.path.join(FS_DIR, "index.html.gz"), index)
+    changed |= write_if_changed(os.path.join(FS_DIR, "index.etag"), ('"%s"' % etag).encode("ascii"))
+    for name, data in assets.items():
+        changed |= write_if_changed(os.path.join(ASSET_DIR, name), data)
+    for name in os.listdir(ASSET_DIR):
+        if name not in assets:
+            os.remove(os.path.join(ASSET_DIR, name))
+            changed = True
+
+    sizes = ", ".join("%s %d" % (n, len(d)) for n, d in sorted(assets.items()))
+    print("LittleFS: %s index.html.gz %d, %s bytes" %
+          ("ghi" if changed else "không thay đổi,", len(index), sizes))
+
+
+def build():
+    with open(SRC_FILE, "r", encoding="utf-8") as f:
+        raw = f.read()
+
+    minified = minify(raw).encode("utf-8")
+    gz = compress(minified)
+    etag = hashlib.sha256(gz).hexdigest()[:16]
+    header = render_header(gz, etag, len(raw.encode("utf-8")), len(minified))
+
+    old = None
+    if os.path.exists(OUT_FILE):
+        with open(OUT_FILE, "r", encoding="utf-8") as f:
+            old = f.read()
+
+    if old == header:
+        print("Dashboard: không thay đổi (ETag %s)" % etag)
+
+    else:
+        with open(OUT_FILE, "w", encoding="utf-8", newline="\n") as f:
+            f.write(header)
+        print("Dashboard: %d -> %d -> %d bytes gzip, ETag %s" %
+              (len(raw.encode("utf-8")), len(minified), len(gz), etag))
+
+    build_fs(minified)
+
+
+build()
@@ -0,0 +1,371 @@
+#!/usr/bin/env python3
+"""
+Kiểm tra QoS 1 của MqttClient: script đóng vai broker, ESP8266 kết nối tới nó
+
+Cách dùng:
+    python tools/mqtt_qos_test.py                  # nghe cổng 1883 trên mọi IP
+    python tools/mqtt_qos_test.py --port 1884 --timeout 180
+
+ESP8266: đặt MQTT_BROKER = IP máy tính chạy script (secrets.h), MQTT_PORT = --port,
+rồi khởi động lại thiết bị. Dừng mosquitto nếu nó đang giữ cổng.
+
+Script sẽ:
+1. Chờ thiết bị kết nối (CONNECT -> CONNACK, trả SUBACK) và lấy deviceId từ topic
+   subscribe devices/{deviceId}/pump/control
+2. Gửi lại khi mất PUBACK: gửi lệnh có "id" (pump/control, action không hợp lệ nên bơm
+   không chạy), giữ PUBACK của ack thiết bị trả về; thiết bị phải gửi lại cùng packet id
+   với cờ DUP sau MQTT_RETRY_TIMEOUT_MS
+3. Lọc trùng: gửi hai lần cùng packet id, lần hai có DUP -> thiết bị PUBACK cả hai nhưng
+   chỉ xử lý lần đầu; cùng id không có DUP là tin mới; sau MQTT_RX_DEDUPE_SIZE id khác,
+   id cũ bị đẩy khỏi vòng nhớ và được xử lý lại
+4. Tin quá lớn (lớn hơn MQTT_PACKET_BUFFER_SIZE): vẫn được PUBACK, không xử lý
+5. Xả hàng đợi offline: giữ PUBACK, gửi 6 lệnh (4 ack chiếm hết cửa sổ in-flight, 2 ack
+   vào hàng đợi), cắt kết nối và từ chối kết nối lại một lúc; sau CONNACK thiết bị phải
+   gửi lại 4 tin in-flight (DUP, cùng packet id) rồi 2 tin trong hàng, đủ và đúng thứ tự
+
+Mã thoát khác 0 nếu có bước sai. Chỉ dùng thư viện chuẩn Python.
+"""
+
+import argparse
+import json
+import socket
+import sys
+import time
+
+# Giống mqtt_client.h
+RETRY_TIMEOUT_S = 5.0       # MQTT_RETRY_TIMEOUT_MS
+INFLIGHT_MAX = 4            # MQTT_INFLIGHT_MAX
+DEDUPE_SIZE = 8             # MQTT_RX_DEDUPE_SIZE
+PACKET_BUFFER = 512         # MQTT_PACKET_BUFFER_SIZE
+
+CONNECT, CONNACK, PUBLISH, PUBACK = 0x10, 0x20, 0x30, 0x40
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK = 0x80, 0x90, 0xA0, 0xB0
+PINGREQ, PINGRESP, DISCONNECT = 0xC0, 0xD0, 0xE0
+
+
+def encode_length(n):
+    out = bytearray()
+    while True:
+        byte = n % 128
+        n //= 128
+        out.append(byte | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+
+def mqtt_string(s):
+    data = s.encode()
+    return len(data).to_bytes(2, "big") + data
+
+
+class Publish:
+    """PUBLISH thiết bị gửi lên"""
+
+    def __init__(self, header, body):
+        self.dup = bool(header & 0x08)
+        self.qos = (header >> 1) & 0x03
+        n = int.from_bytes(body[0:2], "big")
+        self.topic = body[2:2 + n].decode(errors="replace")
+        pos = 2 + n
+        self.pid = 0
+        if self.qos:
+            self.pid = int.from_bytes(body[pos:pos + 2], "big")
+            pos += 2
+        self.payload = body[pos:].decode(errors="replace")
+        self.at = time.monotonic()
+
+    def json(self):
+        try:
+            return json.loads(self.payload)
+        except ValueError:
+            return {}
+
+
+class Session:
+    """Một kết nối của thiết bị; tự trả SUBACK / UNSUBACK / PINGRESP"""
+
+    def __init__(self, sock):
+        self.sock = sock
+        self.sock.settimeout(0.2)
+        self.rx = bytearray()
+        self.auto_ack = True
+        self.device = None
+        self.published = []     # Publish, theo thứ tự nhận
+        self.pubacks = []       # packet id thiết bị PUBACK
+        self.closed = False
+
+    def send(self, data):
+        self.sock.sendall(data)
+
+    def publish(self, topic, payload, pid, dup=False):
+        body = mqtt_string(topic) + pid.to_bytes(2, "big") + payload.encode()
+        self.send(bytes([PUBLISH | 0x02 | (0x08 if dup else 0)]) + encode_length(len(body)) + body)
+
+    def puback(self, pid):
+        self.send(bytes([PUBACK, 2]) + pid.to_bytes(2, "big"))
+
+    def _packet(self):
+        """Tách một gói hoàn chỉnh khỏi self.rx, None nếu chưa đủ"""
+        if len(self.rx) < 2:
+            return None
+        length, mult, pos = 0, 1, 1
+        while True:
+            if pos >= len(self.rx):
+                return None
+            byte = self.rx[pos]
+            length += (byte & 0x7F) * mult
+            mult *= 128
+            pos += 1
+            if not byte & 0x80:
+                break
+        if len(self.rx) < pos + length:
+            return None
+        header = self.rx[0]
+        body = bytes(self.rx[pos:pos + length])
+        del self.rx[:pos + length]
+        return header, body
+
+    def _handle(self, header, body):
+        kind = header & 0xF0
+        if kind == CONNECT:
+            self.send(bytes([CONNACK, 2, 0, 0]))
+        elif kind == SUBSCRIBE:
+            pid = body[0:2]
+            pos, granted = 2, bytearray()
+            while pos < len(body):
+                n = int.from_bytes(body[pos:pos + 2], "big")
+                topic = body[pos + 2:pos + 2 + n].decode(errors="replace")
+                granted.append(min(body[pos + 2 + n], 1))
+                pos += 3 + n
+                if topic.startswith("devices/") and topic.endswith("/pump/control"):
+                    self.device = topic[len("devices/"):-len("/pump/control")]
+            self.send(bytes([SUBACK]) + encode_length(2 + len(granted)) + pid + granted)
+        elif kind == UNSUBSCRIBE:
+            self.send(bytes([UNSUBACK, 2]) + body[0:2])
+        elif kind == PINGREQ:
+            self.send(bytes([PINGRESP, 0]))
+        elif kind == PUBACK:
+            self.pubacks.append(int.from_bytes(body[0:2], "big"))
+        elif kind == PUBLISH:
+            msg = Publish(header, body)
+            self.published.append(msg)
+            if msg.qos and self.auto_ack:
+                self.puback(msg.pid)
+        elif kind == DISCONNECT:
+            self.closed = True
+
+    def poll(self):
+        try:
+            data = self.sock.recv(4096)
+            if not data:
+                self.closed = True
+            self.rx += data
+        except socket.timeout:
+            pass
+        except OSError:
+            self.closed = True
+        while True:
+            packet = self._packet()
+            if packet is None:
+                return
+            self._handle(*packet)
+
+    def wait(self, cond, timeout):
+        """poll() tới khi cond() đúng; trả về kết quả cuối của cond()"""
+        end = time.monotonic() + timeout
+        while time.monotonic() < end and not self.closed:
+            if cond():
+                return True
+            self.poll()
+        return cond()
+
+    def acks(self, prefix, dup=None):
+        """Tin trên topic ack có "id" bắt đầu bằng prefix"""
+        topic = "devices/%s/ack" % self.device
+        return [m for m in self.published if m.topic == topic and
+                str(m.json().get("id", "")).startswith(prefix) and (dup is None or m.dup == dup)]
+
+    def close(self):
+        try:
+            self.sock.close()
+        except OSError:
+            pass
+
+
+class Checks:
+    def __init__(self):
+        self.failures = 0
+
+    def expect(self, ok, what):
+        print("   %s %s" % ("✅" if ok else "❌", what))
+        if not ok:
+            self.failures += 1
+        return ok
+
+
+def accept(server, timeout):
+    server.settimeout(timeout)
+    try:
+        sock, addr = server.accept()
+    except socket.timeout:
+        return None
+    print("   🔌 Thiết bị %s:%d kết nối" % addr)
+    return Session(sock)
+
+
+def connect(server, timeout):
+    """Chờ thiết bị kết nối và subscribe xong"""
+    session = accept(server, timeout)
+    if session and session.wait(lambda: session.device is not None, 15.0):
+        session.wait(lambda: False, 1.0)    # Hết loạt SUBSCRIBE / tin lúc kết nối
+        return session
+    return None
+
+
+def command(session, pid, cmd_id, dup=False, pad=0):
+    payload = {"id": cmd_id, "action": "qos-test"}
+    if pad:
+        payload["pad"] = "x" * pad
+    session.publish("devices/%s/pump/control" % session.device, json.dumps(payload), pid, dup)
+
+
+def retransmit(session, checks, tag):
+    print("\n🔁 Gửi lại khi mất PUBACK")
+    session.auto_ack = False
+    command(session, 1, tag + "rt")
+    checks.expect(session.wait(lambda: 1 in session.pubacks, 5.0), "Thiết bị PUBACK lệnh")
+    checks.expect(session.wait(lambda: session.acks(tag + "rt", dup=False), 5.0),
+                  "Ack gửi lên (QoS 1), giữ PUBACK")
+    first = session.acks(tag + "rt", dup=False)
+    if not first:
+        session.auto_ack = True
+        return
+    pid = first[0].pid
+    resent = session.wait(lambda: [m for m in session.acks(tag + "rt", dup=True) if m.pid == pid],
+                          RETRY_TIMEOUT_S * 2 + 5)
+    if checks.expect(resent, "Gửi lại cùng packet id %d với DUP" % pid):
+        again = [m for m in session.acks(tag + "rt", dup=True) if m.pid == pid][0]
+        delay = again.at - first[0].at
+        checks.expect(delay >= RETRY_TIMEOUT_S - 1, "Sau khoảng %.1f s (timeout %.0f s)" %
+                      (delay, RETRY_TIMEOUT_S))
+    session.puback(pid)
+    session.auto_ack = True
+
+
+def dedupe(session, checks, tag):
+    print("\n🧹 Lọc tin trùng (DUP)")
+    session.pubacks.clear()
+    command(session, 200, tag + "dd-a")
+    command(session, 200, tag + "dd-b", dup=True)
+    checks.expect(session.wait(lambda: session.pubacks.count(200) == 2, 5.0), "PUBACK cả hai lần")
+    session.wait(lambda: False, 3.0)
+    checks.expect(len(session.acks(tag + "dd-a")) == 1, "Lần đầu được xử lý")
+    checks.expect(not session.acks(tag + "dd-b"), "Lần gửi lại (DUP, cùng packet id) bị bỏ")
+
+    command(session, 200, tag + "dd-c")
+    checks.expect(session.wait(lambda: session.acks(tag + "dd-c"), 5.0),
+                  "Cùng packet id, không DUP: tin mới, được xử lý")
+
+    for i in range(DEDUPE_SIZE):
+        command(session, 201 + i, tag + "dd-f%d" % i)
+    session.wait(lambda: len(session.acks(tag + "dd-f")) == DEDUPE_SIZE, 10.0)
+    command(session, 200, tag + "dd-d", dup=True)
+    checks.expect(session.wait(lambda: session.acks(tag + "dd-d"), 5.0),
+                  "Sau %d id khác, id cũ rời vòng nhớ: DUP được xử lý lại" % DEDUPE_SIZE)
+
+
+def oversized(session, checks, tag):
+    print("\n📦 Tin quá lớn")
+    session.pubacks.clear()
+    command(session, 300, tag + "big", pad=PACKET_BUFFER)
+    checks.expect(session.wait(lambda: 300 in session.pubacks, 5.0),
+                  "Tin %d+ byte vẫn được PUBACK" % PACKET_BUFFER)
+    session.wait(lambda: False, 2.0)
+    checks.expect(not session.acks(tag + "big") and not session.closed,
+                  "Không xử lý, kết nối vẫn giữ")
+
+
+def offline_queue(server, session, checks, tag, refuse_s, timeout):
+    print("\n📴 Xả hàng đợi offline")
+    count = INFLIGHT_MAX + 2
+    session.auto_ack = False
+    for i in range(count):
+        command(session, 400 + i, tag + "q%d" % i)
+    session.wait(lambda: len(session.acks(tag + "q")) >= INFLIGHT_MAX, 5.0)
+    session.wait(lambda: False, 1.0)
+    sent = session.acks(tag + "q")
+    checks.expect(len(sent) == INFLIGHT_MAX,
+                  "Cửa sổ in-flight đầy: %d ack gửi, phần còn lại vào hàng" % len(sent))
+    inflight = {m.pid for m in sent}
+    session.close()
+
+    # Từ chối kết nối lại một lúc (thiết bị thử lại với backoff)
+    end = time.monotonic() + refuse_s
+    refused = 0
+    while time.monotonic() < end:
+        server.settimeout(max(0.1, end - time.monotonic()))
+        try:
+            sock, _ = server.accept()
+            sock.close()
+            refused += 1
+        except socket.timeout:
+            pass
+    print("   🚫 Từ chối %d lần kết nối lại trong %.0f s" % (refused, refuse_s))
+
+    session = connect(server, timeout)
+    if not checks.expect(session is not None, "Thiết bị kết nối lại"):
+        return None
+    session.wait(lambda: len({m.json().get("id") for m in session.acks(tag + "q")}) >= count,
+                 RETRY_TIMEOUT_S * 2)
+    after = session.acks(tag + "q")
+    resent = [m for m in after if m.pid in inflight]
+    checks.expect(len(resent) == INFLIGHT_MAX and all(m.dup for m in resent),
+                  "%d tin in-flight gửi lại với DUP, cùng packet id" % len(resent))
+    ids = [m.json().get("id") for m in after]
+    unique = list(dict.fromkeys(ids))
+    checks.expect(unique == [tag + "q%d" % i for i in range(count)],
+                  "Đủ %d ack, đúng thứ tự (%d tin)" % (count, len(after)))
+    checks.expect(len(ids) == count, "Không ack nào gửi hai lần")
+    return session
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TuoiCay MQTT QoS 1 test (broker giả)")
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--timeout", type=float, default=120.0,
+                        help="chờ thiết bị kết nối (giây)")
+    parser.add_argument("--refuse", type=float, default=6.0,
+                        help="từ chối kết nối lại bao lâu (giây)")
+    args = parser.parse_args()
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind((args.bind, args.port))
+    server.listen(4)
+    print("🚀 Broker giả tại %s:%d, chờ ESP8266 (tối đa %.0f s)..." %
+          (args.bind, args.port, args.timeout))
+
+    session = connect(server, args.timeout)
+    if session is None:
+        print("   ❌ Thiết bị không kết nối / không subscribe pump/control")
+        return 2
+    print("   📟 deviceId: %s" % session.device)
+
+    # id lệnh khác nhau mỗi lần chạy: CommandCache trên thiết bị nhớ id cũ
+    tag = "qos%d-" % (int(time.time()) % 100000)
+    checks = Checks()
+    retransmit(session, checks, tag)
+    dedupe(session, checks, tag)
+    oversized(session, checks, tag)
+    session = offline_queue(server, session, checks, tag, args.refuse, args.timeout)
+    if session:
+        session.close()
+    server.close()
+
+    print("\n%s %d lỗi" % ("❌" if checks.failures else "✅", checks.failures))
+    return 1 if checks.failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
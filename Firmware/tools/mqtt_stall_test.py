@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+Kiểm tra loop() không bị chặn khi broker MQTT chậm hoặc không tới được
+
+Cách dùng:
+    python tools/mqtt_stall_test.py 192.168.1.100                    # mọi kiểu broker, 60 s mỗi kiểu
+    python tools/mqtt_stall_test.py 192.168.1.100 --mode silent --duration 120
+    python tools/mqtt_stall_test.py 192.168.1.100 --mode blackhole   # MQTT_BROKER = IP không tồn tại
+
+ESP8266: đặt MQTT_BROKER = IP máy tính chạy script (secrets.h), MQTT_PORT = --port (TCP
+thường, không TLS), rồi khởi động lại thiết bị. Với --mode blackhole, đặt MQTT_BROKER là
+một IP trong mạng không có máy nào (SYN không ai trả lời); script chỉ đo, không nghe cổng.
+
+Kiểu broker giả:
+- silent : nhận TCP và CONNECT nhưng không bao giờ trả CONNACK (thiết bị chờ tới timeout)
+- slow   : trả CONNACK sau 3 s, từng byte cách nhau 1 s; sau đó hoạt động bình thường
+           10 s rồi đóng kết nối (thiết bị kết nối lại)
+- reset  : nhận TCP rồi đóng ngay
+- refuse : không nghe cổng (thiết bị nhận RST)
+- blackhole: không có gì trả lời (xem trên)
+
+Mỗi kiểu: POST /api/perf để reset số liệu đỉnh, để thiết bị thử kết nối trong --duration
+giây (đọc /api/state để chắc nó thật sự thử lại), rồi GET /api/perf. Mã thoát khác 0 nếu
+loop() chậm nhất vượt --max-loop-ms (mặc định 50 ms, bằng LOOP_STALL_WARN_MS) hoặc
+thiết bị không thử kết nối lần nào.
+
+Chỉ dùng thư viện chuẩn Python.
+"""
+
+import argparse
+import http.client
+import json
+import socket
+import sys
+import threading
+import time
+
+MODES = ["silent", "slow", "reset", "refuse", "blackhole"]
+CONNACK = bytes([0x20, 2, 0, 0])
+
+
+def request(host, port, method, path, body=None, timeout=5.0):
+    """Một request trên kết nối mới, trả về (status, body)"""
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        headers = {"Content-Type": "application/json"} if body is not None else {}
+        conn.request(method, path, body=body, headers=headers)
+        resp = conn.getresponse()
+        return resp.status, resp.read()
+    finally:
+        conn.close()
+
+
+def get_json(args, path):
+    try:
+        status, body = request(args.host, args.http_port, "GET", path, timeout=10.0)
+        return json.loads(body) if status == 200 else {}
+    except (OSError, ValueError):
+        return {}
+
+
+def answer(sock, data):
+    """Trả SUBACK / PUBACK / PINGRESP cho các gói trong data (đủ cho thiết bị chạy tiếp)"""
+    pos = 0
+    while pos + 2 <= len(data):
+        kind = data[pos] & 0xF0
+        length, mult, p = 0, 1, pos + 1
+        while p < len(data):
+            length += (data[p] & 0x7F) * mult
+            mult *= 128
+            p += 1
+            if not data[p - 1] & 0x80:
+                break
+        body = data[p:p + length]
+        if kind == 0x80 and len(body) >= 2:                 # SUBSCRIBE
+            sock.sendall(bytes([0x90, 3]) + body[0:2] + b"\x01")
+        elif kind == 0xA0 and len(body) >= 2:               # UNSUBSCRIBE
+            sock.sendall(bytes([0xB0, 2]) + body[0:2])
+        elif kind == 0xC0:                                  # PINGREQ
+            sock.sendall(bytes([0xD0, 0]))
+        elif kind == 0x30 and (data[pos] >> 1) & 0x03:      # PUBLISH QoS 1
+            n = int.from_bytes(body[0:2], "big")
+            sock.sendall(bytes([0x40, 2]) + body[2 + n:4 + n])
+        pos = p + length
+
+
+def serve_client(sock, mode, stop):
+    sock.settimeout(0.5)
+    try:
+        if mode == "reset":
+            return
+        start = time.monotonic()
+        sent = 0
+        until = None
+        while not stop.is_set():
+            try:
+                data = sock.recv(4096)
+                if not data:
+                    return
+            except socket.timeout:
+                data = b""
+            if mode == "slow":
+                elapsed = time.monotonic() - start
+                while sent < len(CONNACK) and elapsed >= 3 + sent:
+                    sock.sendall(CONNACK[sent:sent + 1])
+                    sent += 1
+                    if sent == len(CONNACK):
+                        until = time.monotonic() + 10
+                if sent == len(CONNACK) and data:
+                    answer(sock, data)
+                if until and time.monotonic() >= until:
+                    return
+    except OSError:
+        pass
+    finally:
+        sock.close()
+
+
+def broker(args, mode, stop):
+    """Broker giả cho một kiểu, chạy tới khi stop được set"""
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind((args.bind, args.port))
+    server.listen(4)
+    server.settimeout(0.5)
+    try:
+        while not stop.is_set():
+            try:
+                sock, _ = server.accept()
+            except socket.timeout:
+                continue
+            threading.Thread(target=serve_client, args=(sock, mode, stop), daemon=True).start()
+    finally:
+        server.close()
+
+
+def run_mode(args, mode):
+    print("\n🐢 Broker: %s (%.0f s)" % (mode, args.duration))
+    stop = threading.Event()
+    thread = None
+    if mode not in ("refuse", "blackhole"):
+        thread = threading.Thread(target=broker, args=(args, mode, stop), daemon=True)
+        thread.start()
+
+    before = get_json(args, "/api/state").get("mqtt", {}).get("reconnects", 0)
+    try:
+        request(args.host, args.http_port, "POST", "/api/perf", body="{}")
+    except OSError as e:
+        print("   ❌ Không kết nối được %s:%d (%s)" % (args.host, args.http_port, e))
+        stop.set()
+        return None
+
+    # Đọc /api/state đều đặn: web server cũng phải trả lời trong lúc đó
+    slowest = 0.0
+    end = time.monotonic() + args.duration
+    while time.monotonic() < end:
+        start = time.monotonic()
+        get_json(args, "/api/state")
+        slowest = max(slowest, (time.monotonic() - start) * 1000.0)
+        time.sleep(min(5.0, max(0.0, end - time.monotonic())))
+
+    perf = get_json(args, "/api/perf")
+    mqtt = get_json(args, "/api/state").get("mqtt", {})
+    stop.set()
+    if thread:
+        thread.join()
+
+    loop = perf.get("loop", {})
+    peak_ms = loop.get("peakUs", 0) / 1000.0
+    attempts = mqtt.get("reconnects", 0) - before
+    print("   MQTT: %s, %d lần thử kết nối lại" % (mqtt.get("state", "?"), attempts))
+    print("   loop() chậm nhất: %.1f ms, stall: %d / %d vòng; /api/state chậm nhất %.0f ms" % (
+        peak_ms, loop.get("stalls", 0), loop.get("iterations", 0), slowest))
+    ok = True
+    if not perf:
+        print("   ❌ Không đọc được /api/perf")
+        ok = False
+    if attempts <= 0 and mode != "slow":
+        print("   ❌ Thiết bị không thử kết nối lại (MQTT_BROKER / MQTT_PORT đúng chưa?)")
+        ok = False
+    if peak_ms > args.max_loop_ms:
+        print("   ❌ loop() bị chặn %.1f ms (> %.0f ms)" % (peak_ms, args.max_loop_ms))
+        ok = False
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TuoiCay MQTT connect stall test")
+    parser.add_argument("host", help="IP của ESP8266")
+    parser.add_argument("--http-port", type=int, default=80)
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=1883, help="cổng broker giả")
+    parser.add_argument("--mode", action="append", choices=MODES,
+                        help="lặp lại được (mặc định silent, slow, reset, refuse)")
+    parser.add_argument("--duration", type=float, default=60.0, help="giây mỗi kiểu")
+    parser.add_argument("--max-loop-ms", type=float, default=50.0)
+    args = parser.parse_args()
+    if not args.mode:
+        args.mode = ["silent", "slow", "reset", "refuse"]
+
+    failed = 0
+    for mode in args.mode:
+        ok = run_mode(args, mode)
+        if ok is None:
+            return 2
+        failed += 0 if ok else 1
+
+    if failed:
+        print("\n❌ %d / %d kiểu broker không đạt" % (failed, len(args.mode)))
+        return 1
+    print("\n✅ loop() luôn dưới %.0f ms khi kết nối MQTT" % args.max_loop_ms)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+Broker mosquitto TLS cục bộ để thử nghiệm MQTT 8883 với ESP8266
+
+Cách dùng:
+    python tools/mqtt_tls_broker.py 192.168.1.10     # IP máy tính chạy broker
+
+Script sẽ:
+1. Tạo CA + chứng chỉ broker (thư mục tls_test/, chỉ tạo lần đầu)
+2. Ghi data/mqtt_ca.pem và data/mqtt_fp.txt để nạp lên LittleFS
+3. Chạy mosquitto trên cổng 8883 (log chi tiết, thấy được session reuse)
+
+Yêu cầu: openssl và mosquitto có trong PATH
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+
+# Đường dẫn tính từ Firmware/, chạy từ thư mục nào cũng được
+FIRMWARE_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TLS_DIR = os.path.join(FIRMWARE_DIR, "tls_test")
+DATA_DIR = os.path.join(FIRMWARE_DIR, "data")
+
+
+def run(cmd):
+    """Chạy lệnh, dừng nếu lỗi"""
+    print("   $ " + " ".join(cmd))
+    subprocess.run(cmd, check=True)
+
+
+def make_certs(host):
+    """Tạo CA và chứng chỉ broker với SAN = IP máy tính"""
+    ca_key = os.path.join(TLS_DIR, "ca.key")
+    ca_crt = os.path.join(TLS_DIR, "ca.crt")
+    srv_key = os.path.join(TLS_DIR, "server.key")
+    srv_csr = os.path.join(TLS_DIR, "server.csr")
+    srv_crt = os.path.join(TLS_DIR, "server.crt")
+    ext = os.path.join(TLS_DIR, "san.ext")
+
+    if os.path.exists(srv_crt):
+        print("✅ Đã có chứng chỉ trong " + TLS_DIR)
+        return ca_crt, srv_crt, srv_key
+
+    os.makedirs(TLS_DIR, exist_ok=True)
+    print("🔐 Tạo CA và chứng chỉ broker...")
+
+    # EC P-256: handshake trên ESP8266 nhanh hơn RSA-2048 nhiều lần
+    run(["openssl", "ecparam", "-name", "prime256v1", "-genkey", "-noout", "-out", ca_key])
+    run(["openssl", "req", "-x509", "-new", "-key", ca_key, "-days", "3650",
+         "-subj", "/CN=TuoiCay Test CA", "-out", ca_crt])
+
+    run(["openssl", "ecparam", "-name", "prime256v1", "-genkey", "-noout", "-out", srv_key])
+    run(["openssl", "req", "-new", "-key", srv_key, "-subj", "/CN=" + host, "-out", srv_csr])
+
+    with open(ext, "w") as f:
+        f.write("subjectAltName=IP:%s\n" % host)
+    run(["openssl", "x509", "-req", "-in", srv_csr, "-CA", ca_crt, "-CAkey", ca_key,
+         "-CAcreateserial", "-days", "825", "-extfile", ext, "-out", srv_crt])
+
+    return ca_crt, srv_crt, srv_key
+
+
+def write_pins(ca_crt, srv_crt):
+    """Ghi CA và fingerprint vào data/ cho LittleFS"""
+    os.makedirs(DATA_DIR, exist_ok=True)
+    shutil.copy(ca_crt, os.path.join(DATA_DIR, "mqtt_ca.pem"))
+
+    out = subprocess.run(["openssl", "x509", "-in", srv_crt, "-noout", "-fingerprint", "-sha1"],
+                         capture_output=True, text=True, check=True).stdout
+    fingerprint = out.strip().split("=", 1)[1]
+    with open(os.path.join(DATA_DIR, "mqtt_fp.txt"), "w") as f:
+        f.write(fingerprint + "\n")
+
+    print("📁 data/mqtt_ca.pem, data/mqtt_fp.txt (%s)" % fingerprint)
+    print("   Nạp lên ESP8266: pio run -t uploadfs")
+
+
+def write_config(ca_crt, srv_crt, srv_key):
+    """Cấu hình mosquitto: chỉ listener 8883, cho phép anonymous"""
+    conf = os.path.join(TLS_DIR, "mosquitto.conf")
+    with open(conf, "w") as f:
+        f.write("listener 8883\n")
+        f.write("allow_anonymous true\n")
+        f.write("cafile %s\n" % os.path.abspath(ca_crt))
+        f.write("certfile %s\n" % os.path.abspath(srv_crt))
+        f.write("keyfile %s\n" % os.path.abspath(srv_key))
+        f.write("tls_version tlsv1.2\n")
+    return conf
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    host = sys.argv[1]
+    ca_crt, srv_crt, srv_key = make_certs(host)
+    write_pins(ca_crt, srv_crt)
+    conf = write_config(ca_crt, srv_crt, srv_key)
+
+    print("\n🚀 mosquitto TLS tại %s:8883 (Ctrl+C để dừng)" % host)
+    print("   ESP8266: đặt MQTT_BROKER \"%s\", MQTT_PORT 8883 trong secrets.h" % host)
+    print("   Kiểm tra: mosquitto_sub -h %s -p 8883 --cafile %s -t 'devices/#' -v\n"
+          % (host, ca_crt))
+    try:
+        subprocess.run(["mosquitto", "-c", conf, "-v"])
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
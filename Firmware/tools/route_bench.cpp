@@ -0,0 +1,203 @@
+/**
+ * @file route_bench.cpp
+ * @brief Host benchmark: HTTP route dispatch and request-body parse cost
+ *
+ * LOGIC:
+ * - Dispatch, per request:
+ *   - linear: method + String compare against every registered route, in
+ *     order (what one ESP8266WebServer::on() per route did)
+ *   - hashed: route_table.h lookup (one hash, one slot read, one strcmp)
+ * - Parse, per request:
+ *   - copy: body copied out of the server (arg("plain") String) and parsed
+ *     into a fresh heap-backed JsonDocument inside the handler
+ *   - shared: one JsonDocument backed by JsonArena, cleared and reused
+ * - Same request mix for both: dashboard polls, control POSTs, a 404
+ * - Also checks that every route is found and unknown paths are not
+ *
+ * BUILD (from Firmware/, after one `pio run` fetched ArduinoJson):
+ *   g++ -O2 -std=gnu++17 -I include -I lib/TuoiCay_Utils/src \
+ *       -I .pio/libdeps/nodemcuv2/ArduinoJson/src \
+ *       tools/route_bench.cpp -o route_bench && ./route_bench
+ *
+ * Host numbers are only relative: the ESP8266 at 80 MHz is roughly
+ * 30-50x slower, and heap allocation there also costs fragmentation.
+ *
+ * RULES: #HTTP(24) #PERF(15)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <ArduinoJson.h>
+#include <json_arena.h>
+#include <route_table.h>
+
+//=============================================================================
+// ROUTES (keep in sync with WebServerManager::ROUTES)
+//=============================================================================
+
+struct BenchRoute {
+    const char* path;
+    bool post;
+};
+
+static constexpr BenchRoute ROUTES[] = {
+    { "/",              false },
+    { "/api/status",    false },
+    { "/api/state",     false },
+    { "/api/events",    false },
+    { "/api/perf",      false },
+    { "/api/perf",      true  },
+    { "/api/pump",      true  },
+    { "/api/mode",      true  },
+    { "/api/config",    true  },
+    { "/api/speed",     false },
+    { "/api/speed",     true  },
+    { "/api/schedule",  false },
+    { "/api/schedule",  true  },
+    { "/api/batch",     true  },
+    { "/metrics",       false },
+    { "/api/budget",    false },
+    { "/api/jobs",      false },
+    { "/api/time",      true  },
+};
+
+static constexpr size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+static constexpr RouteSlots ROUTE_INDEX = buildRouteSlots(ROUTES);
+static_assert(ROUTE_INDEX.perfect, "Route hash collision: change WEB_ROUTE_HASH_SEED");
+
+//=============================================================================
+// REQUEST MIX
+//=============================================================================
+
+struct BenchRequest {
+    const char* path;
+    bool post;
+    const char* body;       // nullptr = no body
+};
+
+static const BenchRequest REQUESTS[] = {
+    { "/api/state",     false, nullptr },
+    { "/api/state",     false, nullptr },
+    { "/api/state",     false, nullptr },
+    { "/api/status",    false, nullptr },
+    { "/api/pump",      true,  "{\"action\":\"toggle\"}" },
+    { "/api/config",    true,  "{\"threshold_dry\":30,\"threshold_wet\":60}" },
+    { "/api/speed",     true,  "{\"speed\":80}" },
+    { "/api/schedule",  true,  "{\"schedules\":["
+                               "{\"hour\":6,\"minute\":0,\"duration\":30,\"enabled\":true},"
+                               "{\"hour\":18,\"minute\":0,\"duration\":30,\"enabled\":true},"
+                               "{\"hour\":12,\"minute\":0,\"duration\":30,\"enabled\":false},"
+                               "{\"hour\":0,\"minute\":0,\"duration\":30,\"enabled\":false}]}" },
+    { "/api/batch",     true,  "{\"ops\":["
+                               "{\"op\":\"thresholds\",\"dry\":30,\"wet\":60},"
+                               "{\"op\":\"mode\",\"mode\":\"auto\"},"
+                               "{\"op\":\"calibration\",\"sensor\":1,\"dry\":1010,\"wet\":320}]}" },
+    { "/favicon.ico",   false, nullptr },
+};
+
+static const size_t REQUEST_COUNT = sizeof(REQUESTS) / sizeof(REQUESTS[0]);
+static const long ITERATIONS = 200000;
+
+static volatile long sink;      // Keeps results observable to the optimizer
+
+//=============================================================================
+// DISPATCH
+//=============================================================================
+
+static int linearLookup(const std::vector<std::string>& paths, const std::string& uri, bool post) {
+    for (size_t i = 0; i < ROUTE_COUNT; i++) {
+        if (ROUTES[i].post == post && paths[i] == uri) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static bool checkLookup() {
+    bool ok = true;
+    for (size_t i = 0; i < ROUTE_COUNT; i++) {
+        if (findRoute(ROUTE_INDEX, ROUTES, ROUTES[i].path, ROUTES[i].post) != (int)i) {
+            printf("   ❌ %s %s không tìm thấy\n", ROUTES[i].post ? "POST" : "GET", ROUTES[i].path);
+            ok = false;
+        }
+    }
+    const char* unknown[] = { "/favicon.ico", "/api", "/api/statu", "/api/status/", "" };
+    for (const char* path : unknown) {
+        if (findRoute(ROUTE_INDEX, ROUTES, path, false) >= 0 ||
+            findRoute(ROUTE_INDEX, ROUTES, path, true) >= 0) {
+            printf("   ❌ '%s' khớp nhầm\n", path);
+            ok = false;
+        }
+    }
+    if (findRoute(ROUTE_INDEX, ROUTES, "/api/pump", false) >= 0) {
+        printf("   ❌ GET /api/pump khớp nhầm\n");
+        ok = false;
+    }
+    return ok;
+}
+
+template <typename F>
+static double nsPerRequest(F fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (long n = 0; n < ITERATIONS; n++) {
+        fn(REQUESTS[n % REQUEST_COUNT]);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+
+int main() {
+    printf("🔎 Kiểm tra bảng route (%zu route, %u slot)\n", ROUTE_COUNT, (unsigned)ROUTE_SLOTS);
+    if (!checkLookup()) {
+        return 1;
+    }
+    printf("   ✅ Mọi route đều tìm thấy, đường dẫn lạ trả về 404\n");
+
+    // Server hands the URI over as a String
+    std::vector<std::string> paths;
+    for (const BenchRoute& r : ROUTES) {
+        paths.push_back(r.path);
+    }
+
+    double linear = nsPerRequest([&](const BenchRequest& req) {
+        std::string uri(req.path);
+        sink += linearLookup(paths, uri, req.post);
+    });
+    double hashed = nsPerRequest([&](const BenchRequest& req) {
+        sink += findRoute(ROUTE_INDEX, ROUTES, req.path, req.post);
+    });
+
+    double copyParse = nsPerRequest([&](const BenchRequest& req) {
+        if (req.body) {
+            std::string body(req.body);         // arg("plain") copy
+            JsonDocument doc;                   // Heap-backed, per handler
+            sink += (long)deserializeJson(doc, body).code() + (long)doc.size();
+        }
+    });
+
+    static JsonArena<WEB_JSON_ARENA_SIZE> arena;
+    JsonDocument shared(&arena);
+    double sharedParse = nsPerRequest([&](const BenchRequest& req) {
+        shared.clear();
+        arena.reset();
+        if (req.body) {
+            sink += (long)deserializeJson(shared, req.body, strlen(req.body)).code() + (long)shared.size();
+        }
+    });
+
+    printf("\n📊 Chi phí mỗi request (ns, trung bình %ld request)\n", ITERATIONS);
+    printf("   Dispatch tuyến tính : %8.1f\n", linear);
+    printf("   Dispatch hash       : %8.1f  (x%.1f)\n", hashed, linear / hashed);
+    printf("   Parse copy + doc mới: %8.1f\n", copyParse);
+    printf("   Parse doc dùng chung: %8.1f  (x%.1f)\n", sharedParse, copyParse / sharedParse);
+    printf("   Arena đỉnh          : %zu / %u byte\n", arena.peak(), (unsigned)WEB_JSON_ARENA_SIZE);
+
+    return 0;
+}
@@ -0,0 +1,600 @@
+/**
+ * @file schedule_sim.cpp
+ * @brief Host checks: schedule plan (schedule_plan.h) driven by a fake clock
+ *
+ * LOGIC:
+ * - The clock is a plain time_t handed to SchedulePlan::poll(), moved in
+ *   steps like loop() would see it, or jumped like an NTP resync does
+ * - Reboot = new SchedulePlan restored from the saved lastRun array
+ * - Each scenario checks which slots ran (entry, epoch) and how many
+ *   were reported missed; local time is UTC+7 like the device (TZ)
+ * - DST scenarios switch TZ to POSIX rules with transitions (Europe,
+ *   Australia) and name expected instants in UTC, since the wall times
+ *   around a transition are ambiguous or do not exist
+ * - posix_tz.h validator: accepted and rejected TZ strings
+ * - http_date.h: Date headers against timegm() values, time host strings
+ * - sun_calc.h: sunrise / sunset against almanac times (local, +-1 min)
+ *   for sites from the equator to the polar circle, polar day / night,
+ *   and sun entries planned through it. Reference times come from a
+ *   double-precision NOAA / Meeus calculation (apparent sun, h0 = -0.833
+ *   deg), which agrees with published almanacs to the minute
+ * - irrigation_queue.h: priorities, preemption with resume, FIFO, auto
+ *   never waiting, duplicates, cancel per source and expiry, on a fake
+ *   millis() value
+ *
+ * BUILD (from Firmware/):
+ *   g++ -O2 -std=gnu++17 -I include -I lib/TuoiCay_Utils/src \
+ *       tools/schedule_sim.cpp -o schedule_sim && ./schedule_sim
+ *
+ * RULES: #TIME(12)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <http_date.h>
+#include <irrigation_queue.h>
+#include <posix_tz.h>
+#include <schedule_plan.h>
+#include <sun_calc.h>
+
+//=============================================================================
+// FAKE DEVICE
+//=============================================================================
+
+struct Run {
+    uint8_t index;
+    time_t due;
+};
+
+/**
+ * @brief Local time -> epoch (TZ of the simulated device)
+ */
+static time_t at(int year, int month, int day, int hour, int minute, int second = 0) {
+    struct tm t = {};
+    t.tm_year = year - 1900;
+    t.tm_mon = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    t.tm_sec = second;
+    t.tm_isdst = -1;
+    return mktime(&t);
+}
+
+/**
+ * @brief UTC wall time -> epoch
+ */
+static time_t utc(int year, int month, int day, int hour, int minute) {
+    struct tm t = {};
+    t.tm_year = year - 1900;
+    t.tm_mon = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    return timegm(&t);
+}
+
+static void useTz(const char* tz) {
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+static ScheduleEntry daily(uint8_t hour, uint8_t minute, CatchUpPolicy policy = CatchUpPolicy::SKIP,
+                           uint16_t windowMin = 0) {
+    ScheduleEntry e;
+    e.setDefaults();
+    e.hour = hour;
+    e.minute = minute;
+    e.catchUp = policy;
+    e.windowMin = windowMin;
+    e.enabled = true;
+    return e;
+}
+
+/**
+ * @brief Scheduler stand-in: entries, plan, flash copy of the history
+ */
+struct Device {
+    ScheduleEntry entries[MAX_SCHEDULE_ENTRIES];
+    uint8_t count = 0;
+    SchedulePlan plan;
+    time_t flash[MAX_SCHEDULE_ENTRIES] = {};
+    std::vector<Run> runs;
+    int missed = 0;         // MISSED events + slots given up while planning
+
+    void add(const ScheduleEntry& e) {
+        entries[count++] = e;
+        plan.attach(entries, count);
+    }
+
+    void poll(time_t now) {
+        ScheduleRun run;
+        ScheduleEvent event;
+        while ((event = plan.poll(now, run)) != ScheduleEvent::NONE) {
+            if (event == ScheduleEvent::RUN) {
+                runs.push_back({ run.index, run.due });
+            } else if (event == ScheduleEvent::MISSED) {
+                missed++;
+            } else {
+                missed += run.index;
+            }
+        }
+        if (plan.takeDirty()) {
+            memcpy(flash, plan.lastRuns(), sizeof(flash));
+        }
+    }
+
+    /**
+     * @brief Clock running normally from..to (inclusive) in steps
+     */
+    void run(time_t from, time_t to, time_t step = 1) {
+        for (time_t t = from; t <= to; t += step) {
+            poll(t);
+        }
+    }
+
+    /**
+     * @brief Power cycle: RAM lost, history restored from flash
+     */
+    void reboot() {
+        plan = SchedulePlan();
+        plan.attach(entries, count);
+        plan.setLastRuns(flash, MAX_SCHEDULE_ENTRIES);
+    }
+};
+
+//=============================================================================
+// CHECKS
+//=============================================================================
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what) {
+    printf("   %s %s\n", ok ? "✅" : "❌", what);
+    if (!ok) failures++;
+}
+
+static bool ranAt(const Device& d, std::initializer_list<time_t> slots) {
+    if (d.runs.size() != slots.size()) return false;
+    size_t i = 0;
+    for (time_t slot : slots) {
+        if (d.runs[i++].due != slot) return false;
+    }
+    return true;
+}
+
+static void onTime() {
+    printf("\n⏰ Chạy đúng giờ\n");
+    Device d;
+    d.add(daily(6, 0));
+    d.run(at(2026, 3, 10, 5, 58), at(2026, 3, 10, 6, 2));
+    expect(ranAt(d, { at(2026, 3, 10, 6, 0) }), "06:00 chạy đúng một lần");
+
+    d.run(at(2026, 3, 10, 6, 2), at(2026, 3, 12, 6, 30), 7);
+    expect(d.runs.size() == 3, "3 ngày liên tiếp: 3 lần");
+    expect(d.plan.nextEpoch() == at(2026, 3, 13, 6, 0), "Lần kế tiếp là 06:00 hôm sau");
+
+    ScheduleRun run;
+    expect(d.plan.poll(at(2026, 3, 12, 7, 0), run) == ScheduleEvent::NONE, "Chưa tới giờ: poll() trả NONE");
+}
+
+static void rebootPolicies() {
+    printf("\n🔌 Khởi động lại lúc 06:20, lịch 06:00 bị lỡ\n");
+    struct Case {
+        CatchUpPolicy policy;
+        uint16_t window;
+        bool runs;
+        const char* what;
+    };
+    const Case cases[] = {
+        { CatchUpPolicy::SKIP,   0,  false, "skip: bỏ qua" },
+        { CatchUpPolicy::WITHIN, 30, true,  "within 30 phút: chạy bù" },
+        { CatchUpPolicy::WITHIN, 10, false, "within 10 phút: bỏ qua" },
+        { CatchUpPolicy::ALWAYS, 0,  true,  "always: chạy bù" },
+    };
+    for (const Case& c : cases) {
+        Device d;
+        d.add(daily(6, 0, c.policy, c.window));
+        d.run(at(2026, 3, 9, 5, 0), at(2026, 3, 9, 6, 5), 30);    // Ran yesterday
+        d.reboot();
+        d.runs.clear();
+        d.run(at(2026, 3, 10, 6, 20), at(2026, 3, 10, 8, 0), 10);
+        bool ok = c.runs ? ranAt(d, { at(2026, 3, 10, 6, 0) }) : d.runs.empty() && d.missed == 1;
+        expect(ok, c.what);
+    }
+}
+
+static void longOutage() {
+    printf("\n🪫 Mất điện 4 ngày, policy always\n");
+    Device d;
+    d.add(daily(6, 0, CatchUpPolicy::ALWAYS));
+    d.run(at(2026, 3, 1, 5, 59), at(2026, 3, 1, 6, 1));
+    d.reboot();
+    d.runs.clear();
+    d.run(at(2026, 3, 5, 12, 0), at(2026, 3, 5, 13, 0), 5);
+    expect(ranAt(d, { at(2026, 3, 5, 6, 0) }), "Chỉ chạy bù một lần (lịch mới nhất)");
+    expect(d.missed == 1, "Các lịch cũ hơn được báo bỏ qua");
+
+    printf("\n🔁 Mỗi giờ, within 90 phút, khởi động lại lúc 10:30\n");
+    Device h;
+    ScheduleEntry hourly = daily(6, 0, CatchUpPolicy::WITHIN, 90);
+    hourly.kind = ScheduleKind::INTERVAL;
+    hourly.everyHours = 1;
+    h.add(hourly);
+    h.run(at(2026, 3, 10, 5, 59), at(2026, 3, 10, 6, 1));
+    h.reboot();
+    h.runs.clear();
+    h.run(at(2026, 3, 10, 10, 30), at(2026, 3, 10, 11, 5), 10);
+    expect(ranAt(h, { at(2026, 3, 10, 10, 0), at(2026, 3, 10, 11, 0) }),
+           "Chạy bù 10:00 (mới nhất), rồi 11:00 đúng giờ");
+}
+
+static void firstSync() {
+    printf("\n🆕 Lịch mới, chưa có lịch sử\n");
+    Device d;
+    d.add(daily(6, 0, CatchUpPolicy::ALWAYS));
+    d.run(at(2026, 3, 10, 9, 0), at(2026, 3, 10, 10, 0), 10);
+    expect(d.runs.empty(), "Không chạy bù lịch trước khi mục được tạo");
+    expect(d.flash[0] != 0, "Mốc bắt đầu được lưu flash");
+}
+
+static void clockBack() {
+    printf("\n⏪ NTP kéo đồng hồ lùi sau khi vừa tưới\n");
+    Device d;
+    d.add(daily(6, 0));
+    d.run(at(2026, 3, 10, 5, 59, 50), at(2026, 3, 10, 6, 0, 5));
+    d.run(at(2026, 3, 10, 5, 59, 58), at(2026, 3, 10, 6, 1));         // -7 s
+    d.run(at(2026, 3, 10, 5, 50), at(2026, 3, 10, 6, 5), 3);          // -11 min
+    expect(ranAt(d, { at(2026, 3, 10, 6, 0) }), "Không tưới lần hai");
+
+    d.reboot();
+    d.run(at(2026, 3, 10, 5, 0), at(2026, 3, 10, 6, 30), 20);         // Reboot, clock behind
+    expect(d.runs.size() == 1, "Khởi động lại với đồng hồ lùi: vẫn một lần");
+}
+
+static void clockForward() {
+    printf("\n⏩ NTP kéo đồng hồ tới 05:00 -> 09:00\n");
+    struct Case {
+        CatchUpPolicy policy;
+        uint16_t window;
+        size_t runs;
+        const char* what;
+    };
+    const Case cases[] = {
+        { CatchUpPolicy::SKIP,   0,   0, "skip: bỏ qua, báo lỡ" },
+        { CatchUpPolicy::WITHIN, 60,  0, "within 60 phút: bỏ qua" },
+        { CatchUpPolicy::WITHIN, 240, 1, "within 240 phút: chạy bù" },
+        { CatchUpPolicy::ALWAYS, 0,   1, "always: chạy bù" },
+    };
+    for (const Case& c : cases) {
+        Device d;
+        d.add(daily(6, 0, c.policy, c.window));
+        d.run(at(2026, 3, 10, 4, 0), at(2026, 3, 10, 5, 0), 10);
+        d.run(at(2026, 3, 10, 9, 0), at(2026, 3, 10, 10, 0), 10);
+        bool ok = d.runs.size() == c.runs && (c.runs > 0 || d.missed == 1);
+        expect(ok, c.what);
+    }
+}
+
+static void intervalsAndDays() {
+    printf("\n📅 Chu kỳ, thứ trong tuần, khoảng ngày\n");
+    Device d;
+    ScheduleEntry every = daily(8, 0);
+    every.kind = ScheduleKind::INTERVAL;
+    every.everyHours = 4;                           // 08, 12, 16, 20
+    every.days = (1 << 1) | (1 << 3) | (1 << 5);    // Mon, Wed, Fri
+    d.add(every);
+    d.run(at(2026, 3, 9, 0, 0), at(2026, 3, 15, 23, 59), 30);         // Mon..Sun
+    expect(d.runs.size() == 12, "T2/T4/T6 mỗi 4 giờ từ 08:00: 12 lần/tuần");
+    expect(d.runs.size() > 3 && d.runs[3].due == at(2026, 3, 9, 20, 0), "Lần cuối trong ngày 20:00");
+
+    ScheduleEntry winter = daily(7, 0);
+    winter.from = 1101;
+    winter.to = 228;
+    expect(SchedulePlan::nextAfter(winter, at(2026, 3, 10, 0, 0), nullptr) == at(2026, 11, 1, 7, 0),
+           "Khoảng 1101-0228: tháng 3 -> 1/11");
+    expect(SchedulePlan::nextAfter(winter, at(2026, 12, 31, 8, 0), nullptr) == at(2027, 1, 1, 7, 0),
+           "Khoảng vắt qua năm mới");
+
+    ScheduleEntry sun = daily(0, 0);
+    sun.kind = ScheduleKind::SUNRISE;
+    expect(SchedulePlan::nextAfter(sun, at(2026, 3, 10, 0, 0), nullptr) == SCHEDULE_NEVER,
+           "Mục mặt trời không có nguồn giờ mọc: nằm chờ");
+}
+
+static void dstTransitions() {
+    printf("\n🕑 Đổi giờ mùa hè / mùa đông (CET-1CEST,M3.5.0,M10.5.0/3)\n");
+    useTz("CET-1CEST,M3.5.0,M10.5.0/3");
+
+    // 29/3/2026 02:00 CET -> 03:00 CEST: 02:30 does not exist that day
+    Device spring;
+    spring.add(daily(2, 30));
+    spring.run(utc(2026, 3, 27, 23, 0), utc(2026, 3, 30, 3, 0), 20);
+    expect(ranAt(spring, { utc(2026, 3, 28, 1, 30), utc(2026, 3, 29, 1, 30), utc(2026, 3, 30, 0, 30) }),
+           "02:30 rơi vào giờ bị bỏ: chạy lúc 03:30 CEST, một lần");
+
+    // 25/10/2026 03:00 CEST -> 02:00 CET: 02:30 happens twice
+    Device fall;
+    fall.add(daily(2, 30));
+    fall.run(utc(2026, 10, 23, 22, 0), utc(2026, 10, 26, 3, 0), 20);
+    expect(ranAt(fall, { utc(2026, 10, 24, 0, 30), utc(2026, 10, 25, 0, 30), utc(2026, 10, 26, 1, 30) }),
+           "02:30 lặp lại: chỉ chạy lần đầu (CEST)");
+    expect(SchedulePlan::nextAfter(daily(2, 30), utc(2026, 10, 25, 0, 30), nullptr) == utc(2026, 10, 26, 1, 30),
+           "Sau lần đầu, lần kế tiếp là hôm sau (không chạy lại lúc 02:30 CET)");
+
+    ScheduleEntry hourly = daily(0, 0);
+    hourly.kind = ScheduleKind::INTERVAL;
+    hourly.everyHours = 1;
+
+    Device shortDay;
+    shortDay.add(hourly);
+    shortDay.run(utc(2026, 3, 28, 22, 59), utc(2026, 3, 29, 21, 59), 30);
+    expect(shortDay.runs.size() == 23, "Mỗi giờ, ngày 23 giờ: 23 lần");
+
+    Device longDay;
+    longDay.add(hourly);
+    longDay.run(utc(2026, 10, 24, 21, 59), utc(2026, 10, 25, 22, 59), 30);
+    bool spaced = true;
+    for (size_t i = 1; i < longDay.runs.size(); i++) {
+        spaced = spaced && longDay.runs[i].due - longDay.runs[i - 1].due >= 3600;
+    }
+    expect(longDay.runs.size() == 24 && spaced, "Mỗi giờ, ngày 25 giờ: 24 lần, không lần nào sát nhau");
+
+    printf("\n🦘 Nam bán cầu (AEST-10AEDT,M10.1.0,M4.1.0/3)\n");
+    useTz("AEST-10AEDT,M10.1.0,M4.1.0/3");
+    expect(SchedulePlan::nextAfter(daily(2, 30), utc(2026, 4, 4, 12, 0), nullptr) == utc(2026, 4, 4, 15, 30),
+           "5/4 02:30 lặp lại: lần đầu (AEDT)");
+    expect(SchedulePlan::nextAfter(daily(2, 30), utc(2026, 4, 4, 15, 30), nullptr) == utc(2026, 4, 5, 16, 30),
+           "Rồi 6/4 02:30 AEST");
+    expect(SchedulePlan::nextAfter(daily(2, 30), utc(2026, 10, 3, 12, 0), nullptr) == utc(2026, 10, 3, 16, 30),
+           "4/10 02:30 không tồn tại: 03:30 AEDT");
+
+    useTz("ICT-7");
+}
+
+static void tzStrings() {
+    printf("\n🌐 Kiểm tra chuỗi TZ\n");
+    const char* valid[] = {
+        "ICT-7", "<+07>-7", "UTC0", "CET-1CEST,M3.5.0,M10.5.0/3", "AEST-10AEDT,M10.1.0,M4.1.0/3",
+        "EST5EDT,M3.2.0/2,M11.1.0/2", "IST-5:30", "<-03>3", "NZST-12NZDT,M9.5.0,M4.1.0/3",
+        "EST5EDT", "WART4WARST,J1/0,J365/25",
+    };
+    const char* invalid[] = {
+        "", "Asia/Ho_Chi_Minh", "ICT", "IC-7", "ICT+25", "CET-1CEST,M13.5.0,M10.5.0",
+        "CET-1CEST,M3.6.0,M10.5.0", "CET-1CEST,M3.5.7,M10.5.0", "CET-1CEST,M3.5.0", "<+7>-7",
+        "CET-1CEST,M3.5.0,M10.5.0/3x", "UTC0 ",
+    };
+    bool ok = true;
+    for (const char* tz : valid) {
+        if (!posixTzValid(tz, 47)) {
+            printf("   ❌ '%s' bị từ chối\n", tz);
+            ok = false;
+        }
+    }
+    for (const char* tz : invalid) {
+        if (posixTzValid(tz, 47)) {
+            printf("   ❌ '%s' được chấp nhận\n", tz);
+            ok = false;
+        }
+    }
+    expect(ok, "Chuỗi hợp lệ được nhận, chuỗi sai bị từ chối");
+    expect(!posixTzValid("CET-1CEST,M3.5.0,M10.5.0/3", 20), "Quá dài bị từ chối");
+}
+
+static void httpDates() {
+    printf("\n🕒 Kiểm tra HTTP Date / máy chủ giờ\n");
+    struct { const char* s; int64_t epoch; } good[] = {
+        { "Thu, 01 Jan 1970 00:00:00 GMT", 0 },
+        { "Sun, 06 Nov 1994 08:49:37 GMT", 784111777 },
+        { " Sat, 29 Feb 2020 23:59:59 GMT", 1583020799 },
+        { "Sun, 18 Oct 2026 05:30:00 GMT", 1792301400 },
+    };
+    const char* bad[] = {
+        "", "Sunday, 06-Nov-94 08:49:37 GMT", "Sun Nov  6 08:49:37 1994",
+        "Sun, 06 Nov 1994 08:49:37 UTC", "Sun, 6 Nov 1994 08:49:37 GMT",
+        "Sun, 06 Nv 1994 08:49:37 GMT", "Sun, 06 Nov 1994 24:00:00 GMT",
+        "Sun, 00 Nov 1994 08:49:37 GMT", "Sun, 06 Nov 1994 08:49",
+    };
+    bool ok = true;
+    for (const auto& g : good) {
+        int64_t epoch = -1;
+        if (!httpDateParse(g.s, epoch) || epoch != g.epoch) {
+            printf("   ❌ '%s' -> %lld\n", g.s, (long long)epoch);
+            ok = false;
+        }
+    }
+    for (const char* s : bad) {
+        int64_t epoch;
+        if (httpDateParse(s, epoch)) {
+            printf("   ❌ '%s' được chấp nhận\n", s);
+            ok = false;
+        }
+    }
+    expect(ok, "Date đúng được đọc, dạng khác bị từ chối");
+
+    uint16_t port;
+    size_t nameLen;
+    expect(httpHostValid("", 47, port, nameLen) && nameLen == 0, "Rỗng = tắt");
+    expect(httpHostValid("192.168.1.1", 47, port, nameLen) && port == 80 && nameLen == 11,
+           "IP, cổng mặc định 80");
+    expect(httpHostValid("nas.local:8080", 47, port, nameLen) && port == 8080 && nameLen == 9,
+           "Tên:cổng");
+    expect(!httpHostValid("nas:0", 47, port, nameLen) && !httpHostValid("nas:65536", 47, port, nameLen) &&
+           !httpHostValid(":80", 47, port, nameLen) && !httpHostValid("nas:", 47, port, nameLen) &&
+           !httpHostValid("http://nas", 47, port, nameLen) && !httpHostValid("nas/x", 47, port, nameLen),
+           "Cổng sai, URL, ký tự lạ bị từ chối");
+    expect(!httpHostValid("router.example.com:80", 10, port, nameLen), "Quá dài bị từ chối");
+}
+
+static int32_t sunLatE4;
+static int32_t sunLonE4;
+
+/**
+ * @brief ScheduleSunFunc over sun_calc.h, like TimeManager::sunTimes()
+ */
+static bool sunAt(uint16_t year, uint8_t month, uint8_t day, int16_t* sunriseMin, int16_t* sunsetMin) {
+    int64_t rise, set;
+    if (!sunTimes(year, month, day, sunLatE4, sunLonE4, rise, set)) return false;
+    *sunriseMin = sunLocalMinute(rise, day);
+    *sunsetMin = sunLocalMinute(set, day);
+    return true;
+}
+
+static void sunTimesCheck() {
+    printf("\n☀️  Kiểm tra giờ mặt trời mọc / lặn\n");
+    struct {
+        const char* site;
+        const char* tz;
+        int year, month, day;
+        int32_t latE4, lonE4;
+        int rise, set;              // Local minutes; 24:04 = past midnight
+    } almanac[] = {
+        { "Ho Chi Minh", "ICT-7", 2026, 3, 20, 107769, 1067009, 5 * 60 + 58, 18 * 60 + 4 },
+        { "Ho Chi Minh", "ICT-7", 2026, 6, 21, 107769, 1067009, 5 * 60 + 32, 18 * 60 + 18 },
+        { "Ho Chi Minh", "ICT-7", 2026, 12, 21, 107769, 1067009, 6 * 60 + 6, 17 * 60 + 36 },
+        { "Ha Noi", "ICT-7", 2026, 1, 15, 210285, 1058542, 6 * 60 + 36, 17 * 60 + 36 },
+        { "Ha Noi", "ICT-7", 2026, 7, 1, 210285, 1058542, 5 * 60 + 19, 18 * 60 + 42 },
+        { "Berlin", "CET-1CEST,M3.5.0,M10.5.0/3", 2026, 3, 29, 525200, 134050, 6 * 60 + 48, 19 * 60 + 35 },
+        { "Berlin", "CET-1CEST,M3.5.0,M10.5.0/3", 2026, 6, 21, 525200, 134050, 4 * 60 + 43, 21 * 60 + 33 },
+        { "Berlin", "CET-1CEST,M3.5.0,M10.5.0/3", 2026, 12, 21, 525200, 134050, 8 * 60 + 15, 15 * 60 + 54 },
+        { "Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3", 2026, 1, 15, -338688, 1512093, 6 * 60 + 0, 20 * 60 + 9 },
+        { "Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3", 2026, 4, 5, -338688, 1512093, 6 * 60 + 10, 17 * 60 + 45 },
+        { "Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3", 2026, 7, 15, -338688, 1512093, 6 * 60 + 58, 17 * 60 + 4 },
+        { "New York", "EST5EDT,M3.2.0,M11.1.0", 2026, 3, 8, 407128, -740060, 7 * 60 + 19, 18 * 60 + 55 },
+        { "New York", "EST5EDT,M3.2.0,M11.1.0", 2026, 11, 1, 407128, -740060, 6 * 60 + 26, 16 * 60 + 52 },
+        { "Quito", "<-05>5", 2026, 9, 23, -1807, -784678, 6 * 60 + 3, 18 * 60 + 9 },
+        { "Reykjavik", "GMT0", 2026, 6, 21, 641466, -219426, 2 * 60 + 55, 24 * 60 + 4 },
+        { "Reykjavik", "GMT0", 2026, 12, 21, 641466, -219426, 11 * 60 + 22, 15 * 60 + 29 },
+        { "Tromso", "CET-1CEST,M3.5.0,M10.5.0/3", 2026, 3, 1, 696492, 189553, 7 * 60 + 10, 16 * 60 + 45 },
+    };
+    bool ok = true;
+    for (const auto& a : almanac) {
+        useTz(a.tz);
+        sunLatE4 = a.latE4;
+        sunLonE4 = a.lonE4;
+        int16_t rise = 0, set = 0;
+        bool up = sunAt(a.year, a.month, a.day, &rise, &set);
+        if (!up || abs(rise - a.rise) > 1 || abs(set - a.set) > 1) {
+            printf("   ❌ %s %04d-%02d-%02d: %d / %d phút, lịch %d / %d\n", a.site, a.year, a.month,
+                   a.day, rise, set, a.rise, a.set);
+            ok = false;
+        }
+    }
+    expect(ok, "Lệch lịch thiên văn không quá 1 phút (xích đạo tới vòng cực, giờ mùa hè)");
+
+    int64_t rise, set;
+    expect(!sunTimes(2026, 6, 21, 696492, 189553, rise, set) &&
+           !sunTimes(2026, 12, 21, 696492, 189553, rise, set),
+           "Tromsø ngày / đêm địa cực: không có giờ mọc / lặn");
+
+    int32_t latE4, lonE4;
+    expect(sunLocationFromDegrees(-33.86885, 151.20935, latE4, lonE4) && latE4 == -338689 &&
+           lonE4 == 1512094 && !sunLocationFromDegrees(90.5, 0, latE4, lonE4) &&
+           !sunLocationFromDegrees(0, -180.01, latE4, lonE4),
+           "Độ -> 1e-4 độ, ngoài khoảng bị từ chối");
+
+    // Planned through the plan, like the device does
+    ScheduleEntry morning = daily(0, 0);
+    morning.kind = ScheduleKind::SUNRISE;
+    morning.offsetMin = 15;
+    useTz("ICT-7");
+    sunLatE4 = 107769;
+    sunLonE4 = 1067009;
+    expect(SchedulePlan::nextAfter(morning, at(2026, 3, 20, 0, 0), sunAt) == at(2026, 3, 20, 6, 13),
+           "Mọc + 15 phút ở TP.HCM: 06:13");
+
+    ScheduleEntry evening = daily(0, 0);
+    evening.kind = ScheduleKind::SUNSET;
+    evening.offsetMin = -30;
+    useTz("GMT0");
+    sunLatE4 = 641466;
+    sunLonE4 = -219426;
+    expect(SchedulePlan::nextAfter(evening, at(2026, 6, 21, 12, 0), sunAt) == at(2026, 6, 21, 23, 34),
+           "Lặn sau nửa đêm (Reykjavik), lặn - 30 phút vẫn là 23:34 hôm đó");
+    useTz("ICT-7");
+}
+
+static bool activeIs(const IrrigationQueue& q, IrrigationSource source, uint8_t entry) {
+    return q.hasActive() && q.active().source == source && q.active().entry == entry;
+}
+
+static void irrigationJobs() {
+    printf("\n🚿 Kiểm tra hàng đợi tưới\n");
+    const IrrigationSource MANUAL = IrrigationSource::MANUAL;
+    const IrrigationSource AUTO = IrrigationSource::AUTO;
+    const IrrigationSource SCHEDULE = IrrigationSource::SCHEDULE;
+    const uint8_t NO = IRRIGATION_NO_ENTRY;
+    uint8_t expired;
+
+    // Preemption: a schedule run resumes with what it had left
+    IrrigationQueue q;
+    expect(q.submit(SCHEDULE, 300, 0, 0) == IrrigationVerdict::STARTED, "Lịch #0 chạy ngay");
+    expect(q.submit(SCHEDULE, 300, 0, 5000) == IrrigationVerdict::DUPLICATE, "Lịch #0 lần hai: trùng");
+    expect(q.submit(SCHEDULE, 120, 1, 10000) == IrrigationVerdict::QUEUED, "Lịch #1 chờ sau #0");
+    expect(q.submit(MANUAL, 0, NO, 100000) == IrrigationVerdict::PREEMPTED, "Thủ công chen ngang lịch");
+    expect(q.waitingCount() == 2 && q.waiting(0).entry == 0 && q.waiting(0).doneSec == 100 &&
+           q.waiting(0).runSec() == 200 && q.waiting(1).entry == 1,
+           "Lịch #0 về đầu hàng với 200 s còn lại, #1 vẫn sau nó");
+    expect(q.submit(AUTO, 0, NO, 110000) == IrrigationVerdict::BUSY, "Tự động không chờ");
+    expect(q.submit(MANUAL, 0, NO, 120000) == IrrigationVerdict::DUPLICATE, "Thủ công lần hai: trùng");
+    expect(!q.due(1000000), "Thủ công không thời hạn: không tự hết");
+
+    expect(q.next(130000, expired) && activeIs(q, SCHEDULE, 0) && q.active().runSec() == 200,
+           "Hết thủ công: lịch #0 chạy tiếp 200 s");
+    expect(!q.due(329000) && q.due(330000), "Lịch #0 xong sau 200 s");
+    expect(q.next(330000, expired) && activeIs(q, SCHEDULE, 1) && expired == 0, "Rồi đến lịch #1");
+    expect(q.due(450000) && !q.next(450000, expired) && !q.hasActive(), "Hàng trống");
+    expect(q.getStarted() == 4 && q.getPreempted() == 1, "Đếm: 4 lần chạy, 1 lần chen ngang");
+
+    // Auto is preempted by a schedule and dropped; cancel stays in its source
+    IrrigationQueue a;
+    expect(a.submit(AUTO, 0, NO, 0) == IrrigationVerdict::STARTED, "Tự động chạy khi rảnh");
+    expect(a.submit(SCHEDULE, 60, 2, 1000) == IrrigationVerdict::PREEMPTED, "Lịch chen ngang tự động");
+    expect(a.waitingCount() == 0 && !a.has(AUTO), "Tự động bị bỏ, không chờ");
+    expect(!a.cancel(AUTO) && activeIs(a, SCHEDULE, 2), "Đất ướt không dừng lượt tưới theo lịch");
+    expect(a.submit(MANUAL, 30, NO, 2000) == IrrigationVerdict::PREEMPTED &&
+           a.cancel(MANUAL) && a.has(SCHEDULE, 2) && !a.has(SCHEDULE, 1),
+           "Hủy thủ công chỉ bỏ việc thủ công");
+
+    // FIFO within a class, queue limit, expiry
+    IrrigationQueue f;
+    f.submit(MANUAL, 0, NO, 0);
+    bool fifo = true;
+    for (uint8_t i = 0; i < IRRIGATION_QUEUE_MAX; i++) {
+        fifo &= f.submit(SCHEDULE, 60, i, i * 1000) == IrrigationVerdict::QUEUED;
+    }
+    expect(fifo && f.submit(SCHEDULE, 60, 200, 9000) == IrrigationVerdict::FULL, "Hàng đầy");
+    uint32_t late = IRRIGATION_WAIT_MAX_SEC * 1000UL + 1500;
+    expect(f.next(late, expired) && expired == 2 && activeIs(f, SCHEDULE, 2),
+           "Chờ quá lâu: 2 lịch bị bỏ, lịch #2 chạy (theo thứ tự)");
+    expect(f.getExpired() == 2 && f.waitingCount() == IRRIGATION_QUEUE_MAX - 3, "Đếm bỏ do chờ");
+    expect(f.clear() && !f.hasActive() && f.waitingCount() == 0, "Tắt bơm: xóa hết");
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+
+int main() {
+    setenv("TZ", "ICT-7", 1);
+    tzset();
+
+    printf("🗓️  Mô phỏng lịch tưới với đồng hồ giả (UTC+7)\n");
+    onTime();
+    rebootPolicies();
+    longOutage();
+    firstSync();
+    clockBack();
+    clockForward();
+    intervalsAndDays();
+    dstTransitions();
+    tzStrings();
+    httpDates();
+    sunTimesCheck();
+    irrigationJobs();
+
+    printf("\n%s %d lỗi\n", failures ? "❌" : "✅", failures);
+    return failures ? 1 : 0;
+}
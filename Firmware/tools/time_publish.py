@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""
+Phát giờ lên topic MQTT "time" (retained) cho mạng không có NTP
+
+Cách dùng:
+    python tools/time_publish.py 192.168.1.10
+    python tools/time_publish.py 192.168.1.10 --interval 30
+    python tools/time_publish.py 192.168.1.10 --once
+    python tools/time_publish.py 192.168.1.10 --clear
+
+Script sẽ:
+1. Mỗi --interval giây publish {"epoch", "ms", "interval"} theo đồng hồ máy này
+   (máy này nên có NTP hoặc GPS; thiết bị tin giờ này ±250 ms)
+2. Publish retained: thiết bị kết nối sau vẫn có giờ ngay ("clear" = xoá bản retained)
+3. Xem kết quả: GET /api/status trên thiết bị, time.source = "mqtt"
+
+Yêu cầu: mosquitto_pub có trong PATH (broker cục bộ: mosquitto -v)
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import time
+
+TOPIC = "time"
+
+
+def publish(args, payload):
+    cmd = ["mosquitto_pub", "-h", args.broker, "-p", str(args.port), "-q", "0", "-r", "-t", TOPIC]
+    cmd += ["-m", payload] if payload else ["-n"]
+    subprocess.run(cmd, check=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Phát giờ lên topic MQTT time")
+    parser.add_argument("broker", nargs="?", default="localhost", help="Địa chỉ broker MQTT")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--interval", type=int, default=10, help="Chu kỳ publish, 1-3600 giây")
+    parser.add_argument("--once", action="store_true", help="Publish một lần rồi thoát")
+    parser.add_argument("--clear", action="store_true", help="Xoá bản retained")
+    args = parser.parse_args()
+
+    if not 1 <= args.interval <= 3600:
+        print("❌ --interval phải 1-3600")
+        return 1
+
+    try:
+        if args.clear:
+            publish(args, "")
+            print("✅ Đã xoá giờ retained trên %s" % TOPIC)
+            return 0
+
+        print("📤 %s <- giờ máy này mỗi %d s (Ctrl+C để dừng)" % (TOPIC, args.interval))
+        while True:
+            now = time.time()
+            payload = json.dumps({"epoch": int(now), "ms": int(now * 1000) % 1000,
+                                  "interval": args.interval})
+            publish(args, payload)
+            print("   %s  %s" % (time.strftime("%H:%M:%S"), payload))
+            if args.once:
+                return 0
+            # Publish near the start of a second
+            time.sleep(args.interval - (time.time() % 1))
+    except FileNotFoundError:
+        print("❌ Không tìm thấy mosquitto_pub")
+        return 1
+    except subprocess.CalledProcessError as e:
+        print("❌ mosquitto_pub lỗi (%d)" % e.returncode)
+        return 1
+    except KeyboardInterrupt:
+        print("\n⏹️  Dừng (bản retained cuối vẫn còn trên broker)")
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
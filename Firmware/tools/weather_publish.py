@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Gửi dự báo thời tiết mẫu (retained) để thử ngân sách nước trên thiết bị
+
+Cách dùng:
+    python tools/weather_publish.py 192.168.1.10 --device TC_A1B2C3 hot
+    python tools/weather_publish.py 192.168.1.10 --group zoneA rain
+    python tools/weather_publish.py 192.168.1.10 --device TC_A1B2C3 clear
+    python tools/weather_publish.py 192.168.1.10 --device TC_A1B2C3 --json '{"rain": 3, "et0": 4}'
+    python tools/weather_publish.py --list
+
+Script sẽ:
+1. Chọn dự báo mẫu (hoặc --json) và tính trước ngân sách thiết bị sẽ áp dụng
+2. Publish retained lên devices/{id}/weather hoặc groups/{group}/weather
+   ("clear" = payload rỗng, xoá dự báo)
+3. Xem kết quả: GET /api/budget trên thiết bị, hoặc log BUDGET qua Serial
+
+Yêu cầu: mosquitto_pub có trong PATH (broker cục bộ: mosquitto -v)
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+
+# Dự báo mẫu: tên -> payload
+FORECASTS = {
+    "hot":    {"rain": 0, "temp": 37, "et0": 7.5, "ttl": 24},
+    "mild":   {"rain": 1, "rain_prob": 50, "temp": 28, "et0": 4.0, "ttl": 24},
+    "cloudy": {"rain": 2.5, "rain_prob": 60, "temp": 29, "et0": 4.5, "ttl": 24},
+    "rain":   {"rain": 12, "rain_prob": 90, "temp": 26, "ttl": 12},
+    "temp":   {"temp": 35, "ttl": 6},
+    "clear":  None,
+}
+
+# Giống config.h (BUDGET_*), đơn vị 0.1 mm / 0.1 °C như trên thiết bị
+ET0_REF_MM10 = 50
+TEMP_REF_C10 = 300
+ET0_PER_C_MM100 = 15
+RAIN_SKIP_MM10 = 50
+MIN_PERCENT, MAX_PERCENT = 25, 200
+SHIFT_MAX = 10
+
+
+def tenths(value):
+    """Số thực -> phần mười, làm tròn như thiết bị"""
+    return int(value * 10 - 0.5) if value < 0 else int(value * 10 + 0.5)
+
+
+def expected_budget(f):
+    """Ngân sách thiết bị sẽ tính (%), và độ dịch ngưỡng tự động"""
+    if f is None:
+        return 100, 0
+    if "et0" in f:
+        et0 = tenths(f["et0"])
+    elif "temp" in f:
+        et0 = max(0, ET0_REF_MM10 + int((tenths(f["temp"]) - TEMP_REF_C10) * ET0_PER_C_MM100 / 100))
+    else:
+        et0 = ET0_REF_MM10
+    rain = tenths(f.get("rain", 0)) * f.get("rain_prob", 100) // 100
+    if rain >= RAIN_SKIP_MM10 or (rain > 0 and rain >= et0):
+        return 0, -SHIFT_MAX
+    percent = int((et0 - rain) * 100 / ET0_REF_MM10)
+    percent = min(MAX_PERCENT, max(MIN_PERCENT, percent))
+    shift = int((percent - 100) / 10)
+    return percent, min(SHIFT_MAX, max(-SHIFT_MAX, shift))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Publish dự báo thời tiết mẫu")
+    parser.add_argument("broker", nargs="?", default="localhost", help="Địa chỉ broker MQTT")
+    parser.add_argument("forecast", nargs="?", default="hot", choices=sorted(FORECASTS))
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--device", help="Device ID, vd. TC_A1B2C3")
+    parser.add_argument("--group", help="Tên nhóm (groups/{group}/weather)")
+    parser.add_argument("--json", help="Payload tự viết thay cho dự báo mẫu")
+    parser.add_argument("--list", action="store_true", help="Liệt kê dự báo mẫu")
+    args = parser.parse_args()
+
+    if args.list:
+        print("🌦️  Dự báo mẫu:")
+        for name in sorted(FORECASTS):
+            percent, shift = expected_budget(FORECASTS[name])
+            print("   %-7s %-60s -> %3d%%, ngưỡng %+d" %
+                  (name, json.dumps(FORECASTS[name]), percent, shift))
+        return 0
+
+    if bool(args.device) == bool(args.group):
+        print("❌ Cần đúng một trong --device hoặc --group")
+        return 1
+
+    forecast = json.loads(args.json) if args.json else FORECASTS[args.forecast]
+    topic = ("devices/%s/weather" % args.device) if args.device else ("groups/%s/weather" % args.group)
+    payload = json.dumps(forecast) if forecast is not None else ""
+
+    percent, shift = expected_budget(forecast)
+    print("📤 %s <- %s" % (topic, payload or "(rỗng, xoá dự báo)"))
+    if forecast is None:
+        print("   Thiết bị quay về 100% nếu không còn dự báo khác")
+    elif percent == 0:
+        print("   Dự kiến: bỏ tưới (mưa đủ), ngưỡng tự động %+d" % shift)
+    else:
+        print("   Dự kiến: thời gian lịch x%d%%, ngưỡng tự động %+d" % (percent, shift))
+
+    cmd = ["mosquitto_pub", "-h", args.broker, "-p", str(args.port), "-q", "1", "-r", "-t", topic]
+    cmd += ["-m", payload] if payload else ["-n"]
+    try:
+        subprocess.run(cmd, check=True)
+    except FileNotFoundError:
+        print("❌ Không tìm thấy mosquitto_pub")
+        return 1
+    except subprocess.CalledProcessError as e:
+        print("❌ mosquitto_pub lỗi (%d)" % e.returncode)
+        return 1
+
+    print("✅ Đã publish (retained). Kiểm tra: curl http://<thiết-bị>/api/budget")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+Kiểm tra tải web server: nhiều client cùng gọi /api/status, đo độ trễ loop()
+
+Cách dùng:
+    python tools/web_load_test.py 192.168.1.100
+    python tools/web_load_test.py 192.168.1.100 --clients 20 --duration 30
+    python tools/web_load_test.py 192.168.1.100 --duration 3600 --path /api/status --path /api/schedule
+    python tools/web_load_test.py 192.168.1.100 --clients 3 --keep-alive
+
+Script sẽ:
+1. POST /api/perf để reset số liệu đỉnh trên thiết bị
+2. Chạy N client song song, mỗi client gọi GET <path> liên tục (kết nối mới mỗi lần,
+   hoặc giữ một kết nối HTTP/1.1 với --keep-alive, mở lại khi thiết bị đóng);
+   --path lặp lại nhiều lần thì các endpoint được gọi xoay vòng (soak test)
+3. GET /api/perf: loop() chậm nhất, số lần stall, heap thấp nhất trong lúc chịu tải,
+   số kết nối (mở đỉnh, dùng lại, bị đẩy ra, bị từ chối, timeout)
+4. In thống kê độ trễ request (p50/p95/p99/max) và lỗi
+
+Mã thoát khác 0 nếu loop() chậm nhất vượt --max-loop-ms (mặc định 50 ms,
+bằng LOOP_STALL_WARN_MS) - dùng để so sánh backend sync và async.
+
+Chỉ dùng thư viện chuẩn Python.
+"""
+
+import argparse
+import http.client
+import json
+import sys
+import threading
+import time
+
+
+def request(host, port, method, path, body=None, timeout=5.0):
+    """Một request trên kết nối mới, trả về (status, body)"""
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        headers = {"Content-Type": "application/json"} if body is not None else {}
+        conn.request(method, path, body=body, headers=headers)
+        resp = conn.getresponse()
+        return resp.status, resp.read()
+    finally:
+        conn.close()
+
+
+def request_on(conn, method, path):
+    """Một request trên kết nối có sẵn (keep-alive), trả về (status, body, còn mở)"""
+    conn.request(method, path)
+    resp = conn.getresponse()
+    body = resp.read()
+    return resp.status, body, not resp.will_close
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    idx = min(len(values) - 1, int(round(pct / 100.0 * (len(values) - 1))))
+    return values[idx]
+
+
+def worker(args, index, stop, results, lock):
+    """Gọi liên tục cho tới khi stop được set"""
+    latencies = []
+    errors = {}
+    conn = None
+    n = index
+    while not stop.is_set():
+        path = args.path[n % len(args.path)]
+        n += 1
+        start = time.monotonic()
+        try:
+            if args.keep_alive:
+                if conn is None:
+                    conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+                status, _, open_ = request_on(conn, "GET", path)
+                if not open_:
+                    conn.close()
+                    conn = None
+            else:
+                status, _ = request(args.host, args.port, "GET", path, timeout=args.timeout)
+            key = None if status == 200 else "HTTP %d" % status
+        except Exception as e:  # noqa: BLE001 - đếm mọi loại lỗi mạng
+            key = type(e).__name__
+            if conn is not None:
+                conn.close()
+                conn = None
+        elapsed = (time.monotonic() - start) * 1000.0
+        if key is None:
+            latencies.append(elapsed)
+        else:
+            errors[key] = errors.get(key, 0) + 1
+    if conn is not None:
+        conn.close()
+    with lock:
+        results["latencies"].extend(latencies)
+        for key, count in errors.items():
+            results["errors"][key] = results["errors"].get(key, 0) + count
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TuoiCay web server load test")
+    parser.add_argument("host", help="IP của ESP8266")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--path", action="append", help="lặp lại được (mặc định /api/status)")
+    parser.add_argument("--clients", type=int, default=20)
+    parser.add_argument("--duration", type=float, default=30.0, help="giây")
+    parser.add_argument("--timeout", type=float, default=5.0, help="timeout mỗi request (giây)")
+    parser.add_argument("--max-loop-ms", type=float, default=50.0)
+    parser.add_argument("--keep-alive", action="store_true",
+                        help="mỗi client giữ một kết nối HTTP/1.1 (backend sync)")
+    args = parser.parse_args()
+    if not args.path:
+        args.path = ["/api/status"]
+
+    print("🔄 Reset số liệu /api/perf...")
+    try:
+        request(args.host, args.port, "POST", "/api/perf", body="{}")
+    except Exception as e:  # noqa: BLE001
+        print("   ❌ Không kết nối được %s:%d (%s)" % (args.host, args.port, e))
+        return 2
+
+    print("🚀 %d client x %.0fs -> GET %s%s" % (args.clients, args.duration, ", ".join(args.path),
+                                              " (keep-alive)" if args.keep_alive else ""))
+    stop = threading.Event()
+    lock = threading.Lock()
+    results = {"latencies": [], "errors": {}}
+    threads = [threading.Thread(target=worker, args=(args, i, stop, results, lock))
+               for i in range(args.clients)]
+    started = time.monotonic()
+    for t in threads:
+        t.start()
+    time.sleep(args.duration)
+    stop.set()
+    for t in threads:
+        t.join()
+    elapsed = time.monotonic() - started
+
+    # Thiết bị có thể còn đang xả hàng đợi; đợi một chút rồi đọc số liệu
+    time.sleep(1.0)
+    status, body = request(args.host, args.port, "GET", "/api/perf", timeout=10.0)
+    perf = json.loads(body) if status == 200 else {}
+
+    lat = sorted(results["latencies"])
+    total = len(lat) + sum(results["errors"].values())
+    print("\n📊 Request")
+    print("   Thành công: %d / %d (%.1f req/s)" % (len(lat), total, len(lat) / elapsed))
+    print("   Độ trễ ms : p50=%.1f p95=%.1f p99=%.1f max=%.1f" % (
+        percentile(lat, 50), percentile(lat, 95), percentile(lat, 99), lat[-1] if lat else 0.0))
+    for key, count in sorted(results["errors"].items()):
+        print("   Lỗi %-12s: %d" % (key, count))
+
+    loop = perf.get("loop", {})
+    heap = perf.get("heap", {})
+    web = perf.get("web", {})
+    peak_ms = loop.get("peakUs", 0) / 1000.0
+    print("\n📊 Thiết bị (backend %s)" % web.get("backend", "?"))
+    print("   loop() chậm nhất: %.1f ms, stall: %d / %d vòng" % (
+        peak_ms, loop.get("stalls", 0), loop.get("iterations", 0)))
+    print("   handler chậm nhất: %.1f ms, bị từ chối: %d" % (
+        web.get("maxHandlerUs", 0) / 1000.0, web.get("rejected", 0)))
+    print("   heap: free=%d maxBlock=%d frag=%d%%" % (
+        heap.get("free", 0), heap.get("maxBlock", 0), heap.get("fragmentation", 0)))
+    print("   heap thấp nhất: free=%d maxBlock=%d" % (
+        heap.get("minFree", 0), heap.get("minMaxBlock", 0)))
+    conns = web.get("connections")
+    if conns:
+        print("   kết nối: đỉnh=%d/%d nhận=%d dùng lại=%d đẩy ra=%d từ chối=%d timeout=%d" % (
+            conns.get("peak", 0), conns.get("max", 0), conns.get("accepted", 0),
+            conns.get("reused", 0), conns.get("evicted", 0), conns.get("rejected", 0),
+            conns.get("timeouts", 0)))
+
+    if peak_ms > args.max_loop_ms:
+        print("\n❌ loop() bị chặn %.1f ms (> %.0f ms)" % (peak_ms, args.max_loop_ms))
+        return 1
+    print("\n✅ loop() luôn dưới %.0f ms" % args.max_loop_ms)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())